@@ -0,0 +1,63 @@
+// include/adjacency_bitset.h
+#ifndef ADJACENCY_BITSET_H
+#define ADJACENCY_BITSET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tdma_types.h"
+#include "topology_graph.h"
+
+#define BITSET_WORD_BITS 64
+#define BITSET_WORDS_FOR(n) (((n) + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS)
+
+typedef uint64_t bitset_word_t;
+
+/**
+ * Adjacência compacta: bit j da linha i = link i-j existe
+ * (mesma indexação que connectivity_matrix_t / topology_graph_t)
+ *
+ * Cada linha tem words_per_row palavras de 64 bits, alocadas em heap
+ * de acordo com o número de nós.
+ */
+typedef struct {
+    bitset_word_t *rows;        // num_nodes * words_per_row
+    node_id_t *node_ids;
+    uint32_t num_nodes;
+    uint32_t words_per_row;
+    uint32_t capacity;          // nós suportados pelas alocações atuais
+} adjacency_bitset_t;
+
+void adjacency_bitset_init(adjacency_bitset_t *adj);
+void adjacency_bitset_destroy(adjacency_bitset_t *adj);
+
+// Redimensiona para num_nodes e limpa todos os links
+int adjacency_bitset_resize(adjacency_bitset_t *adj, uint32_t num_nodes);
+
+/**
+ * Converte a connectivity matrix (byte por link) para bitset
+ * Qualquer valor != 0 na matriz conta como link ativo
+ */
+int adjacency_bitset_from_matrix(adjacency_bitset_t *adj,
+                                 const connectivity_matrix_t *topo);
+
+// Converte a topologia esparsa para bitset
+int adjacency_bitset_from_graph(adjacency_bitset_t *adj,
+                                const topology_graph_t *graph);
+
+void adjacency_bitset_set(adjacency_bitset_t *adj, int i, int j, bool connected);
+
+static inline const bitset_word_t *adjacency_bitset_row(const adjacency_bitset_t *adj,
+                                                        int i) {
+    return &adj->rows[(size_t)i * adj->words_per_row];
+}
+
+static inline bool adjacency_bitset_test(const adjacency_bitset_t *adj,
+                                         int i, int j) {
+    return (adjacency_bitset_row(adj, i)[j / BITSET_WORD_BITS] >>
+            (j % BITSET_WORD_BITS)) & 1ULL;
+}
+
+// Número de vizinhos do nó i (popcount da linha)
+int adjacency_bitset_degree(const adjacency_bitset_t *adj, int i);
+
+#endif // ADJACENCY_BITSET_H
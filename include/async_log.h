@@ -0,0 +1,136 @@
+// include/async_log.h
+#ifndef ASYNC_LOG_H
+#define ASYNC_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#define LOG_LEVEL_ERROR 0
+#define LOG_LEVEL_WARN  1
+#define LOG_LEVEL_INFO  2
+#define LOG_LEVEL_DEBUG 3
+
+// Filtro em compile time: chamadas acima deste nível desaparecem do binário
+// (ex.: make CFLAGS+=-DASYNC_LOG_LEVEL=LOG_LEVEL_WARN)
+#ifndef ASYNC_LOG_LEVEL
+#define ASYNC_LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#define ASYNC_LOG_MAX_ARGS 8
+#define ASYNC_LOG_RING_SIZE 1024          // Registos por thread (potência de 2)
+#define ASYNC_LOG_MAX_THREADS 64
+#define ASYNC_LOG_FLUSH_INTERVAL_MS 10
+
+/**
+ * Local de uma chamada de log (estático, um por chamada)
+ *
+ * O endereço serve de format id: um registo guarda só o ponteiro, o
+ * timestamp e os argumentos em bruto; o texto só é formatado na thread
+ * de escoamento.
+ */
+typedef struct {
+    const char *fmt;
+    int level;
+} async_log_site_t;
+
+/**
+ * Registo binário no anel de uma thread
+ *
+ * Cada argumento ocupa uma palavra de 64 bits (inteiros alargados,
+ * double pelos bits, ponteiros). Strings (%s) são guardadas por
+ * ponteiro: só literais ou memória que vive até ao escoamento.
+ */
+typedef struct {
+    uint64_t timestamp_us;
+    const async_log_site_t *site;
+    uint32_t nargs;
+    uint64_t args[ASYNC_LOG_MAX_ARGS];
+} async_log_record_t;
+
+typedef struct {
+    uint64_t written;                 // Registos aceites nos anéis
+    uint64_t dropped;                 // Anel cheio (o produtor nunca bloqueia)
+    uint64_t synchronous;             // Formatados na hora (logger parado / sem anel)
+    uint64_t drained;
+    uint64_t flushes;                 // write(2) feitos pelo escoamento
+} async_log_stats_t;
+
+/**
+ * Logger assíncrono: um anel SPSC lock-free por thread
+ *
+ * O produtor (qualquer thread, via LOG_*) escreve o registo no seu anel
+ * com um store release, sem locks nem syscalls; uma thread de fundo
+ * escoa todos os anéis a cada ASYNC_LOG_FLUSH_INTERVAL_MS, intercala-os
+ * por timestamp, formata e faz um único fwrite() por passagem. Sem
+ * async_log_start() (ex.: testes) cada LOG_* imprime de imediato, como
+ * o printf que substitui.
+ */
+int async_log_start(FILE *sink);
+void async_log_stop(void);            // Escoa tudo antes de parar
+void async_log_flush(void);           // Escoa agora (antes de um dump síncrono)
+bool async_log_running(void);
+void async_log_get_stats(async_log_stats_t *stats);
+
+void async_log_write(const async_log_site_t *site, uint32_t nargs, const uint64_t *args);
+
+// Formata um registo como printf faria (usado pelo escoamento)
+int async_log_format(char *out, size_t size, const char *fmt,
+                     uint32_t nargs, const uint64_t *args);
+
+// ========================================
+// Captura de Argumentos
+// ========================================
+
+static inline uint64_t async_log_arg_int(uint64_t value) { return value; }
+static inline uint64_t async_log_arg_ptr(const void *value) { return (uint64_t)(uintptr_t)value; }
+static inline uint64_t async_log_arg_double(double value) {
+    union { double d; uint64_t u; } bits = { .d = value };
+    return bits.u;
+}
+
+#define ASYNC_LOG_ARG(x) _Generic((x),                    \
+    double: async_log_arg_double,                         \
+    float: async_log_arg_double,                          \
+    char *: async_log_arg_ptr,                            \
+    const char *: async_log_arg_ptr,                      \
+    void *: async_log_arg_ptr,                            \
+    const void *: async_log_arg_ptr,                      \
+    default: async_log_arg_int)(x)
+
+#define ASYNC_LOG_COUNT(...) ASYNC_LOG_COUNT_(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0, _)
+#define ASYNC_LOG_COUNT_(fmt, a1, a2, a3, a4, a5, a6, a7, a8, n, ...) n
+
+#define ASYNC_LOG_CAT(a, b) ASYNC_LOG_CAT_(a, b)
+#define ASYNC_LOG_CAT_(a, b) a##b
+
+#define ASYNC_LOG_MAP_0(...)
+#define ASYNC_LOG_MAP_1(a) , ASYNC_LOG_ARG(a)
+#define ASYNC_LOG_MAP_2(a, ...) , ASYNC_LOG_ARG(a) ASYNC_LOG_MAP_1(__VA_ARGS__)
+#define ASYNC_LOG_MAP_3(a, ...) , ASYNC_LOG_ARG(a) ASYNC_LOG_MAP_2(__VA_ARGS__)
+#define ASYNC_LOG_MAP_4(a, ...) , ASYNC_LOG_ARG(a) ASYNC_LOG_MAP_3(__VA_ARGS__)
+#define ASYNC_LOG_MAP_5(a, ...) , ASYNC_LOG_ARG(a) ASYNC_LOG_MAP_4(__VA_ARGS__)
+#define ASYNC_LOG_MAP_6(a, ...) , ASYNC_LOG_ARG(a) ASYNC_LOG_MAP_5(__VA_ARGS__)
+#define ASYNC_LOG_MAP_7(a, ...) , ASYNC_LOG_ARG(a) ASYNC_LOG_MAP_6(__VA_ARGS__)
+#define ASYNC_LOG_MAP_8(a, ...) , ASYNC_LOG_ARG(a) ASYNC_LOG_MAP_7(__VA_ARGS__)
+
+#define ASYNC_LOG_EMIT(level, n, fmt, ...) do {                              \
+    if ((level) <= ASYNC_LOG_LEVEL) {                                         \
+        static const async_log_site_t async_log_site_ = { fmt, level };       \
+        const uint64_t async_log_args_[] = {                                  \
+            0 ASYNC_LOG_CAT(ASYNC_LOG_MAP_, n)(__VA_ARGS__)                   \
+        };                                                                    \
+        async_log_write(&async_log_site_, n, async_log_args_ + 1);            \
+    }                                                                         \
+} while (0)
+
+#define ASYNC_LOG(level, ...) \
+    ASYNC_LOG_EMIT(level, ASYNC_LOG_COUNT(__VA_ARGS__), __VA_ARGS__)
+
+// Mesma assinatura que printf (até ASYNC_LOG_MAX_ARGS argumentos)
+#define LOG_ERROR(...) ASYNC_LOG(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_WARN(...)  ASYNC_LOG(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_INFO(...)  ASYNC_LOG(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_DEBUG(...) ASYNC_LOG(LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+#endif // ASYNC_LOG_H
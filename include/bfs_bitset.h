@@ -0,0 +1,33 @@
+// include/bfs_bitset.h
+#ifndef BFS_BITSET_H
+#define BFS_BITSET_H
+
+#include "tdma_types.h"
+#include "adjacency_bitset.h"
+#include "dijkstra.h"
+
+/**
+ * BFS por fronteira sobre adjacência em bitset (routing por hop count)
+ *
+ * Cada nível expande a fronteira inteira com operações OR/ANDNOT
+ * sobre palavras de 64 bits. O desempate entre caminhos de igual
+ * comprimento é o mesmo do dijkstra_compute() (menor índice primeiro),
+ * por isso os resultados são idênticos.
+ *
+ * @param src Source node ID
+ * @param adj Adjacência em bitset
+ * @param results Array de resultados [adj->num_nodes] (mesmo formato do Dijkstra)
+ * @return 0 em sucesso, -1 em erro
+ */
+int bfs_bitset_compute(node_id_t src,
+                       const adjacency_bitset_t *adj,
+                       dijkstra_result_t *results);
+
+/**
+ * Atalho: converte a matriz para bitset e corre o BFS
+ */
+int bfs_bitset_compute_matrix(node_id_t src,
+                              connectivity_matrix_t *topology,
+                              dijkstra_result_t results[MAX_NODES]);
+
+#endif // BFS_BITSET_H
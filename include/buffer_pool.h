@@ -0,0 +1,58 @@
+// include/buffer_pool.h
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+#define BUFFER_POOL_BUF_SIZE 1536     // MAX_PACKET_SIZE arredondado a 64 bytes
+
+/**
+ * Pool de buffers do tamanho de um pacote (slab + free list lock-free)
+ *
+ * Os buffers vivem num único slab; a free list é uma pilha de Treiber
+ * sobre índices, com tag na cabeça contra ABA. Partilhado pelo anel de
+ * RX do transporte, pelo forwarding e pela fila de TX, sem malloc/free
+ * por pacote. As páginas do slab só entram no RSS quando são usadas.
+ */
+typedef struct {
+    uint8_t *slab;
+    uint32_t count;
+    uint32_t buf_size;
+    _Atomic uint32_t *next;           // next[i] = índice+1 do seguinte (0 = fim)
+    _Atomic uint64_t head;            // (tag << 32) | (índice+1)
+    
+    // Stats
+    _Atomic uint32_t in_use;
+    _Atomic uint32_t high_water;
+    _Atomic uint64_t allocs;
+    _Atomic uint64_t alloc_failures;
+} buffer_pool_t;
+
+int buffer_pool_init(buffer_pool_t *pool, uint32_t count, uint32_t buf_size);
+void buffer_pool_destroy(buffer_pool_t *pool);
+
+// Buffer livre (buf_size bytes), NULL se o pool esgotou
+uint8_t *buffer_pool_get(buffer_pool_t *pool);
+
+// Devolve um buffer obtido com buffer_pool_get()
+void buffer_pool_put(buffer_pool_t *pool, uint8_t *buf);
+
+static inline bool buffer_pool_owns(const buffer_pool_t *pool, const uint8_t *buf) {
+    return pool && buf >= pool->slab &&
+           buf < pool->slab + (size_t)pool->count * pool->buf_size;
+}
+
+/**
+ * Aloca 'size' bytes: do pool se couber, senão malloc (pool NULL = malloc)
+ */
+uint8_t *buffer_pool_alloc(buffer_pool_t *pool, size_t size);
+
+// Liberta um buffer de buffer_pool_alloc(): volta ao pool ou free()
+void buffer_pool_release(buffer_pool_t *pool, uint8_t *buf);
+
+void buffer_pool_print_stats(buffer_pool_t *pool);
+
+#endif // BUFFER_POOL_H
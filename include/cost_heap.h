@@ -0,0 +1,76 @@
+// include/cost_heap.h
+#ifndef COST_HEAP_H
+#define COST_HEAP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Heap binário indexado (min-heap com decrease-key)
+ *
+ * Guarda índices de nós; a chave de cada nó vive no array 'key' do
+ * caller. Ordena por (custo, índice) para que o desempate seja
+ * determinístico. Partilhado pelo Dijkstra pesado e pela SPT incremental.
+ */
+typedef struct {
+    uint32_t *items;     // Índices dos nós no heap
+    int32_t *pos;        // Posição de cada nó no heap (-1 = fora)
+    const uint32_t *key; // Custo atual de cada nó
+    uint32_t size;
+} cost_heap_t;
+
+static inline bool cost_heap_less(const cost_heap_t *h, uint32_t a, uint32_t b) {
+    return h->key[a] < h->key[b] || (h->key[a] == h->key[b] && a < b);
+}
+
+static inline void cost_heap_swap(cost_heap_t *h, uint32_t i, uint32_t j) {
+    uint32_t tmp = h->items[i];
+    h->items[i] = h->items[j];
+    h->items[j] = tmp;
+    h->pos[h->items[i]] = i;
+    h->pos[h->items[j]] = j;
+}
+
+static inline void cost_heap_sift_up(cost_heap_t *h, uint32_t i) {
+    while (i > 0) {
+        uint32_t p = (i - 1) / 2;
+        if (!cost_heap_less(h, h->items[i], h->items[p])) break;
+        cost_heap_swap(h, i, p);
+        i = p;
+    }
+}
+
+static inline void cost_heap_sift_down(cost_heap_t *h, uint32_t i) {
+    while (true) {
+        uint32_t l = 2 * i + 1, r = l + 1, m = i;
+        if (l < h->size && cost_heap_less(h, h->items[l], h->items[m])) m = l;
+        if (r < h->size && cost_heap_less(h, h->items[r], h->items[m])) m = r;
+        if (m == i) break;
+        cost_heap_swap(h, i, m);
+        i = m;
+    }
+}
+
+// Insere ou diminui a chave (key[node] já atualizado pelo caller)
+static inline void cost_heap_push_or_decrease(cost_heap_t *h, uint32_t node) {
+    if (h->pos[node] == -1) {
+        h->items[h->size] = node;
+        h->pos[node] = h->size++;
+    }
+    cost_heap_sift_up(h, h->pos[node]);
+}
+
+static inline uint32_t cost_heap_pop(cost_heap_t *h) {
+    uint32_t top = h->items[0];
+    h->pos[top] = -1;
+    
+    if (--h->size > 0) {
+        h->items[0] = h->items[h->size];
+        h->pos[h->items[0]] = 0;
+        cost_heap_sift_down(h, 0);
+    }
+    
+    return top;
+}
+
+#endif // COST_HEAP_H
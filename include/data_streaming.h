@@ -5,10 +5,22 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "udp_transport.h"
+#include "forwarding.h"
+#include "stream_reassembly.h"
+#include "stream_arq.h"
+#include "frame_generator.h"
+#include "latency_histogram.h"
 
 #define MAX_CHUNK_SIZE 1400  // MTU safe
 #define MAX_STREAM_BUFFER (1024 * 1024)  // 1MB
 
+#define STREAM_NACK_INTERVAL_MS 100      // Um NACK por stream por ronda TDMA
+#define STREAM_VIDEO_DEADLINE_MS 500     // Frame de vídeo inútil depois disto
+#define STREAM_AUDIO_DEADLINE_MS 300
+
+#define STREAM_LAT_SOURCES 16            // Origens com histograma próprio
+#define STREAM_LAT_MAX_HOPS 16           // O último agrega caminhos mais longos
+
 typedef enum {
     STREAM_TYPE_VIDEO = 1,
     STREAM_TYPE_AUDIO = 2,
@@ -21,9 +33,39 @@ typedef struct {
     uint32_t total_chunks;
     uint16_t chunk_size;
     stream_type_t type;
-    uint64_t timestamp_us;
+    uint64_t timestamp_us;        // Frame submetido na origem (relógio TDMA); igual em
+                                  // todos os chunks, paridades e retransmissões
 } __attribute__((packed)) stream_header_t;
 
+/**
+ * Payload de MSG_STREAM_NACK (depois do mesh_header_t)
+ *
+ * Seguido de (num_chunks + 63) / 64 palavras uint64_t de bitmap:
+ * bit i = chunk base_seq + i em falta.
+ */
+typedef struct {
+    uint32_t stream_id;
+    uint32_t base_seq;
+    uint16_t num_chunks;
+} __attribute__((packed)) stream_nack_t;
+
+/**
+ * Início do payload de um chunk de paridade FEC
+ *
+ * Paridades usam sequence_number >= total_chunks (total_chunks + bloco * k
+ * + índice) e chunk_size = sizeof(stream_fec_t) + STREAM_CHUNK_PAYLOAD.
+ */
+typedef struct {
+    uint8_t data_chunks;          // n: chunks de dados por bloco
+    uint8_t parity_chunks;        // k: paridades por bloco
+    uint32_t frame_size;
+} __attribute__((packed)) stream_fec_t;
+
+// Dados por chunk (todos menos o último têm exatamente este tamanho);
+// uma paridade (com stream_fec_t) também cabe em MAX_CHUNK_SIZE
+#define STREAM_CHUNK_PAYLOAD (MAX_CHUNK_SIZE - sizeof(stream_header_t) - \
+                              sizeof(mesh_header_t) - sizeof(stream_fec_t))
+
 typedef struct {
     uint32_t stream_id;
     uint32_t total_bytes;
@@ -36,21 +78,55 @@ typedef struct {
     double avg_latency_ms;
 } stream_stats_t;
 
+/**
+ * Latência one-way dos frames entregues: submissão na origem → frame
+ * completo no destino (inclui fila, espera pelo slot, relays e FEC/ARQ)
+ *
+ * Medida com o relógio TDMA (ra_tdmas_get_current_time_us(), o mesmo dos
+ * slots e do mesh_header_t), comum aos nós que partilham o host.
+ */
+typedef struct {
+    latency_hist_t all;
+    latency_hist_t by_hops[STREAM_LAT_MAX_HOPS];   // [hops - 1]
+    node_id_t sources[STREAM_LAT_SOURCES];
+    latency_hist_t by_source[STREAM_LAT_SOURCES];
+    uint32_t num_sources;
+    uint64_t untracked;                            // Origens além da tabela
+    uint64_t clock_skew;                           // Timestamp no futuro (relógios ≠)
+} stream_latency_t;
+
 typedef struct {
     node_id_t my_node_id;
     udp_transport_t *transport;
+    forwarding_engine_t *forwarding; // Se definido, chunks esperam pelo slot
     
     // TX state
     uint32_t next_stream_id;
-    uint8_t tx_buffer[MAX_STREAM_BUFFER];
     
-    // RX state
-    uint8_t rx_buffer[MAX_STREAM_BUFFER];
-    uint32_t rx_bytes_received;
+    // TX: streams retidos para responder a NACKs (só com forwarding)
+    arq_window_t arq;
+    uint32_t deadline_ms[STREAM_TYPE_DATA + 1];   // Por stream_type_t (0 = sem prazo)
+    uint8_t fec_n[STREAM_TYPE_DATA + 1];          // FEC por tipo (fec_k = 0: desligado)
+    uint8_t fec_k[STREAM_TYPE_DATA + 1];
+    uint8_t *fec_buf;                             // Paridades de um bloco (+ padding)
+    
+    // RX state: reconstrução por (origem, stream_id)
+    reasm_engine_t reasm;
+    pthread_mutex_t rx_lock;         // reasm: thread de RX vs. ronda (NACKs)
+    reasm_deliver_cb on_frame;       // Callback da aplicação (opcional)
+    void *on_frame_ctx;
     
     // Stats
     stream_stats_t tx_stats;
     stream_stats_t rx_stats;
+    uint64_t frames_delivered;       // Frames completos entregues
+    uint64_t bytes_delivered;
+    uint64_t first_delivery_ms;
+    uint64_t last_delivery_ms;
+    uint64_t nacks_sent;
+    uint64_t nack_send_failed;
+    uint64_t parity_sent;
+    stream_latency_t *latency;       // Heap (~1 MB): atualizado com rx_lock
     
 } data_streaming_t;
 
@@ -59,6 +135,16 @@ int data_streaming_init(data_streaming_t *stream,
                        node_id_t my_id,
                        udp_transport_t *transport);
 
+/**
+ * Encaminha o TX pelo motor de forwarding (next hop + fila do slot TDMA)
+ *
+ * Com forwarding, data_streaming_send() bloqueia quando a fila está cheia
+ * (backpressure) em vez de usar pacing fixo e o destino pode estar a
+ * vários hops. NULL repõe o envio direto.
+ */
+void data_streaming_set_forwarding(data_streaming_t *stream,
+                                  forwarding_engine_t *forwarding);
+
 // TX
 int data_streaming_send(data_streaming_t *stream,
                        node_id_t destination,
@@ -66,16 +152,83 @@ int data_streaming_send(data_streaming_t *stream,
                        uint32_t size,
                        stream_type_t type);
 
-// RX
+void data_streaming_destroy(data_streaming_t *stream);
+
+/**
+ * Callback para frames completos (reconstruídos, sem cópia extra)
+ *
+ * frame->data aponta para o buffer de reconstrução e só é válido
+ * durante a chamada.
+ */
+void data_streaming_set_frame_callback(data_streaming_t *stream,
+                                      reasm_deliver_cb callback,
+                                      void *ctx);
+
+/**
+ * RX: entrega um chunk [stream_header | dados] de 'src' à reconstrução
+ *
+ * @return Bytes do frame se este chunk o completou, 0 se aceite, -1 se inválido
+ */
 int data_streaming_receive(data_streaming_t *stream,
-                          uint8_t *buffer,
+                          node_id_t src,
+                          const uint8_t *buffer,
+                          uint32_t buffer_size);
+
+// Como data_streaming_receive(), com o número de hops do caminho
+// (mesh_header_t.hops + 1) para os histogramas de latência por hop
+int data_streaming_receive_from(data_streaming_t *stream,
+                               node_id_t src,
+                               uint8_t hops,
+                               const uint8_t *buffer,
+                               uint32_t buffer_size);
+
+// Prazo dos frames de um tipo, no emissor e no recetor (0 = sem prazo)
+void data_streaming_set_deadline(data_streaming_t *stream,
+                                stream_type_t type,
+                                uint32_t deadline_ms);
+
+/**
+ * FEC para um tipo de stream: k paridades por cada bloco de n chunks
+ *
+ * O recetor reconstrói até k chunks perdidos por bloco sem esperar por
+ * uma retransmissão (uma ronda TDMA por tentativa), à custa de k/n de
+ * banda extra. k = 0 desliga. O recetor não precisa de configuração.
+ * @return 0, -1 se n/k fora dos limites (FEC_MAX_DATA, FEC_MAX_PARITY)
+ */
+int data_streaming_set_fec(data_streaming_t *stream,
+                          stream_type_t type,
+                          uint8_t data_chunks,
+                          uint8_t parity_chunks);
+
+/**
+ * Uma vez por ronda TDMA: envia NACKs dos streams com chunks em falta
+ *
+ * Chamado pelo escalonador antes de drenar a fila, para os NACKs
+ * saírem no mesmo slot. Precisa de forwarding.
+ * @return Número de NACKs colocados na fila
+ */
+int data_streaming_on_round(data_streaming_t *stream, uint64_t now_ms);
+
+/**
+ * RX de um MSG_STREAM_NACK [stream_nack_t | bitmap] vindo de 'src'
+ *
+ * Reenvia da janela de retransmissão os chunks pedidos, sem bloquear.
+ * @return Chunks reenviados, -1 se inválido, desconhecido ou fora do prazo
+ */
+int data_streaming_on_nack(data_streaming_t *stream,
+                          node_id_t src,
+                          const uint8_t *buffer,
                           uint32_t buffer_size);
 
 // Stats
 void data_streaming_print_stats(data_streaming_t *stream);
 void data_streaming_reset_stats(data_streaming_t *stream);
 
-// Video simulation
+// Percentis de latência (total, por origem, por hops) em CSV
+int data_streaming_export_latency_csv(data_streaming_t *stream, const char *filename);
+
+// Video simulation (frame_generator_t com o modelo e seed por defeito)
 int generate_video_frame(uint8_t *buffer, uint32_t size);
+int generate_audio_chunk(uint8_t *buffer, uint32_t size);
 
 #endif // DATA_STREAMING_H
\ No newline at end of file
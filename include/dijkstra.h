@@ -3,8 +3,10 @@
 #define DIJKSTRA_H
 
 #include "tdma_types.h"
+#include "topology_graph.h"
 
-#define INFINITY_COST 255
+#define INFINITY_COST 0xFFFF
+#define INFINITY_PATH_COST 0xFFFFFFFFu
 
 /**
  * Estrutura para resultado do Dijkstra
@@ -12,7 +14,8 @@
 typedef struct {
     node_id_t destination;
     node_id_t next_hop;        // Próximo hop no caminho
-    uint8_t distance;          // Número de hops
+    uint16_t distance;         // Número de hops
+    uint32_t cost;             // Custo acumulado (== distance em hop count)
     bool reachable;
 } dijkstra_result_t;
 
@@ -28,6 +31,39 @@ int dijkstra_compute(node_id_t src,
                      connectivity_matrix_t *topology,
                      dijkstra_result_t results[MAX_NODES]);
 
+/**
+ * Dijkstra (hop count) sobre a topologia dinâmica
+ *
+ * Com custo unitário reduz-se a um BFS por níveis; cada nível é
+ * processado por ordem de índice para manter o mesmo desempate
+ * do dijkstra_compute().
+ *
+ * @param src Source node ID
+ * @param graph Topologia esparsa
+ * @param results Array de resultados [graph->num_nodes], indexado como o grafo
+ * @return 0 em sucesso, -1 em erro
+ */
+int dijkstra_compute_graph(node_id_t src,
+                           const topology_graph_t *graph,
+                           dijkstra_result_t *results);
+
+/**
+ * Dijkstra pesado sobre a topologia dinâmica
+ *
+ * Usa o peso de cada aresta do grafo como custo do link e um heap
+ * binário indexado (decrease-key) com custos de 32 bits: O(E log V).
+ * Empates de custo resolvem-se pelo menor índice, por isso com pesos
+ * unitários o resultado é igual ao de dijkstra_compute_graph().
+ *
+ * @param src Source node ID
+ * @param graph Topologia esparsa (weight = custo do link, >= 1)
+ * @param results Array de resultados [graph->num_nodes], indexado como o grafo
+ * @return 0 em sucesso, -1 em erro
+ */
+int dijkstra_compute_weighted(node_id_t src,
+                              const topology_graph_t *graph,
+                              dijkstra_result_t *results);
+
 /**
  * Imprime resultados do Dijkstra
  */
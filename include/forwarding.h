@@ -0,0 +1,129 @@
+// include/forwarding.h
+#ifndef FORWARDING_H
+#define FORWARDING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tdma_types.h"
+#include "udp_transport.h"
+#include "routing_manager.h"
+#include "tx_queue.h"
+
+#define FWD_DEFAULT_TTL 16
+
+/**
+ * Header end-to-end no início de cada payload MSG_DATA
+ *
+ * O udp_header_t é por hop (src = hop anterior, dst = próximo hop);
+ * a origem e o destino final viajam aqui.
+ */
+typedef struct __attribute__((packed)) {
+    node_id_t origin;             // Nó que gerou o pacote
+    node_id_t final_dst;          // Destino final
+    uint8_t ttl;                  // Decrementado em cada hop
+    uint8_t hops;                 // Hops já percorridos
+    uint64_t origin_tx_us;        // CLOCK_MONOTONIC na origem
+} mesh_header_t;
+
+typedef enum {
+    FWD_DELIVER = 0,              // Destino sou eu: entregar à aplicação
+    FWD_FORWARDED,                // Reencaminhado para a fila de TX
+    FWD_DROPPED                   // Descartado (TTL, sem rota, fila cheia)
+} fwd_verdict_t;
+
+// Séries do forwarding no registo de métricas (ver forwarding_set_metrics)
+typedef struct {
+    metric_id_t delivered;
+    metric_id_t forwarded;
+    metric_id_t ttl_expired;
+    metric_id_t no_route;
+    metric_id_t queue_full;
+} forwarding_metric_ids_t;
+
+/**
+ * Plano de forwarding em processo
+ *
+ * Pacotes de dados são encaminhados hop a hop pelo next hop do
+ * routing_manager e transmitidos no slot TDMA através da tx_queue,
+ * sem depender de rotas IP no kernel.
+ */
+typedef struct {
+    node_id_t my_id;
+    routing_manager_t *routing;
+    tx_queue_t *tx_queue;
+    udp_transport_t *transport;
+    uint8_t default_ttl;
+    
+    // Origem (thread de streaming)
+    uint64_t originated;
+    uint64_t originate_failed;
+    
+    // Receção (thread de RX)
+    uint64_t delivered;
+    uint64_t forwarded;
+    uint64_t bytes_forwarded;
+    uint64_t ttl_expired;
+    uint64_t no_route;
+    uint64_t queue_full;
+    uint64_t malformed;
+    
+    // Latência
+    uint64_t hop_latency_samples;
+    uint64_t total_hop_latency_us;  // TX do hop anterior → RX aqui
+    uint64_t max_hop_latency_us;
+    uint64_t total_delivered_hops;
+    uint64_t total_e2e_latency_us;  // Origem → entrega
+    uint64_t max_e2e_latency_us;
+    
+    // Séries exportadas, somadas nos shards de cada thread
+    metrics_registry_t *metrics;  // NULL = sem registo
+    forwarding_metric_ids_t metric_ids;
+} forwarding_engine_t;
+
+int forwarding_init(forwarding_engine_t *fwd, node_id_t my_id,
+                    routing_manager_t *routing, tx_queue_t *tx_queue,
+                    udp_transport_t *transport);
+
+// Buffer para forwarding_send() (pool da fila de TX se couber)
+uint8_t *forwarding_alloc_frame(forwarding_engine_t *fwd, uint16_t len);
+
+/**
+ * Origina um pacote de dados para 'destination'
+ *
+ * 'frame' vem de forwarding_alloc_frame() com 'len' bytes; os primeiros
+ * sizeof(mesh_header_t) bytes são preenchidos aqui. O motor fica
+ * sempre com a posse do buffer (libertado em caso de erro).
+ *
+ * @param timeout_ms Espera máxima com a fila cheia (backpressure)
+ * @return 0 em sucesso, -1 sem rota ou fila cheia
+ */
+int forwarding_send(forwarding_engine_t *fwd, node_id_t destination,
+                    uint8_t *frame, uint16_t len, int timeout_ms);
+
+// Como forwarding_send() para outro tipo de mensagem com mesh_header_t
+int forwarding_send_msg(forwarding_engine_t *fwd, node_id_t destination,
+                        message_type_t type, uint8_t *frame, uint16_t len,
+                        int timeout_ms);
+
+/**
+ * Decide o destino de um MSG_DATA (ou MSG_STREAM_NACK) recebido
+ *
+ * Se o destino final não for este nó, reclama o buffer de RX do
+ * transporte, atualiza TTL/hops no próprio buffer e coloca-o na fila
+ * de TX para o próximo hop (sem copiar o payload, sem bloquear).
+ *
+ * @param payload Payload recebido (começa com mesh_header_t)
+ * @return FWD_DELIVER, FWD_FORWARDED ou FWD_DROPPED
+ */
+fwd_verdict_t forwarding_on_receive(forwarding_engine_t *fwd,
+                                    const udp_header_t *header,
+                                    const uint8_t *payload,
+                                    uint16_t payload_len,
+                                    uint64_t rx_time_us);
+
+// Regista as séries forwarding_* em 'reg' (depois do init, antes das threads)
+void forwarding_set_metrics(forwarding_engine_t *fwd, metrics_registry_t *reg);
+
+void forwarding_print_stats(forwarding_engine_t *fwd);
+
+#endif // FORWARDING_H
@@ -0,0 +1,64 @@
+// include/frame_generator.h
+#ifndef FRAME_GENERATOR_H
+#define FRAME_GENERATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define FRAME_GEN_HEADER_SIZE 16      // "VID" | tipo | timestamp | contador
+#define FRAME_GEN_AUDIO_TABLE 4096    // Amostras pré-calculadas (128 + 127 sin(0.1 i))
+#define FRAME_GEN_DEFAULT_SEED 0x5DEECE66DULL
+#define FRAME_GEN_SIZE_JITTER 10      // ±% de variação do tamanho dos frames
+
+/**
+ * Modelo de bitrate de um codec de vídeo (GOP de I/P frames)
+ *
+ * Cada GOP tem um I-frame seguido de gop_size - 1 P-frames; um I-frame
+ * é i_to_p_ratio vezes maior. A média dá bitrate_bps a fps frames/s.
+ */
+typedef struct {
+    uint32_t fps;
+    uint32_t bitrate_bps;
+    uint32_t gop_size;
+    uint32_t i_to_p_ratio;
+    uint64_t seed;                    // Mesma seed → mesmos frames (reprodutível)
+} frame_model_t;
+
+typedef struct {
+    frame_model_t model;
+    uint64_t lanes[4];                // xorshift64 independentes (32 bytes/iteração)
+    uint32_t frame_counter;
+    uint32_t audio_counter;
+    uint32_t i_frame_size;
+    uint32_t p_frame_size;
+    uint8_t audio_table[FRAME_GEN_AUDIO_TABLE];
+} frame_generator_t;
+
+// Modelo por defeito: 720p @ 30 FPS, ~2 Mbps, GOP 30, I = 5 P
+void frame_model_default(frame_model_t *model);
+
+int frame_generator_init(frame_generator_t *gen, const frame_model_t *model);
+
+// Maior frame que o modelo pode gerar (tamanho do buffer a alocar)
+uint32_t frame_generator_max_frame_size(const frame_generator_t *gen);
+
+/**
+ * Gera o próximo frame do GOP (I ou P) em buffer
+ *
+ * @return Tamanho do frame (≤ max_size, ≥ FRAME_GEN_HEADER_SIZE), -1 se
+ *         max_size não chega para o cabeçalho
+ */
+int frame_generator_next_video(frame_generator_t *gen, uint8_t *buffer,
+                               uint32_t max_size, bool *is_iframe);
+
+// Frame de vídeo de tamanho fixo (header + payload pseudo-aleatório)
+int frame_generator_video(frame_generator_t *gen, uint8_t *buffer,
+                          uint32_t size, bool iframe);
+
+// Chunk de áudio (sinusoide pré-calculada)
+int frame_generator_audio(frame_generator_t *gen, uint8_t *buffer, uint32_t size);
+
+// Preenche buffer com bytes pseudo-aleatórios
+void frame_generator_fill(frame_generator_t *gen, uint8_t *buffer, uint32_t size);
+
+#endif // FRAME_GENERATOR_H
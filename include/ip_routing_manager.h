@@ -6,8 +6,8 @@
 #include <stdbool.h>
 #include <pthread.h>
 #include "routing_manager.h"
+#include "netlink_route.h"
 
-#define MAX_ROUTES 32
 #define IFNAMSIZ 16
 
 typedef struct {
@@ -20,20 +20,42 @@ typedef struct {
     uint64_t last_updated_ms;
 } ip_route_entry_t;
 
+// Alteração pendente num sync (destino + mensagem que decide o resultado)
+typedef struct {
+    node_id_t destination;
+    int msg;
+} ip_route_change_t;
+
 typedef struct {
     node_id_t my_node_id;
     int num_nodes;
     char interface_name[IFNAMSIZ];
     
-    // Route table
-    ip_route_entry_t route_table[MAX_ROUTES];
+    // Mirror do que está instalado no kernel, indexado por node_id
+    // [max_routes = num_nodes + 1]; num_routes = entradas válidas
+    ip_route_entry_t *route_table;
     int num_routes;
+    int max_routes;
+    
+    // Scratch do sync (pré-alocado, mesmo índice que o mirror)
+    ip_route_entry_t *desired;
+    ip_route_change_t *changes;
+    int *results;
+    
+    // Kernel (rtnetlink)
+    nl_route_t nl;
     
     // Stats
     uint32_t route_adds;
     uint32_t route_deletes;
     uint32_t route_updates;
     uint32_t route_errors;
+    uint32_t routes_adopted;         // Rotas encontradas no kernel no arranque
+    uint64_t syncs;
+    uint32_t last_sync_changes;
+    uint64_t total_sync_changes;
+    uint64_t last_sync_us;
+    uint64_t total_sync_us;
     
     pthread_mutex_t lock;
 } ip_routing_manager_t;
@@ -54,10 +76,27 @@ int ip_routing_manager_delete_route(ip_routing_manager_t *mgr,
                                     node_id_t destination);
 int ip_routing_manager_flush_all(ip_routing_manager_t *mgr);
 
-// Integration with Routing Manager
+/**
+ * Sincroniza o kernel com a tabela do routing manager
+ *
+ * Compara o estado desejado com o mirror e aplica só o diff
+ * (add/replace/delete) num batch netlink: o custo é proporcional ao
+ * que mudou, não ao tamanho da rede.
+ * @return Número de alterações aplicadas
+ */
 int ip_routing_manager_update_from_routing(ip_routing_manager_t *mgr,
                                           routing_manager_t *routing_mgr);
 
+/**
+ * Reconciliação única com o kernel (arranque)
+ *
+ * Adota no mirror as rotas NL_ROUTE_PROTO da interface que ficaram de
+ * uma execução anterior e remove as duplicadas/fora da rede, para que
+ * o primeiro sync só envie diferenças.
+ * @return Rotas adotadas, -1 em erro
+ */
+int ip_routing_manager_reconcile(ip_routing_manager_t *mgr);
+
 // Display
 void ip_routing_manager_print_table(ip_routing_manager_t *mgr);
 void ip_routing_manager_print_stats(ip_routing_manager_t *mgr);
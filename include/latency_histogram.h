@@ -0,0 +1,54 @@
+// include/latency_histogram.h
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define LATENCY_HIST_SUB_BITS 7                          // 128 sub-buckets: erro < 0.8%
+#define LATENCY_HIST_SUB_COUNT (1 << LATENCY_HIST_SUB_BITS)
+#define LATENCY_HIST_MAX_US 0xFFFFFFFFULL                // ~71 min; acima disto satura
+#define LATENCY_HIST_BUCKETS ((32 - LATENCY_HIST_SUB_BITS + 1) * LATENCY_HIST_SUB_COUNT)
+
+/**
+ * Histograma de latências log-linear (estilo HDR), em μs
+ *
+ * Valores até 2 * LATENCY_HIST_SUB_COUNT μs são exatos; acima disso cada
+ * potência de 2 tem LATENCY_HIST_SUB_COUNT buckets, logo o erro relativo
+ * de um percentil é constante (< 1 / LATENCY_HIST_SUB_COUNT). Registar é
+ * O(1) sem alocação; zero-inicializado é um histograma vazio. Não é
+ * thread-safe: cada histograma tem um só escritor.
+ */
+typedef struct {
+    uint64_t counts[LATENCY_HIST_BUCKETS];
+    uint64_t total;
+    uint64_t sum_us;
+    uint64_t min_us;
+    uint64_t max_us;
+} latency_hist_t;
+
+void latency_hist_reset(latency_hist_t *hist);
+void latency_hist_record(latency_hist_t *hist, uint64_t value_us);
+
+// Soma 'src' em 'dst' (ex.: agregar fluxos ou nós)
+void latency_hist_merge(latency_hist_t *dst, const latency_hist_t *src);
+
+/**
+ * Valor do percentil (0-100), em μs
+ *
+ * Limite superior do bucket que contém o percentil, nunca acima do máximo
+ * registado. 0 se o histograma está vazio.
+ */
+uint64_t latency_hist_percentile(const latency_hist_t *hist, double pct);
+
+double latency_hist_mean_us(const latency_hist_t *hist);
+
+// Uma linha: "<label>: N samples | p50 | p90 | p99 | p99.9 | max (ms)"
+void latency_hist_print(const latency_hist_t *hist, const char *label);
+
+// CSV: scope,key,samples,mean_ms,min_ms,p50_ms,p90_ms,p99_ms,p999_ms,max_ms
+void latency_hist_csv_header(FILE *fp);
+void latency_hist_csv_row(FILE *fp, const char *scope, long key,
+                          const latency_hist_t *hist);
+
+#endif // LATENCY_HISTOGRAM_H
@@ -0,0 +1,116 @@
+// include/link_quality.h
+#ifndef LINK_QUALITY_H
+#define LINK_QUALITY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+#include "tdma_types.h"
+
+#define LQ_WINDOW_ROUNDS 50               // 5 s a 100 ms/ronda (o antigo TIMEOUT_MS); ≤ 64
+#define LQ_ETX_SCALE 10                   // Peso de um link perfeito (ETX 1.0)
+#define LQ_MAX_ETX 10                     // Acima disto o link conta como em baixo
+#define LQ_MAX_REPORTS 128                // Vizinhos relatados por heartbeat
+#define LQ_HYSTERESIS_PERCENT 20          // Mudança de peso mínima para mexer no routing
+#define LQ_FLAG_COMPLETE 0x01             // O relatório inclui todos os vizinhos ouvidos
+
+/**
+ * Payload do heartbeat: sequência do emissor e, para cada vizinho que
+ * ele ouviu na janela, quantos heartbeats desse vizinho recebeu
+ *
+ * O relatório dá a cada vizinho a taxa de entrega no sentido inverso
+ * (dele para o emissor), que ele não consegue medir sozinho.
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t seq;                 // +1 por heartbeat (um por ronda)
+    uint16_t num_reports;
+    uint8_t flags;
+    uint8_t reserved;
+} lq_heartbeat_t;
+
+typedef struct __attribute__((packed)) {
+    node_id_t node;
+    uint8_t received;             // Heartbeats de 'node' ouvidos na janela
+    uint8_t window;               // Rondas cobertas pela janela
+} lq_report_t;
+
+#define LQ_HEARTBEAT_MAX_SIZE \
+    (sizeof(lq_heartbeat_t) + LQ_MAX_REPORTS * sizeof(lq_report_t))
+
+// Estado de um vizinho (indexado por node_id - 1)
+typedef struct {
+    uint64_t rx_bits;             // Bit k = ouvi o heartbeat last_seq - k
+    uint32_t last_seq;            // Último heartbeat esperado deste vizinho
+    uint8_t span;                 // Rondas já cobertas pela janela (≤ LQ_WINDOW_ROUNDS)
+    uint8_t silent_rounds;        // Rondas sem o ouvir (só antes da primeira receção)
+    bool known;                   // Ouvido dentro da janela
+    bool heard;                   // Heartbeat recebido nesta ronda
+    uint8_t tx_received;          // Relatado por ele: heartbeats meus que ouviu
+    uint8_t tx_window;            // 0 = ainda sem relatório
+} lq_neighbor_t;
+
+/**
+ * Estimador de qualidade dos links (ETX) a partir dos heartbeats
+ *
+ * Cada nó envia um heartbeat por ronda. A taxa de entrega de um vizinho
+ * para mim (df) conta-se numa janela deslizante de LQ_WINDOW_ROUNDS
+ * sequências; a de mim para ele (dr) vem do relatório que ele junta ao
+ * seu heartbeat. ETX = 1 / (df * dr) é o número esperado de transmissões
+ * por pacote entregue e entra na topologia como peso do link.
+ *
+ * on_heartbeat() corre na thread de receção e o resto na de heartbeat.
+ */
+typedef struct {
+    node_id_t my_id;
+    uint32_t num_nodes;
+    lq_neighbor_t *neighbors;     // [num_nodes]
+    uint32_t seq;                 // Próximo heartbeat meu
+    uint32_t report_cursor;       // Onde começa o próximo relatório (se não couber tudo)
+    pthread_mutex_t lock;
+    
+    // Estatísticas
+    uint64_t heartbeats_parsed;
+    uint64_t malformed;           // Payload curto ou com relatórios truncados
+} link_quality_t;
+
+int link_quality_init(link_quality_t *lq, node_id_t my_id, uint32_t num_nodes);
+void link_quality_destroy(link_quality_t *lq);
+
+/**
+ * Escreve o payload do meu próximo heartbeat (sequência + relatório)
+ *
+ * Se os vizinhos ouvidos não cabem em LQ_MAX_REPORTS, cada heartbeat
+ * relata uma parte e o seguinte continua onde este parou.
+ * @return Bytes escritos, -1 se 'cap' < sizeof(lq_heartbeat_t)
+ */
+int link_quality_build_heartbeat(link_quality_t *lq, uint8_t *buf, size_t cap);
+
+// Heartbeat recebido de 'src'; -1 se o payload não é válido
+int link_quality_on_heartbeat(link_quality_t *lq, node_id_t src,
+                              const uint8_t *payload, int len);
+
+// Fim da minha ronda: desliza a janela dos vizinhos que não ouvi
+void link_quality_on_round(link_quality_t *lq);
+
+// Ouvido dentro da janela (tem medições, não só o peso otimista inicial)
+bool link_quality_known(link_quality_t *lq, node_id_t neighbor);
+
+// Taxas de entrega na janela atual: src → me (inbound) ou me → src
+double link_quality_delivery(link_quality_t *lq, node_id_t neighbor, bool inbound);
+
+/**
+ * Peso do link para a topologia: round(ETX * LQ_ETX_SCALE)
+ *
+ * Um vizinho ainda não ouvido conta como perfeito até passar uma janela
+ * inteira em silêncio (como o timeout antigo). 0 = link em baixo: nada
+ * ouvido na janela ou ETX acima de LQ_MAX_ETX.
+ */
+uint16_t link_quality_weight(link_quality_t *lq, node_id_t neighbor);
+
+// Vale a pena passar de 'old_weight' a 'new_weight' ao routing?
+bool link_quality_significant(uint16_t old_weight, uint16_t new_weight);
+
+void link_quality_print(link_quality_t *lq);
+
+#endif // LINK_QUALITY_H
@@ -0,0 +1,126 @@
+// include/link_state.h
+#ifndef LINK_STATE_H
+#define LINK_STATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+#include "tdma_types.h"
+
+#define LS_MAX_LINKS 256                  // Links por LSA (cabe num pacote de 1500 B)
+#define LS_REFRESH_ROUNDS 300             // Reorigina o meu LSA a cada 30 s mesmo sem mudanças
+#define LS_MAX_AGE_ROUNDS 1000            // LSA sem refresh durante ~3 períodos: origem dada como morta
+#define LS_FLOOD_PER_SLOT 32              // LSAs (re)enviados por slot; o resto fica para o seguinte
+
+/**
+ * Payload de MSG_TOPOLOGY_UPDATE: um LSA (Link State Advertisement)
+ *
+ * A origem anuncia os vizinhos que mede (link_quality) e o peso ETX de
+ * cada link. O LSA é reenviado tal como está por cada nó que o instala,
+ * por isso 'origin' viaja no payload e não no udp_header_t (que é por hop).
+ */
+typedef struct __attribute__((packed)) {
+    node_id_t origin;
+    uint16_t num_links;
+    uint32_t seq;                 // Maior = mais recente; duplicados não são reenviados
+} lsa_header_t;
+
+typedef struct __attribute__((packed)) {
+    node_id_t neighbor;
+    uint16_t weight;              // round(ETX * LQ_ETX_SCALE), > 0
+} lsa_link_t;
+
+#define LSA_MAX_SIZE (sizeof(lsa_header_t) + LS_MAX_LINKS * sizeof(lsa_link_t))
+
+// LSA mais recente de uma origem (indexado por node_id - 1)
+typedef struct {
+    lsa_link_t *links;            // Ordenados por neighbor (pesquisa binária)
+    uint16_t num_links;
+    uint16_t capacity;
+    uint32_t seq;
+    uint32_t age_rounds;          // Rondas desde que foi instalado
+    bool valid;
+    bool flood_pending;           // Reenviar no meu próximo slot
+    bool changed;                 // Links mudaram desde a última link_state_next_changed()
+} ls_entry_t;
+
+/**
+ * Base de dados link-state (LSDB)
+ *
+ * Cada nó origina um LSA com os seus links e reenvia uma vez cada LSA
+ * novo que recebe (sequência maior que a instalada), no seu slot TDMA.
+ * Com a LSDB completa, todos os nós veem a mesma topologia.
+ *
+ * on_lsa() corre na thread de receção e o resto na de heartbeat.
+ */
+typedef struct {
+    node_id_t my_id;
+    uint32_t num_nodes;
+    ls_entry_t *entries;          // [num_nodes], a minha incluída
+    uint32_t rounds_since_originate;
+    uint32_t flood_cursor;        // Onde começa a procura de pendentes
+    uint32_t change_cursor;
+    pthread_mutex_t lock;
+    
+    // Estatísticas
+    uint64_t originated;
+    uint64_t installed;           // LSAs novos de outras origens
+    uint64_t duplicates;          // Sequência já conhecida: não reenviados
+    uint64_t flooded;             // LSAs enviados (meus e reenviados)
+    uint64_t expired;
+    uint64_t malformed;
+} link_state_t;
+
+int link_state_init(link_state_t *ls, node_id_t my_id, uint32_t num_nodes);
+void link_state_destroy(link_state_t *ls);
+
+/**
+ * Atualiza os meus links e origina um LSA novo se mudaram
+ *
+ * Também reorigina quando passam LS_REFRESH_ROUNDS rondas. Com mais de
+ * LS_MAX_LINKS vizinhos, anuncia os de menor peso.
+ * @return true se originou um LSA
+ */
+bool link_state_update_local(link_state_t *ls, const lsa_link_t *links,
+                             uint32_t num_links);
+
+/**
+ * LSA recebido (de qualquer vizinho)
+ *
+ * Instala-o e marca-o para reenvio se a sequência é maior que a
+ * conhecida; se não, é um duplicado e morre aqui. Um LSA meu com
+ * sequência ≥ à minha (de antes de um reinício) faz-me reoriginar acima.
+ * @return 1 se instalado, 0 se duplicado/antigo, -1 se inválido
+ */
+int link_state_on_lsa(link_state_t *ls, const uint8_t *payload, int len);
+
+/**
+ * Próximo LSA pendente de envio
+ *
+ * @return Bytes escritos em 'buf', 0 se não há pendentes, -1 se 'cap'
+ *         não chega para o LSA (fica pendente)
+ */
+int link_state_next_flood(link_state_t *ls, uint8_t *buf, size_t cap);
+
+// Fim da minha ronda: envelhece os LSAs e expira os que passam LS_MAX_AGE_ROUNDS
+void link_state_on_round(link_state_t *ls);
+
+// Próxima origem (≠ eu) cujos links mudaram ou expiraram; 0 quando não há mais
+node_id_t link_state_next_changed(link_state_t *ls);
+
+/**
+ * Peso do link a-b segundo a LSDB (a, b ≠ eu)
+ *
+ * Com os LSAs das duas pontas, o link só existe se ambas o anunciam
+ * (verificação bidirecional) e pesa o maior dos dois. Com só um, vale o
+ * que esse diz; sem nenhum, 0.
+ */
+uint16_t link_state_link_weight(link_state_t *ls, node_id_t a, node_id_t b);
+
+// Número de origens com LSA válido (a minha incluída)
+uint32_t link_state_known_origins(link_state_t *ls);
+
+void link_state_print(link_state_t *ls);
+
+#endif // LINK_STATE_H
@@ -0,0 +1,183 @@
+// include/metrics_registry.h
+#ifndef METRICS_REGISTRY_H
+#define METRICS_REGISTRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <pthread.h>
+#include "tdma_types.h"
+
+#define METRICS_MAX 64                   // Métricas por registo
+#define METRICS_MAX_HISTOGRAMS 8
+#define METRICS_MAX_SHARDS 32            // Threads distintas que incrementam
+#define METRICS_NAME_LEN 48
+#define METRICS_HIST_BUCKETS 24          // le = 2^0 .. 2^23 (+Inf à parte)
+#define METRICS_DEFAULT_INTERVAL_MS 1000
+
+typedef int metric_id_t;                 // -1 = não registada (incrementos ignorados)
+
+typedef enum {
+    METRIC_COUNTER = 0,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM
+} metric_type_t;
+
+typedef struct {
+    char name[METRICS_NAME_LEN];         // Nome Prometheus ([a-z0-9_]), sem prefixo
+    const char *help;
+    metric_type_t type;
+    
+    // Campo já existente lido no snapshot (NULL = contador/histograma por shard)
+    const void *source;
+    uint8_t source_size;                 // 4 ou 8 bytes
+    int hist_index;                      // Só METRIC_HISTOGRAM
+} metric_desc_t;
+
+/**
+ * Histograma de potências de 2: bucket i conta valores <= 2^i
+ *
+ * Grosseiro de propósito (25 buckets) para o export Prometheus; para
+ * percentis precisos ver latency_histogram.h.
+ */
+typedef struct {
+    uint64_t buckets[METRICS_HIST_BUCKETS + 1];
+    uint64_t sum;
+    uint64_t count;
+} metric_hist_t;
+
+/**
+ * Valores de uma thread
+ *
+ * Só a thread dona escreve (load + store relaxed, sem instruções
+ * atómicas read-modify-write nem partilha de linhas de cache); o
+ * snapshot soma todos os shards com loads relaxed.
+ */
+typedef struct {
+    uint64_t values[METRICS_MAX];
+    metric_hist_t hists[METRICS_MAX_HISTOGRAMS];
+    pthread_t owner;
+} __attribute__((aligned(64))) metrics_shard_t;
+
+/**
+ * Registo central de métricas de um nó
+ *
+ * As métricas registam-se no arranque (caminho frio, com lock); o
+ * caminho quente (metrics_inc/add/observe) encontra o shard da thread
+ * através de uma cache thread-local e não toma locks. Um exportador
+ * opcional escreve snapshots periódicos num ficheiro (substituído
+ * atomicamente) e/ou serve-os num socket Unix, em texto Prometheus ou
+ * JSON, para scraping de muitos processos sem parsing de logs.
+ */
+typedef struct {
+    node_id_t node_id;                   // Label node="<id>" em todas as séries
+    uint64_t epoch;                      // Distingue registos no mesmo endereço
+    
+    metric_desc_t metrics[METRICS_MAX];
+    int num_metrics;
+    int num_histograms;
+    
+    metrics_shard_t *shards[METRICS_MAX_SHARDS];
+    int num_shards;
+    uint64_t shard_overflows;            // Threads sem shard (incrementos perdidos)
+    pthread_mutex_t lock;                // Registo de métricas e shards
+    
+    // Exportador
+    pthread_t export_thread;
+    bool exporting;
+    uint32_t interval_ms;
+    char file_path[256];                 // "" = sem ficheiro; *.json → JSON
+    char socket_path[108];               // "" = sem socket
+    int listen_fd;
+    int wake_fd;
+    uint64_t snapshots_written;
+    uint64_t scrapes_served;
+} metrics_registry_t;
+
+int metrics_registry_init(metrics_registry_t *reg, node_id_t node_id);
+void metrics_registry_destroy(metrics_registry_t *reg);
+
+// ========================================
+// Registo (antes de as threads arrancarem)
+// ========================================
+
+metric_id_t metrics_register_counter(metrics_registry_t *reg, const char *name,
+                                     const char *help);
+metric_id_t metrics_register_histogram(metrics_registry_t *reg, const char *name,
+                                       const char *help);
+
+/**
+ * Expõe um campo uint32_t/uint64_t existente (ex.: transport.packets_sent)
+ *
+ * Lido com um load relaxed em cada snapshot; o módulo dono continua a
+ * atualizá-lo como sempre. 'size' é sizeof(campo).
+ */
+metric_id_t metrics_register_source(metrics_registry_t *reg, const char *name,
+                                    const char *help, metric_type_t type,
+                                    const void *source, size_t size);
+
+// ========================================
+// Caminho Quente
+// ========================================
+
+// Shard da thread atual (cria-o à primeira utilização); NULL se esgotou
+metrics_shard_t *metrics_shard_slow(metrics_registry_t *reg);
+
+extern __thread const metrics_registry_t *metrics_tls_registry;
+extern __thread uint64_t metrics_tls_epoch;
+extern __thread metrics_shard_t *metrics_tls_shard;
+
+static inline metrics_shard_t *metrics_local_shard(metrics_registry_t *reg) {
+    if (metrics_tls_registry == reg && metrics_tls_epoch == reg->epoch) {
+        return metrics_tls_shard;
+    }
+    return metrics_shard_slow(reg);
+}
+
+static inline void metrics_add(metrics_registry_t *reg, metric_id_t id, uint64_t n) {
+    if (!reg || id < 0) return;
+    
+    metrics_shard_t *shard = metrics_local_shard(reg);
+    if (!shard) return;
+    
+    uint64_t *value = &shard->values[id];
+    __atomic_store_n(value, __atomic_load_n(value, __ATOMIC_RELAXED) + n,
+                     __ATOMIC_RELAXED);
+}
+
+static inline void metrics_inc(metrics_registry_t *reg, metric_id_t id) {
+    metrics_add(reg, id, 1);
+}
+
+void metrics_observe(metrics_registry_t *reg, metric_id_t id, uint64_t value);
+
+// ========================================
+// Snapshot e Export
+// ========================================
+
+// Soma de todos os shards (ou valor do campo exposto); contagem p/ histogramas
+uint64_t metrics_value(metrics_registry_t *reg, metric_id_t id);
+
+// Histograma agregado de todos os shards
+void metrics_histogram(metrics_registry_t *reg, metric_id_t id, metric_hist_t *out);
+
+// Texto Prometheus (exposition format 0.0.4), prefixo "tdma_"
+void metrics_write_prometheus(metrics_registry_t *reg, FILE *fp);
+
+// {"node": N, "metrics": {"nome": valor | {"count", "sum", "buckets"}}}
+void metrics_write_json(metrics_registry_t *reg, FILE *fp);
+
+/**
+ * Arranca o exportador periódico
+ *
+ * file_path: reescrito a cada interval_ms via ficheiro temporário +
+ * rename(), logo um leitor nunca vê um snapshot parcial (.json → JSON,
+ * resto → Prometheus). socket_path: socket Unix SOCK_STREAM; cada
+ * ligação recebe um snapshot Prometheus e é fechada. Qualquer dos dois
+ * pode ser NULL.
+ */
+int metrics_export_start(metrics_registry_t *reg, const char *file_path,
+                         const char *socket_path, uint32_t interval_ms);
+void metrics_export_stop(metrics_registry_t *reg);
+
+#endif // METRICS_REGISTRY_H
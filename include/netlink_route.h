@@ -0,0 +1,105 @@
+// include/netlink_route.h
+#ifndef NETLINK_ROUTE_H
+#define NETLINK_ROUTE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <netinet/in.h>
+
+#define NL_ROUTE_PROTO 0x54            // rtm_protocol das rotas instaladas por nós
+#define NL_ROUTE_CHUNK_MSGS 64         // Máximo por sendmsg() num batch (acks
+                                       // pendentes cabem no rcvbuf do socket)
+#define NL_ROUTE_ACK_TIMEOUT_MS 1000
+
+typedef enum {
+    NL_ROUTE_ADD = 0,       // Falha se já existir (EEXIST)
+    NL_ROUTE_REPLACE,       // Cria ou substitui (dst + metric)
+    NL_ROUTE_DELETE
+} nl_route_op_t;
+
+// Rota IPv4 da tabela main devolvida por nl_route_dump()
+typedef struct {
+    in_addr_t dst;                // Network byte order
+    uint8_t dst_len;
+    in_addr_t gateway;            // 0 = rota direta
+    uint32_t metric;
+    int ifindex;
+    uint8_t protocol;
+} nl_route_info_t;
+
+typedef void (*nl_route_dump_cb)(const nl_route_info_t *route, void *ctx);
+
+/**
+ * Socket NETLINK_ROUTE para programar rotas IPv4 /32 numa interface
+ *
+ * Cada operação é uma mensagem RTM_NEWROUTE/RTM_DELROUTE com NLM_F_ACK.
+ * Gateways são vizinhos a um hop na interface da mesh (RTNH_F_ONLINK),
+ * mesmo quando o endereço cai fora da sub-rede da interface.
+ * Um batch junta várias mensagens num só sendmsg() e recolhe os acks
+ * pela ordem (sequence number) — sem fork/exec de "ip route".
+ */
+typedef struct {
+    int fd;
+    int ifindex;
+    uint32_t seq;
+    
+    // Batch: mensagens nlmsghdr contíguas
+    uint8_t *batch;
+    size_t batch_len;
+    size_t batch_cap;
+    uint32_t batch_count;
+    uint32_t batch_first_seq;
+    
+    // Stats
+    uint64_t messages_sent;
+    uint64_t sendmsg_calls;
+    uint64_t acks_ok;
+    uint64_t acks_failed;
+    uint64_t total_ack_time_us;
+} nl_route_t;
+
+/**
+ * Abre o socket e resolve a interface
+ * @return 0 em sucesso, -1 se o socket falhar ou a interface não existir
+ */
+int nl_route_open(nl_route_t *nl, const char *ifname);
+void nl_route_close(nl_route_t *nl);
+
+/**
+ * Aplica uma operação (uma mensagem + ack)
+ *
+ * @param dst Destino /32 (network byte order)
+ * @param gateway Gateway (network byte order), 0 = rota direta na interface
+ * @param metric RTA_PRIORITY
+ * @return 0 em sucesso, -errno do kernel em erro
+ */
+int nl_route_apply(nl_route_t *nl, nl_route_op_t op, in_addr_t dst,
+                   in_addr_t gateway, uint32_t metric);
+
+// Batch: begin → add* → commit
+void nl_route_batch_begin(nl_route_t *nl);
+
+// @return Índice da mensagem no batch, -1 sem memória
+int nl_route_batch_add(nl_route_t *nl, nl_route_op_t op, in_addr_t dst,
+                       in_addr_t gateway, uint32_t metric);
+
+/**
+ * Envia o batch (em chunks de NL_ROUTE_CHUNK_MSGS) e recolhe os acks
+ *
+ * @param results Opcional: results[i] = 0 ou -errno da mensagem i
+ * @param max_results Tamanho de results
+ * @return Número de mensagens falhadas, -1 em erro do socket
+ */
+int nl_route_batch_commit(nl_route_t *nl, int *results, int max_results);
+
+/**
+ * Lê a tabela main do kernel (RTM_GETROUTE + NLM_F_DUMP)
+ *
+ * Não usar durante um batch aberto (partilha o socket).
+ * @return Número de rotas passadas ao callback, -1 em erro
+ */
+int nl_route_dump(nl_route_t *nl, nl_route_dump_cb callback, void *ctx);
+
+void nl_route_print_stats(nl_route_t *nl);
+
+#endif // NETLINK_ROUTE_H
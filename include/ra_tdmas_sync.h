@@ -19,10 +19,12 @@ typedef struct {
     int64_t delay_us;
 } packet_timing_t;
 
-// Buffer para cálculo de média de atrasos
+// Buffer para cálculo de média de atrasos (heap, um valor por slot)
 typedef struct {
-    int64_t delays[MAX_NODES];
-    uint32_t count[MAX_NODES];
+    int64_t *delays;
+    uint32_t *count;
+    uint32_t *heard;            // Slots com count > 0 nesta ronda [num_slots]
+    uint32_t num_heard;
     pthread_mutex_t lock;
 } delay_buffer_t;
 
@@ -37,19 +39,26 @@ typedef struct {
 // --- ESTRUTURA PRINCIPAL DE SINCRONIZAÇÃO ---
 typedef struct {
     node_id_t my_node_id;
-    uint8_t my_slot_index;
-    uint8_t num_slots;
+    uint32_t my_slot_index;
+    uint32_t num_slots;
     
     uint32_t round_number;
     uint64_t round_start_us;    // O "Zero" desta ronda
     uint32_t round_period_us;   // 100ms em microsegundos
+    int64_t last_served_round;  // Ronda da última janela de TX servida (-1 = nenhuma)
     
-    slot_boundary_t slots[MAX_NODES];
+    slot_boundary_t *slots;     // [num_slots]
+    int32_t *slot_of_node;      // node_id → índice do slot (-1 se ausente)
+    uint32_t slot_of_node_size;
     
     delay_buffer_t current_delays;
     delay_buffer_t previous_delays;
     
-    spanning_tree_t *mst; // Ponteiro para a árvore (para saber quem ouvir)
+    // Vizinhos na MST por slot (para saber quem ouvir); copiado, não partilhado
+    bool *sync_neighbors;
+    bool has_sync_neighbors;
+    
+    int64_t *filtered_delays;   // Scratch para a mediana [num_slots]
     
     bool is_synchronized;
     uint32_t sync_rounds_count;
@@ -65,11 +74,28 @@ typedef struct {
 
 // Inicializa a estrutura
 int ra_tdmas_init(ra_tdmas_sync_t *sync, node_id_t my_id, 
-                  node_id_t *all_nodes, uint8_t num_nodes);
+                  node_id_t *all_nodes, uint32_t num_nodes);
+
+// Liberta os buffers alocados no init
+void ra_tdmas_destroy(ra_tdmas_sync_t *sync);
+
+/**
+ * Muda a duração da ronda e volta a dividi-la igualmente pelos slots
+ *
+ * Para antes de o nó arrancar (ex.: varrer períodos no simulador);
+ * as correções já acumuladas perdem-se.
+ * @return 0, -1 se o período não chega para 1 us por slot
+ */
+int ra_tdmas_set_round_period(ra_tdmas_sync_t *sync, uint32_t period_us);
 
-// Atualiza o ponteiro para a Spanning Tree (para filtrar vizinhos)
+// Atualiza os vizinhos na Spanning Tree (para filtrar vizinhos)
 void ra_tdmas_set_spanning_tree(ra_tdmas_sync_t *sync, spanning_tree_t *mst);
 
+// Variante esparsa: lista de node IDs adjacentes a mim na MST
+void ra_tdmas_set_sync_neighbors(ra_tdmas_sync_t *sync,
+                                 const node_id_t *neighbors,
+                                 uint32_t count);
+
 // Chama isto sempre que receberes um pacote (para medir o atraso)
 void ra_tdmas_on_packet_received(ra_tdmas_sync_t *sync, node_id_t sender_id,
                                  uint64_t tx_timestamp_us, uint64_t rx_timestamp_us);
@@ -83,9 +109,35 @@ bool ra_tdmas_can_transmit(ra_tdmas_sync_t *sync);
 // Quanto tempo falta para a minha vez? (Para usleep)
 uint32_t ra_tdmas_time_until_my_slot_us(ra_tdmas_sync_t *sync);
 
+/**
+ * Janela do meu slot em tempo absoluto (CLOCK_MONOTONIC, μs)
+ *
+ * Se 'now_us' já está dentro do slot devolve a janela atual; senão a
+ * próxima ocorrência. Nunca devolve uma janela numa ronda já servida
+ * (ver ra_tdmas_mark_window_served): um ajuste que empurre o slot para
+ * mais tarde não dá duas janelas na mesma ronda. Usado pelo
+ * tx_scheduler para armar um deadline.
+ */
+void ra_tdmas_next_slot_window(ra_tdmas_sync_t *sync, uint64_t now_us,
+                               uint64_t *start_us, uint64_t *end_us);
+
+// Regista a ronda da janela que começa em 'start_us' como servida
+void ra_tdmas_mark_window_served(ra_tdmas_sync_t *sync, uint64_t start_us);
+
 // Utilitário de tempo
 uint64_t ra_tdmas_get_current_time_us(void);
 
+/**
+ * Relógio injetável (tempo virtual do simulador)
+ *
+ * Com um relógio definido, ra_tdmas_get_current_time_us() devolve
+ * clock(ctx) em vez de CLOCK_MONOTONIC; NULL repõe o relógio real.
+ * Todo o código de protocolo (slots, fila de TX, forwarding, streaming,
+ * traffic engine) lê o tempo por aqui. Definir antes de criar threads.
+ */
+typedef uint64_t (*ra_tdmas_clock_fn)(void *ctx);
+void ra_tdmas_set_clock(ra_tdmas_clock_fn clock, void *ctx);
+
 // Chama no fim de cada ciclo do loop principal
 void ra_tdmas_on_round_end(ra_tdmas_sync_t *sync);
 
@@ -5,10 +5,17 @@
 #include <stdint.h>      // <--- ADICIONA (para uint64_t, uint32_t)
 #include <stdbool.h>     // <--- ADICIONA (para bool, true, false)
 #include <pthread.h>     // <--- ADICIONA (para pthread_mutex_t)
+#include <stdatomic.h>
 #include "tdma_types.h"  // <--- ADICIONA (para node_id_t, MAX_NODES)
 #include "connectivity_matrix.h"
 #include "spanning_tree.h"
 #include "dijkstra.h"
+#include "adjacency_bitset.h"
+#include "topology_graph.h"
+#include "spt_incremental.h"
+
+// Máximo de links mudados numa atualização para usar o modo incremental
+#define ROUTING_INCREMENTAL_MAX_CHANGES 8
 
 // Estratégias de routing disponíveis
 typedef enum {
@@ -17,6 +24,13 @@ typedef enum {
     ROUTING_STRATEGY_HYBRID      // Usa MST como fallback, Dijkstra como optimal
 } routing_strategy_t;
 
+// Motor usado para calcular os caminhos (mesmo dijkstra_result_t)
+typedef enum {
+    PATH_ENGINE_DIJKSTRA,        // Dijkstra com min-scan linear
+    PATH_ENGINE_BITSET_BFS,      // BFS por fronteira em bitset (hop count)
+    PATH_ENGINE_WEIGHTED         // Dijkstra com heap e custo real dos links
+} path_engine_t;
+
 // Estado de cada rota
 typedef enum {
     PATH_STATE_OPTIMAL,      // Usando Dijkstra (melhor caminho)
@@ -29,27 +43,52 @@ typedef enum {
 typedef struct {
     node_id_t destination;
     node_id_t next_hop;
-    uint8_t distance;        // Número de hops
+    uint16_t distance;       // Número de hops
+    uint32_t cost;           // Custo do caminho (== distance em hop count)
     path_state_t state;
     bool valid;
 } routing_entry_t;
 
+/**
+ * Snapshot imutável da routing table (publicado estilo RCU)
+ *
+ * Indexado diretamente pelo node_id do destino. Nunca é alterado depois
+ * de publicado: cada recompute cria um novo e troca o ponteiro.
+ */
+typedef struct {
+    uint64_t version;              // topology_version quando foi publicado
+    uint32_t size;                 // Maior node_id + 1
+    routing_entry_t *by_dest;      // [size], valid == false se não há rota
+} routing_snapshot_t;
+
 // Routing Manager principal
 typedef struct {
     // Configuração
     node_id_t my_node_id;
     routing_strategy_t strategy;
+    path_engine_t path_engine;
     
-    // Dados de topologia
-    connectivity_matrix_t current_topology;
-    spanning_tree_t mst;
-    uint64_t topology_version;  // Incrementa a cada mudança
+    // Dados de topologia (dimensionados em runtime)
+    topology_graph_t current_topology;
+    int32_t *mst_parent;           // Pai de cada nó na MST (-1 = raiz/isolado)
+    uint64_t topology_version;     // Incrementa a cada mudança
+    adjacency_bitset_t adjacency;  // Usado por PATH_ENGINE_BITSET_BFS
     
-    // Routing tables
-    routing_entry_t routing_table[MAX_NODES];
-    dijkstra_result_t dijkstra_cache[MAX_NODES];  // Cache de Dijkstra
+    // SPT incremental (repara só a parte afetada quando poucos links mudam)
+    bool incremental_spt;
+    spt_state_t spt;
     
-    // Sincronização
+    // Routing tables (heap, indexadas pelo índice do nó na topologia)
+    routing_entry_t *routing_table;
+    dijkstra_result_t *dijkstra_cache;  // Cache de Dijkstra
+    uint32_t table_capacity;
+    
+    // Leitura sem bloqueio: snapshot + contadores de leitores por época
+    _Atomic(routing_snapshot_t *) snapshot;
+    atomic_uint rcu_epoch;
+    atomic_uint rcu_readers[2];
+    
+    // Sincronização (escritores)
     pthread_mutex_t lock;
     bool needs_recomputation;
     
@@ -69,6 +108,13 @@ typedef struct {
     uint64_t mst_compute_time_us;
     uint64_t table_update_time_us;
     
+    // Atualizações incrementais da SPT
+    uint32_t incremental_updates;          // Mudanças tratadas sem recompute total
+    uint32_t last_nodes_relaxed;           // Nós re-relaxados na última atualização
+    uint64_t total_nodes_relaxed;
+    uint64_t last_incremental_time_us;
+    uint64_t total_incremental_time_us;
+    
 } routing_manager_t;
 
 // ========================================
@@ -81,10 +127,41 @@ void routing_manager_init(routing_manager_t *rm,
                          routing_strategy_t strategy);
 
 // Atualiza topologia (detecta mudanças automaticamente)
+bool routing_manager_update_graph(routing_manager_t *rm,
+                                 const topology_graph_t *new_topology);
+
+// Variante para a matriz densa (converte e chama update_graph)
 bool routing_manager_update_topology(routing_manager_t *rm,
                                     connectivity_matrix_t *new_topology);
 
-// Obtém next hop para um destino
+// Número de nós na topologia atual
+uint32_t routing_manager_num_nodes(routing_manager_t *rm);
+
+// Copia a routing table (sob lock) para um array em heap; o caller liberta
+int routing_manager_copy_table(routing_manager_t *rm,
+                               routing_entry_t **entries);
+
+// Escolhe o motor de cálculo de caminhos (default: Dijkstra)
+void routing_manager_set_path_engine(routing_manager_t *rm,
+                                    path_engine_t engine);
+
+// Ativa/desativa a manutenção incremental da SPT (default: desligada)
+void routing_manager_set_incremental(routing_manager_t *rm, bool enabled);
+
+/**
+ * Leitura sem bloqueio da routing table
+ *
+ * Nunca espera por um recompute. O snapshot devolvido é válido até ao
+ * release correspondente (não guardar o ponteiro depois disso).
+ *
+ * @param epoch Preenchido pelo acquire, passado ao release
+ * @return Snapshot atual (NULL se ainda não há rotas)
+ */
+const routing_snapshot_t *routing_manager_snapshot_acquire(routing_manager_t *rm,
+                                                           unsigned *epoch);
+void routing_manager_snapshot_release(routing_manager_t *rm, unsigned epoch);
+
+// Obtém next hop para um destino (sem lock, via snapshot)
 node_id_t routing_manager_get_next_hop(routing_manager_t *rm, 
                                        node_id_t destination);
 
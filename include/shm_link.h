@@ -0,0 +1,183 @@
+// include/shm_link.h
+#ifndef SHM_LINK_H
+#define SHM_LINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "tdma_types.h"
+#include "udp_transport.h"
+
+#define SHM_LINK_RING_SIZE 128            // Pacotes em voo por link dirigido (potência de 2)
+#define SHM_LINK_LOSS_SCALE 1000000       // Perda guardada em partes por milhão
+
+/**
+ * Impairments de um link dirigido (src → dst)
+ *
+ * O atraso de cada pacote é delay_us + U[0, jitter_us], mas a entrega
+ * nunca ultrapassa um pacote anterior do mesmo link (FIFO, como um
+ * rádio). Com down = true tudo o que é enviado se perde.
+ */
+typedef struct {
+    double loss;                  // Probabilidade de perda [0, 1]
+    uint32_t delay_us;
+    uint32_t jitter_us;
+    bool down;
+} shm_link_params_t;
+
+typedef struct {
+    uint64_t sent;                // Entregues ao anel (ainda em voo ou já recebidos)
+    uint64_t delivered;           // Retirados pelo recetor
+    uint64_t lost;                // Descartados pelo sorteio de perda
+    uint64_t down_drops;          // Enviados com o link em baixo
+    uint64_t overflows;           // Anel cheio (o recetor não acompanha)
+} shm_link_stats_t;
+
+// Pacote em voo: buffer [udp_header_t][payload] do pool do destino
+typedef struct {
+    uint8_t *buffer;
+    uint64_t deliver_at_us;
+} shm_link_slot_t;
+
+/**
+ * Link dirigido: anel SPSC lock-free de pacotes
+ *
+ * Produtor = transporte de origem (envios serializados pelo seu
+ * tx_lock); consumidor = thread de RX do destino. head e tail ficam em
+ * linhas de cache separadas; cada lado só escreve o seu índice.
+ */
+typedef struct {
+    _Alignas(64) _Atomic uint32_t head;   // Próximo slot a escrever (produtor)
+    _Alignas(64) _Atomic uint32_t tail;   // Próximo slot a ler (consumidor)
+    _Alignas(64) shm_link_slot_t slots[SHM_LINK_RING_SIZE];
+    
+    node_id_t src;
+    node_id_t dst;
+    
+    // Impairments: qualquer thread altera, o produtor lê a cada pacote
+    _Atomic uint32_t loss_ppm;
+    _Atomic uint32_t delay_us;
+    _Atomic uint32_t jitter_us;
+    _Atomic bool down;
+    
+    // Estado do produtor
+    uint64_t rng;
+    uint64_t last_deliver_us;     // Mantém a entrega FIFO com jitter
+    
+    shm_link_stats_t stats;       // delivered é do consumidor, o resto do produtor
+} shm_link_t;
+
+// Tempo virtual (simulador): relógio da fabric e aviso de cada pacote em voo
+typedef uint64_t (*shm_clock_fn)(void *ctx);
+typedef void (*shm_enqueue_fn)(void *ctx, node_id_t dst, uint64_t deliver_at_us);
+
+// Links de entrada de um nó, pela ordem em que foram criados
+typedef struct {
+    _Atomic(shm_link_t *) *links; // [max_nodes]
+    _Atomic uint32_t count;
+} shm_inbound_t;
+
+/**
+ * Malha de links em memória entre N transportes do mesmo processo
+ *
+ * Substitui veth + namespaces: cada udp_transport_t ligado à fabric
+ * envia diretamente para o anel do link (src, dst) e o destino lê os
+ * seus anéis de entrada. Os links são criados no primeiro uso (ou ao
+ * configurar impairments), por isso uma topologia esparsa só paga os
+ * anéis que usa.
+ */
+struct shm_fabric {
+    uint32_t max_nodes;           // IDs 1..max_nodes
+    _Atomic(shm_link_t *) *links; // [max_nodes * max_nodes], (src-1) * max_nodes + (dst-1)
+    shm_inbound_t *inbound;       // [max_nodes], indexado por dst - 1
+    _Atomic(udp_transport_t *) *ports;   // [max_nodes + 1], indexado por node_id
+    
+    // Parâmetros dos links ainda não criados
+    shm_link_params_t defaults;
+    uint64_t seed;
+    pthread_mutex_t lock;         // Configuração (não é usado no envio/receção)
+    
+    // NULL = CLOCK_MONOTONIC e recetores acordados pelo eventfd
+    shm_clock_fn clock;
+    shm_enqueue_fn on_enqueue;
+    void *hook_ctx;
+};
+
+/**
+ * Lado de um transporte na fabric (definido aqui, usado por udp_transport.c)
+ */
+struct shm_endpoint {
+    shm_fabric_t *fabric;
+    pthread_mutex_t tx_lock;      // Um produtor por link: serializa os envios
+    _Atomic bool sleeping;        // Recetor bloqueado em wait(): produtores acordam-no
+    uint32_t next_inbound;        // Round-robin entre links de entrada
+    
+    // Buffers entregues no último receive_batch() (válidos até ao próximo)
+    uint8_t *held[UDP_RX_BATCH];
+    int num_held;
+};
+
+// ========================================
+// Fabric
+// ========================================
+
+int shm_fabric_init(shm_fabric_t *fabric, uint32_t max_nodes, uint64_t seed);
+
+// Só depois de destruir (ou desligar) todos os transportes ligados
+void shm_fabric_destroy(shm_fabric_t *fabric);
+
+// Impairments dos links criados a partir daqui e dos que já existem
+void shm_fabric_set_defaults(shm_fabric_t *fabric, const shm_link_params_t *params);
+
+/**
+ * Impairments de um link dirigido (cria-o se ainda não existe)
+ *
+ * Pode ser chamada com os nós a correr (ex.: cortar um link a meio).
+ * @return 0, -1 se um dos IDs está fora de 1..max_nodes
+ */
+int shm_fabric_set_link(shm_fabric_t *fabric, node_id_t src, node_id_t dst,
+                        const shm_link_params_t *params);
+
+// Os dois sentidos de a <-> b
+int shm_fabric_set_link_pair(shm_fabric_t *fabric, node_id_t a, node_id_t b,
+                             const shm_link_params_t *params);
+
+// Estatísticas de src → dst (zeros se o link nunca foi usado)
+void shm_fabric_get_link_stats(shm_fabric_t *fabric, node_id_t src, node_id_t dst,
+                               shm_link_stats_t *stats);
+
+// Soma de todos os links
+void shm_fabric_get_totals(shm_fabric_t *fabric, shm_link_stats_t *stats);
+
+void shm_fabric_print_stats(shm_fabric_t *fabric);
+
+/**
+ * Liga a fabric a um escalonador de eventos (tempo virtual)
+ *
+ * deliver_at e a entrega passam a usar clock(ctx); cada pacote posto
+ * num anel chama on_enqueue(ctx, dst, deliver_at) para o escalonador
+ * marcar a receção em dst. Definir antes de haver tráfego.
+ */
+void shm_fabric_set_virtual_time(shm_fabric_t *fabric, shm_clock_fn clock,
+                                 shm_enqueue_fn on_enqueue, void *ctx);
+
+// ========================================
+// Endpoints (chamados por udp_transport.c)
+// ========================================
+
+// Liga o transporte à fabric com o seu node_id; -1 se o ID está ocupado
+int shm_endpoint_attach(udp_transport_t *transport, shm_fabric_t *fabric);
+
+// Desliga e devolve ao pool os pacotes ainda por receber
+void shm_endpoint_detach(udp_transport_t *transport);
+
+int shm_endpoint_send_batch(udp_transport_t *transport,
+                            const udp_tx_packet_t *packets, int count, bool *sent_ok);
+int shm_endpoint_wait(udp_transport_t *transport, int timeout_ms);
+int shm_endpoint_receive_batch(udp_transport_t *transport,
+                               udp_rx_packet_t *packets, int max_packets);
+uint8_t *shm_endpoint_claim_rx_buffer(udp_transport_t *transport,
+                                      const uint8_t *payload);
+
+#endif // SHM_LINK_H
@@ -0,0 +1,56 @@
+// include/sim_event_queue.h
+#ifndef SIM_EVENT_QUEUE_H
+#define SIM_EVENT_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tdma_types.h"
+
+#define SIM_QUEUE_INITIAL_CAPACITY 1024
+
+typedef enum {
+    SIM_EVENT_SLOT = 0,           // Início do slot TDMA de 'node'
+    SIM_EVENT_RX,                 // Pacote entregável em 'node'
+    SIM_EVENT_TRAFFIC,            // Próximo frame do traffic engine de 'node'
+    SIM_EVENT_LINK,               // Link 'arg' muda de estado na fabric
+    SIM_EVENT_TOPOLOGY,           // Os nós detetam a mudança do link 'arg'
+    SIM_EVENT_TYPES
+} sim_event_type_t;
+
+typedef struct {
+    uint64_t time_us;             // Tempo global (virtual)
+    uint64_t seq;                 // Ordem de inserção: desempate determinístico
+    uint32_t arg;
+    node_id_t node;
+    uint8_t type;
+} sim_event_t;
+
+/**
+ * Fila de eventos do simulador: min-heap binário por (time_us, seq)
+ *
+ * Eventos ao mesmo instante saem pela ordem em que entraram, por isso
+ * a mesma seed dá sempre a mesma execução.
+ */
+typedef struct {
+    sim_event_t *heap;
+    uint32_t count;
+    uint32_t capacity;
+    uint64_t next_seq;
+} sim_event_queue_t;
+
+int sim_queue_init(sim_event_queue_t *queue, uint32_t capacity);
+void sim_queue_destroy(sim_event_queue_t *queue);
+
+// Cresce quando cheia; -1 sem memória
+int sim_queue_push(sim_event_queue_t *queue, uint64_t time_us,
+                   sim_event_type_t type, node_id_t node, uint32_t arg);
+
+// Retira o evento mais cedo; false se a fila está vazia
+bool sim_queue_pop(sim_event_queue_t *queue, sim_event_t *event);
+
+// Instante do próximo evento (UINT64_MAX se vazia)
+static inline uint64_t sim_queue_next_time(const sim_event_queue_t *queue) {
+    return queue->count > 0 ? queue->heap[0].time_us : UINT64_MAX;
+}
+
+#endif // SIM_EVENT_QUEUE_H
@@ -2,11 +2,16 @@
 #define SPANNING_TREE_H
 
 #include "tdma_types.h"
+#include "topology_graph.h"
 
 // Calcula a Spanning Tree (MST) baseada na matriz de conectividade
 void spanning_tree_compute(connectivity_matrix_t *topo, spanning_tree_t *tree);
 
+// Versão esparsa (Prim com heap binário), raiz no índice 0 como na densa.
+// parent[i] = índice do pai na árvore (-1 para a raiz e nós inalcançáveis)
+int spanning_tree_compute_graph(const topology_graph_t *topo, int32_t *parent);
+
 // Imprime a árvore para debug
 void spanning_tree_print(spanning_tree_t *tree);
 
-#endif
\ No newline at end of file
+#endif
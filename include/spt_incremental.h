@@ -0,0 +1,75 @@
+// include/spt_incremental.h
+#ifndef SPT_INCREMENTAL_H
+#define SPT_INCREMENTAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tdma_types.h"
+#include "topology_graph.h"
+#include "dijkstra.h"
+
+/**
+ * Shortest Path Tree com manutenção incremental
+ *
+ * Guarda a SPT (custo + pai) a partir de um nó e repara-a quando um
+ * link muda, no estilo Ramalingam-Reps:
+ *   - Link piora/cai numa aresta da árvore: só a sub-árvore do filho é
+ *     invalidada e re-relaxada a partir da fronteira.
+ *   - Link melhora/aparece: Dijkstra a partir do extremo que melhorou,
+ *     propagando só enquanto os custos descem.
+ *   - Link fora da árvore que piora: nada a fazer.
+ *
+ * O pai de cada nó segue a mesma regra do Dijkstra completo (menor
+ * (custo, índice) entre os vizinhos no caminho ótimo), por isso o
+ * resultado é igual ao de dijkstra_compute_weighted() (ou, com pesos
+ * unitários, ao de dijkstra_compute_graph()).
+ */
+typedef struct {
+    uint32_t num_nodes;
+    uint32_t capacity;
+    uint32_t src;               // Índice da raiz
+    bool unit_weights;          // true = hop count (ignora o peso do link)
+    bool valid;                 // SPT corresponde à topologia atual
+    
+    uint32_t *cost;             // Custo até à raiz (INFINITY_PATH_COST = inalcançável)
+    int32_t *parent;            // Pai na SPT (-1 = raiz/inalcançável)
+    uint32_t *first_hop;        // Índice do primeiro hop a partir da raiz
+    uint16_t *hops;             // Número de hops na SPT
+    
+    // Scratch
+    uint32_t *heap_items;
+    int32_t *heap_pos;
+    uint8_t *mark;
+    uint32_t *stack;
+    
+    // Estatísticas
+    uint32_t last_relaxed;      // Nós re-relaxados na última operação
+    uint64_t total_relaxed;
+} spt_state_t;
+
+void spt_init(spt_state_t *spt);
+void spt_destroy(spt_state_t *spt);
+
+/**
+ * Calcula a SPT completa (Dijkstra com heap)
+ * @return 0 em sucesso, -1 em erro
+ */
+int spt_compute(spt_state_t *spt, const topology_graph_t *graph,
+                node_id_t src, bool unit_weights);
+
+/**
+ * Repara a SPT após a mudança de um link simétrico
+ *
+ * O grafo já tem de conter o novo peso (change->new_weight).
+ * @return Nós re-relaxados, ou -1 se a SPT não é válida
+ */
+int spt_update_link(spt_state_t *spt, const topology_graph_t *graph,
+                    const graph_link_change_t *change);
+
+/**
+ * Exporta a SPT no formato do Dijkstra [graph->num_nodes]
+ */
+void spt_export(const spt_state_t *spt, const topology_graph_t *graph,
+                dijkstra_result_t *results);
+
+#endif // SPT_INCREMENTAL_H
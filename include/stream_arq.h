@@ -0,0 +1,85 @@
+// include/stream_arq.h
+#ifndef STREAM_ARQ_H
+#define STREAM_ARQ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "tdma_types.h"
+
+#define ARQ_WINDOW_STREAMS 8          // Streams enviados retidos para retransmissão
+
+// Stream enviado, retido até ao prazo ou até ser substituído
+typedef struct {
+    bool active;
+    node_id_t dst;
+    uint32_t stream_id;
+    uint8_t type;
+    uint32_t total_chunks;
+    uint32_t chunk_stride;
+    uint32_t size;
+    uint64_t deadline_us;             // CLOCK_MONOTONIC (0 = sem prazo)
+    uint64_t origin_us;               // stream_header_t.timestamp_us do original
+    uint32_t retransmitted;
+
+    uint8_t *data;                    // Cópia do frame (reutilizada)
+    uint32_t capacity;
+} arq_stream_t;
+
+/**
+ * Chamado para cada chunk pedido num NACK
+ *
+ * @return 0 se o chunk foi reenviado, -1 se falhou (ex.: fila cheia)
+ */
+typedef int (*arq_retransmit_cb)(const arq_stream_t *entry, uint32_t sequence,
+                                 const uint8_t *chunk, uint16_t len, void *ctx);
+
+/**
+ * Janela de retransmissão do emissor (selective repeat)
+ *
+ * Os últimos ARQ_WINDOW_STREAMS streams enviados ficam retidos; um NACK
+ * do recetor reenvia só os chunks do bitmap enquanto o prazo do stream
+ * não tiver passado. Partilhada entre a thread que envia e a de RX.
+ */
+typedef struct {
+    arq_stream_t streams[ARQ_WINDOW_STREAMS];
+    uint32_t next;                    // Próxima entrada a (re)utilizar
+    pthread_mutex_t lock;
+
+    // Stats
+    uint64_t streams_retained;
+    uint64_t nacks_received;
+    uint64_t nacks_unknown;           // Stream já fora da janela
+    uint64_t nacks_late;              // Prazo do stream já passou
+    uint64_t chunks_retransmitted;
+    uint64_t retransmit_failed;
+} arq_window_t;
+
+int arq_window_init(arq_window_t *window);
+void arq_window_destroy(arq_window_t *window);
+
+/**
+ * Retém uma cópia do frame (substitui o stream mais antigo)
+ *
+ * @param origin_us   Timestamp do frame, repetido nas retransmissões
+ * @param deadline_us Prazo absoluto (CLOCK_MONOTONIC, μs), 0 = sem prazo
+ */
+int arq_window_retain(arq_window_t *window, node_id_t dst, uint32_t stream_id,
+                      uint8_t type, const uint8_t *data, uint32_t size,
+                      uint32_t chunk_stride, uint64_t origin_us,
+                      uint64_t deadline_us);
+
+/**
+ * Trata um NACK de 'src': reenvia os chunks em falta via callback
+ *
+ * @param missing Bitmap (bit i = chunk base_seq + i em falta)
+ * @return Chunks reenviados, -1 se o stream é desconhecido ou passou o prazo
+ */
+int arq_window_on_nack(arq_window_t *window, node_id_t src, uint32_t stream_id,
+                       uint32_t base_seq, uint32_t num_chunks,
+                       const uint64_t *missing, uint64_t now_us,
+                       arq_retransmit_cb retransmit, void *ctx);
+
+void arq_window_print_stats(arq_window_t *window);
+
+#endif // STREAM_ARQ_H
@@ -0,0 +1,43 @@
+// include/stream_fec.h
+#ifndef STREAM_FEC_H
+#define STREAM_FEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define FEC_MAX_DATA 32               // Chunks de dados por bloco (n)
+#define FEC_MAX_PARITY 8              // Chunks de paridade por bloco (k)
+#define FEC_MAX_LEN 1500              // Bytes por chunk no decode
+
+/**
+ * Reed-Solomon sistemático sobre GF(256) (matriz de Cauchy)
+ *
+ * Um bloco de n chunks de dados gera k chunks de paridade; quaisquer n
+ * dos n + k chunks reconstroem o bloco. Os chunks têm todos 'len'
+ * bytes (o último chunk do frame vai com padding a zeros).
+ */
+
+// dst[i] ^= c * src[i] em GF(256) (SSSE3 quando o CPU suporta)
+void gf256_mul_add(uint8_t *dst, const uint8_t *src, uint8_t c, uint32_t len);
+
+/**
+ * Calcula as k paridades de um bloco
+ *
+ * @param data   n ponteiros para chunks de 'len' bytes
+ * @param parity k ponteiros para buffers de 'len' bytes (escritos)
+ * @return 0, -1 se n/k fora dos limites
+ */
+int fec_encode(const uint8_t *const *data, uint32_t n,
+               uint8_t *const *parity, uint32_t k, uint32_t len);
+
+/**
+ * Reconstrói os chunks de dados em falta de um bloco
+ *
+ * @param data    n ponteiros; os chunks com present[i] = false são escritos
+ * @param parity  k ponteiros, NULL para paridades que não chegaram
+ * @return Chunks reconstruídos, -1 se faltam mais chunks do que há paridades
+ */
+int fec_decode(uint8_t *const *data, const bool *present, uint32_t n,
+               const uint8_t *const *parity, uint32_t k, uint32_t len);
+
+#endif // STREAM_FEC_H
@@ -0,0 +1,180 @@
+// include/stream_reassembly.h
+#ifndef STREAM_REASSEMBLY_H
+#define STREAM_REASSEMBLY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tdma_types.h"
+#include "stream_fec.h"
+
+#define REASM_MAX_STREAMS 16          // Streams em reconstrução em simultâneo
+#define REASM_TIMEOUT_MS 2000         // Stream incompleto é descartado após isto
+#define REASM_RECENT_STREAMS 128      // Streams fechados lembrados (chunks atrasados)
+#define REASM_GAP_MAX_CHUNKS 1024     // Chunks cobertos por um reasm_gap_t
+#define REASM_GAP_WORDS (REASM_GAP_MAX_CHUNKS / 64)
+
+// Chunk recebido (campos do stream_header já validados)
+typedef struct {
+    node_id_t src;                    // Origem end-to-end
+    uint32_t stream_id;
+    uint32_t sequence;
+    uint32_t total_chunks;
+    uint8_t type;
+    uint32_t chunk_stride;            // Tamanho nominal dos chunks (offset = seq * stride)
+    uint32_t deadline_ms;             // Prazo do frame desde o 1º chunk (0 = sem prazo)
+    uint64_t origin_us;               // Frame submetido na origem (relógio TDMA)
+    uint8_t hops;                     // Hops percorridos por este chunk
+    const uint8_t *data;
+    uint16_t len;
+    
+    // Paridade FEC: sequence = total_chunks + bloco * fec_k + índice
+    bool parity;
+    uint8_t fec_n;                    // Chunks de dados por bloco
+    uint8_t fec_k;                    // Chunks de paridade por bloco
+    uint32_t frame_size;              // Tamanho do frame (para reconstruir o último chunk)
+} reasm_chunk_t;
+
+// Frame completo entregue ao callback (data válido só durante a chamada)
+typedef struct {
+    node_id_t src;
+    uint32_t stream_id;
+    uint8_t type;
+    const uint8_t *data;
+    uint32_t size;
+    uint32_t chunks;
+    uint32_t out_of_order;            // Chunks que chegaram fora de ordem
+    uint32_t recovered;               // Chunks reconstruídos por FEC
+    uint64_t duration_ms;             // Primeiro → último chunk
+    uint64_t origin_us;               // Do 1º chunk recebido (relógio TDMA)
+    uint8_t hops;                     // Máximo entre os chunks do frame
+} reasm_frame_t;
+
+typedef void (*reasm_deliver_cb)(const reasm_frame_t *frame, void *ctx);
+
+// Chunks em falta de um stream, a pedir à origem (NACK)
+typedef struct {
+    node_id_t src;
+    uint32_t stream_id;
+    uint32_t base_seq;                // Primeiro chunk em falta
+    uint32_t num_chunks;              // Bits válidos em missing (a partir de base_seq)
+    uint32_t missing_count;
+    uint64_t missing[REASM_GAP_WORDS];  // 1 = em falta
+} reasm_gap_t;
+
+typedef struct {
+    bool active;
+    node_id_t src;
+    uint32_t stream_id;
+    uint8_t type;
+    uint32_t total_chunks;
+    uint32_t chunk_stride;
+    uint32_t chunks_received;
+    uint32_t size;                    // Conhecido quando chega o último chunk (ou paridade)
+    uint32_t next_expected;
+    uint32_t highest_seq;             // Maior sequence recebido
+    uint32_t out_of_order;
+    uint64_t first_rx_ms;
+    uint64_t last_rx_ms;
+    uint64_t deadline_ms;             // Absoluto (0 = sem prazo)
+    uint64_t last_nack_ms;
+    uint64_t origin_us;
+    uint8_t hops;
+    
+    // Buffer e bitmap reutilizados entre streams
+    uint8_t *data;
+    uint32_t capacity;
+    uint64_t *received;               // 1 bit por chunk
+    uint32_t bitmap_words;
+    
+    // FEC: geometria conhecida com a 1ª paridade (fec_k = 0: sem FEC)
+    uint8_t fec_n;
+    uint8_t fec_k;
+    uint32_t recovered;               // Chunks reconstruídos neste frame
+    uint8_t *parity;                  // [blocos * fec_k][chunk_stride]
+    uint32_t parity_capacity;
+    uint64_t *parity_received;
+    uint32_t parity_words;
+} reasm_slot_t;
+
+// Stream já entregue, expirado ou despejado
+typedef struct {
+    node_id_t src;
+    uint32_t stream_id;
+    uint64_t closed_ms;
+} reasm_closed_t;
+
+/**
+ * Reconstrução de frames por (origem, stream_id)
+ *
+ * Cada chunk é colocado diretamente em sequence * chunk_stride no
+ * buffer do stream, com um bitmap de chunks recebidos: tolera reordenação,
+ * duplicados e streams intercalados de várias origens. Com paridade FEC,
+ * um bloco com tantos chunks em falta quantas paridades recebidas é
+ * reconstruído sem esperar por retransmissões.
+ *
+ * Os últimos REASM_RECENT_STREAMS streams fechados ficam num anel durante
+ * timeout_ms: as paridades que chegam depois de o frame estar completo e
+ * as retransmissões atrasadas contam como duplicados em vez de abrirem
+ * um stream novo (que acabaria num NACK do frame inteiro).
+ */
+typedef struct {
+    reasm_slot_t slots[REASM_MAX_STREAMS];
+    reasm_deliver_cb deliver;
+    void *ctx;
+    uint32_t max_frame_size;
+    uint32_t timeout_ms;
+    uint32_t nack_interval_ms;        // Mínimo entre NACKs do mesmo stream
+    reasm_closed_t closed[REASM_RECENT_STREAMS];
+    uint32_t closed_next;             // Próxima posição a escrever no anel
+    
+    // Stats
+    uint64_t chunks_accepted;
+    uint64_t chunks_duplicate;        // Inclui chunks de streams já fechados
+    uint64_t chunks_out_of_order;
+    uint64_t chunks_rejected;
+    uint64_t frames_completed;
+    uint64_t frames_expired;
+    uint64_t frames_evicted;
+    uint64_t frames_late;             // Expirados por passarem o prazo
+    uint64_t chunks_lost;             // Em frames expirados/despejados
+    uint64_t gaps_reported;
+    uint64_t parity_accepted;
+    uint64_t chunks_recovered;        // Reconstruídos por FEC
+    uint64_t frames_recovered;        // Completos graças a FEC
+} reasm_engine_t;
+
+void reasm_init(reasm_engine_t *engine, uint32_t max_frame_size,
+                reasm_deliver_cb deliver, void *ctx);
+void reasm_destroy(reasm_engine_t *engine);
+
+/**
+ * Coloca um chunk no seu stream
+ *
+ * @return 1 se completou (e entregou) o frame, 0 se aceite,
+ *         -1 se inválido ou duplicado
+ */
+int reasm_on_chunk(reasm_engine_t *engine, const reasm_chunk_t *chunk,
+                   uint64_t now_ms);
+
+// Descarta streams sem chunks há mais de timeout_ms ou fora do prazo; devolve quantos
+int reasm_expire(reasm_engine_t *engine, uint64_t now_ms);
+
+/**
+ * Recolhe os chunks em falta dos streams em reconstrução (para NACK)
+ *
+ * Lacunas abaixo do maior sequence recebido contam sempre; a cauda do
+ * frame só depois de o stream estar parado há nack_interval_ms. Cada
+ * stream é reportado no máximo uma vez por nack_interval_ms e nunca
+ * depois do prazo.
+ *
+ * @return Número de entradas preenchidas em gaps
+ */
+int reasm_collect_gaps(reasm_engine_t *engine, uint64_t now_ms,
+                       reasm_gap_t *gaps, int max_gaps);
+
+// Streams em reconstrução
+int reasm_active_streams(const reasm_engine_t *engine);
+
+void reasm_print_stats(const reasm_engine_t *engine);
+
+#endif // STREAM_REASSEMBLY_H
@@ -0,0 +1,46 @@
+// include/tdma_cluster.h
+#ifndef TDMA_CLUSTER_H
+#define TDMA_CLUSTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tdma_node.h"
+#include "shm_link.h"
+
+#define TDMA_CLUSTER_DEFAULT_SEED 1
+
+/**
+ * N nós TDMA num só processo, ligados por uma fabric em memória
+ *
+ * Cada nó é um tdma_node_t completo (threads de heartbeat e RX,
+ * RA-TDMAs+, routing, forwarding, streaming) com o transporte sobre
+ * anéis SPSC em vez de UDP/veth: corre sem root nem namespaces e os
+ * impairments de cada link configuram-se em cluster->fabric.
+ */
+typedef struct {
+    shm_fabric_t fabric;
+    tdma_node_t *nodes;           // [num_nodes], nodes[i] tem ID i + 1
+    int num_nodes;
+    bool running;
+} tdma_cluster_t;
+
+int tdma_cluster_init(tdma_cluster_t *cluster, int num_nodes,
+                      routing_strategy_t strategy, uint64_t seed);
+
+// Nó com o ID dado (1..num_nodes), NULL fora do intervalo
+tdma_node_t *tdma_cluster_node(tdma_cluster_t *cluster, node_id_t id);
+
+// Arranca todos os nós (sem descoberta: os links já existem)
+int tdma_cluster_start(tdma_cluster_t *cluster);
+
+// Pára todos antes de destruir: nenhum nó envia para um nó já destruído
+void tdma_cluster_stop(tdma_cluster_t *cluster);
+void tdma_cluster_destroy(tdma_cluster_t *cluster);
+
+// Nós sincronizados (RA-TDMAs+)
+int tdma_cluster_synchronized(tdma_cluster_t *cluster);
+
+// Totais do cluster e da fabric
+void tdma_cluster_print_summary(tdma_cluster_t *cluster);
+
+#endif // TDMA_CLUSTER_H
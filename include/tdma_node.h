@@ -6,11 +6,19 @@
 #include <stdbool.h>
 #include <pthread.h>
 #include "connectivity_matrix.h"
+#include "topology_graph.h"
 #include "routing_manager.h"
 #include "ip_routing_manager.h"
 #include "data_streaming.h"
 #include "udp_transport.h"
 #include "ra_tdmas_sync.h"
+#include "tx_scheduler.h"
+#include "tx_queue.h"
+#include "forwarding.h"
+#include "link_quality.h"
+#include "link_state.h"
+#include "metrics_registry.h"
+#include "shm_link.h"
 
 typedef enum {
     NODE_STATE_INIT = 0,
@@ -19,14 +27,25 @@ typedef enum {
     NODE_STATE_SHUTDOWN
 } node_state_t;
 
+// Métricas próprias do nó (o resto são campos dos módulos expostos no registo)
+typedef struct {
+    metric_id_t heartbeats_sent;
+    metric_id_t heartbeats_received;
+    metric_id_t topology_updates;
+    metric_id_t link_weight_updates;     // Pesos ETX passados ao routing
+    metric_id_t heartbeat_delay_us;      // Histograma: TX do vizinho → RX aqui
+    metric_id_t rx_batch_packets;        // Histograma: pacotes por recvmmsg()
+    metric_id_t slot_packets;            // Histograma: pacotes enviados por slot
+} tdma_node_metric_ids_t;
+
 typedef struct {
     // Identity
     node_id_t my_id;
     int total_nodes;
     node_state_t state;
     
-    // Topology
-    connectivity_matrix_t topology;
+    // Topology (dimensionada em runtime para total_nodes)
+    topology_graph_t topology;
     
     // Routing
     routing_manager_t routing_mgr;
@@ -36,10 +55,17 @@ typedef struct {
     data_streaming_t streaming;
     
     // Transport
+    buffer_pool_t buffers;           // Buffers de pacote partilhados
     udp_transport_t transport;
+    shm_fabric_t *fabric;            // Modo cluster: links em memória (NULL = UDP/veth)
     
     // RA-TDMAs+ Sync
     ra_tdmas_sync_t ra_sync;
+    tx_scheduler_t tx_sched;
+    tx_queue_t tx_queue;             // Dados drenados só no meu slot
+    forwarding_engine_t forwarding;  // Relay multi-hop sobre a tx_queue
+    link_quality_t link_quality;     // ETX por vizinho, a partir dos heartbeats
+    link_state_t link_state;         // LSAs de todos os nós: links entre os outros
     
     // Threads
     pthread_t heartbeat_thread;
@@ -48,12 +74,11 @@ typedef struct {
     
     // Timing
     uint32_t heartbeat_interval_ms;
-    uint64_t last_seen_ms[MAX_NODES];
+    uint32_t settle_time_ms;         // Descoberta em tdma_node_start() antes de RUNNING
     
-    // Stats
-    uint64_t heartbeats_sent;
-    uint64_t heartbeats_received;
-    uint64_t topology_updates;
+    // Stats (contadores no registo; incrementos sem atómicos por thread)
+    metrics_registry_t metrics;
+    tdma_node_metric_ids_t metric_ids;
     uint32_t packets_sent_in_slot;
     
 } tdma_node_t;
@@ -61,6 +86,18 @@ typedef struct {
 // Lifecycle
 int tdma_node_init(tdma_node_t *node, node_id_t my_id,
                    int total_nodes, routing_strategy_t strategy);
+
+/**
+ * Inicializa o nó sobre uma fabric em memória partilhada com outros nós
+ * do mesmo processo
+ *
+ * Sem espera pela veth nem rotas no kernel (não precisa de root); o
+ * resto (TDMA, routing, forwarding, streaming) é o mesmo código. Sem
+ * descoberta inicial: os nós de um cluster arrancam juntos.
+ */
+int tdma_node_init_shm(tdma_node_t *node, node_id_t my_id,
+                       int total_nodes, routing_strategy_t strategy,
+                       shm_fabric_t *fabric);
 int tdma_node_start(tdma_node_t *node);
 void tdma_node_stop(tdma_node_t *node);
 void tdma_node_destroy(tdma_node_t *node);
@@ -73,6 +110,18 @@ void tdma_node_process_message(tdma_node_t *node,
 void tdma_node_update_connectivity(tdma_node_t *node,
                                   node_id_t neighbor,
                                   bool is_alive);
+
+/**
+ * Passa à topologia os pesos ETX do estimador de qualidade dos links
+ *
+ * Um link cai quando o vizinho não é ouvido numa janela inteira ou o
+ * ETX passa LQ_MAX_ETX; fora disso o peso só muda quando a diferença
+ * chega a LQ_HYSTERESIS_PERCENT. Todas as mudanças entram no routing
+ * de uma vez. Se os meus links mudaram, origina um LSA novo.
+ *
+ * Corre na thread de heartbeat, a única que mexe na topologia (a cada
+ * 100 ms na descoberta, depois a cada segundo).
+ */
 void tdma_node_check_timeouts(tdma_node_t *node);
 
 // Status
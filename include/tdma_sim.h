@@ -0,0 +1,175 @@
+// include/tdma_sim.h
+#ifndef TDMA_SIM_H
+#define TDMA_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tdma_types.h"
+#include "ra_tdmas_sync.h"
+#include "routing_manager.h"
+#include "buffer_pool.h"
+#include "udp_transport.h"
+#include "tx_queue.h"
+#include "forwarding.h"
+#include "data_streaming.h"
+#include "traffic_gen.h"
+#include "latency_histogram.h"
+#include "shm_link.h"
+#include "sim_event_queue.h"
+
+#define SIM_EPOCH_US 1000000ULL           // Tempo global no arranque (relógios locais > 0)
+#define SIM_NODE_POOL_SIZE 16             // Buffers por nó (o pool recorre a malloc se faltar)
+#define SIM_TX_QUEUE_CAPACITY 256
+#define SIM_DEFAULT_DETECT_MS 5000        // Link em baixo → routing (TIMEOUT_MS do tdma_node)
+#define SIM_RECOVER_DETECT_MS 1000        // Link de volta → routing (verificação a cada 1 s)
+#define SIM_DEFAULT_WARMUP_SEC 1
+#define SIM_MAX_LINK_EVENTS 64
+
+typedef enum {
+    SIM_TOPO_GRID = 0,            // Grelha ceil(sqrt(N)) colunas, vizinhos N/S/E/W
+    SIM_TOPO_RING,
+    SIM_TOPO_LINE,
+    SIM_TOPO_RANDOM,              // Anel + cordas aleatórias até ao grau médio pedido
+    SIM_TOPO_MESH                 // Full mesh (N pequeno)
+} sim_topology_kind_t;
+
+// Falha de um link físico a meio da simulação
+typedef struct {
+    node_id_t a;
+    node_id_t b;
+    double down_sec;              // Tempo simulado em que o link cai
+    double up_sec;                // Quando volta (0 = fica em baixo)
+} sim_link_event_t;
+
+typedef struct {
+    uint32_t num_nodes;
+    sim_topology_kind_t topology;
+    uint32_t degree;              // SIM_TOPO_RANDOM: grau médio
+    uint32_t round_period_us;     // Ronda TDMA (dividida igualmente pelos nós)
+    double drift_ppm;             // Relógio de cada nó: U[-drift, +drift] ppm
+    uint32_t max_offset_us;       // Fase inicial de cada nó: U[0, max]
+    shm_link_params_t link;       // Atraso, jitter e perda de todos os links
+    uint32_t detect_ms;           // Atraso até o routing ver um link em baixo
+    routing_strategy_t strategy;
+    uint32_t warmup_sec;          // Antes do início dos fluxos
+    uint64_t seed;
+    
+    traffic_flow_t flows[TRAFFIC_MAX_FLOWS];
+    int num_flows;
+    sim_link_event_t link_events[SIM_MAX_LINK_EVENTS];
+    int num_link_events;
+} sim_config_t;
+
+struct tdma_sim;
+
+/**
+ * Um nó simulado: o código real de sincronização, routing, forwarding
+ * e streaming, sem threads nem sockets
+ *
+ * O relógio local é global * clock_rate + clock_offset_us; enquanto o
+ * simulador executa código deste nó, ra_tdmas_get_current_time_us()
+ * devolve esse relógio.
+ */
+typedef struct {
+    node_id_t id;
+    struct tdma_sim *sim;
+    double clock_rate;            // 1 + drift
+    uint64_t clock_offset_us;
+    
+    ra_tdmas_sync_t sync;
+    routing_manager_t routing;
+    buffer_pool_t buffers;
+    udp_transport_t transport;    // Sobre a fabric em memória da simulação
+    tx_queue_t tx_queue;
+    forwarding_engine_t forwarding;
+    
+    // Só nos extremos dos fluxos (NULL nos outros)
+    data_streaming_t *stream;
+    traffic_engine_t *traffic;
+    reasm_deliver_cb app_on_frame;    // Callback do traffic engine, chamado a seguir
+    void *app_on_frame_ctx;
+    
+    uint64_t last_slot_start_us;  // Relógio local, como no tx_scheduler
+    uint64_t tx_end_us;           // Fim da última transmissão, tempo global
+    
+    // Estatísticas
+    uint64_t slots;
+    uint64_t collisions;          // Slots sobrepostos ao de um vizinho físico
+    uint64_t heartbeats_sent;
+    uint64_t heartbeats_received;
+    uint64_t packets_sent;        // Heartbeats + dados enviados nos slots
+} sim_node_t;
+
+/**
+ * Simulador de eventos discretos da rede TDMA
+ *
+ * Uma só thread e tempo virtual: cada evento (slot, receção, frame,
+ * falha de link) avança o relógio global até ao seu instante. Os
+ * pacotes passam pela fabric em memória com o atraso configurado e
+ * cada pacote posto num link marca um evento de receção.
+ *
+ * A topologia que o routing vê é partilhada por todos os nós e muda
+ * detect_ms depois de um link cair (oráculo: ainda não há flooding de
+ * estado dos links).
+ */
+typedef struct tdma_sim {
+    sim_config_t config;
+    uint64_t now_us;              // Tempo global
+    sim_node_t *current;          // Nó em execução (relógio local), NULL = global
+    
+    sim_event_queue_t queue;
+    shm_fabric_t fabric;
+    topology_graph_t topology;    // Links ativos (entrada do routing)
+    
+    // Vizinhos físicos (CSR): adj[adj_offset[i] .. adj_offset[i + 1])
+    uint32_t *adj_offset;
+    node_id_t *adj;
+    uint32_t max_degree;
+    udp_tx_packet_t *hb_batch;    // [max_degree]
+    
+    sim_node_t *nodes;            // nodes[i] tem ID i + 1
+    uint32_t num_nodes;           // Nós inicializados
+    latency_hist_t *flow_latency; // [num_flows], latência real (relógio global)
+    
+    uint64_t events[SIM_EVENT_TYPES];
+    uint64_t topology_changes;
+    uint64_t wall_us;             // Tempo real gasto em tdma_sim_run()
+} tdma_sim_t;
+
+// 16 nós em grelha, ronda de TDMA_ROUND_PERIOD_MS, 20 ppm, sem perdas
+void sim_config_default(sim_config_t *config);
+
+/**
+ * Constrói a topologia e os nós e liga o relógio virtual
+ *
+ * Só pode existir uma simulação de cada vez (o relógio do RA-TDMAs+ é
+ * global ao processo).
+ * @return 0, -1 se a configuração é inválida ou falta memória
+ */
+int tdma_sim_init(tdma_sim_t *sim, const sim_config_t *config);
+
+// Processa os eventos dos próximos 'seconds' segundos simulados
+int tdma_sim_run(tdma_sim_t *sim, double seconds);
+
+// Repõe o relógio real e liberta tudo
+void tdma_sim_destroy(tdma_sim_t *sim);
+
+// Nó com o ID dado (1..num_nodes), NULL fora do intervalo
+sim_node_t *tdma_sim_node(tdma_sim_t *sim, node_id_t id);
+
+// Conversão entre o relógio global e o relógio local de um nó
+uint64_t tdma_sim_local_time(const sim_node_t *node, uint64_t global_us);
+uint64_t tdma_sim_global_time(const sim_node_t *node, uint64_t local_us);
+
+// Segundos simulados desde o arranque
+double tdma_sim_elapsed_sec(const tdma_sim_t *sim);
+
+// Nós sincronizados (RA-TDMAs+)
+uint32_t tdma_sim_synchronized(tdma_sim_t *sim);
+
+void tdma_sim_print_summary(tdma_sim_t *sim);
+
+// Acrescenta uma linha de resumo a um CSV (cabeçalho se o ficheiro é novo)
+int tdma_sim_append_csv(tdma_sim_t *sim, const char *filename);
+
+#endif // TDMA_SIM_H
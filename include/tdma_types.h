@@ -6,18 +6,27 @@
 #include <stdbool.h>
 #include <pthread.h>
 
+// Capacidade das estruturas densas (connectivity_matrix_t, spanning_tree_t).
+// A topologia em runtime (topology_graph_t) não depende deste limite.
 #define MAX_NODES 20
+
+// Limite de nós numa topologia dinâmica (tdma_node, routing manager, sync)
+#define MAX_NETWORK_NODES 4096
+
 #define MAC_BYTES 6
 
 // Node ID type
-typedef uint8_t node_id_t;
+typedef uint16_t node_id_t;
+
+// Next hop inválido / destino inalcançável
+#define NODE_ID_INVALID ((node_id_t)0xFFFF)
 
 // MAC address
 typedef struct {
     uint8_t bytes[MAC_BYTES];
 } mac_addr_t;
 
-// Network topology (connectivity matrix)
+// Network topology (connectivity matrix) - representação densa
 typedef struct {
     uint8_t matrix[MAX_NODES][MAX_NODES];  // Binary: 1=connected, 0=not
     node_id_t node_ids[MAX_NODES];         // Active node IDs
@@ -26,7 +35,7 @@ typedef struct {
     pthread_mutex_t lock;
 } connectivity_matrix_t;
 
-// Spanning tree (for synchronization)
+// Spanning tree (for synchronization) - representação densa
 typedef struct {
     uint8_t tree[MAX_NODES][MAX_NODES];    // MST representation
     node_id_t node_ids[MAX_NODES];
@@ -39,15 +48,16 @@ typedef struct {
     node_id_t destination;
     node_id_t next_hop;
     mac_addr_t next_hop_mac;
-    uint8_t hop_count;
+    uint16_t hop_count;
     bool valid;
     uint64_t timestamp;
 } route_entry_t;
 
-// Routing table
+// Routing table (alocada em heap, indexada pelo índice do nó)
 typedef struct {
-    route_entry_t routes[MAX_NODES];
+    route_entry_t *routes;
+    uint32_t capacity;
     pthread_mutex_t lock;
 } routing_table_t;
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,104 @@
+// include/topology_graph.h
+#ifndef TOPOLOGY_GRAPH_H
+#define TOPOLOGY_GRAPH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tdma_types.h"
+
+/**
+ * Topologia dinâmica (dimensionada em runtime)
+ *
+ * Listas de adjacência esparsas em heap, ordenadas por índice do vizinho,
+ * e mapa direto node_id → índice. Substitui a matriz densa
+ * MAX_NODES x MAX_NODES para redes grandes (1000+ nós).
+ */
+
+// Aresta dirigida: índice do vizinho + peso do link (0 = sem link)
+typedef struct {
+    uint32_t to;
+    uint16_t weight;
+} graph_edge_t;
+
+typedef struct {
+    graph_edge_t *edges;
+    uint32_t degree;
+    uint32_t capacity;
+} graph_adj_list_t;
+
+typedef struct {
+    uint32_t num_nodes;
+    uint32_t capacity;
+    
+    node_id_t *node_ids;        // índice → node_id
+    graph_adj_list_t *adj;      // índice → vizinhos
+    
+    int32_t *index_of;          // node_id → índice (-1 se ausente)
+    uint32_t index_of_size;     // maior node_id + 1 suportado pelo mapa
+    
+    uint32_t num_edges;         // Arestas dirigidas
+    uint64_t timestamp;         // Last update time
+} topology_graph_t;
+
+// Init/Destroy
+int topology_graph_init(topology_graph_t *graph, uint32_t capacity);
+void topology_graph_destroy(topology_graph_t *graph);
+void topology_graph_clear(topology_graph_t *graph);
+
+// Nós
+int topology_graph_add_node(topology_graph_t *graph, node_id_t id);
+
+static inline int topology_graph_index_of(const topology_graph_t *graph,
+                                          node_id_t id) {
+    if (id >= graph->index_of_size) return -1;
+    return graph->index_of[id];
+}
+
+// Arestas por índice (dirigidas). weight == 0 remove a aresta.
+int topology_graph_set_edge(topology_graph_t *graph, uint32_t from,
+                            uint32_t to, uint16_t weight);
+uint16_t topology_graph_edge_weight(const topology_graph_t *graph,
+                                    uint32_t from, uint32_t to);
+
+// Links por node_id (simétricos). weight == 0 remove o link.
+int topology_graph_set_link(topology_graph_t *graph, node_id_t a,
+                            node_id_t b, uint16_t weight);
+uint16_t topology_graph_link_weight(const topology_graph_t *graph,
+                                    node_id_t a, node_id_t b);
+
+// Mudança de um link simétrico entre duas versões da topologia
+typedef struct {
+    uint32_t a, b;              // Índices (a < b)
+    uint16_t old_weight;        // 0 = link não existia
+    uint16_t new_weight;        // 0 = link removido
+} graph_link_change_t;
+
+// Cópia / comparação
+int topology_graph_copy(topology_graph_t *dst, const topology_graph_t *src);
+bool topology_graph_equals(const topology_graph_t *a, const topology_graph_t *b);
+
+/**
+ * Lista os links que mudaram entre duas versões com o mesmo conjunto de nós
+ *
+ * @return Número de mudanças, ou -1 se os nós diferem, há uma mudança
+ *         assimétrica ou mais de max_changes links mudaram
+ */
+int topology_graph_diff(const topology_graph_t *old_graph,
+                        const topology_graph_t *new_graph,
+                        graph_link_change_t *changes,
+                        uint32_t max_changes);
+
+// Conversão a partir da matriz densa (API legada)
+int topology_graph_from_matrix(topology_graph_t *graph,
+                               const connectivity_matrix_t *matrix);
+
+// Full mesh com IDs 1..num_nodes (topologia inicial de um nó)
+int topology_graph_full_mesh(topology_graph_t *graph, uint32_t num_nodes);
+
+// Igual, com todos os links a 'weight' (> 0)
+int topology_graph_full_mesh_weighted(topology_graph_t *graph, uint32_t num_nodes,
+                                      uint16_t weight);
+
+void topology_graph_print(const topology_graph_t *graph);
+
+#endif // TOPOLOGY_GRAPH_H
@@ -0,0 +1,189 @@
+// include/traffic_gen.h
+#ifndef TRAFFIC_GEN_H
+#define TRAFFIC_GEN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "data_streaming.h"
+
+#define TRAFFIC_MAX_FLOWS 64
+#define TRAFFIC_MAGIC 0x5447              // "TG" no início do payload
+#define TRAFFIC_REPORT_MAGIC 0x5452       // "TR": fim de fluxo (traffic_report_t)
+#define TRAFFIC_SEQ_WINDOW 1024           // Seqs recentes lembradas (duplicados)
+#define TRAFFIC_DEFAULT_WARMUP_SEC 30
+
+typedef enum {
+    TRAFFIC_PATTERN_CBR = 0,              // Intervalo fixo 1/rate
+    TRAFFIC_PATTERN_BURSTY,               // 'burst' frames seguidos, média = rate
+    TRAFFIC_PATTERN_POISSON               // Chegadas exponenciais de média 1/rate
+} traffic_pattern_t;
+
+typedef enum {
+    TRAFFIC_SIZE_FIXED = 0,
+    TRAFFIC_SIZE_UNIFORM,                 // [size_min, size_max]
+    TRAFFIC_SIZE_GOP                      // frame_generator_t (I/P a bitrate_bps)
+} traffic_size_dist_t;
+
+/**
+ * Definição de um fluxo (igual em todos os nós)
+ *
+ * Formato texto: pares chave=valor separados por vírgulas ou espaços,
+ *   src=1,dst=4,rate=30,pattern=poisson,size=1000-8000,duration=10
+ * Chaves: src, dst, rate (frames/s, 0 = saturação), pattern (cbr|bursty|
+ * poisson), burst, size (N | MIN-MAX | gop), bitrate (bps, para gop),
+ * type (video|audio|data), start e duration (segundos), seed.
+ */
+typedef struct {
+    uint16_t id;
+    node_id_t src;
+    node_id_t dst;
+    stream_type_t type;
+    traffic_pattern_t pattern;
+    double rate_fps;
+    uint32_t burst;
+    traffic_size_dist_t size_dist;
+    uint32_t size_min;
+    uint32_t size_max;
+    uint32_t bitrate_bps;
+    double start_sec;                     // Depois do warm-up
+    double duration_sec;
+    uint64_t seed;
+} traffic_flow_t;
+
+// Início de cada frame gerado (sobrepõe o cabeçalho do frame_generator)
+typedef struct {
+    uint16_t magic;
+    uint16_t flow_id;
+    uint32_t seq;
+    uint64_t tx_time_us;                  // Relógio TDMA (ra_tdmas_get_current_time_us)
+} __attribute__((packed)) traffic_header_t;
+
+// Enviado pelo emissor quando o fluxo termina: o recetor passa a contar
+// também as perdas no fim do fluxo (que nenhum seq posterior revela)
+typedef struct {
+    uint16_t magic;
+    uint16_t flow_id;
+    uint32_t frames_sent;
+} __attribute__((packed)) traffic_report_t;
+
+// Estado do emissor de um fluxo local
+typedef struct {
+    frame_generator_t gen;
+    uint64_t rng;
+    uint64_t next_us;                     // Próximo envio (CLOCK_MONOTONIC)
+    uint64_t start_us;
+    uint64_t end_us;
+    uint32_t burst_left;
+    bool done;
+
+    uint64_t frames_sent;
+    uint64_t frames_failed;
+    uint64_t bytes_sent;
+    uint64_t first_tx_us;
+    uint64_t last_tx_us;
+} traffic_tx_state_t;
+
+// Estado do recetor de um fluxo (atualizado na thread de RX)
+typedef struct {
+    uint64_t frames_received;             // Seqs distintas
+    uint64_t frames_duplicate;
+    uint64_t bytes_received;
+    uint32_t next_seq;                    // Maior seq vista + 1
+    uint64_t seen[TRAFFIC_SEQ_WINDOW / 64];   // Seqs em [next_seq - janela, next_seq)
+    uint32_t sender_frames_sent;          // Do traffic_report_t
+    bool report_received;
+    uint64_t first_rx_us;
+    uint64_t last_rx_us;
+    latency_hist_t latency;               // Geração do frame → entrega
+} traffic_rx_state_t;
+
+typedef struct {
+    data_streaming_t *stream;
+    node_id_t my_id;
+
+    traffic_flow_t flows[TRAFFIC_MAX_FLOWS];
+    traffic_tx_state_t tx[TRAFFIC_MAX_FLOWS];
+    traffic_rx_state_t rx[TRAFFIC_MAX_FLOWS];
+    int num_flows;
+    int num_local_tx;
+
+    uint32_t warmup_sec;
+    uint8_t *frame_buf;
+    uint32_t frame_buf_size;
+
+    pthread_t thread;
+    bool running;
+    volatile bool stop;
+    uint64_t frames_unknown;              // Payload sem traffic_header_t válido
+} traffic_engine_t;
+
+/**
+ * Lê um fluxo no formato texto (ver traffic_flow_t)
+ *
+ * @return 0, -1 se uma chave ou valor é inválido (mensagem em stderr)
+ */
+int traffic_flow_parse(traffic_flow_t *flow, const char *spec);
+
+void traffic_engine_init(traffic_engine_t *engine, data_streaming_t *stream,
+                         node_id_t my_id);
+void traffic_engine_destroy(traffic_engine_t *engine);
+
+// Acrescenta um fluxo (id = índice); -1 se a tabela está cheia
+int traffic_engine_add_flow(traffic_engine_t *engine, const traffic_flow_t *flow);
+
+/**
+ * Lê fluxos de um ficheiro: um por linha, '#' inicia comentário
+ *
+ * @return Fluxos lidos, -1 se o ficheiro não abre ou uma linha é inválida
+ */
+int traffic_engine_load_file(traffic_engine_t *engine, const char *path);
+
+/**
+ * Regista o callback de RX e arranca a thread emissora se este nó é a
+ * origem de algum fluxo
+ *
+ * Uma só thread envia todos os fluxos locais por ordem do próximo envio
+ * (data_streaming_send() não é reentrante).
+ */
+int traffic_engine_start(traffic_engine_t *engine);
+
+/**
+ * Como traffic_engine_start() mas sem thread: o chamador envia os
+ * frames com traffic_engine_poll() (ex.: o simulador, em tempo virtual)
+ */
+int traffic_engine_arm(traffic_engine_t *engine);
+
+/**
+ * Envia os frames locais já devidos em 'now' (relógio TDMA, μs)
+ *
+ * @return Instante do próximo envio; 'now' se ainda há frames devidos
+ *         (saturação, parou em TRAFFIC_POLL_MAX_FRAMES); UINT64_MAX
+ *         quando todos os fluxos locais terminaram
+ */
+uint64_t traffic_engine_poll(traffic_engine_t *engine, uint64_t now);
+
+// Pára a thread emissora e espera por ela
+void traffic_engine_stop(traffic_engine_t *engine);
+
+// true quando todos os fluxos locais terminaram (ou não há nenhum)
+bool traffic_engine_tx_done(traffic_engine_t *engine);
+
+/**
+ * Frames perdidos de um fluxo recebido neste nó
+ *
+ * Com o traffic_report_t do emissor, enviados - recebidos; antes dele,
+ * só as lacunas até à maior seq vista (as perdas no fim não aparecem).
+ */
+uint64_t traffic_engine_rx_lost(traffic_engine_t *engine, int flow);
+
+// Jain's fairness index do throughput dos fluxos recebidos neste nó
+double traffic_engine_rx_fairness(traffic_engine_t *engine);
+
+// Imprime os fluxos com origem ou destino neste nó; devolve quantos
+int traffic_engine_print_report(traffic_engine_t *engine);
+
+// Percentis de latência dos fluxos recebidos neste nó em CSV
+int traffic_engine_export_latency_csv(traffic_engine_t *engine, const char *filename);
+
+#endif // TRAFFIC_GEN_H
@@ -0,0 +1,131 @@
+// include/tx_queue.h
+#ifndef TX_QUEUE_H
+#define TX_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "tdma_types.h"
+#include "udp_transport.h"
+#include "buffer_pool.h"
+
+#define TX_QUEUE_DEFAULT_CAPACITY 1024   // Frames pendentes por nó
+#define TX_SLOT_GUARD_US 500             // Margem máxima antes do fim do slot
+#define TX_SLOT_GUARD_FRACTION 10        // Margem = 1/10 do slot (até TX_SLOT_GUARD_US)
+
+// Séries da fila no registo de métricas (ver tx_queue_set_metrics)
+typedef struct {
+    metric_id_t sent;
+    metric_id_t rejected;
+} tx_queue_metric_ids_t;
+
+/**
+ * Frame pendente para transmissão no slot do nó
+ *
+ * 'data' vem de buffer_pool_alloc() (pool da fila ou malloc); o payload UDP (ex.: mesh_header
+ * + stream_header + chunk) está em data + offset. A fila fica com a posse
+ * depois de um push com sucesso e liberta-o após o envio. O offset permite
+ * reenviar um buffer de RX reclamado sem copiar o payload.
+ */
+typedef struct {
+    node_id_t dst;                // Destino UDP (próximo hop)
+    message_type_t type;
+    uint8_t *data;
+    uint16_t offset;              // Início do payload em data
+    uint16_t len;
+    uint64_t enqueue_time_us;
+} tx_frame_t;
+
+/**
+ * Fila de transmissão gated pelo slot TDMA
+ *
+ * Produtores (streaming) fazem push e bloqueiam quando a fila está
+ * cheia (backpressure). O escalonador de slots drena-a só dentro do
+ * slot do nó, em batches de sendmmsg(), até ao fim do slot.
+ */
+typedef struct {
+    tx_frame_t *frames;           // Buffer circular [capacity]
+    buffer_pool_t *pool;          // Onde os frames enviados são devolvidos
+    uint32_t capacity;
+    uint32_t head;
+    uint32_t count;
+    bool closed;
+    int max_wait_ms;              // Limite às esperas do push (-1 = sem limite)
+    
+    pthread_mutex_t lock;
+    pthread_cond_t not_full;
+    
+    // Estatísticas
+    uint64_t enqueued;
+    uint64_t sent;
+    uint64_t send_errors;
+    uint64_t rejected;            // Push falhado (timeout/fechada)
+    uint64_t producer_waits;      // Push que teve de esperar (fila cheia)
+    uint64_t bytes_sent;
+    uint64_t total_queue_delay_us;
+    
+    // Goodput por slot
+    uint64_t slots_with_data;
+    uint64_t last_slot_bytes;
+    uint64_t max_slot_bytes;
+    uint64_t first_send_us;
+    uint64_t last_send_us;
+    
+    // Séries exportadas: push vem de várias threads e o exportador não toma o lock
+    metrics_registry_t *metrics;  // NULL = sem registo
+    tx_queue_metric_ids_t metric_ids;
+} tx_queue_t;
+
+int tx_queue_init(tx_queue_t *queue, uint32_t capacity);
+void tx_queue_destroy(tx_queue_t *queue);
+
+/**
+ * Coloca um frame na fila (a fila fica com frame->data em caso de sucesso)
+ *
+ * @param timeout_ms Espera máxima com a fila cheia (-1 = infinito, 0 = não espera)
+ * @return 0 em sucesso, -1 em timeout ou se a fila foi fechada
+ */
+int tx_queue_push(tx_queue_t *queue, const tx_frame_t *frame, int timeout_ms);
+
+/**
+ * Envia frames pendentes até a fila esvaziar ou chegar a deadline_us
+ *
+ * Chamado pelo escalonador dentro do slot do nó.
+ * @param deadline_us Tempo absoluto (CLOCK_MONOTONIC, μs) a não ultrapassar
+ * @return Número de frames enviados
+ */
+int tx_queue_drain(tx_queue_t *queue, udp_transport_t *transport,
+                   uint64_t deadline_us);
+
+/**
+ * Deadline de tx_queue_drain() para o slot [slot_start_us, slot_end_us)
+ *
+ * A margem antes do fim é 1/TX_SLOT_GUARD_FRACTION do slot, no máximo
+ * TX_SLOT_GUARD_US: slots curtos (rondas rápidas, muitos nós) continuam
+ * a ter tempo para dados.
+ */
+uint64_t tx_queue_slot_deadline(uint64_t slot_start_us, uint64_t slot_end_us);
+
+/**
+ * Limita a espera de qualquer push com a fila cheia (-1 = sem limite)
+ *
+ * Com 0 nenhum produtor bloqueia: num processo de uma só thread (o
+ * simulador) ninguém drenaria a fila durante a espera.
+ */
+void tx_queue_set_max_wait(tx_queue_t *queue, int max_wait_ms);
+
+// Pool dos buffers dos frames (NULL = malloc/free)
+void tx_queue_set_pool(tx_queue_t *queue, buffer_pool_t *pool);
+
+// Regista as séries tx_queue_* em 'reg' (depois do init, antes das threads)
+void tx_queue_set_metrics(tx_queue_t *queue, metrics_registry_t *reg);
+
+// Número de frames pendentes
+uint32_t tx_queue_pending(tx_queue_t *queue);
+
+// Fecha a fila: produtores bloqueados falham (shutdown)
+void tx_queue_close(tx_queue_t *queue);
+
+void tx_queue_print_stats(tx_queue_t *queue);
+
+#endif // TX_QUEUE_H
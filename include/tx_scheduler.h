@@ -0,0 +1,50 @@
+// include/tx_scheduler.h
+#ifndef TX_SCHEDULER_H
+#define TX_SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ra_tdmas_sync.h"
+
+/**
+ * Escalonador de TX por slot TDMA
+ *
+ * Arma um deadline absoluto (timerfd, CLOCK_MONOTONIC, TFD_TIMER_ABSTIME)
+ * no início do próximo slot do nó e bloqueia até lá: uma única wakeup
+ * por slot, em vez de polling a ra_tdmas_can_transmit() a cada 100 μs.
+ * O caller usa a janela devolvida para drenar o que tem a enviar.
+ */
+typedef struct {
+    ra_tdmas_sync_t *sync;
+    int timer_fd;
+    int cancel_fd;                  // eventfd para acordar no shutdown
+    
+    uint64_t last_slot_start_us;    // Último slot servido
+    
+    // Estatísticas (jitter = atraso da wakeup face ao início do slot)
+    uint64_t slots_served;
+    int64_t last_jitter_us;
+    int64_t max_jitter_us;
+    uint64_t total_jitter_us;
+} tx_scheduler_t;
+
+int tx_scheduler_init(tx_scheduler_t *sched, ra_tdmas_sync_t *sync);
+void tx_scheduler_destroy(tx_scheduler_t *sched);
+
+/**
+ * Bloqueia até ao início do próximo slot ainda não servido
+ *
+ * @param slot_start_us Início do slot (absoluto, μs)
+ * @param slot_end_us Fim do slot (absoluto, μs): drenar até aqui
+ * @return 0 no início do slot, -1 se cancelado ou em erro
+ */
+int tx_scheduler_wait_slot(tx_scheduler_t *sched,
+                           uint64_t *slot_start_us,
+                           uint64_t *slot_end_us);
+
+// Acorda uma thread bloqueada em tx_scheduler_wait_slot() (shutdown)
+void tx_scheduler_cancel(tx_scheduler_t *sched);
+
+void tx_scheduler_print_stats(tx_scheduler_t *sched);
+
+#endif // TX_SCHEDULER_H
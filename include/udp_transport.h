@@ -5,18 +5,25 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <netinet/in.h>
+#include <sys/uio.h>
 #include "tdma_types.h"
+#include "buffer_pool.h"
+#include "metrics_registry.h"
 
 #define UDP_PORT_BASE 5000
 #define MAX_PACKET_SIZE 1500
+#define UDP_RX_BATCH 32          // Pacotes por recvmmsg() (tamanho do anel de RX)
+#define UDP_TX_BATCH 32          // Pacotes por sendmmsg()
+#define UDP_TX_MAX_SEGMENTS 3    // Segmentos de payload por pacote (scatter-gather)
 
 // Tipos de mensagens
 typedef enum {
     MSG_HEARTBEAT = 1,      // Keep-alive entre nós
-    MSG_TOPOLOGY_UPDATE,    // Atualização da connectivity matrix
+    MSG_TOPOLOGY_UPDATE,    // LSA com os links de um nó, em flooding (link_state.h)
     MSG_DATA,              // Dados de aplicação
     MSG_ROUTING_REQUEST,   // Pedido de rota
-    MSG_ROUTING_RESPONSE   // Resposta com next hop
+    MSG_ROUTING_RESPONSE,  // Resposta com next hop
+    MSG_STREAM_NACK        // Chunks em falta de um stream (mesh_header + stream_nack_t)
 } message_type_t;
 
 // Header de mensagem UDP (COM TIMESTAMP!)
@@ -30,20 +37,93 @@ typedef struct __attribute__((packed)) {
     uint64_t tx_timestamp_us; // <--- ADICIONA ISTO!
 } udp_header_t;
 
+// Pacote recebido em batch (payload aponta para o anel de RX)
+typedef struct {
+    udp_header_t header;
+    const uint8_t *payload;   // Válido até à próxima receive_batch()
+    uint16_t payload_len;
+} udp_rx_packet_t;
+
+// Pacote a enviar em batch: o payload é referenciado, nunca copiado
+typedef struct {
+    node_id_t dst;
+    message_type_t type;
+    uint64_t tx_timestamp_us;
+    struct iovec segments[UDP_TX_MAX_SEGMENTS];
+    int num_segments;
+} udp_tx_packet_t;
+
+// Anel de buffers + mmsghdr para recvmmsg() (definido em udp_transport.c)
+typedef struct udp_rx_ring udp_rx_ring_t;
+
+// Fabric de links em memória e lado de um transporte (definidos em shm_link.h)
+typedef struct shm_fabric shm_fabric_t;
+typedef struct shm_endpoint shm_endpoint_t;
+
+// Séries do transporte no registo de métricas (ver udp_transport_set_metrics)
+typedef struct {
+    metric_id_t packets_sent;
+    metric_id_t packets_received;
+    metric_id_t bytes_sent;
+    metric_id_t bytes_received;
+    metric_id_t errors;
+} udp_transport_metric_ids_t;
+
 // Estrutura de transporte UDP
 typedef struct {
     int socket_fd;
     uint16_t port;
     node_id_t my_node_id;
     
+    // Receção orientada a eventos
+    int epoll_fd;
+    int wake_fd;              // eventfd para acordar o receptor (shutdown)
+    udp_rx_ring_t *rx_ring;
+    buffer_pool_t *pool;      // Buffers do anel de RX (NULL = malloc)
+    
+    // Endereços pré-calculados por node_id (evita snprintf/inet_pton por pacote)
+    struct sockaddr_in *peer_addrs;   // [num_peers + 1], indexado por node_id
+    uint32_t num_peers;
+    
+    // Modo cluster: links em memória em vez do socket (NULL = UDP)
+    shm_endpoint_t *shm;
+    
     // Estatísticas
     uint64_t packets_sent;
     uint64_t packets_received;
     uint64_t bytes_sent;
     uint64_t bytes_received;
     uint64_t errors;
+    uint64_t rx_batches;      // Chamadas a recvmmsg() com dados
+    uint64_t tx_batches;      // Chamadas a sendmmsg()
+    
+    // Várias threads enviam (heartbeat, streaming): as séries exportadas
+    // somam-se nos shards do registo, não nos campos acima
+    metrics_registry_t *metrics;          // NULL = sem registo
+    udp_transport_metric_ids_t metric_ids;
 } udp_transport_t;
 
+// Contabilidade de envios/receções/erros (também usada por shm_link.c)
+static inline void udp_transport_count_tx(udp_transport_t *transport,
+                                          uint64_t packets, uint64_t bytes) {
+    transport->packets_sent += packets;
+    transport->bytes_sent += bytes;
+    metrics_add(transport->metrics, transport->metric_ids.packets_sent, packets);
+    metrics_add(transport->metrics, transport->metric_ids.bytes_sent, bytes);
+}
+
+static inline void udp_transport_count_rx(udp_transport_t *transport, uint64_t bytes) {
+    transport->packets_received++;
+    transport->bytes_received += bytes;
+    metrics_inc(transport->metrics, transport->metric_ids.packets_received);
+    metrics_add(transport->metrics, transport->metric_ids.bytes_received, bytes);
+}
+
+static inline void udp_transport_count_error(udp_transport_t *transport) {
+    transport->errors++;
+    metrics_inc(transport->metrics, transport->metric_ids.errors);
+}
+
 // ========================================
 // API de Transporte
 // ========================================
@@ -51,6 +131,16 @@ typedef struct {
 // Inicializa transporte UDP
 int udp_transport_init(udp_transport_t *transport, node_id_t my_id);
 
+/**
+ * Inicializa o transporte sobre uma fabric em memória (ver shm_link.h)
+ *
+ * Mesma API e estatísticas que o modo UDP, sem socket: os envios vão
+ * para os anéis dos links e a receção lê os anéis de entrada do nó.
+ * Não precisa de veth, namespaces nem root.
+ */
+int udp_transport_init_shm(udp_transport_t *transport, node_id_t my_id,
+                           shm_fabric_t *fabric);
+
 // Envia mensagem para um nó específico (COM TIMESTAMP!)
 int udp_transport_send(udp_transport_t *transport,
                       node_id_t dst_node,
@@ -59,6 +149,31 @@ int udp_transport_send(udp_transport_t *transport,
                       uint16_t payload_len,
                       uint64_t tx_timestamp_us);  // <--- ADICIONA ISTO!
 
+// Pré-calcula os endereços dos nós 1..num_nodes
+int udp_transport_set_peers(udp_transport_t *transport, uint32_t num_nodes);
+
+/**
+ * Envia vários pacotes com sendmmsg() (header + segmentos via iovec)
+ *
+ * @param packets Pacotes a enviar (payload referenciado, sem cópia)
+ * @param count Número de pacotes (divididos em grupos de UDP_TX_BATCH)
+ * @return Número de pacotes enviados, -1 se nenhum foi enviado por erro
+ */
+int udp_transport_send_batch(udp_transport_t *transport,
+                             const udp_tx_packet_t *packets,
+                             int count);
+
+/**
+ * Como udp_transport_send_batch(), com o resultado de cada pacote
+ *
+ * Um pacote que falha (demasiado grande, destino inalcançável) é
+ * saltado e o resto do batch segue: a contagem não diz quais saíram.
+ * @param sent [count] sent[i] = true se packets[i] foi enviado
+ */
+int udp_transport_send_batch_status(udp_transport_t *transport,
+                                    const udp_tx_packet_t *packets,
+                                    int count, bool *sent);
+
 // Recebe mensagem (blocking ou non-blocking)
 int udp_transport_receive(udp_transport_t *transport,
                          udp_header_t *header,
@@ -66,6 +181,50 @@ int udp_transport_receive(udp_transport_t *transport,
                          uint16_t max_payload_len,
                          bool blocking);
 
+/**
+ * Espera (epoll) até haver dados no socket
+ *
+ * @param timeout_ms Timeout em ms (-1 = infinito)
+ * @return 1 se há dados, 0 em timeout ou wakeup, -1 em erro
+ */
+int udp_transport_wait(udp_transport_t *transport, int timeout_ms);
+
+/**
+ * Recebe um burst de pacotes com um único recvmmsg() (não bloqueante)
+ *
+ * Os payloads apontam para o anel de RX do transporte e só são válidos
+ * até à próxima chamada. Pacotes inválidos são descartados.
+ *
+ * @param packets Array de saída [max_packets]
+ * @param max_packets Máximo de pacotes (limitado a UDP_RX_BATCH)
+ * @return Número de pacotes válidos (0 se não há dados), -1 em erro
+ */
+int udp_transport_receive_batch(udp_transport_t *transport,
+                                udp_rx_packet_t *packets,
+                                int max_packets);
+
+/**
+ * Fica com o buffer de RX de um pacote recebido em batch (zero-copy)
+ *
+ * O anel recebe um buffer novo; o chamador passa a ser dono do antigo
+ * (libertar com buffer_pool_release(transport->pool, buf)). O payload
+ * fica em buffer + sizeof(udp_header_t).
+ *
+ * @param payload Ponteiro devolvido em udp_rx_packet_t.payload
+ * @return Buffer do pacote, NULL se o payload não pertence ao anel
+ */
+uint8_t *udp_transport_claim_rx_buffer(udp_transport_t *transport,
+                                       const uint8_t *payload);
+
+// Passa o anel de RX (e os buffers de substituição) para o pool
+int udp_transport_set_pool(udp_transport_t *transport, buffer_pool_t *pool);
+
+// Regista as séries transport_* em 'reg' (depois do init, antes das threads)
+void udp_transport_set_metrics(udp_transport_t *transport, metrics_registry_t *reg);
+
+// Acorda uma thread bloqueada em udp_transport_wait()
+void udp_transport_wakeup(udp_transport_t *transport);
+
 // Broadcast para todos os nós (COM TIMESTAMP!)
 int udp_transport_broadcast(udp_transport_t *transport,
                            message_type_t msg_type,
@@ -84,10 +243,26 @@ void udp_transport_destroy(udp_transport_t *transport);
 // Funções Helper
 // ========================================
 
-// Converte node_id para IP (192.168.2.11, 192.168.2.12, etc.)
+/**
+ * Endereço IPv4 de um nó (host byte order)
+ *
+ * 192.168.2.11, 192.168.2.12, ... até ao ID 244; os seguintes continuam
+ * em 192.168.3.1+, saltando sempre os octetos .0 e .255. Único sítio com
+ * o mapeamento: o transporte e o ip_routing_manager usam-no os dois.
+ * @return 0 para IDs que já não cabem em 192.168.255.x
+ */
+uint32_t node_id_to_ipv4(node_id_t node_id);
+
+// Inverso de node_id_to_ipv4(); NODE_ID_INVALID fora do mapeamento
+node_id_t ipv4_to_node_id(uint32_t ip);
+
+// Converte node_id para IP em texto (mesmo mapeamento)
 void node_id_to_ip(node_id_t node_id, char *ip_str, size_t len);
 
 // Converte node_id para porta UDP
 uint16_t node_id_to_port(node_id_t node_id);
 
+// Preenche o sockaddr de um nó (mesmo mapeamento, sem strings)
+void node_id_to_sockaddr(node_id_t node_id, struct sockaddr_in *addr);
+
 #endif // UDP_TRANSPORT_H
\ No newline at end of file
@@ -5,10 +5,30 @@
 #include <unistd.h>
 #include <string.h>
 #include "tdma_node.h"
+#include "tdma_cluster.h"
 #include "data_streaming.h"
+#include "traffic_gen.h"
+#include "async_log.h"
+
+// Fluxo por defeito (sem --flow/--traffic): 3 s de vídeo 720p @ 30 FPS
+#define STREAMING_TEST_SRC 1
+#define STREAMING_TEST_DST 4
+#define STREAMING_TEST_FLOW "rate=30,size=gop,bitrate=2000000,duration=3"
+#define STREAMING_TEST_FEC_N 8      // Um frame de 8 KB = um bloco FEC
+#define STREAMING_TEST_FEC_K 2
+#define CLUSTER_MAX_CUTS 64
 
 static tdma_node_t node;
+static traffic_engine_t traffic;
 static volatile sig_atomic_t keep_running = 1;
+static const char *metrics_file = NULL;
+static const char *metrics_socket = NULL;
+static int run_seconds = 0;                  // 0 = até SIGINT
+
+// Modo cluster (node_id 0): impairments dos links em memória
+static shm_link_params_t link_params;
+static node_id_t link_cuts[CLUSTER_MAX_CUTS][2];
+static int num_link_cuts = 0;
 
 void signal_handler(int signum) {
     (void)signum;
@@ -17,149 +37,307 @@ void signal_handler(int signum) {
 }
 
 // ========================================
-// Thread de Streaming (Node 1 apenas)
-// Simula vídeo 720p @ 30 FPS
+// Options
 // ========================================
-void* streaming_test_thread(void* arg) {
-    tdma_node_t *n = (tdma_node_t*)arg;
+
+static void print_usage(const char *prog) {
+    fprintf(stderr, "Usage: %s <node_id> <total_nodes> <strategy> [options]\n", prog);
+    fprintf(stderr, "  node_id:      1-total_nodes, or 0 to run every node in this process\n");
+    fprintf(stderr, "                over shared-memory links (no namespaces or root)\n");
+    fprintf(stderr, "  total_nodes:  2-%d\n", MAX_NETWORK_NODES);
+    fprintf(stderr, "  strategy:     0=Dijkstra, 1=MST, 2=Hybrid\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  --flow SPEC      Add a flow (repeatable), e.g.\n");
+    fprintf(stderr, "                   src=1,dst=4,rate=30,pattern=poisson,size=1000-8000,duration=10\n");
+    fprintf(stderr, "  --traffic FILE   Read flows from FILE (one SPEC per line)\n");
+    fprintf(stderr, "  --warmup SEC     Wait before the flows start (default %d)\n",
+            TRAFFIC_DEFAULT_WARMUP_SEC);
+    fprintf(stderr, "  --metrics FILE   Write a metrics snapshot every %d ms\n",
+            METRICS_DEFAULT_INTERVAL_MS);
+    fprintf(stderr, "                   (Prometheus text; JSON if FILE ends in .json)\n");
+    fprintf(stderr, "  --metrics-socket PATH  Serve Prometheus text on a Unix socket\n");
+    fprintf(stderr, "  --duration SEC   Stop after SEC seconds (default: until Ctrl+C)\n");
+    fprintf(stderr, "Cluster mode (node_id 0) link options:\n");
+    fprintf(stderr, "  --loss P         Loss probability on every link (0-1)\n");
+    fprintf(stderr, "  --delay US       One-way delay on every link\n");
+    fprintf(stderr, "  --jitter US      Extra uniform delay 0-US (delivery stays in order)\n");
+    fprintf(stderr, "  --cut A-B        Take link A<->B down (repeatable)\n");
+}
+
+static bool option_takes_value(const char *opt) {
+    static const char *options[] = {
+        "--flow", "--traffic", "--warmup", "--metrics", "--metrics-socket",
+        "--duration", "--loss", "--delay", "--jitter", "--cut"
+    };
+    for (size_t i = 0; i < sizeof(options) / sizeof(options[0]); i++) {
+        if (strcmp(opt, options[i]) == 0) return true;
+    }
+    return false;
+}
+
+/**
+ * Fluxos da linha de comandos (todos os nós recebem a mesma lista; cada
+ * um envia os seus e mede os que lhe são destinados) e destino das métricas
+ */
+static int parse_options(int argc, char *argv[], int total_nodes) {
+    for (int i = 4; i < argc; i++) {
+        if (!option_takes_value(argv[i])) {
+            fprintf(stderr, "Error: unknown option %s\n", argv[i]);
+            return -1;
+        }
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Error: %s needs a value\n", argv[i]);
+            return -1;
+        }
+        
+        if (strcmp(argv[i], "--flow") == 0) {
+            traffic_flow_t flow;
+            if (traffic_flow_parse(&flow, argv[++i]) < 0 ||
+                traffic_engine_add_flow(&traffic, &flow) < 0) {
+                return -1;
+            }
+        } else if (strcmp(argv[i], "--traffic") == 0) {
+            if (traffic_engine_load_file(&traffic, argv[++i]) < 0) {
+                return -1;
+            }
+        } else if (strcmp(argv[i], "--metrics") == 0) {
+            metrics_file = argv[++i];
+        } else if (strcmp(argv[i], "--metrics-socket") == 0) {
+            metrics_socket = argv[++i];
+        } else if (strcmp(argv[i], "--duration") == 0) {
+            run_seconds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--loss") == 0) {
+            link_params.loss = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--delay") == 0) {
+            link_params.delay_us = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--jitter") == 0) {
+            link_params.jitter_us = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--cut") == 0) {
+            int a, b;
+            if (num_link_cuts >= CLUSTER_MAX_CUTS ||
+                sscanf(argv[++i], "%d-%d", &a, &b) != 2 ||
+                a < 1 || b < 1 || a > total_nodes || b > total_nodes || a == b) {
+                fprintf(stderr, "Error: bad --cut %s (expected A-B)\n", argv[i]);
+                return -1;
+            }
+            link_cuts[num_link_cuts][0] = a;
+            link_cuts[num_link_cuts][1] = b;
+            num_link_cuts++;
+        } else {
+            traffic.warmup_sec = (uint32_t)atoi(argv[++i]);
+        }
+    }
     
-    // Espera rede estabilizar
-    printf("[STREAMING-TEST] Waiting 30 seconds for network to stabilize...\n");
-    sleep(30);
+    for (int i = 0; i < traffic.num_flows; i++) {
+        if (traffic.flows[i].src > total_nodes || traffic.flows[i].dst > total_nodes) {
+            fprintf(stderr, "Error: flow %d uses a node outside 1-%d\n", i, total_nodes);
+            return -1;
+        }
+    }
     
-    printf("\n");
-    printf("╔════════════════════════════════════════════════╗\n");
-    printf("║  VIDEO STREAMING TEST                          ║\n");
-    printf("║  Simulating 720p @ 30 FPS                      ║\n");
-    printf("╚════════════════════════════════════════════════╝\n");
-    printf("\n");
-    printf("📹 Video Parameters:\n");
-    printf("   Resolution:  1280x720\n");
-    printf("   Frame rate:  30 FPS\n");
-    printf("   Codec:       H.264 (simulated)\n");
-    printf("   Bitrate:     ~2 Mbps\n");
-    printf("   Frame size:  ~8 KB per frame\n");
-    printf("\n");
+    if (traffic.num_flows == 0 && STREAMING_TEST_DST <= total_nodes) {
+        char spec[128];
+        traffic_flow_t flow;
+        snprintf(spec, sizeof(spec), "src=%d,dst=%d,%s",
+                 STREAMING_TEST_SRC, STREAMING_TEST_DST, STREAMING_TEST_FLOW);
+        if (traffic_flow_parse(&flow, spec) == 0) {
+            traffic_engine_add_flow(&traffic, &flow);
+        }
+    }
     
-    // Simulate 3 seconds of video = 90 frames
-    const int FRAMES_TO_SEND = 90;  // 3 seconds @ 30 FPS
-    const int FRAME_SIZE = 8192;    // 8 KB per frame (compressed H.264)
-    const int FRAME_INTERVAL_MS = 33;  // 1000ms / 30fps ≈ 33ms
+    return 0;
+}
+
+// ========================================
+// Cluster Mode
+// ========================================
+
+// Engine de tráfego do nó 'id' no cluster (criado na primeira vez)
+static traffic_engine_t *cluster_engine(traffic_engine_t **engines,
+                                        tdma_cluster_t *cluster, node_id_t id) {
+    if (engines[id]) return engines[id];
     
-    int frames_sent = 0;
-    int frames_failed = 0;
-    uint64_t total_bytes = 0;
+    traffic_engine_t *engine = malloc(sizeof(traffic_engine_t));
+    if (!engine) return NULL;
     
-    struct timespec start, end;
-    clock_gettime(CLOCK_MONOTONIC, &start);
+    traffic_engine_init(engine, &tdma_cluster_node(cluster, id)->streaming, id);
+    engine->warmup_sec = traffic.warmup_sec;
+    for (int i = 0; i < traffic.num_flows; i++) {
+        traffic_engine_add_flow(engine, &traffic.flows[i]);
+    }
     
-    printf("[STREAMING-TEST] Starting transmission of %d frames...\n", FRAMES_TO_SEND);
-    printf("\n");
+    engines[id] = engine;
+    return engine;
+}
+
+/**
+ * Todos os nós neste processo, ligados por links em memória (node_id 0)
+ *
+ * Os fluxos são os mesmos que no modo de um nó por processo: cada nó
+ * origem ou destino de um fluxo tem o seu traffic engine.
+ */
+static int run_cluster(int total_nodes, routing_strategy_t strategy) {
+    static tdma_cluster_t cluster;
     
-    for (int i = 0; i < FRAMES_TO_SEND && keep_running; i++) {
-        // Gerar frame realista
-        uint8_t video_frame[FRAME_SIZE];
-        int frame_size = generate_video_frame(video_frame, sizeof(video_frame));
+    if (metrics_file || metrics_socket) {
+        fprintf(stderr, "Error: --metrics/--metrics-socket need a node_id\n");
+        return 1;
+    }
+    
+    printf("╔══════════════════════════════════════╗\n");
+    printf("║  TDMA CLUSTER - %-4d NODES           ║\n", total_nodes);
+    printf("╚══════════════════════════════════════╝\n");
+    
+    async_log_start(stdout);
+    atexit(async_log_stop);
+    
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+    
+    if (tdma_cluster_init(&cluster, total_nodes, strategy, TDMA_CLUSTER_DEFAULT_SEED) < 0) {
+        fprintf(stderr, "[MAIN] Failed to initialize cluster\n");
+        return 1;
+    }
+    
+    shm_fabric_set_defaults(&cluster.fabric, &link_params);
+    for (int i = 0; i < num_link_cuts; i++) {
+        shm_link_params_t cut = link_params;
+        cut.down = true;
+        shm_fabric_set_link_pair(&cluster.fabric, link_cuts[i][0], link_cuts[i][1], &cut);
+        printf("[MAIN] Link %d <-> %d down\n", link_cuts[i][0], link_cuts[i][1]);
+    }
+    
+    traffic_engine_t **engines = calloc(total_nodes + 1, sizeof(traffic_engine_t *));
+    if (!engines) {
+        tdma_cluster_destroy(&cluster);
+        return 1;
+    }
+    for (int i = 0; i < traffic.num_flows; i++) {
+        if (!cluster_engine(engines, &cluster, traffic.flows[i].src) ||
+            !cluster_engine(engines, &cluster, traffic.flows[i].dst)) {
+            fprintf(stderr, "[MAIN] Out of memory for traffic engines\n");
+            keep_running = 0;
+        }
+    }
+    
+    for (int id = 1; id <= total_nodes; id++) {
+        data_streaming_set_fec(&tdma_cluster_node(&cluster, id)->streaming, STREAM_TYPE_VIDEO,
+                               STREAMING_TEST_FEC_N, STREAMING_TEST_FEC_K);
+    }
+    
+    if (tdma_cluster_start(&cluster) < 0) {
+        fprintf(stderr, "[MAIN] Failed to start cluster\n");
+        keep_running = 0;
+    }
+    
+    printf("[MAIN] %d traffic flow(s) configured\n", traffic.num_flows);
+    for (int id = 1; id <= total_nodes && keep_running; id++) {
+        if (engines[id] && traffic_engine_start(engines[id]) < 0) {
+            fprintf(stderr, "[MAIN] Failed to start traffic engine on node %d\n", id);
+        }
+    }
+    
+    int runtime = 0;
+    while (keep_running && (run_seconds == 0 || runtime < run_seconds)) {
+        sleep(1);
+        runtime++;
         
-        if (frame_size > 0) {
-            // Enviar para Node 4
-            int result = data_streaming_send(&n->streaming, 4, 
-                                            video_frame, frame_size,
-                                            STREAM_TYPE_VIDEO);
-            
-            if (result > 0) {
-                frames_sent++;
-                total_bytes += frame_size;
-                
-                // Progress indicator (every 30 frames = 1 second)
-                if ((i + 1) % 30 == 0) {
-                    printf("[STREAMING-TEST] Progress: %d/%d frames (%.1f seconds)\n",
-                           i + 1, FRAMES_TO_SEND, (i + 1) / 30.0);
-                }
-            } else {
-                frames_failed++;
-                if (frames_failed < 5) {  // Only log first few failures
-                    printf("[STREAMING-TEST] ⚠️  Frame %d failed to send\n", i + 1);
-                }
-            }
-            
-            // Simulate 30 FPS timing (33ms between frames)
-            usleep(FRAME_INTERVAL_MS * 1000);
+        if (runtime % 30 == 0) {
+            async_log_flush();
+            printf("\n[MAIN] Cluster status (runtime: %d seconds)\n", runtime);
+            tdma_cluster_print_summary(&cluster);
         }
     }
     
-    clock_gettime(CLOCK_MONOTONIC, &end);
+    for (int id = 1; id <= total_nodes; id++) {
+        if (engines[id]) traffic_engine_stop(engines[id]);
+    }
     
-    // Calculate statistics
-    double duration_sec = (end.tv_sec - start.tv_sec) + 
-                         (end.tv_nsec - start.tv_nsec) / 1e9;
-    double actual_bitrate = (total_bytes * 8) / (duration_sec * 1000000);  // Mbps
+    printf("\n[MAIN] Stopping cluster...\n");
+    tdma_cluster_stop(&cluster);
+    async_log_flush();
     
     printf("\n");
     printf("╔════════════════════════════════════════════════╗\n");
-    printf("║  STREAMING TEST RESULTS                        ║\n");
+    printf("║  FINAL STATISTICS - CLUSTER                     \n");
     printf("╚════════════════════════════════════════════════╝\n");
-    printf("\n");
-    printf("📊 Transmission Statistics:\n");
-    printf("   Frames sent:       %d / %d\n", frames_sent, FRAMES_TO_SEND);
-    printf("   Frames failed:     %d\n", frames_failed);
-    printf("   Success rate:      %.1f%%\n", 
-           (frames_sent * 100.0) / FRAMES_TO_SEND);
-    printf("   Total data:        %.2f KB\n", total_bytes / 1024.0);
-    printf("   Duration:          %.2f seconds\n", duration_sec);
-    printf("   Actual bitrate:    %.2f Mbps\n", actual_bitrate);
-    printf("   Average FPS:       %.1f\n", frames_sent / duration_sec);
-    printf("\n");
     
-    if (frames_sent >= FRAMES_TO_SEND * 0.9) {  // 90% success
-        printf("✅ Video streaming test PASSED!\n");
-    } else {
-        printf("⚠️  Video streaming test INCOMPLETE (check network)\n");
+    tdma_cluster_print_summary(&cluster);
+    
+    for (int id = 1; id <= total_nodes; id++) {
+        if (!engines[id] || traffic_engine_print_report(engines[id]) == 0) continue;
+        
+        char path[64];
+        snprintf(path, sizeof(path), "logs/traffic_node_%d.csv", id);
+        traffic_engine_export_latency_csv(engines[id], path);
     }
-    printf("\n");
     
-    return NULL;
+    tdma_cluster_destroy(&cluster);
+    for (int id = 1; id <= total_nodes; id++) {
+        if (engines[id]) {
+            traffic_engine_destroy(engines[id]);
+            free(engines[id]);
+        }
+    }
+    free(engines);
+    
+    async_log_stop();
+    printf("\n[MAIN] Cluster of %d nodes exited cleanly.\n", total_nodes);
+    return 0;
 }
 
 // ========================================
 // Main Function
 // ========================================
 int main(int argc, char *argv[]) {
-    // Desativa buffer para logs aparecerem imediatamente
+    // Desativa buffer para logs aparecerem imediatamente; os LOG_* dos
+    // caminhos quentes saem em lote pela thread do logger (um write por passagem)
     setbuf(stdout, NULL);
     
     if (argc < 4) {
-        fprintf(stderr, "Usage: %s <node_id> <total_nodes> <strategy>\n", argv[0]);
-        fprintf(stderr, "  node_id:      1-255\n");
-        fprintf(stderr, "  total_nodes:  2-16\n");
-        fprintf(stderr, "  strategy:     0=Dijkstra, 1=MST, 2=Hybrid\n");
+        print_usage(argv[0]);
         return 1;
     }
     
-    node_id_t my_id = atoi(argv[1]);
+    int id_arg = atoi(argv[1]);
     int total_nodes = atoi(argv[2]);
     routing_strategy_t strategy = atoi(argv[3]);
     
-    if (my_id < 1 || my_id > 255) {
-        fprintf(stderr, "Error: node_id must be 1-255\n");
+    if (total_nodes < 2 || total_nodes > MAX_NETWORK_NODES) {
+        fprintf(stderr, "Error: total_nodes must be 2-%d\n", MAX_NETWORK_NODES);
         return 1;
     }
     
-    if (total_nodes < 2 || total_nodes > MAX_NODES) {
-        fprintf(stderr, "Error: total_nodes must be 2-%d\n", MAX_NODES);
+    if (id_arg < 0 || id_arg > total_nodes) {
+        fprintf(stderr, "Error: node_id must be 0-%d\n", total_nodes);
         return 1;
     }
     
+    node_id_t my_id = (node_id_t)id_arg;
+    
     if (strategy < 0 || strategy > 2) {
         fprintf(stderr, "Error: strategy must be 0-2\n");
         return 1;
     }
     
+    traffic_engine_init(&traffic, &node.streaming, my_id);
+    if (parse_options(argc, argv, total_nodes) < 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    
+    if (my_id == 0) {
+        return run_cluster(total_nodes, strategy);
+    }
+    
     // Banner
     printf("╔══════════════════════════════════════╗\n");
     printf("║  TDMA DAEMON - NODE %-2d               ║\n", my_id);
     printf("╚══════════════════════════════════════╝\n");
     
+    async_log_start(stdout);
+    atexit(async_log_stop);   // Também escoa nos returns de erro
+    
     // Setup signal handler
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
@@ -170,6 +348,13 @@ int main(int argc, char *argv[]) {
         return 1;
     }
     
+    // Snapshots também durante a descoberta
+    if ((metrics_file || metrics_socket) &&
+        metrics_export_start(&node.metrics, metrics_file, metrics_socket,
+                             METRICS_DEFAULT_INTERVAL_MS) < 0) {
+        fprintf(stderr, "[MAIN] Failed to start metrics export\n");
+    }
+    
     // Start node
     if (tdma_node_start(&node) < 0) {
         fprintf(stderr, "[MAIN] Failed to start node\n");
@@ -178,24 +363,27 @@ int main(int argc, char *argv[]) {
     }
     
     // ============================================
-    // Start streaming test thread (Node 1 only)
+    // Traffic flows (origem envia, destino mede)
     // ============================================
-    pthread_t streaming_thread;
-    if (my_id == 1) {
-        printf("[MAIN] Starting streaming test thread...\n");
-        if (pthread_create(&streaming_thread, NULL, streaming_test_thread, &node) != 0) {
-            fprintf(stderr, "[MAIN] Failed to start streaming thread\n");
-        }
+    // Perdas recuperadas no recetor sem esperar uma ronda por retransmissão
+    data_streaming_set_fec(&node.streaming, STREAM_TYPE_VIDEO,
+                           STREAMING_TEST_FEC_N, STREAMING_TEST_FEC_K);
+    
+    printf("[MAIN] %d traffic flow(s) configured\n", traffic.num_flows);
+    if (traffic_engine_start(&traffic) < 0) {
+        fprintf(stderr, "[MAIN] Failed to start traffic engine\n");
     }
     // ============================================
     
     // Main loop - print stats every 30 seconds
     int stats_interval = 30;
     int elapsed = 0;
+    int runtime = 0;
     
-    while (keep_running) {
+    while (keep_running && (run_seconds == 0 || runtime < run_seconds)) {
         sleep(1);
         elapsed++;
+        runtime++;
         
         if (elapsed >= stats_interval) {
             printf("\n");
@@ -205,8 +393,10 @@ int main(int argc, char *argv[]) {
             
             // Heartbeat stats
             printf("\n📡 TDMA Stats:\n");
-            printf("  Heartbeats sent:     %lu\n", node.heartbeats_sent);
-            printf("  Heartbeats received: %lu\n", node.heartbeats_received);
+            printf("  Heartbeats sent:     %lu\n",
+                   metrics_value(&node.metrics, node.metric_ids.heartbeats_sent));
+            printf("  Heartbeats received: %lu\n",
+                   metrics_value(&node.metrics, node.metric_ids.heartbeats_received));
             printf("  Round number:        %u\n", node.ra_sync.round_number);
             printf("  Synchronized:        %s\n", 
                    node.ra_sync.is_synchronized ? "YES" : "NO");
@@ -234,14 +424,13 @@ int main(int argc, char *argv[]) {
         }
     }
     
-    // Wait for streaming thread to finish
-    if (my_id == 1) {
-        pthread_join(streaming_thread, NULL);
-    }
+    // Pára os fluxos ainda a enviar antes de parar o nó
+    traffic_engine_stop(&traffic);
     
     // Cleanup
     printf("\n[MAIN] Stopping node...\n");
     tdma_node_stop(&node);
+    async_log_flush();   // Logs pendentes antes do relatório síncrono
     
     // Final statistics
     printf("\n");
@@ -251,8 +440,21 @@ int main(int argc, char *argv[]) {
     
     tdma_node_print_status(&node);
     
+    // Frames entregues (com retransmissões) no destino, não só enviados
+    if (traffic_engine_print_report(&traffic) > 0) {
+        data_streaming_print_stats(&node.streaming);
+        
+        char path[64];
+        snprintf(path, sizeof(path), "logs/latency_node_%d.csv", my_id);
+        data_streaming_export_latency_csv(&node.streaming, path);
+        snprintf(path, sizeof(path), "logs/traffic_node_%d.csv", my_id);
+        traffic_engine_export_latency_csv(&traffic, path);
+    }
+    
     tdma_node_destroy(&node);
+    traffic_engine_destroy(&traffic);
     
+    async_log_stop();
     printf("\n[MAIN] Node %d exited cleanly.\n", my_id);
     return 0;
 }
\ No newline at end of file
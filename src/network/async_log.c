@@ -0,0 +1,410 @@
+// src/network/async_log.c
+#include "async_log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <sched.h>
+
+#define RING_MASK (ASYNC_LOG_RING_SIZE - 1)
+#define LINE_MAX_LEN 1024
+#define OUT_BUF_SIZE (64 * 1024)
+
+_Static_assert((ASYNC_LOG_RING_SIZE & RING_MASK) == 0, "ring size must be a power of 2");
+
+/**
+ * Anel SPSC de uma thread
+ *
+ * head só é escrito pelo produtor, tail só pelo consumidor (que tem de
+ * segurar drain_lock); cada um na sua linha de cache. writing marca um
+ * push em curso para o async_log_stop() esperar por ele.
+ */
+typedef struct {
+    async_log_record_t records[ASYNC_LOG_RING_SIZE];
+    _Alignas(64) _Atomic uint64_t head;
+    uint64_t dropped;                       // Escrito só pelo produtor
+    _Atomic bool writing;                   // Escrito só pelo produtor
+    _Alignas(64) _Atomic uint64_t tail;
+    _Atomic bool claimed;                   // Thread viva a usar este anel
+} async_log_ring_t;
+
+static struct {
+    async_log_ring_t *rings[ASYNC_LOG_MAX_THREADS];
+    _Atomic int num_rings;
+    pthread_mutex_t ring_lock;              // Criação/atribuição de anéis (caminho frio)
+    pthread_mutex_t drain_lock;             // Um consumidor de cada vez
+    pthread_key_t ring_key;                 // Liberta o anel quando a thread termina
+    pthread_once_t once;
+    
+    FILE *sink;
+    _Atomic bool running;
+    _Atomic bool stopping;
+    pthread_t thread;
+    
+    _Atomic uint64_t synchronous;
+    uint64_t drained;                       // Protegidos por drain_lock
+    uint64_t flushes;
+    char out[OUT_BUF_SIZE];
+    size_t out_len;
+} logger = {
+    .ring_lock = PTHREAD_MUTEX_INITIALIZER,
+    .drain_lock = PTHREAD_MUTEX_INITIALIZER,
+    .once = PTHREAD_ONCE_INIT
+};
+
+static __thread async_log_ring_t *tls_ring = NULL;
+
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// ========================================
+// Formatação (thread de escoamento)
+// ========================================
+
+static bool is_flag(char c) {
+    return c == '-' || c == '+' || c == ' ' || c == '#' || c == '0';
+}
+
+static bool is_length(char c) {
+    return c == 'h' || c == 'l' || c == 'j' || c == 'z' || c == 't';
+}
+
+int async_log_format(char *out, size_t size, const char *fmt,
+                     uint32_t nargs, const uint64_t *args) {
+    if (size == 0) return 0;
+    
+    size_t len = 0;
+    uint32_t next = 0;
+    const char *p = fmt;
+    
+    while (*p && len + 1 < size) {
+        if (*p != '%') {
+            out[len++] = *p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            out[len++] = '%';
+            p += 2;
+            continue;
+        }
+        
+        // %[flags][largura][.precisão][comprimento]conversão ('*' não suportado)
+        const char *start = p++;
+        while (is_flag(*p)) p++;
+        while ((*p >= '0' && *p <= '9') || *p == '.') p++;
+        
+        bool wide = false;
+        while (is_length(*p)) {
+            if (*p != 'h') wide = true;
+            p++;
+        }
+        
+        char conv = *p;
+        if (!conv) break;
+        p++;
+        
+        char spec[32];
+        size_t spec_len = (size_t)(p - start);
+        if (spec_len >= sizeof(spec)) break;
+        memcpy(spec, start, spec_len);
+        spec[spec_len] = '\0';
+        
+        uint64_t arg = next < nargs ? args[next++] : 0;
+        char *dst = out + len;
+        size_t room = size - len;
+        int n;
+        
+        switch (conv) {
+            case 'd': case 'i':
+                n = wide ? snprintf(dst, room, spec, (long)arg)
+                         : snprintf(dst, room, spec, (int)arg);
+                break;
+            case 'u': case 'x': case 'X': case 'o':
+                n = wide ? snprintf(dst, room, spec, (unsigned long)arg)
+                         : snprintf(dst, room, spec, (unsigned int)arg);
+                break;
+            case 'c':
+                n = snprintf(dst, room, spec, (int)arg);
+                break;
+            case 'f': case 'F': case 'e': case 'E':
+            case 'g': case 'G': case 'a': case 'A': {
+                union { uint64_t u; double d; } bits = { .u = arg };
+                n = snprintf(dst, room, spec, bits.d);
+                break;
+            }
+            case 's': {
+                const char *str = (const char *)(uintptr_t)arg;
+                n = snprintf(dst, room, spec, str ? str : "(null)");
+                break;
+            }
+            case 'p':
+                n = snprintf(dst, room, spec, (void *)(uintptr_t)arg);
+                break;
+            default:
+                n = snprintf(dst, room, "%s", spec);   // Desconhecida: texto literal
+                break;
+        }
+        
+        if (n < 0) break;
+        len += (size_t)n < room ? (size_t)n : room - 1;
+    }
+    
+    out[len] = '\0';
+    return (int)len;
+}
+
+static void write_now(const async_log_site_t *site, uint32_t nargs, const uint64_t *args) {
+    char line[LINE_MAX_LEN];
+    int len = async_log_format(line, sizeof(line), site->fmt, nargs, args);
+    
+    FILE *sink = logger.sink ? logger.sink : stdout;
+    fwrite(line, 1, len, sink);
+    atomic_fetch_add_explicit(&logger.synchronous, 1, memory_order_relaxed);
+}
+
+// ========================================
+// Anéis
+// ========================================
+
+static void release_ring(void *arg) {
+    async_log_ring_t *ring = arg;
+    // Registos ainda por escoar continuam lá; o próximo dono só acrescenta
+    atomic_store_explicit(&ring->claimed, false, memory_order_release);
+}
+
+static void create_key(void) {
+    pthread_key_create(&logger.ring_key, release_ring);
+}
+
+static async_log_ring_t *claim_ring(void) {
+    pthread_once(&logger.once, create_key);
+    pthread_mutex_lock(&logger.ring_lock);
+    
+    async_log_ring_t *ring = NULL;
+    int count = atomic_load_explicit(&logger.num_rings, memory_order_relaxed);
+    
+    // Anel de uma thread que já terminou
+    for (int i = 0; i < count && !ring; i++) {
+        if (!atomic_load_explicit(&logger.rings[i]->claimed, memory_order_acquire)) {
+            ring = logger.rings[i];
+        }
+    }
+    
+    if (!ring && count < ASYNC_LOG_MAX_THREADS) {
+        void *mem = NULL;
+        if (posix_memalign(&mem, 64, sizeof(async_log_ring_t)) == 0) {
+            ring = mem;
+            memset(ring, 0, sizeof(async_log_ring_t));
+            logger.rings[count] = ring;
+            atomic_store_explicit(&logger.num_rings, count + 1, memory_order_release);
+        }
+    }
+    
+    if (ring) {
+        atomic_store_explicit(&ring->claimed, true, memory_order_relaxed);
+        pthread_setspecific(logger.ring_key, ring);
+        tls_ring = ring;
+    }
+    
+    pthread_mutex_unlock(&logger.ring_lock);
+    return ring;
+}
+
+// ========================================
+// Produtor
+// ========================================
+
+void async_log_write(const async_log_site_t *site, uint32_t nargs, const uint64_t *args) {
+    if (nargs > ASYNC_LOG_MAX_ARGS) nargs = ASYNC_LOG_MAX_ARGS;
+    
+    if (!atomic_load_explicit(&logger.running, memory_order_acquire)) {
+        write_now(site, nargs, args);
+        return;
+    }
+    
+    async_log_ring_t *ring = tls_ring ? tls_ring : claim_ring();
+    if (!ring) {
+        write_now(site, nargs, args);   // Mais threads do que anéis
+        return;
+    }
+    
+    // Anuncia o push e só depois confirma que o logger não está a parar:
+    // ou o stop vê writing e espera, ou nós vemos running a false
+    atomic_store_explicit(&ring->writing, true, memory_order_seq_cst);
+    if (!atomic_load_explicit(&logger.running, memory_order_seq_cst)) {
+        atomic_store_explicit(&ring->writing, false, memory_order_relaxed);
+        write_now(site, nargs, args);
+        return;
+    }
+    
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    
+    if (head - tail >= ASYNC_LOG_RING_SIZE) {
+        __atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+        atomic_store_explicit(&ring->writing, false, memory_order_release);
+        return;
+    }
+    
+    async_log_record_t *record = &ring->records[head & RING_MASK];
+    record->timestamp_us = now_us();
+    record->site = site;
+    record->nargs = nargs;
+    memcpy(record->args, args, nargs * sizeof(uint64_t));
+    
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    atomic_store_explicit(&ring->writing, false, memory_order_release);
+}
+
+// ========================================
+// Consumidor
+// ========================================
+
+static void flush_out(void) {
+    if (logger.out_len == 0) return;
+    
+    FILE *sink = logger.sink ? logger.sink : stdout;
+    fwrite(logger.out, 1, logger.out_len, sink);
+    fflush(sink);
+    logger.out_len = 0;
+    logger.flushes++;
+}
+
+// Intercala os anéis por timestamp até às cabeças lidas à entrada
+static void drain_locked(void) {
+    int count = atomic_load_explicit(&logger.num_rings, memory_order_acquire);
+    uint64_t pos[ASYNC_LOG_MAX_THREADS];
+    uint64_t end[ASYNC_LOG_MAX_THREADS];
+    
+    for (int i = 0; i < count; i++) {
+        pos[i] = atomic_load_explicit(&logger.rings[i]->tail, memory_order_relaxed);
+        end[i] = atomic_load_explicit(&logger.rings[i]->head, memory_order_acquire);
+    }
+    
+    char line[LINE_MAX_LEN];
+    
+    while (true) {
+        int best = -1;
+        uint64_t best_ts = UINT64_MAX;
+        
+        for (int i = 0; i < count; i++) {
+            if (pos[i] == end[i]) continue;
+            
+            uint64_t ts = logger.rings[i]->records[pos[i] & RING_MASK].timestamp_us;
+            if (ts < best_ts) {
+                best_ts = ts;
+                best = i;
+            }
+        }
+        if (best < 0) break;
+        
+        async_log_ring_t *ring = logger.rings[best];
+        const async_log_record_t *record = &ring->records[pos[best] & RING_MASK];
+        int len = async_log_format(line, sizeof(line), record->site->fmt,
+                                   record->nargs, record->args);
+        
+        // Slot livre para o produtor só depois de formatado
+        pos[best]++;
+        atomic_store_explicit(&ring->tail, pos[best], memory_order_release);
+        
+        if (logger.out_len + (size_t)len > sizeof(logger.out)) {
+            flush_out();
+        }
+        memcpy(logger.out + logger.out_len, line, len);
+        logger.out_len += len;
+        logger.drained++;
+    }
+    
+    flush_out();
+}
+
+void async_log_flush(void) {
+    pthread_mutex_lock(&logger.drain_lock);
+    drain_locked();
+    pthread_mutex_unlock(&logger.drain_lock);
+}
+
+static void *drain_thread(void *arg) {
+    (void)arg;
+    struct timespec interval = {
+        .tv_sec = 0,
+        .tv_nsec = ASYNC_LOG_FLUSH_INTERVAL_MS * 1000000L
+    };
+    
+    while (!atomic_load_explicit(&logger.stopping, memory_order_acquire)) {
+        nanosleep(&interval, NULL);
+        async_log_flush();
+    }
+    return NULL;
+}
+
+// ========================================
+// Lifecycle
+// ========================================
+
+int async_log_start(FILE *sink) {
+    if (atomic_load(&logger.running)) {
+        return -1;
+    }
+    
+    logger.sink = sink ? sink : stdout;
+    atomic_store(&logger.stopping, false);
+    atomic_store(&logger.running, true);
+    
+    if (pthread_create(&logger.thread, NULL, drain_thread, NULL) != 0) {
+        perror("[LOG] pthread_create");
+        atomic_store(&logger.running, false);
+        return -1;
+    }
+    return 0;
+}
+
+void async_log_stop(void) {
+    if (!atomic_load(&logger.running)) {
+        return;
+    }
+    
+    atomic_store(&logger.stopping, true);
+    pthread_join(logger.thread, NULL);
+    
+    // Daqui em diante LOG_* é síncrono; um push já a meio acaba no anel
+    atomic_store(&logger.running, false);
+    
+    // Anéis reclamados depois deste lock já veem running a false
+    pthread_mutex_lock(&logger.ring_lock);
+    int count = atomic_load_explicit(&logger.num_rings, memory_order_acquire);
+    pthread_mutex_unlock(&logger.ring_lock);
+    
+    for (int i = 0; i < count; i++) {
+        while (atomic_load_explicit(&logger.rings[i]->writing, memory_order_acquire)) {
+            sched_yield();
+        }
+    }
+    
+    // Último escoamento: nenhum produtor volta a escrever nos anéis
+    async_log_flush();
+}
+
+bool async_log_running(void) {
+    return atomic_load_explicit(&logger.running, memory_order_acquire);
+}
+
+void async_log_get_stats(async_log_stats_t *stats) {
+    memset(stats, 0, sizeof(async_log_stats_t));
+    
+    int count = atomic_load_explicit(&logger.num_rings, memory_order_acquire);
+    for (int i = 0; i < count; i++) {
+        stats->written += atomic_load_explicit(&logger.rings[i]->head, memory_order_relaxed);
+        stats->dropped += __atomic_load_n(&logger.rings[i]->dropped, __ATOMIC_RELAXED);
+    }
+    stats->synchronous = atomic_load_explicit(&logger.synchronous, memory_order_relaxed);
+    
+    pthread_mutex_lock(&logger.drain_lock);
+    stats->drained = logger.drained;
+    stats->flushes = logger.flushes;
+    pthread_mutex_unlock(&logger.drain_lock);
+}
@@ -0,0 +1,132 @@
+// src/network/buffer_pool.c
+#include "buffer_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INDEX_MASK 0xFFFFFFFFULL
+
+int buffer_pool_init(buffer_pool_t *pool, uint32_t count, uint32_t buf_size) {
+    memset(pool, 0, sizeof(buffer_pool_t));
+    
+    // Alinhamento a cache line entre buffers
+    buf_size = (buf_size + 63) & ~63u;
+    
+    // malloc grande vem de mmap: páginas não tocadas não contam para o RSS
+    pool->slab = malloc((size_t)count * buf_size);
+    pool->next = malloc(count * sizeof(*pool->next));
+    if (!pool->slab || !pool->next) {
+        free(pool->slab);
+        free(pool->next);
+        pool->slab = NULL;
+        pool->next = NULL;
+        return -1;
+    }
+    
+    pool->count = count;
+    pool->buf_size = buf_size;
+    
+    // Free list inicial: 0 → 1 → ... → count-1
+    for (uint32_t i = 0; i < count; i++) {
+        atomic_init(&pool->next[i], i + 1 < count ? i + 2 : 0);
+    }
+    atomic_init(&pool->head, count > 0 ? 1 : 0);
+    
+    return 0;
+}
+
+void buffer_pool_destroy(buffer_pool_t *pool) {
+    uint32_t in_use = atomic_load(&pool->in_use);
+    if (in_use > 0) {
+        fprintf(stderr, "[POOL] Warning: destroying pool with %u buffers in use\n", in_use);
+    }
+    
+    free(pool->slab);
+    free((void *)pool->next);
+    pool->slab = NULL;
+    pool->next = NULL;
+    pool->count = 0;
+}
+
+uint8_t *buffer_pool_get(buffer_pool_t *pool) {
+    uint64_t head = atomic_load_explicit(&pool->head, memory_order_acquire);
+    
+    while (true) {
+        uint32_t index = (uint32_t)(head & INDEX_MASK);
+        if (index == 0) {
+            atomic_fetch_add_explicit(&pool->alloc_failures, 1, memory_order_relaxed);
+            return NULL;
+        }
+        
+        uint64_t next = atomic_load_explicit(&pool->next[index - 1], memory_order_relaxed);
+        uint64_t new_head = ((head >> 32) + 1) << 32 | next;
+        
+        if (atomic_compare_exchange_weak_explicit(&pool->head, &head, new_head,
+                                                  memory_order_acquire,
+                                                  memory_order_acquire)) {
+            uint32_t in_use = atomic_fetch_add_explicit(&pool->in_use, 1,
+                                                        memory_order_relaxed) + 1;
+            uint32_t high = atomic_load_explicit(&pool->high_water, memory_order_relaxed);
+            while (in_use > high &&
+                   !atomic_compare_exchange_weak_explicit(&pool->high_water, &high, in_use,
+                                                          memory_order_relaxed,
+                                                          memory_order_relaxed)) {
+            }
+            atomic_fetch_add_explicit(&pool->allocs, 1, memory_order_relaxed);
+            
+            return pool->slab + (size_t)(index - 1) * pool->buf_size;
+        }
+    }
+}
+
+void buffer_pool_put(buffer_pool_t *pool, uint8_t *buf) {
+    uint32_t index = (uint32_t)((buf - pool->slab) / pool->buf_size) + 1;
+    
+    // Antes do push: assim in_use nunca excede os buffers fora da lista
+    atomic_fetch_sub_explicit(&pool->in_use, 1, memory_order_relaxed);
+    
+    uint64_t head = atomic_load_explicit(&pool->head, memory_order_relaxed);
+    
+    while (true) {
+        atomic_store_explicit(&pool->next[index - 1], (uint32_t)(head & INDEX_MASK),
+                              memory_order_relaxed);
+        uint64_t new_head = ((head >> 32) + 1) << 32 | index;
+        
+        if (atomic_compare_exchange_weak_explicit(&pool->head, &head, new_head,
+                                                  memory_order_release,
+                                                  memory_order_relaxed)) {
+            break;
+        }
+    }
+}
+
+uint8_t *buffer_pool_alloc(buffer_pool_t *pool, size_t size) {
+    if (pool && size <= pool->buf_size) {
+        uint8_t *buf = buffer_pool_get(pool);
+        if (buf) return buf;
+    }
+    return malloc(size);
+}
+
+void buffer_pool_release(buffer_pool_t *pool, uint8_t *buf) {
+    if (!buf) return;
+    
+    if (buffer_pool_owns(pool, buf)) {
+        buffer_pool_put(pool, buf);
+    } else {
+        free(buf);
+    }
+}
+
+void buffer_pool_print_stats(buffer_pool_t *pool) {
+    printf("\n=== Buffer Pool Stats ===\n");
+    printf("Buffers:        %u x %u bytes (%.1f KB slab)\n",
+           pool->count, pool->buf_size,
+           (double)pool->count * pool->buf_size / 1024.0);
+    printf("In use:         %u (high water %u)\n",
+           atomic_load(&pool->in_use), atomic_load(&pool->high_water));
+    printf("Allocs:         %lu (exhausted: %lu)\n",
+           (unsigned long)atomic_load(&pool->allocs),
+           (unsigned long)atomic_load(&pool->alloc_failures));
+    printf("\n");
+}
@@ -0,0 +1,210 @@
+// src/network/forwarding.c
+#include "forwarding.h"
+#include "ra_tdmas_sync.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Relógio TDMA: origin_tx_us é comparado com o rx_us de forwarding_on_receive()
+static uint64_t get_current_time_us(void) {
+    return ra_tdmas_get_current_time_us();
+}
+
+int forwarding_init(forwarding_engine_t *fwd, node_id_t my_id,
+                    routing_manager_t *routing, tx_queue_t *tx_queue,
+                    udp_transport_t *transport) {
+    memset(fwd, 0, sizeof(forwarding_engine_t));
+    
+    fwd->my_id = my_id;
+    fwd->routing = routing;
+    fwd->tx_queue = tx_queue;
+    fwd->transport = transport;
+    fwd->default_ttl = FWD_DEFAULT_TTL;
+    
+    printf("[FORWARDING] Initialized for node %d (TTL %u)\n",
+           my_id, fwd->default_ttl);
+    return 0;
+}
+
+// ========================================
+// Origination
+// ========================================
+
+uint8_t *forwarding_alloc_frame(forwarding_engine_t *fwd, uint16_t len) {
+    return buffer_pool_alloc(fwd->tx_queue->pool, len);
+}
+
+int forwarding_send(forwarding_engine_t *fwd, node_id_t destination,
+                    uint8_t *frame, uint16_t len, int timeout_ms) {
+    return forwarding_send_msg(fwd, destination, MSG_DATA, frame, len, timeout_ms);
+}
+
+int forwarding_send_msg(forwarding_engine_t *fwd, node_id_t destination,
+                        message_type_t type, uint8_t *frame, uint16_t len,
+                        int timeout_ms) {
+    if (len < sizeof(mesh_header_t) || destination == fwd->my_id) {
+        buffer_pool_release(fwd->tx_queue->pool, frame);
+        fwd->originate_failed++;
+        return -1;
+    }
+    
+    node_id_t next_hop = routing_manager_get_next_hop(fwd->routing, destination);
+    if (next_hop == NODE_ID_INVALID) {
+        buffer_pool_release(fwd->tx_queue->pool, frame);
+        fwd->originate_failed++;
+        return -1;
+    }
+    
+    mesh_header_t mesh = {
+        .origin = fwd->my_id,
+        .final_dst = destination,
+        .ttl = fwd->default_ttl,
+        .hops = 0,
+        .origin_tx_us = get_current_time_us()
+    };
+    memcpy(frame, &mesh, sizeof(mesh));
+    
+    tx_frame_t tx = {
+        .dst = next_hop,
+        .type = type,
+        .data = frame,
+        .len = len
+    };
+    
+    if (tx_queue_push(fwd->tx_queue, &tx, timeout_ms) < 0) {
+        buffer_pool_release(fwd->tx_queue->pool, frame);
+        fwd->originate_failed++;
+        return -1;
+    }
+    
+    fwd->originated++;
+    return 0;
+}
+
+// ========================================
+// Reception / Relay
+// ========================================
+
+fwd_verdict_t forwarding_on_receive(forwarding_engine_t *fwd,
+                                    const udp_header_t *header,
+                                    const uint8_t *payload,
+                                    uint16_t payload_len,
+                                    uint64_t rx_time_us) {
+    if (payload_len < sizeof(mesh_header_t)) {
+        fwd->malformed++;
+        return FWD_DROPPED;
+    }
+    
+    mesh_header_t mesh;
+    memcpy(&mesh, payload, sizeof(mesh));
+    
+    // Latência do hop: timestamp de TX (no drain do slot) → RX
+    if (rx_time_us >= header->tx_timestamp_us) {
+        uint64_t hop_us = rx_time_us - header->tx_timestamp_us;
+        fwd->hop_latency_samples++;
+        fwd->total_hop_latency_us += hop_us;
+        if (hop_us > fwd->max_hop_latency_us) fwd->max_hop_latency_us = hop_us;
+    }
+    
+    if (mesh.final_dst == fwd->my_id) {
+        fwd->delivered++;
+        metrics_inc(fwd->metrics, fwd->metric_ids.delivered);
+        fwd->total_delivered_hops += mesh.hops + 1;
+        
+        if (rx_time_us >= mesh.origin_tx_us) {
+            uint64_t e2e_us = rx_time_us - mesh.origin_tx_us;
+            fwd->total_e2e_latency_us += e2e_us;
+            if (e2e_us > fwd->max_e2e_latency_us) fwd->max_e2e_latency_us = e2e_us;
+        }
+        return FWD_DELIVER;
+    }
+    
+    if (mesh.ttl <= 1) {
+        fwd->ttl_expired++;
+        metrics_inc(fwd->metrics, fwd->metric_ids.ttl_expired);
+        return FWD_DROPPED;
+    }
+    
+    node_id_t next_hop = routing_manager_get_next_hop(fwd->routing, mesh.final_dst);
+    if (next_hop == NODE_ID_INVALID || next_hop == fwd->my_id) {
+        fwd->no_route++;
+        metrics_inc(fwd->metrics, fwd->metric_ids.no_route);
+        return FWD_DROPPED;
+    }
+    
+    // Zero-copy: o buffer do anel de RX passa para a fila de TX
+    uint8_t *buffer = udp_transport_claim_rx_buffer(fwd->transport, payload);
+    if (!buffer) {
+        fwd->malformed++;
+        return FWD_DROPPED;
+    }
+    
+    mesh_header_t *relay = (mesh_header_t *)(buffer + sizeof(udp_header_t));
+    relay->ttl--;
+    relay->hops++;
+    
+    tx_frame_t tx = {
+        .dst = next_hop,
+        .type = header->type,
+        .data = buffer,
+        .offset = sizeof(udp_header_t),
+        .len = payload_len
+    };
+    
+    // A thread de RX nunca bloqueia: fila cheia descarta
+    if (tx_queue_push(fwd->tx_queue, &tx, 0) < 0) {
+        buffer_pool_release(fwd->tx_queue->pool, buffer);
+        fwd->queue_full++;
+        metrics_inc(fwd->metrics, fwd->metric_ids.queue_full);
+        return FWD_DROPPED;
+    }
+    
+    fwd->forwarded++;
+    metrics_inc(fwd->metrics, fwd->metric_ids.forwarded);
+    fwd->bytes_forwarded += payload_len;
+    return FWD_FORWARDED;
+}
+
+void forwarding_set_metrics(forwarding_engine_t *fwd, metrics_registry_t *reg) {
+    forwarding_metric_ids_t *ids = &fwd->metric_ids;
+    
+    ids->delivered = metrics_register_counter(reg,
+        "forwarding_delivered_total", "Mesh packets delivered locally");
+    ids->forwarded = metrics_register_counter(reg,
+        "forwarding_forwarded_total", "Mesh packets relayed");
+    ids->ttl_expired = metrics_register_counter(reg,
+        "forwarding_ttl_expired_total", "Mesh packets dropped on TTL");
+    ids->no_route = metrics_register_counter(reg,
+        "forwarding_no_route_total", "Mesh packets dropped without a route");
+    ids->queue_full = metrics_register_counter(reg,
+        "forwarding_queue_full_total", "Mesh packets dropped on a full TX queue");
+    fwd->metrics = reg;
+}
+
+void forwarding_print_stats(forwarding_engine_t *fwd) {
+    printf("\n=== Forwarding Stats ===\n");
+    printf("Originated:     %lu (failed: %lu)\n",
+           fwd->originated, fwd->originate_failed);
+    printf("Delivered:      %lu\n", fwd->delivered);
+    printf("Forwarded:      %lu (%lu bytes)\n",
+           fwd->forwarded, fwd->bytes_forwarded);
+    printf("Dropped:        TTL %lu | no route %lu | queue full %lu | malformed %lu\n",
+           fwd->ttl_expired, fwd->no_route, fwd->queue_full, fwd->malformed);
+    
+    if (fwd->hop_latency_samples > 0) {
+        printf("Hop latency:    %.1f us avg | %lu us max\n",
+               (double)fwd->total_hop_latency_us / fwd->hop_latency_samples,
+               fwd->max_hop_latency_us);
+    }
+    
+    if (fwd->delivered > 0) {
+        double avg_hops = (double)fwd->total_delivered_hops / fwd->delivered;
+        double avg_e2e = (double)fwd->total_e2e_latency_us / fwd->delivered;
+        printf("End-to-end:     %.1f us avg | %lu us max | %.2f hops avg\n",
+               avg_e2e, fwd->max_e2e_latency_us, avg_hops);
+        printf("Per hop:        %.1f us avg (incl. slot wait)\n", avg_e2e / avg_hops);
+    }
+    
+    printf("\n");
+}
@@ -0,0 +1,157 @@
+// src/network/frame_generator.c
+#include "frame_generator.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+
+// ========================================
+// PRNG
+// ========================================
+
+// splitmix64: espalha a seed pelas lanes (nunca ficam a zero)
+static uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t xorshift64(uint64_t *s) {
+    uint64_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *s = x;
+}
+
+static uint64_t get_current_time_us(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+// ========================================
+// API
+// ========================================
+
+void frame_model_default(frame_model_t *model) {
+    model->fps = 30;
+    model->bitrate_bps = 2000000;
+    model->gop_size = 30;
+    model->i_to_p_ratio = 5;
+    model->seed = FRAME_GEN_DEFAULT_SEED;
+}
+
+int frame_generator_init(frame_generator_t *gen, const frame_model_t *model) {
+    memset(gen, 0, sizeof(frame_generator_t));
+    
+    if (model->fps == 0 || model->gop_size == 0 || model->i_to_p_ratio == 0) {
+        return -1;
+    }
+    gen->model = *model;
+    
+    uint64_t x = model->seed;
+    for (int i = 0; i < 4; i++) {
+        gen->lanes[i] = splitmix64(&x) | 1;
+    }
+    
+    // Média por frame = (I + (gop - 1) P) / gop, com I = ratio * P
+    uint64_t avg = (uint64_t)model->bitrate_bps / 8 / model->fps;
+    uint64_t p = avg * model->gop_size / (model->i_to_p_ratio + model->gop_size - 1);
+    if (p < FRAME_GEN_HEADER_SIZE) p = FRAME_GEN_HEADER_SIZE;
+    gen->p_frame_size = (uint32_t)p;
+    gen->i_frame_size = (uint32_t)(p * model->i_to_p_ratio);
+    
+    for (int i = 0; i < FRAME_GEN_AUDIO_TABLE; i++) {
+        gen->audio_table[i] = (uint8_t)(128 + 127 * sin(i * 0.1));
+    }
+    
+    return 0;
+}
+
+uint32_t frame_generator_max_frame_size(const frame_generator_t *gen) {
+    return (uint32_t)((uint64_t)gen->i_frame_size * (100 + FRAME_GEN_SIZE_JITTER) / 100) + 1;
+}
+
+void frame_generator_fill(frame_generator_t *gen, uint8_t *buffer, uint32_t size) {
+    uint64_t a = gen->lanes[0], b = gen->lanes[1];
+    uint64_t c = gen->lanes[2], d = gen->lanes[3];
+    uint32_t i = 0;
+    
+    // Quatro lanes sem dependência entre si: 32 bytes por iteração
+    for (; i + 32 <= size; i += 32) {
+        xorshift64(&a);
+        xorshift64(&b);
+        xorshift64(&c);
+        xorshift64(&d);
+        memcpy(buffer + i, &a, 8);
+        memcpy(buffer + i + 8, &b, 8);
+        memcpy(buffer + i + 16, &c, 8);
+        memcpy(buffer + i + 24, &d, 8);
+    }
+    
+    for (; i < size; i += 8) {
+        uint64_t word = xorshift64(&a);
+        memcpy(buffer + i, &word, size - i < 8 ? size - i : 8);
+    }
+    
+    gen->lanes[0] = a;
+    gen->lanes[1] = b;
+    gen->lanes[2] = c;
+    gen->lanes[3] = d;
+}
+
+static void write_header(uint8_t *buffer, const char *tag, uint8_t kind,
+                         uint32_t counter) {
+    memcpy(buffer, tag, 3);
+    buffer[3] = kind;
+    
+    uint64_t timestamp = get_current_time_us();
+    memcpy(buffer + 4, &timestamp, sizeof(timestamp));
+    memcpy(buffer + 12, &counter, sizeof(counter));
+}
+
+int frame_generator_video(frame_generator_t *gen, uint8_t *buffer,
+                          uint32_t size, bool iframe) {
+    if (size < FRAME_GEN_HEADER_SIZE) return -1;
+    
+    write_header(buffer, "VID", iframe ? 'I' : 'P', gen->frame_counter++);
+    frame_generator_fill(gen, buffer + FRAME_GEN_HEADER_SIZE, size - FRAME_GEN_HEADER_SIZE);
+    
+    return size;
+}
+
+int frame_generator_next_video(frame_generator_t *gen, uint8_t *buffer,
+                               uint32_t max_size, bool *is_iframe) {
+    bool iframe = gen->frame_counter % gen->model.gop_size == 0;
+    uint64_t base = iframe ? gen->i_frame_size : gen->p_frame_size;
+    
+    // Variação determinística de ±FRAME_GEN_SIZE_JITTER %
+    int64_t jitter = (int64_t)(xorshift64(&gen->lanes[0]) % (2 * FRAME_GEN_SIZE_JITTER + 1)) -
+                     FRAME_GEN_SIZE_JITTER;
+    uint64_t size = base * (100 + jitter) / 100;
+    
+    if (size < FRAME_GEN_HEADER_SIZE) size = FRAME_GEN_HEADER_SIZE;
+    if (size > max_size) size = max_size;
+    
+    if (is_iframe) *is_iframe = iframe;
+    return frame_generator_video(gen, buffer, (uint32_t)size, iframe);
+}
+
+int frame_generator_audio(frame_generator_t *gen, uint8_t *buffer, uint32_t size) {
+    if (size < FRAME_GEN_HEADER_SIZE) return -1;
+    
+    write_header(buffer, "AUD", 0xFF, gen->audio_counter++);
+    
+    // Amostra i = 128 + 127 sin(0.1 i), copiada da tabela
+    for (uint32_t i = FRAME_GEN_HEADER_SIZE; i < size; ) {
+        uint32_t pos = i % FRAME_GEN_AUDIO_TABLE;
+        uint32_t n = FRAME_GEN_AUDIO_TABLE - pos;
+        if (n > size - i) n = size - i;
+        memcpy(buffer + i, gen->audio_table + pos, n);
+        i += n;
+    }
+    
+    return size;
+}
@@ -1,11 +1,14 @@
 // src/network/ip_routing_manager.c
 #include "ip_routing_manager.h"
+#include "async_log.h"
+#include "udp_transport.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <time.h>
 #include <errno.h>
+#include <arpa/inet.h>
 
 // ========================================
 // Helper Functions
@@ -17,52 +20,112 @@ static uint64_t get_current_time_ms(void) {
     return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
 }
 
+static uint64_t get_current_time_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
 void node_id_to_ip_str(node_id_t node_id, char *ip_str) {
-    snprintf(ip_str, 16, "192.168.2.%d", 10 + node_id);
+    node_id_to_ip(node_id, ip_str, 16);
 }
 
 bool ip_routing_requires_sudo(void) {
     return (geteuid() != 0);
 }
 
+static in_addr_t node_id_to_addr(node_id_t node_id) {
+    return htonl(node_id_to_ipv4(node_id));
+}
+
+static node_id_t addr_to_node_id(in_addr_t addr) {
+    return ipv4_to_node_id(ntohl(addr));
+}
+
 // ========================================
-// IP Route Manipulation via System Commands
+// Kernel Mirror (rtnetlink)
 // ========================================
 
-static int execute_route_command(const char *interface,
-                                const char *dest_ip,
-                                const char *gateway_ip,
-                                uint32_t metric,
-                                bool is_delete) {
-    char cmd[512];
-    
-    if (is_delete) {
-        // Delete route: ip route del <dest> via <gateway> dev <interface>
-        snprintf(cmd, sizeof(cmd), 
-                "ip route del %s via %s dev %s 2>/dev/null",
-                dest_ip, gateway_ip, interface);
-    } else {
-        // Add route: ip route add <dest> via <gateway> dev <interface> metric <metric>
-        snprintf(cmd, sizeof(cmd),
-                "ip route add %s via %s dev %s metric %u 2>/dev/null",
-                dest_ip, gateway_ip, interface, metric);
+static int enable_ip_forwarding(void) {
+    FILE *f = fopen("/proc/sys/net/ipv4/ip_forward", "w");
+    if (!f) return -1;
+    int ret = fputs("1", f) < 0 ? -1 : 0;
+    if (fclose(f) != 0) ret = -1;
+    return ret;
+}
+
+// Entrada do mirror para um destino (NULL fora da rede)
+static ip_route_entry_t *mirror_entry(ip_routing_manager_t *mgr, node_id_t destination) {
+    if (destination == 0 || destination >= mgr->max_routes) return NULL;
+    return &mgr->route_table[destination];
+}
+
+static bool entry_differs(const ip_route_entry_t *entry, node_id_t gateway,
+                          uint32_t metric) {
+    return !entry->valid || entry->gateway != gateway || entry->metric != metric;
+}
+
+/**
+ * Coloca no batch as mensagens para levar a entrada a (gateway, metric)
+ *
+ * REPLACE troca o gateway de forma atómica; se a métrica mudar, a rota
+ * antiga (outra chave no kernel) é apagada primeiro.
+ * @return Índice da mensagem REPLACE no batch, -1 em erro
+ */
+static int stage_route(ip_routing_manager_t *mgr, const ip_route_entry_t *entry,
+                       node_id_t gateway, uint32_t metric) {
+    in_addr_t dst = node_id_to_addr(entry->destination);
+    
+    if (entry->valid && entry->metric != metric) {
+        if (nl_route_batch_add(&mgr->nl, NL_ROUTE_DELETE, dst,
+                               node_id_to_addr(entry->gateway), entry->metric) < 0) {
+            return -1;
+        }
     }
     
-    int ret = system(cmd);
-    
-    if (ret != 0 && !is_delete) {
-        // Try to replace if add failed (route already exists)
-        snprintf(cmd, sizeof(cmd),
-                "ip route replace %s via %s dev %s metric %u 2>/dev/null",
-                dest_ip, gateway_ip, interface, metric);
-        ret = system(cmd);
+    return nl_route_batch_add(&mgr->nl, NL_ROUTE_REPLACE, dst,
+                              node_id_to_addr(gateway), metric);
+}
+
+static int stage_delete(ip_routing_manager_t *mgr, const ip_route_entry_t *entry) {
+    return nl_route_batch_add(&mgr->nl, NL_ROUTE_DELETE,
+                              node_id_to_addr(entry->destination),
+                              node_id_to_addr(entry->gateway),
+                              entry->metric);
+}
+
+static void mark_installed(ip_routing_manager_t *mgr, ip_route_entry_t *entry,
+                           node_id_t gateway, uint32_t metric) {
+    if (entry->valid) {
+        mgr->route_updates++;
+    } else {
+        mgr->route_adds++;
+        mgr->num_routes++;
     }
     
-    return ret;
+    entry->gateway = gateway;
+    node_id_to_ip_str(gateway, entry->gateway_ip);
+    entry->metric = metric;
+    entry->valid = true;
+    entry->last_updated_ms = get_current_time_ms();
+    
+    // Octetos por valor: dest_ip/gateway_ip podem mudar antes de o log ser escrito
+    uint32_t dst = node_id_to_ipv4(entry->destination);
+    uint32_t gw = node_id_to_ipv4(gateway);
+    LOG_INFO("[IP-ROUTING] ✅ 192.168.%u.%u via 192.168.%u.%u (Node %d) metric %u\n",
+             (dst >> 8) & 0xFF, dst & 0xFF, (gw >> 8) & 0xFF, gw & 0xFF,
+             gateway, metric);
 }
 
-static int enable_ip_forwarding(void) {
-    return system("echo 1 > /proc/sys/net/ipv4/ip_forward 2>/dev/null");
+static void mark_removed(ip_routing_manager_t *mgr, ip_route_entry_t *entry) {
+    entry->valid = false;
+    entry->last_updated_ms = get_current_time_ms();
+    mgr->route_deletes++;
+    mgr->num_routes--;
+    
+    uint32_t dst = node_id_to_ipv4(entry->destination);
+    LOG_INFO("[IP-ROUTING] ❌ Deleted route to 192.168.%u.%u\n",
+             (dst >> 8) & 0xFF, dst & 0xFF);
 }
 
 // ========================================
@@ -80,104 +143,55 @@ int ip_routing_manager_add_route(ip_routing_manager_t *mgr,
         return 0;  // Don't route to self
     }
     
-    char dest_ip[16], gateway_ip[16];
-    node_id_to_ip_str(destination, dest_ip);
-    node_id_to_ip_str(gateway, gateway_ip);
-    
-    // Find or create entry
-    int idx = -1;
-    for (int i = 0; i < mgr->num_routes; i++) {
-        if (mgr->route_table[i].destination == destination) {
-            idx = i;
-            break;
-        }
+    ip_route_entry_t *entry = mirror_entry(mgr, destination);
+    if (!entry) {
+        fprintf(stderr, "[IP-ROUTING] Destination %d outside network\n", destination);
+        pthread_mutex_unlock(&mgr->lock);
+        return -1;
     }
     
-    if (idx == -1) {
-        if (mgr->num_routes >= MAX_ROUTES) {
-            fprintf(stderr, "[IP-ROUTING] Route table full!\n");
-            pthread_mutex_unlock(&mgr->lock);
-            return -1;
-        }
-        idx = mgr->num_routes++;
+    if (!entry_differs(entry, gateway, metric)) {
+        pthread_mutex_unlock(&mgr->lock);
+        return 0;  // No change needed
     }
     
-    // Check if route changed
-    bool changed = !mgr->route_table[idx].valid ||
-                   mgr->route_table[idx].gateway != gateway ||
-                   mgr->route_table[idx].metric != metric;
-    
-    if (changed) {
-        // Delete old route if exists
-        if (mgr->route_table[idx].valid) {
-            execute_route_command(mgr->interface_name,
-                                dest_ip,
-                                mgr->route_table[idx].gateway_ip,
-                                mgr->route_table[idx].metric,
-                                true);
-        }
-        
-        // Add new route
-        int ret = execute_route_command(mgr->interface_name,
-                                       dest_ip, gateway_ip, metric, false);
-        
-        if (ret == 0) {
-            mgr->route_table[idx].destination = destination;
-            mgr->route_table[idx].gateway = gateway;
-            strncpy(mgr->route_table[idx].dest_ip, dest_ip, sizeof(dest_ip));
-            strncpy(mgr->route_table[idx].gateway_ip, gateway_ip, sizeof(gateway_ip));
-            mgr->route_table[idx].metric = metric;
-            mgr->route_table[idx].valid = true;
-            mgr->route_table[idx].last_updated_ms = get_current_time_ms();
-            
-            if (idx == mgr->num_routes - 1) {
-                mgr->route_adds++;
-            } else {
-                mgr->route_updates++;
-            }
-            
-            printf("[IP-ROUTING] ✅ %s via %s (Node %d) metric %u\n",
-                   dest_ip, gateway_ip, gateway, metric);
-        } else {
-            mgr->route_errors++;
-            fprintf(stderr, "[IP-ROUTING] ❌ Failed to add route to %s\n", dest_ip);
-        }
-        
-        pthread_mutex_unlock(&mgr->lock);
-        return ret;
+    nl_route_batch_begin(&mgr->nl);
+    int replace_msg = stage_route(mgr, entry, gateway, metric);
+    
+    int results[2] = { -1, -1 };
+    int ret = -1;
+    if (replace_msg >= 0 && nl_route_batch_commit(&mgr->nl, results, 2) >= 0 &&
+        results[replace_msg] == 0) {
+        mark_installed(mgr, entry, gateway, metric);
+        ret = 0;
+    } else {
+        mgr->route_errors++;
+        fprintf(stderr, "[IP-ROUTING] ❌ Failed to add route to %s: %s\n",
+                entry->dest_ip, strerror(replace_msg >= 0 ? -results[replace_msg] : ENOMEM));
     }
     
     pthread_mutex_unlock(&mgr->lock);
-    return 0;  // No change needed
+    return ret;
 }
 
 int ip_routing_manager_delete_route(ip_routing_manager_t *mgr,
                                     node_id_t destination) {
     pthread_mutex_lock(&mgr->lock);
     
-    for (int i = 0; i < mgr->num_routes; i++) {
-        if (mgr->route_table[i].destination == destination &&
-            mgr->route_table[i].valid) {
-            
-            execute_route_command(mgr->interface_name,
-                                mgr->route_table[i].dest_ip,
-                                mgr->route_table[i].gateway_ip,
-                                mgr->route_table[i].metric,
-                                true);
-            
-            mgr->route_table[i].valid = false;
-            mgr->route_deletes++;
-            
-            printf("[IP-ROUTING] ❌ Deleted route to %s\n",
-                   mgr->route_table[i].dest_ip);
-            
-            pthread_mutex_unlock(&mgr->lock);
-            return 0;
-        }
+    ip_route_entry_t *entry = mirror_entry(mgr, destination);
+    if (!entry || !entry->valid) {
+        pthread_mutex_unlock(&mgr->lock);
+        return -1;
     }
     
+    nl_route_apply(&mgr->nl, NL_ROUTE_DELETE,
+                   node_id_to_addr(entry->destination),
+                   node_id_to_addr(entry->gateway),
+                   entry->metric);
+    mark_removed(mgr, entry);
+    
     pthread_mutex_unlock(&mgr->lock);
-    return -1;
+    return 0;
 }
 
 int ip_routing_manager_flush_all(ip_routing_manager_t *mgr) {
@@ -186,17 +200,17 @@ int ip_routing_manager_flush_all(ip_routing_manager_t *mgr) {
     printf("[IP-ROUTING] Flushing all routes...\n");
     int count = 0;
     
-    for (int i = 0; i < mgr->num_routes; i++) {
-        if (mgr->route_table[i].valid) {
-            execute_route_command(mgr->interface_name,
-                                mgr->route_table[i].dest_ip,
-                                mgr->route_table[i].gateway_ip,
-                                mgr->route_table[i].metric,
-                                true);
-            mgr->route_table[i].valid = false;
+    // Um único batch para todas as remoções
+    nl_route_batch_begin(&mgr->nl);
+    for (int dest = 1; dest < mgr->max_routes; dest++) {
+        ip_route_entry_t *entry = &mgr->route_table[dest];
+        if (entry->valid) {
+            stage_delete(mgr, entry);
+            entry->valid = false;
             count++;
         }
     }
+    nl_route_batch_commit(&mgr->nl, NULL, 0);
     
     mgr->num_routes = 0;
     
@@ -210,27 +224,154 @@ int ip_routing_manager_flush_all(ip_routing_manager_t *mgr) {
 
 int ip_routing_manager_update_from_routing(ip_routing_manager_t *mgr,
                                           routing_manager_t *routing_mgr) {
-    int updates = 0;
+    uint64_t start_us = get_current_time_us();
+    
+    // Cópia da tabela: não seguramos o lock do routing durante o netlink
+    routing_entry_t *table = NULL;
+    int num_entries = routing_manager_copy_table(routing_mgr, &table);
     
-    printf("[IP-ROUTING] Updating from routing table (version %lu)...\n",
-           routing_mgr->topology_version);
+    pthread_mutex_lock(&mgr->lock);
+    
+    // Estado desejado, indexado por destino como o mirror
+    ip_route_entry_t *desired = mgr->desired;
+    for (int dest = 0; dest < mgr->max_routes; dest++) {
+        desired[dest].valid = false;
+    }
     
-    for (int i = 0; i < routing_mgr->current_topology.num_nodes; i++) {
-        routing_entry_t *entry = &routing_mgr->routing_table[i];
+    for (int i = 0; i < num_entries; i++) {
+        routing_entry_t *entry = &table[i];
         
         if (entry->destination == mgr->my_node_id) continue;
-        if (!entry->valid || entry->next_hop == 0) continue;
+        if (!entry->valid || entry->next_hop == 0 ||
+            entry->next_hop == NODE_ID_INVALID) continue;
+        if (entry->destination == 0 || entry->destination >= mgr->max_routes) continue;
         
-        uint32_t metric = entry->distance;
+        ip_route_entry_t *want = &desired[entry->destination];
+        want->gateway = entry->next_hop;
+        want->metric = entry->distance;
+        want->valid = true;
+    }
+    free(table);
+    
+    // Diff mínimo contra o mirror: só as rotas que mudaram vão ao kernel
+    int num_changes = 0;
+    nl_route_batch_begin(&mgr->nl);
+    
+    for (int dest = 1; dest < mgr->max_routes; dest++) {
+        ip_route_entry_t *have = &mgr->route_table[dest];
+        ip_route_entry_t *want = &desired[dest];
+        int msg;
+        
+        if (want->valid) {
+            if (!entry_differs(have, want->gateway, want->metric)) continue;
+            msg = stage_route(mgr, have, want->gateway, want->metric);
+        } else if (have->valid) {
+            msg = stage_delete(mgr, have);
+        } else {
+            continue;
+        }
+        
+        if (msg < 0) {
+            mgr->route_errors++;
+            continue;
+        }
         
-        if (ip_routing_manager_add_route(mgr, entry->destination,
-                                        entry->next_hop, metric) == 0) {
-            updates++;
+        mgr->changes[num_changes].destination = dest;
+        mgr->changes[num_changes].msg = msg;
+        num_changes++;
+    }
+    
+    int failed = nl_route_batch_commit(&mgr->nl, mgr->results, 2 * mgr->max_routes);
+    
+    int applied = 0;
+    for (int c = 0; c < num_changes; c++) {
+        ip_route_change_t *change = &mgr->changes[c];
+        ip_route_entry_t *have = &mgr->route_table[change->destination];
+        ip_route_entry_t *want = &desired[change->destination];
+        int result = failed >= 0 ? mgr->results[change->msg] : -EIO;
+        
+        if (want->valid) {
+            if (result == 0) {
+                mark_installed(mgr, have, want->gateway, want->metric);
+                applied++;
+            } else {
+                mgr->route_errors++;
+                fprintf(stderr, "[IP-ROUTING] ❌ Failed to add route to %s: %s\n",
+                        have->dest_ip, strerror(-result));
+            }
+        } else {
+            // ESRCH: já não estava no kernel, o mirror fica coerente na mesma
+            if (result == 0 || result == -ESRCH) {
+                mark_removed(mgr, have);
+                applied++;
+            } else {
+                mgr->route_errors++;
+            }
         }
     }
     
-    printf("[IP-ROUTING] Updated %d routes\n", updates);
-    return updates;
+    mgr->syncs++;
+    mgr->last_sync_changes = num_changes;
+    mgr->total_sync_changes += num_changes;
+    mgr->last_sync_us = get_current_time_us() - start_us;
+    mgr->total_sync_us += mgr->last_sync_us;
+    
+    pthread_mutex_unlock(&mgr->lock);
+    
+    if (num_changes > 0) {
+        LOG_INFO("[IP-ROUTING] Synced version %lu: %d/%d changes applied in %lu us\n",
+                 routing_mgr->topology_version, applied, num_changes, mgr->last_sync_us);
+    }
+    return applied;
+}
+
+// Callback do dump: adota rotas nossas que ficaram no kernel
+static void reconcile_route(const nl_route_info_t *route, void *ctx) {
+    ip_routing_manager_t *mgr = ctx;
+    
+    if (route->ifindex != mgr->nl.ifindex || route->protocol != NL_ROUTE_PROTO ||
+        route->dst_len != 32) {
+        return;
+    }
+    
+    node_id_t dest = addr_to_node_id(route->dst);
+    node_id_t gateway = route->gateway ? addr_to_node_id(route->gateway) : dest;
+    ip_route_entry_t *entry = mirror_entry(mgr, dest);
+    
+    if (entry && dest != mgr->my_node_id && !entry->valid &&
+        gateway != NODE_ID_INVALID) {
+        entry->gateway = gateway;
+        node_id_to_ip_str(gateway, entry->gateway_ip);
+        entry->metric = route->metric;
+        entry->valid = true;
+        entry->last_updated_ms = get_current_time_ms();
+        mgr->num_routes++;
+        mgr->routes_adopted++;
+    } else {
+        // Duplicada ou fora da rede: remove no fim do dump
+        nl_route_batch_add(&mgr->nl, NL_ROUTE_DELETE, route->dst,
+                           route->gateway, route->metric);
+        mgr->route_deletes++;
+    }
+}
+
+int ip_routing_manager_reconcile(ip_routing_manager_t *mgr) {
+    pthread_mutex_lock(&mgr->lock);
+    
+    uint32_t deletes_before = mgr->route_deletes;
+    nl_route_batch_begin(&mgr->nl);
+    
+    if (nl_route_dump(&mgr->nl, reconcile_route, mgr) < 0) {
+        pthread_mutex_unlock(&mgr->lock);
+        return -1;
+    }
+    nl_route_batch_commit(&mgr->nl, NULL, 0);
+    
+    printf("[IP-ROUTING] Reconciled with kernel: %u adopted, %u stale removed\n",
+           mgr->routes_adopted, mgr->route_deletes - deletes_before);
+    
+    pthread_mutex_unlock(&mgr->lock);
+    return mgr->routes_adopted;
 }
 
 // ========================================
@@ -242,13 +383,43 @@ int ip_routing_manager_init(ip_routing_manager_t *mgr,
                             const char *interface,
                             int total_nodes) {
     memset(mgr, 0, sizeof(ip_routing_manager_t));
+    mgr->nl.fd = -1;
     
     mgr->my_node_id = my_id;
     mgr->num_nodes = total_nodes;
     strncpy(mgr->interface_name, interface, IFNAMSIZ - 1);
     
+    // Mirror e estado desejado indexados por node_id (0 não usado)
+    mgr->max_routes = total_nodes + 1;
+    mgr->route_table = calloc(mgr->max_routes, sizeof(ip_route_entry_t));
+    mgr->desired = calloc(mgr->max_routes, sizeof(ip_route_entry_t));
+    mgr->changes = calloc(mgr->max_routes, sizeof(ip_route_change_t));
+    mgr->results = calloc(2 * mgr->max_routes, sizeof(int));
+    if (!mgr->route_table || !mgr->desired || !mgr->changes || !mgr->results) {
+        fprintf(stderr, "[IP-ROUTING] Out of memory for %d routes\n", total_nodes);
+        free(mgr->route_table);
+        free(mgr->desired);
+        free(mgr->changes);
+        free(mgr->results);
+        mgr->route_table = NULL;
+        mgr->desired = NULL;
+        mgr->changes = NULL;
+        mgr->results = NULL;
+        return -1;
+    }
+    
+    for (int dest = 1; dest < mgr->max_routes; dest++) {
+        mgr->route_table[dest].destination = dest;
+        node_id_to_ip_str(dest, mgr->route_table[dest].dest_ip);
+    }
+    
     pthread_mutex_init(&mgr->lock, NULL);
     
+    // Socket rtnetlink único para todas as rotas
+    if (nl_route_open(&mgr->nl, mgr->interface_name) < 0) {
+        fprintf(stderr, "[IP-ROUTING] Warning: netlink unavailable, routes disabled\n");
+    }
+    
     // Enable IP forwarding
     if (enable_ip_forwarding() != 0) {
         fprintf(stderr, "[IP-ROUTING] Warning: Could not enable IP forwarding\n");
@@ -267,7 +438,18 @@ int ip_routing_manager_init(ip_routing_manager_t *mgr,
 void ip_routing_manager_destroy(ip_routing_manager_t *mgr) {
     printf("[IP-ROUTING] Destroying...\n");
     ip_routing_manager_flush_all(mgr);
+    nl_route_close(&mgr->nl);
     pthread_mutex_destroy(&mgr->lock);
+    
+    free(mgr->route_table);
+    free(mgr->desired);
+    free(mgr->changes);
+    free(mgr->results);
+    mgr->route_table = NULL;
+    mgr->desired = NULL;
+    mgr->changes = NULL;
+    mgr->results = NULL;
+    mgr->max_routes = 0;
 }
 
 // ========================================
@@ -284,10 +466,10 @@ void ip_routing_manager_print_table(ip_routing_manager_t *mgr) {
     printf("Destination     | Gateway        | Metric | Status\n");
     printf("----------------|----------------|--------|--------\n");
     
-    for (int i = 0; i < mgr->num_routes; i++) {
-        if (!mgr->route_table[i].valid) continue;
+    for (int dest = 1; dest < mgr->max_routes; dest++) {
+        if (!mgr->route_table[dest].valid) continue;
         
-        ip_route_entry_t *entry = &mgr->route_table[i];
+        ip_route_entry_t *entry = &mgr->route_table[dest];
         
         printf("%-15s | %-14s | %-6u | ACTIVE\n",
                entry->dest_ip,
@@ -308,16 +490,37 @@ void ip_routing_manager_print_stats(ip_routing_manager_t *mgr) {
     printf("Deletes: %u\n", mgr->route_deletes);
     printf("Errors:  %u\n", mgr->route_errors);
     printf("Active:  %d routes\n", mgr->num_routes);
+    if (mgr->syncs > 0) {
+        printf("Syncs:   %lu (%.1f changes, %.1f us avg | last %u changes, %lu us)\n",
+               mgr->syncs,
+               (double)mgr->total_sync_changes / mgr->syncs,
+               (double)mgr->total_sync_us / mgr->syncs,
+               mgr->last_sync_changes, mgr->last_sync_us);
+    }
+    nl_route_print_stats(&mgr->nl);
     
     pthread_mutex_unlock(&mgr->lock);
 }
 
+static void print_kernel_route(const nl_route_info_t *route, void *ctx) {
+    const ip_routing_manager_t *mgr = ctx;
+    if (route->ifindex != mgr->nl.ifindex) return;
+    
+    char dst[INET_ADDRSTRLEN], gw[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &route->dst, dst, sizeof(dst));
+    inet_ntop(AF_INET, &route->gateway, gw, sizeof(gw));
+    
+    printf("%s/%u via %s metric %u%s\n", dst, route->dst_len,
+           route->gateway ? gw : "-", route->metric,
+           route->protocol == NL_ROUTE_PROTO ? " (tdma)" : "");
+}
+
 void ip_routing_manager_print_kernel_routes(ip_routing_manager_t *mgr) {
     printf("\n=== Kernel Routing Table ===\n");
     
-    char cmd[256];
-    snprintf(cmd, sizeof(cmd), "ip route show dev %s", mgr->interface_name);
-    system(cmd);
+    pthread_mutex_lock(&mgr->lock);
+    nl_route_dump(&mgr->nl, print_kernel_route, mgr);
+    pthread_mutex_unlock(&mgr->lock);
     
     printf("\n");
-}
\ No newline at end of file
+}
@@ -0,0 +1,110 @@
+// src/network/latency_histogram.c
+#include "latency_histogram.h"
+#include <string.h>
+#include <math.h>
+
+// ========================================
+// Bucket Index
+// ========================================
+
+static uint32_t bucket_of(uint64_t value) {
+    if (value < 2 * LATENCY_HIST_SUB_COUNT) {
+        return (uint32_t)value;
+    }
+    
+    // Potência de 2 → linha; os LATENCY_HIST_SUB_BITS bits seguintes → coluna
+    uint32_t msb = 63 - __builtin_clzll(value);
+    uint32_t shift = msb - LATENCY_HIST_SUB_BITS;
+    uint32_t top = (uint32_t)(value >> shift);
+    
+    return (shift + 1) * LATENCY_HIST_SUB_COUNT + (top - LATENCY_HIST_SUB_COUNT);
+}
+
+// Maior valor que cai no bucket
+static uint64_t bucket_upper(uint32_t index) {
+    if (index < 2 * LATENCY_HIST_SUB_COUNT) {
+        return index;
+    }
+    
+    uint32_t shift = index / LATENCY_HIST_SUB_COUNT - 1;
+    uint64_t top = index % LATENCY_HIST_SUB_COUNT + LATENCY_HIST_SUB_COUNT;
+    return ((top + 1) << shift) - 1;
+}
+
+// ========================================
+// API
+// ========================================
+
+void latency_hist_reset(latency_hist_t *hist) {
+    memset(hist, 0, sizeof(latency_hist_t));
+}
+
+void latency_hist_record(latency_hist_t *hist, uint64_t value_us) {
+    if (value_us > LATENCY_HIST_MAX_US) value_us = LATENCY_HIST_MAX_US;
+    
+    hist->counts[bucket_of(value_us)]++;
+    hist->sum_us += value_us;
+    if (hist->total == 0 || value_us < hist->min_us) hist->min_us = value_us;
+    if (value_us > hist->max_us) hist->max_us = value_us;
+    hist->total++;
+}
+
+void latency_hist_merge(latency_hist_t *dst, const latency_hist_t *src) {
+    if (src->total == 0) return;
+    
+    for (uint32_t i = 0; i < LATENCY_HIST_BUCKETS; i++) {
+        dst->counts[i] += src->counts[i];
+    }
+    if (dst->total == 0 || src->min_us < dst->min_us) dst->min_us = src->min_us;
+    if (src->max_us > dst->max_us) dst->max_us = src->max_us;
+    dst->sum_us += src->sum_us;
+    dst->total += src->total;
+}
+
+uint64_t latency_hist_percentile(const latency_hist_t *hist, double pct) {
+    if (hist->total == 0) return 0;
+    
+    uint64_t rank = (uint64_t)ceil(hist->total * pct / 100.0);
+    if (rank == 0) rank = 1;
+    
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < LATENCY_HIST_BUCKETS; i++) {
+        seen += hist->counts[i];
+        if (seen >= rank) {
+            uint64_t upper = bucket_upper(i);
+            return upper < hist->max_us ? upper : hist->max_us;
+        }
+    }
+    return hist->max_us;
+}
+
+double latency_hist_mean_us(const latency_hist_t *hist) {
+    return hist->total > 0 ? (double)hist->sum_us / hist->total : 0;
+}
+
+void latency_hist_print(const latency_hist_t *hist, const char *label) {
+    printf("   %-14s %6lu samples | p50 %.2f | p90 %.2f | p99 %.2f | p99.9 %.2f | max %.2f ms\n",
+           label, hist->total,
+           latency_hist_percentile(hist, 50) / 1000.0,
+           latency_hist_percentile(hist, 90) / 1000.0,
+           latency_hist_percentile(hist, 99) / 1000.0,
+           latency_hist_percentile(hist, 99.9) / 1000.0,
+           hist->max_us / 1000.0);
+}
+
+void latency_hist_csv_header(FILE *fp) {
+    fprintf(fp, "scope,key,samples,mean_ms,min_ms,p50_ms,p90_ms,p99_ms,p999_ms,max_ms\n");
+}
+
+void latency_hist_csv_row(FILE *fp, const char *scope, long key,
+                          const latency_hist_t *hist) {
+    fprintf(fp, "%s,%ld,%lu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+            scope, key, hist->total,
+            latency_hist_mean_us(hist) / 1000.0,
+            hist->min_us / 1000.0,
+            latency_hist_percentile(hist, 50) / 1000.0,
+            latency_hist_percentile(hist, 90) / 1000.0,
+            latency_hist_percentile(hist, 99) / 1000.0,
+            latency_hist_percentile(hist, 99.9) / 1000.0,
+            hist->max_us / 1000.0);
+}
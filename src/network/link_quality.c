@@ -0,0 +1,299 @@
+// src/network/link_quality.c
+#include "link_quality.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// ========================================
+// Helper Functions
+// ========================================
+
+static inline uint64_t window_mask(uint8_t span) {
+    return span >= 64 ? ~0ULL : (1ULL << span) - 1;
+}
+
+static inline uint8_t received_in_window(const lq_neighbor_t *nb) {
+    return (uint8_t)__builtin_popcountll(nb->rx_bits & window_mask(nb->span));
+}
+
+static lq_neighbor_t *neighbor_of(link_quality_t *lq, node_id_t id) {
+    if (id < 1 || id > lq->num_nodes || id == lq->my_id) return NULL;
+    return &lq->neighbors[id - 1];
+}
+
+// Primeira receção (ou regresso depois de uma janela em silêncio)
+static void neighbor_reset(lq_neighbor_t *nb, uint32_t seq) {
+    nb->rx_bits = 1;
+    nb->last_seq = seq;
+    nb->span = 1;
+    nb->silent_rounds = 0;
+    nb->known = true;
+    nb->tx_received = 0;
+    nb->tx_window = 0;
+}
+
+static void neighbor_forget(lq_neighbor_t *nb) {
+    nb->rx_bits = 0;
+    nb->span = 0;
+    nb->silent_rounds = LQ_WINDOW_ROUNDS;
+    nb->known = false;
+    nb->tx_received = 0;
+    nb->tx_window = 0;
+}
+
+static double inbound_ratio(const lq_neighbor_t *nb) {
+    return nb->span ? (double)received_in_window(nb) / nb->span : 0.0;
+}
+
+// Sem relatório ainda: assume o link simétrico
+static double outbound_ratio(const lq_neighbor_t *nb) {
+    return nb->tx_window ? (double)nb->tx_received / nb->tx_window : inbound_ratio(nb);
+}
+
+// ========================================
+// Lifecycle
+// ========================================
+
+int link_quality_init(link_quality_t *lq, node_id_t my_id, uint32_t num_nodes) {
+    memset(lq, 0, sizeof(link_quality_t));
+    
+    lq->neighbors = calloc(num_nodes ? num_nodes : 1, sizeof(lq_neighbor_t));
+    if (!lq->neighbors) return -1;
+    
+    lq->my_id = my_id;
+    lq->num_nodes = num_nodes;
+    pthread_mutex_init(&lq->lock, NULL);
+    return 0;
+}
+
+void link_quality_destroy(link_quality_t *lq) {
+    if (!lq->neighbors) return;
+    
+    pthread_mutex_destroy(&lq->lock);
+    free(lq->neighbors);
+    lq->neighbors = NULL;
+}
+
+// ========================================
+// Heartbeats
+// ========================================
+
+int link_quality_build_heartbeat(link_quality_t *lq, uint8_t *buf, size_t cap) {
+    if (cap < sizeof(lq_heartbeat_t)) return -1;
+    
+    uint32_t max_reports = (cap - sizeof(lq_heartbeat_t)) / sizeof(lq_report_t);
+    if (max_reports > LQ_MAX_REPORTS) max_reports = LQ_MAX_REPORTS;
+    
+    lq_heartbeat_t hdr = { 0 };
+    uint8_t *out = buf + sizeof(lq_heartbeat_t);
+    uint32_t n = lq->num_nodes;
+    uint32_t visited = 0;
+    
+    pthread_mutex_lock(&lq->lock);
+    
+    hdr.seq = lq->seq++;
+    
+    for (; visited < n; visited++) {
+        uint32_t i = (lq->report_cursor + visited) % n;
+        lq_neighbor_t *nb = &lq->neighbors[i];
+        
+        if (!nb->known) continue;
+        if (hdr.num_reports == max_reports) break;
+        
+        lq_report_t report = {
+            .node = (node_id_t)(i + 1),
+            .received = received_in_window(nb),
+            .window = nb->span
+        };
+        memcpy(out, &report, sizeof(report));
+        out += sizeof(report);
+        hdr.num_reports++;
+    }
+    
+    if (visited == n) {
+        hdr.flags |= LQ_FLAG_COMPLETE;
+    } else {
+        lq->report_cursor = (lq->report_cursor + visited) % n;
+    }
+    
+    pthread_mutex_unlock(&lq->lock);
+    
+    memcpy(buf, &hdr, sizeof(hdr));
+    return (int)(out - buf);
+}
+
+int link_quality_on_heartbeat(link_quality_t *lq, node_id_t src,
+                              const uint8_t *payload, int len) {
+    lq_neighbor_t *nb = neighbor_of(lq, src);
+    if (!nb) return -1;
+    
+    lq_heartbeat_t hdr;
+    if (len < (int)sizeof(hdr)) {
+        __atomic_fetch_add(&lq->malformed, 1, __ATOMIC_RELAXED);
+        return -1;
+    }
+    memcpy(&hdr, payload, sizeof(hdr));
+    
+    if ((size_t)len < sizeof(hdr) + (size_t)hdr.num_reports * sizeof(lq_report_t)) {
+        __atomic_fetch_add(&lq->malformed, 1, __ATOMIC_RELAXED);
+        return -1;
+    }
+    
+    // O que o emissor diz de mim (procurado antes de tomar o lock)
+    const uint8_t *reports = payload + sizeof(hdr);
+    lq_report_t mine = { 0 };
+    bool reported = false;
+    
+    for (uint16_t r = 0; r < hdr.num_reports; r++) {
+        lq_report_t report;
+        memcpy(&report, reports + r * sizeof(report), sizeof(report));
+        if (report.node == lq->my_id) {
+            mine = report;
+            reported = true;
+            break;
+        }
+    }
+    
+    pthread_mutex_lock(&lq->lock);
+    
+    if (!nb->known || (hdr.seq < nb->last_seq &&
+                       nb->last_seq - hdr.seq >= LQ_WINDOW_ROUNDS)) {
+        neighbor_reset(nb, hdr.seq);              // Novo ou reiniciado
+    } else if (hdr.seq > nb->last_seq) {
+        uint32_t shift = hdr.seq - nb->last_seq;
+        nb->rx_bits = shift >= 64 ? 0 : nb->rx_bits << shift;
+        nb->rx_bits |= 1;
+        nb->span = (uint8_t)(nb->span + shift >= LQ_WINDOW_ROUNDS ?
+                             LQ_WINDOW_ROUNDS : nb->span + shift);
+        nb->last_seq = hdr.seq;
+    } else {
+        // Atrasado: a ronda dele já tinha sido dada como perdida
+        nb->rx_bits |= 1ULL << (nb->last_seq - hdr.seq);
+    }
+    nb->heard = true;
+    
+    if (reported && mine.window > 0) {
+        nb->tx_received = mine.received <= mine.window ? mine.received : mine.window;
+        nb->tx_window = mine.window;
+    } else if ((hdr.flags & LQ_FLAG_COMPLETE) &&
+               (nb->tx_window > 0 || nb->span >= LQ_WINDOW_ROUNDS)) {
+        // Relatório completo sem mim: não me ouviu numa janela inteira
+        nb->tx_received = 0;
+        nb->tx_window = LQ_WINDOW_ROUNDS;
+    }
+    
+    lq->heartbeats_parsed++;
+    pthread_mutex_unlock(&lq->lock);
+    return 0;
+}
+
+void link_quality_on_round(link_quality_t *lq) {
+    pthread_mutex_lock(&lq->lock);
+    
+    for (uint32_t i = 0; i < lq->num_nodes; i++) {
+        lq_neighbor_t *nb = &lq->neighbors[i];
+        
+        if (i + 1 == lq->my_id) continue;
+        
+        if (!nb->known) {
+            if (nb->silent_rounds < LQ_WINDOW_ROUNDS) nb->silent_rounds++;
+            continue;
+        }
+        
+        // O heartbeat desta ronda não chegou: a sequência esperada avança na mesma
+        if (!nb->heard) {
+            nb->last_seq++;
+            nb->rx_bits <<= 1;
+            if (nb->span < LQ_WINDOW_ROUNDS) nb->span++;
+            
+            if ((nb->rx_bits & window_mask(nb->span)) == 0) {
+                neighbor_forget(nb);
+            }
+        }
+        nb->heard = false;
+    }
+    
+    pthread_mutex_unlock(&lq->lock);
+}
+
+// ========================================
+// Metrics
+// ========================================
+
+bool link_quality_known(link_quality_t *lq, node_id_t neighbor) {
+    lq_neighbor_t *nb = neighbor_of(lq, neighbor);
+    if (!nb) return false;
+    
+    pthread_mutex_lock(&lq->lock);
+    bool known = nb->known;
+    pthread_mutex_unlock(&lq->lock);
+    return known;
+}
+
+double link_quality_delivery(link_quality_t *lq, node_id_t neighbor, bool inbound) {
+    lq_neighbor_t *nb = neighbor_of(lq, neighbor);
+    if (!nb) return 0.0;
+    
+    pthread_mutex_lock(&lq->lock);
+    double ratio = inbound ? inbound_ratio(nb) : outbound_ratio(nb);
+    pthread_mutex_unlock(&lq->lock);
+    return ratio;
+}
+
+uint16_t link_quality_weight(link_quality_t *lq, node_id_t neighbor) {
+    lq_neighbor_t *nb = neighbor_of(lq, neighbor);
+    if (!nb) return 0;
+    
+    pthread_mutex_lock(&lq->lock);
+    
+    uint16_t weight;
+    if (!nb->known) {
+        weight = nb->silent_rounds >= LQ_WINDOW_ROUNDS ? 0 : LQ_ETX_SCALE;
+    } else {
+        double delivery = inbound_ratio(nb) * outbound_ratio(nb);
+        
+        if (delivery * LQ_MAX_ETX < 1.0) {
+            weight = 0;
+        } else {
+            weight = (uint16_t)lround(LQ_ETX_SCALE / delivery);
+        }
+    }
+    
+    pthread_mutex_unlock(&lq->lock);
+    return weight;
+}
+
+bool link_quality_significant(uint16_t old_weight, uint16_t new_weight) {
+    if (old_weight == new_weight) return false;
+    if (old_weight == 0 || new_weight == 0) return true;
+    
+    uint32_t diff = old_weight > new_weight ? old_weight - new_weight
+                                            : new_weight - old_weight;
+    return diff * 100 >= (uint32_t)old_weight * LQ_HYSTERESIS_PERCENT;
+}
+
+void link_quality_print(link_quality_t *lq) {
+    printf("\n=== Link Quality (Node %d, window %d rounds) ===\n",
+           lq->my_id, LQ_WINDOW_ROUNDS);
+    printf("Neighbor | In     | Out    | ETX\n");
+    printf("---------|--------|--------|------\n");
+    
+    for (uint32_t i = 0; i < lq->num_nodes; i++) {
+        node_id_t id = (node_id_t)(i + 1);
+        if (id == lq->my_id || !lq->neighbors[i].known) continue;
+        
+        uint16_t weight = link_quality_weight(lq, id);
+        printf("  %5d  | %5.1f%% | %5.1f%% | ", id,
+               link_quality_delivery(lq, id, true) * 100.0,
+               link_quality_delivery(lq, id, false) * 100.0);
+        if (weight) {
+            printf("%.1f\n", (double)weight / LQ_ETX_SCALE);
+        } else {
+            printf("down\n");
+        }
+    }
+    
+    printf("Heartbeats parsed: %lu (malformed: %lu)\n",
+           lq->heartbeats_parsed, lq->malformed);
+}
@@ -0,0 +1,335 @@
+// src/network/link_state.c
+#include "link_state.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ========================================
+// Helper Functions
+// ========================================
+
+static int compare_neighbor(const void *a, const void *b) {
+    const lsa_link_t *la = a;
+    const lsa_link_t *lb = b;
+    return (int)la->neighbor - (int)lb->neighbor;
+}
+
+// Melhores links primeiro (empates pelo ID, para ser determinístico)
+static int compare_weight(const void *a, const void *b) {
+    const lsa_link_t *la = a;
+    const lsa_link_t *lb = b;
+    if (la->weight != lb->weight) return (int)la->weight - (int)lb->weight;
+    return compare_neighbor(a, b);
+}
+
+static ls_entry_t *entry_of(link_state_t *ls, node_id_t id) {
+    if (id < 1 || id > ls->num_nodes) return NULL;
+    return &ls->entries[id - 1];
+}
+
+// Copia 'links' (já ordenados) para a entrada
+static int entry_store(ls_entry_t *entry, const lsa_link_t *links, uint16_t num_links) {
+    if (num_links > entry->capacity) {
+        lsa_link_t *grown = realloc(entry->links, num_links * sizeof(lsa_link_t));
+        if (!grown) return -1;
+        entry->links = grown;
+        entry->capacity = num_links;
+    }
+    
+    if (num_links > 0) {
+        memcpy(entry->links, links, num_links * sizeof(lsa_link_t));
+    }
+    entry->num_links = num_links;
+    return 0;
+}
+
+static bool entry_same_links(const ls_entry_t *entry, const lsa_link_t *links,
+                             uint16_t num_links) {
+    return entry->num_links == num_links &&
+           (num_links == 0 ||
+            memcmp(entry->links, links, num_links * sizeof(lsa_link_t)) == 0);
+}
+
+// Peso que 'entry' anuncia para 'neighbor' (0 se não o anuncia)
+static uint16_t entry_weight(const ls_entry_t *entry, node_id_t neighbor) {
+    lsa_link_t key = { .neighbor = neighbor };
+    const lsa_link_t *link = bsearch(&key, entry->links, entry->num_links,
+                                     sizeof(lsa_link_t), compare_neighbor);
+    return link ? link->weight : 0;
+}
+
+// ========================================
+// Lifecycle
+// ========================================
+
+int link_state_init(link_state_t *ls, node_id_t my_id, uint32_t num_nodes) {
+    memset(ls, 0, sizeof(link_state_t));
+    
+    ls->entries = calloc(num_nodes ? num_nodes : 1, sizeof(ls_entry_t));
+    if (!ls->entries) return -1;
+    
+    ls->my_id = my_id;
+    ls->num_nodes = num_nodes;
+    pthread_mutex_init(&ls->lock, NULL);
+    return 0;
+}
+
+void link_state_destroy(link_state_t *ls) {
+    if (!ls->entries) return;
+    
+    for (uint32_t i = 0; i < ls->num_nodes; i++) {
+        free(ls->entries[i].links);
+    }
+    pthread_mutex_destroy(&ls->lock);
+    free(ls->entries);
+    ls->entries = NULL;
+}
+
+// ========================================
+// Origination / Flooding
+// ========================================
+
+bool link_state_update_local(link_state_t *ls, const lsa_link_t *links,
+                             uint32_t num_links) {
+    ls_entry_t *mine = entry_of(ls, ls->my_id);
+    if (!mine) return false;
+    
+    lsa_link_t *sorted = malloc((num_links ? num_links : 1) * sizeof(lsa_link_t));
+    if (!sorted) return false;
+    if (num_links > 0) memcpy(sorted, links, num_links * sizeof(lsa_link_t));
+    
+    // Não cabe num pacote: ficam os melhores links
+    if (num_links > LS_MAX_LINKS) {
+        qsort(sorted, num_links, sizeof(lsa_link_t), compare_weight);
+        num_links = LS_MAX_LINKS;
+    }
+    qsort(sorted, num_links, sizeof(lsa_link_t), compare_neighbor);
+    
+    pthread_mutex_lock(&ls->lock);
+    
+    bool originate = !mine->valid ||
+                     ls->rounds_since_originate >= LS_REFRESH_ROUNDS ||
+                     !entry_same_links(mine, sorted, (uint16_t)num_links);
+    
+    if (originate && entry_store(mine, sorted, (uint16_t)num_links) == 0) {
+        mine->seq++;
+        mine->valid = true;
+        mine->flood_pending = true;
+        mine->age_rounds = 0;
+        ls->rounds_since_originate = 0;
+        ls->originated++;
+    } else {
+        originate = false;
+    }
+    
+    pthread_mutex_unlock(&ls->lock);
+    free(sorted);
+    return originate;
+}
+
+int link_state_on_lsa(link_state_t *ls, const uint8_t *payload, int len) {
+    lsa_header_t hdr;
+    
+    if (len < (int)sizeof(hdr)) {
+        __atomic_fetch_add(&ls->malformed, 1, __ATOMIC_RELAXED);
+        return -1;
+    }
+    memcpy(&hdr, payload, sizeof(hdr));
+    
+    ls_entry_t *entry = entry_of(ls, hdr.origin);
+    if (!entry || hdr.num_links > LS_MAX_LINKS ||
+        (size_t)len < sizeof(hdr) + (size_t)hdr.num_links * sizeof(lsa_link_t)) {
+        __atomic_fetch_add(&ls->malformed, 1, __ATOMIC_RELAXED);
+        return -1;
+    }
+    
+    // Links validados e ordenados antes de tomar o lock
+    lsa_link_t links[LS_MAX_LINKS];
+    memcpy(links, payload + sizeof(hdr), hdr.num_links * sizeof(lsa_link_t));
+    
+    for (uint16_t i = 0; i < hdr.num_links; i++) {
+        if (links[i].weight == 0 || links[i].neighbor == hdr.origin ||
+            !entry_of(ls, links[i].neighbor)) {
+            __atomic_fetch_add(&ls->malformed, 1, __ATOMIC_RELAXED);
+            return -1;
+        }
+    }
+    qsort(links, hdr.num_links, sizeof(lsa_link_t), compare_neighbor);
+    
+    pthread_mutex_lock(&ls->lock);
+    
+    int ret = 0;
+    
+    if (hdr.origin == ls->my_id) {
+        // O eco do meu LSA atual volta sempre dos vizinhos e não conta.
+        // Uma sequência maior, ou igual com outros links, é de antes de um
+        // reinício: a próxima origem salta por cima dela.
+        if (hdr.seq > entry->seq ||
+            (hdr.seq == entry->seq && !entry_same_links(entry, links, hdr.num_links))) {
+            entry->seq = hdr.seq;
+            ls->rounds_since_originate = LS_REFRESH_ROUNDS;
+        }
+        ls->duplicates++;
+    } else if (!entry->valid || hdr.seq > entry->seq) {
+        bool same = entry->valid && entry_same_links(entry, links, hdr.num_links);
+        
+        if (entry_store(entry, links, hdr.num_links) == 0) {
+            entry->seq = hdr.seq;
+            entry->valid = true;
+            entry->age_rounds = 0;
+            entry->flood_pending = true;
+            entry->changed |= !same;          // Um refresh não mexe na topologia
+            ls->installed++;
+            ret = 1;
+        }
+    } else {
+        // Quem o enviou tem uma cópia mais antiga: devolve-lhe a nossa
+        if (hdr.seq < entry->seq) entry->flood_pending = true;
+        ls->duplicates++;
+    }
+    
+    pthread_mutex_unlock(&ls->lock);
+    return ret;
+}
+
+int link_state_next_flood(link_state_t *ls, uint8_t *buf, size_t cap) {
+    int written = 0;
+    
+    pthread_mutex_lock(&ls->lock);
+    
+    for (uint32_t visited = 0; visited < ls->num_nodes; visited++) {
+        uint32_t i = (ls->flood_cursor + visited) % ls->num_nodes;
+        ls_entry_t *entry = &ls->entries[i];
+        
+        if (!entry->flood_pending) continue;
+        if (!entry->valid) {
+            entry->flood_pending = false;
+            continue;
+        }
+        
+        size_t len = sizeof(lsa_header_t) + entry->num_links * sizeof(lsa_link_t);
+        if (len > cap) {
+            written = -1;
+            break;
+        }
+        
+        lsa_header_t hdr = {
+            .origin = (node_id_t)(i + 1),
+            .num_links = entry->num_links,
+            .seq = entry->seq
+        };
+        memcpy(buf, &hdr, sizeof(hdr));
+        memcpy(buf + sizeof(hdr), entry->links, entry->num_links * sizeof(lsa_link_t));
+        
+        entry->flood_pending = false;
+        ls->flood_cursor = (i + 1) % ls->num_nodes;
+        ls->flooded++;
+        written = (int)len;
+        break;
+    }
+    
+    pthread_mutex_unlock(&ls->lock);
+    return written;
+}
+
+void link_state_on_round(link_state_t *ls) {
+    pthread_mutex_lock(&ls->lock);
+    
+    if (ls->rounds_since_originate < LS_REFRESH_ROUNDS) {
+        ls->rounds_since_originate++;
+    }
+    
+    for (uint32_t i = 0; i < ls->num_nodes; i++) {
+        ls_entry_t *entry = &ls->entries[i];
+        
+        if (!entry->valid || i + 1 == ls->my_id) continue;
+        
+        // A origem deixou de fazer refresh: morta ou isolada
+        if (++entry->age_rounds >= LS_MAX_AGE_ROUNDS) {
+            entry->valid = false;
+            entry->num_links = 0;
+            entry->seq = 0;
+            entry->flood_pending = false;
+            entry->changed = true;
+            ls->expired++;
+        }
+    }
+    
+    pthread_mutex_unlock(&ls->lock);
+}
+
+// ========================================
+// Topology
+// ========================================
+
+node_id_t link_state_next_changed(link_state_t *ls) {
+    node_id_t origin = 0;
+    
+    pthread_mutex_lock(&ls->lock);
+    
+    for (uint32_t visited = 0; visited < ls->num_nodes; visited++) {
+        uint32_t i = (ls->change_cursor + visited) % ls->num_nodes;
+        ls_entry_t *entry = &ls->entries[i];
+        
+        if (!entry->changed) continue;
+        entry->changed = false;
+        if (i + 1 == ls->my_id) continue;
+        
+        origin = (node_id_t)(i + 1);
+        ls->change_cursor = (i + 1) % ls->num_nodes;
+        break;
+    }
+    
+    pthread_mutex_unlock(&ls->lock);
+    return origin;
+}
+
+uint16_t link_state_link_weight(link_state_t *ls, node_id_t a, node_id_t b) {
+    ls_entry_t *ea = entry_of(ls, a);
+    ls_entry_t *eb = entry_of(ls, b);
+    if (!ea || !eb || a == b) return 0;
+    
+    pthread_mutex_lock(&ls->lock);
+    
+    uint16_t weight = 0;
+    if (ea->valid && eb->valid) {
+        uint16_t wa = entry_weight(ea, b);
+        uint16_t wb = entry_weight(eb, a);
+        if (wa && wb) weight = wa > wb ? wa : wb;
+    } else if (ea->valid) {
+        weight = entry_weight(ea, b);
+    } else if (eb->valid) {
+        weight = entry_weight(eb, a);
+    }
+    
+    pthread_mutex_unlock(&ls->lock);
+    return weight;
+}
+
+uint32_t link_state_known_origins(link_state_t *ls) {
+    uint32_t count = 0;
+    
+    pthread_mutex_lock(&ls->lock);
+    for (uint32_t i = 0; i < ls->num_nodes; i++) {
+        if (ls->entries[i].valid) count++;
+    }
+    pthread_mutex_unlock(&ls->lock);
+    return count;
+}
+
+void link_state_print(link_state_t *ls) {
+    printf("\n=== Link State Database (Node %d) ===\n", ls->my_id);
+    printf("Origins known: %u/%u\n", link_state_known_origins(ls), ls->num_nodes);
+    
+    ls_entry_t *mine = entry_of(ls, ls->my_id);
+    if (mine && mine->valid) {
+        printf("My LSA:        seq %u, %u links\n", mine->seq, mine->num_links);
+    }
+    
+    printf("Originated:    %lu\n", ls->originated);
+    printf("Installed:     %lu\n", ls->installed);
+    printf("Duplicates:    %lu\n", ls->duplicates);
+    printf("Flooded:       %lu\n", ls->flooded);
+    printf("Expired:       %lu\n", ls->expired);
+    printf("Malformed:     %lu\n", ls->malformed);
+}
@@ -0,0 +1,544 @@
+// src/network/metrics_registry.c
+#include "metrics_registry.h"
+#include "ra_tdmas_sync.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+
+#define METRICS_PREFIX "tdma_"
+
+__thread const metrics_registry_t *metrics_tls_registry = NULL;
+__thread uint64_t metrics_tls_epoch = 0;
+__thread metrics_shard_t *metrics_tls_shard = NULL;
+
+static _Atomic uint64_t next_epoch = 1;
+
+// ========================================
+// Lifecycle
+// ========================================
+
+int metrics_registry_init(metrics_registry_t *reg, node_id_t node_id) {
+    memset(reg, 0, sizeof(metrics_registry_t));
+    
+    reg->node_id = node_id;
+    reg->epoch = atomic_fetch_add(&next_epoch, 1);
+    reg->listen_fd = -1;
+    reg->wake_fd = -1;
+    
+    if (pthread_mutex_init(&reg->lock, NULL) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+void metrics_registry_destroy(metrics_registry_t *reg) {
+    metrics_export_stop(reg);
+    
+    for (int i = 0; i < reg->num_shards; i++) {
+        free(reg->shards[i]);
+        reg->shards[i] = NULL;
+    }
+    reg->num_shards = 0;
+    reg->epoch = 0;
+    pthread_mutex_destroy(&reg->lock);
+}
+
+// ========================================
+// Registo
+// ========================================
+
+static bool valid_name(const char *name) {
+    size_t len = strlen(name);
+    if (len == 0 || len >= METRICS_NAME_LEN) return false;
+    
+    for (size_t i = 0; i < len; i++) {
+        char c = name[i];
+        bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' ||
+                  (i > 0 && c >= '0' && c <= '9');
+        if (!ok) return false;
+    }
+    return true;
+}
+
+static metric_id_t add_metric(metrics_registry_t *reg, const char *name,
+                              const char *help, metric_type_t type) {
+    if (!reg || !valid_name(name)) {
+        fprintf(stderr, "[METRICS] Invalid metric name '%s'\n", name ? name : "(null)");
+        return -1;
+    }
+    
+    pthread_mutex_lock(&reg->lock);
+    
+    for (int i = 0; i < reg->num_metrics; i++) {
+        if (strcmp(reg->metrics[i].name, name) == 0) {
+            pthread_mutex_unlock(&reg->lock);
+            fprintf(stderr, "[METRICS] Duplicate metric '%s'\n", name);
+            return -1;
+        }
+    }
+    
+    if (reg->num_metrics >= METRICS_MAX ||
+        (type == METRIC_HISTOGRAM && reg->num_histograms >= METRICS_MAX_HISTOGRAMS)) {
+        pthread_mutex_unlock(&reg->lock);
+        fprintf(stderr, "[METRICS] Registry full, '%s' not registered\n", name);
+        return -1;
+    }
+    
+    metric_id_t id = reg->num_metrics;
+    metric_desc_t *desc = &reg->metrics[id];
+    
+    memset(desc, 0, sizeof(metric_desc_t));
+    strcpy(desc->name, name);
+    desc->help = help ? help : "";
+    desc->type = type;
+    desc->hist_index = type == METRIC_HISTOGRAM ? reg->num_histograms++ : -1;
+    
+    reg->num_metrics++;
+    pthread_mutex_unlock(&reg->lock);
+    return id;
+}
+
+metric_id_t metrics_register_counter(metrics_registry_t *reg, const char *name,
+                                     const char *help) {
+    return add_metric(reg, name, help, METRIC_COUNTER);
+}
+
+metric_id_t metrics_register_histogram(metrics_registry_t *reg, const char *name,
+                                       const char *help) {
+    return add_metric(reg, name, help, METRIC_HISTOGRAM);
+}
+
+metric_id_t metrics_register_source(metrics_registry_t *reg, const char *name,
+                                    const char *help, metric_type_t type,
+                                    const void *source, size_t size) {
+    if (!source || (size != sizeof(uint32_t) && size != sizeof(uint64_t)) ||
+        type == METRIC_HISTOGRAM) {
+        fprintf(stderr, "[METRICS] Invalid source for '%s'\n", name);
+        return -1;
+    }
+    
+    metric_id_t id = add_metric(reg, name, help, type);
+    if (id >= 0) {
+        // Publicado antes de o exportador arrancar (pthread_create sincroniza)
+        reg->metrics[id].source = source;
+        reg->metrics[id].source_size = (uint8_t)size;
+    }
+    return id;
+}
+
+// ========================================
+// Shards (caminho lento)
+// ========================================
+
+metrics_shard_t *metrics_shard_slow(metrics_registry_t *reg) {
+    pthread_t self = pthread_self();
+    metrics_shard_t *shard = NULL;
+    
+    pthread_mutex_lock(&reg->lock);
+    
+    // Mesma thread a alternar entre registos: reutiliza o seu shard
+    for (int i = 0; i < reg->num_shards; i++) {
+        if (pthread_equal(reg->shards[i]->owner, self)) {
+            shard = reg->shards[i];
+            break;
+        }
+    }
+    
+    if (!shard && reg->num_shards < METRICS_MAX_SHARDS) {
+        void *mem = NULL;
+        if (posix_memalign(&mem, 64, sizeof(metrics_shard_t)) == 0) {
+            shard = mem;
+            memset(shard, 0, sizeof(metrics_shard_t));
+            shard->owner = self;
+            reg->shards[reg->num_shards++] = shard;
+        }
+    }
+    
+    if (!shard) {
+        reg->shard_overflows++;
+    }
+    
+    pthread_mutex_unlock(&reg->lock);
+    
+    if (shard) {
+        metrics_tls_registry = reg;
+        metrics_tls_epoch = reg->epoch;
+        metrics_tls_shard = shard;
+    }
+    return shard;
+}
+
+// ========================================
+// Histogramas
+// ========================================
+
+static uint32_t hist_bucket(uint64_t value) {
+    if (value <= 1) return 0;
+    
+    uint32_t index = 64 - __builtin_clzll(value - 1);   // Menor i com value <= 2^i
+    return index < METRICS_HIST_BUCKETS ? index : METRICS_HIST_BUCKETS;
+}
+
+static void relaxed_add(uint64_t *target, uint64_t n) {
+    __atomic_store_n(target, __atomic_load_n(target, __ATOMIC_RELAXED) + n,
+                     __ATOMIC_RELAXED);
+}
+
+void metrics_observe(metrics_registry_t *reg, metric_id_t id, uint64_t value) {
+    if (!reg || id < 0 || reg->metrics[id].type != METRIC_HISTOGRAM) return;
+    
+    metrics_shard_t *shard = metrics_local_shard(reg);
+    if (!shard) return;
+    
+    metric_hist_t *hist = &shard->hists[reg->metrics[id].hist_index];
+    relaxed_add(&hist->buckets[hist_bucket(value)], 1);
+    relaxed_add(&hist->sum, value);
+    relaxed_add(&hist->count, 1);
+}
+
+// ========================================
+// Snapshot
+// ========================================
+
+static int shard_count(metrics_registry_t *reg) {
+    pthread_mutex_lock(&reg->lock);
+    int count = reg->num_shards;
+    pthread_mutex_unlock(&reg->lock);
+    return count;
+}
+
+uint64_t metrics_value(metrics_registry_t *reg, metric_id_t id) {
+    if (!reg || id < 0 || id >= reg->num_metrics) return 0;
+    
+    const metric_desc_t *desc = &reg->metrics[id];
+    
+    if (desc->source) {
+        if (desc->source_size == sizeof(uint32_t)) {
+            return __atomic_load_n((const uint32_t *)desc->source, __ATOMIC_RELAXED);
+        }
+        return __atomic_load_n((const uint64_t *)desc->source, __ATOMIC_RELAXED);
+    }
+    
+    if (desc->type == METRIC_HISTOGRAM) {
+        metric_hist_t hist;
+        metrics_histogram(reg, id, &hist);
+        return hist.count;
+    }
+    
+    uint64_t total = 0;
+    int shards = shard_count(reg);
+    for (int i = 0; i < shards; i++) {
+        total += __atomic_load_n(&reg->shards[i]->values[id], __ATOMIC_RELAXED);
+    }
+    return total;
+}
+
+void metrics_histogram(metrics_registry_t *reg, metric_id_t id, metric_hist_t *out) {
+    memset(out, 0, sizeof(metric_hist_t));
+    if (!reg || id < 0 || id >= reg->num_metrics ||
+        reg->metrics[id].type != METRIC_HISTOGRAM) {
+        return;
+    }
+    
+    int index = reg->metrics[id].hist_index;
+    int shards = shard_count(reg);
+    
+    for (int i = 0; i < shards; i++) {
+        const metric_hist_t *hist = &reg->shards[i]->hists[index];
+        
+        for (int b = 0; b <= METRICS_HIST_BUCKETS; b++) {
+            out->buckets[b] += __atomic_load_n(&hist->buckets[b], __ATOMIC_RELAXED);
+        }
+        out->sum += __atomic_load_n(&hist->sum, __ATOMIC_RELAXED);
+        out->count += __atomic_load_n(&hist->count, __ATOMIC_RELAXED);
+    }
+}
+
+// ========================================
+// Formatos de Texto
+// ========================================
+
+static const char *type_name(metric_type_t type) {
+    switch (type) {
+        case METRIC_COUNTER:   return "counter";
+        case METRIC_GAUGE:     return "gauge";
+        case METRIC_HISTOGRAM: return "histogram";
+    }
+    return "untyped";
+}
+
+void metrics_write_prometheus(metrics_registry_t *reg, FILE *fp) {
+    for (int id = 0; id < reg->num_metrics; id++) {
+        const metric_desc_t *desc = &reg->metrics[id];
+        
+        fprintf(fp, "# HELP " METRICS_PREFIX "%s %s\n", desc->name, desc->help);
+        fprintf(fp, "# TYPE " METRICS_PREFIX "%s %s\n", desc->name, type_name(desc->type));
+        
+        if (desc->type != METRIC_HISTOGRAM) {
+            fprintf(fp, METRICS_PREFIX "%s{node=\"%u\"} %lu\n",
+                    desc->name, reg->node_id, metrics_value(reg, id));
+            continue;
+        }
+        
+        // Buckets cumulativos, como o formato exige
+        metric_hist_t hist;
+        metrics_histogram(reg, id, &hist);
+        
+        uint64_t cumulative = 0;
+        for (int b = 0; b < METRICS_HIST_BUCKETS; b++) {
+            cumulative += hist.buckets[b];
+            fprintf(fp, METRICS_PREFIX "%s_bucket{node=\"%u\",le=\"%lu\"} %lu\n",
+                    desc->name, reg->node_id, 1UL << b, cumulative);
+        }
+        fprintf(fp, METRICS_PREFIX "%s_bucket{node=\"%u\",le=\"+Inf\"} %lu\n",
+                desc->name, reg->node_id, hist.count);
+        fprintf(fp, METRICS_PREFIX "%s_sum{node=\"%u\"} %lu\n",
+                desc->name, reg->node_id, hist.sum);
+        fprintf(fp, METRICS_PREFIX "%s_count{node=\"%u\"} %lu\n",
+                desc->name, reg->node_id, hist.count);
+    }
+}
+
+void metrics_write_json(metrics_registry_t *reg, FILE *fp) {
+    fprintf(fp, "{\"node\": %u, \"timestamp_us\": %lu, \"metrics\": {",
+            reg->node_id, ra_tdmas_get_current_time_us());
+    
+    for (int id = 0; id < reg->num_metrics; id++) {
+        const metric_desc_t *desc = &reg->metrics[id];
+        
+        fprintf(fp, "%s\n  \"%s\": ", id > 0 ? "," : "", desc->name);
+        
+        if (desc->type != METRIC_HISTOGRAM) {
+            fprintf(fp, "%lu", metrics_value(reg, id));
+            continue;
+        }
+        
+        metric_hist_t hist;
+        metrics_histogram(reg, id, &hist);
+        
+        fprintf(fp, "{\"count\": %lu, \"sum\": %lu, \"buckets\": {", hist.count, hist.sum);
+        uint64_t cumulative = 0;
+        for (int b = 0; b < METRICS_HIST_BUCKETS; b++) {
+            cumulative += hist.buckets[b];
+            fprintf(fp, "\"%lu\": %lu, ", 1UL << b, cumulative);
+        }
+        fprintf(fp, "\"+Inf\": %lu}}", hist.count);
+    }
+    
+    fprintf(fp, "\n}}\n");
+}
+
+// ========================================
+// Exportador
+// ========================================
+
+static bool wants_json(const char *path) {
+    size_t len = strlen(path);
+    return len >= 5 && strcmp(path + len - 5, ".json") == 0;
+}
+
+// Temporário + rename(): quem lê vê o snapshot anterior ou o novo, inteiro
+static int write_snapshot_file(metrics_registry_t *reg) {
+    char tmp_path[sizeof(reg->file_path) + 8];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", reg->file_path);
+    
+    FILE *fp = fopen(tmp_path, "w");
+    if (!fp) return -1;
+    
+    if (wants_json(reg->file_path)) {
+        metrics_write_json(reg, fp);
+    } else {
+        metrics_write_prometheus(reg, fp);
+    }
+    
+    if (fclose(fp) != 0 || rename(tmp_path, reg->file_path) != 0) {
+        unlink(tmp_path);
+        return -1;
+    }
+    
+    reg->snapshots_written++;
+    return 0;
+}
+
+static void serve_scrape(metrics_registry_t *reg) {
+    int client = accept(reg->listen_fd, NULL, NULL);
+    if (client < 0) return;
+    
+    // Um scraper lento não pode prender o exportador
+    struct timeval timeout = { .tv_sec = 0, .tv_usec = 200000 };
+    setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    
+    char *text = NULL;
+    size_t len = 0;
+    FILE *fp = open_memstream(&text, &len);
+    if (fp) {
+        metrics_write_prometheus(reg, fp);
+        fclose(fp);
+        
+        size_t offset = 0;
+        while (offset < len) {
+            ssize_t sent = send(client, text + offset, len - offset, MSG_NOSIGNAL);
+            if (sent <= 0) break;
+            offset += sent;
+        }
+        free(text);
+        reg->scrapes_served++;
+    }
+    
+    close(client);
+}
+
+static uint64_t now_ms(void) {
+    return ra_tdmas_get_current_time_us() / 1000;
+}
+
+static void *export_thread(void *arg) {
+    metrics_registry_t *reg = (metrics_registry_t *)arg;
+    
+    struct pollfd fds[2] = {
+        { .fd = reg->wake_fd, .events = POLLIN },
+        { .fd = reg->listen_fd, .events = POLLIN }
+    };
+    nfds_t nfds = reg->listen_fd >= 0 ? 2 : 1;
+    bool has_file = reg->file_path[0] != '\0';
+    uint64_t next_write_ms = now_ms();
+    
+    while (reg->exporting) {
+        uint64_t now = now_ms();
+        
+        if (has_file && now >= next_write_ms) {
+            if (write_snapshot_file(reg) < 0) {
+                fprintf(stderr, "[METRICS] Failed to write %s: %s\n",
+                        reg->file_path, strerror(errno));
+            }
+            next_write_ms += reg->interval_ms;
+            if (next_write_ms <= now) {
+                next_write_ms = now + reg->interval_ms;   // Atrasado: não recupera em rajada
+            }
+        }
+        
+        int timeout = has_file ? (int)(next_write_ms - now_ms()) : -1;
+        if (has_file && timeout < 0) timeout = 0;
+        
+        if (poll(fds, nfds, timeout) <= 0) {
+            continue;
+        }
+        
+        if (fds[0].revents & POLLIN) {
+            uint64_t value;
+            if (read(reg->wake_fd, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+                perror("[METRICS] eventfd read");
+            }
+        }
+        if (nfds > 1 && (fds[1].revents & POLLIN)) {
+            serve_scrape(reg);
+        }
+    }
+    
+    // Último snapshot com os contadores finais
+    if (has_file) {
+        write_snapshot_file(reg);
+    }
+    return NULL;
+}
+
+static int open_listen_socket(const char *path) {
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "[METRICS] Socket path too long: %s\n", path);
+        return -1;
+    }
+    
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("[METRICS] socket");
+        return -1;
+    }
+    
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    unlink(path);   // Socket de uma execução anterior
+    
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 8) < 0) {
+        fprintf(stderr, "[METRICS] Cannot listen on %s: %s\n", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    
+    // accept() devolve um socket bloqueante (não herda SOCK_NONBLOCK)
+    return fd;
+}
+
+int metrics_export_start(metrics_registry_t *reg, const char *file_path,
+                         const char *socket_path, uint32_t interval_ms) {
+    if (reg->exporting || (!file_path && !socket_path)) {
+        return -1;
+    }
+    
+    if (file_path && strlen(file_path) >= sizeof(reg->file_path) - 8) {
+        fprintf(stderr, "[METRICS] File path too long: %s\n", file_path);
+        return -1;
+    }
+    
+    reg->interval_ms = interval_ms > 0 ? interval_ms : METRICS_DEFAULT_INTERVAL_MS;
+    snprintf(reg->file_path, sizeof(reg->file_path), "%s", file_path ? file_path : "");
+    snprintf(reg->socket_path, sizeof(reg->socket_path), "%s", socket_path ? socket_path : "");
+    
+    if (socket_path) {
+        reg->listen_fd = open_listen_socket(socket_path);
+        if (reg->listen_fd < 0) {
+            return -1;
+        }
+    }
+    
+    reg->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (reg->wake_fd < 0) {
+        perror("[METRICS] eventfd");
+        metrics_export_stop(reg);
+        return -1;
+    }
+    
+    reg->exporting = true;
+    if (pthread_create(&reg->export_thread, NULL, export_thread, reg) != 0) {
+        perror("[METRICS] pthread_create");
+        reg->exporting = false;
+        metrics_export_stop(reg);
+        return -1;
+    }
+    
+    printf("[METRICS] Exporting every %u ms%s%s%s%s\n", reg->interval_ms,
+           reg->file_path[0] ? " to " : "", reg->file_path,
+           reg->socket_path[0] ? ", scrape socket " : "", reg->socket_path);
+    return 0;
+}
+
+void metrics_export_stop(metrics_registry_t *reg) {
+    if (reg->exporting) {
+        reg->exporting = false;
+        
+        uint64_t one = 1;
+        if (write(reg->wake_fd, &one, sizeof(one)) < 0) {
+            perror("[METRICS] eventfd write");
+        }
+        pthread_join(reg->export_thread, NULL);
+    }
+    
+    if (reg->listen_fd >= 0) {
+        close(reg->listen_fd);
+        unlink(reg->socket_path);
+        reg->listen_fd = -1;
+    }
+    if (reg->wake_fd >= 0) {
+        close(reg->wake_fd);
+        reg->wake_fd = -1;
+    }
+}
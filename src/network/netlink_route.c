@@ -0,0 +1,352 @@
+// src/network/netlink_route.c
+#include "netlink_route.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <net/if.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#define NL_ROUTE_MSG_SPACE 128   // nlmsghdr + rtmsg + 4 atributos, alinhado
+
+// ========================================
+// Helper Functions
+// ========================================
+
+static uint64_t get_current_time_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void add_attr(struct nlmsghdr *msg, unsigned short type,
+                     const void *data, unsigned short len) {
+    struct rtattr *rta = (struct rtattr *)((uint8_t *)msg + NLMSG_ALIGN(msg->nlmsg_len));
+    rta->rta_type = type;
+    rta->rta_len = RTA_LENGTH(len);
+    memcpy(RTA_DATA(rta), data, len);
+    msg->nlmsg_len = NLMSG_ALIGN(msg->nlmsg_len) + RTA_ALIGN(rta->rta_len);
+}
+
+// Constrói RTM_NEWROUTE/RTM_DELROUTE em buf (NL_ROUTE_MSG_SPACE bytes)
+static size_t build_route_msg(nl_route_t *nl, uint8_t *buf, uint32_t seq,
+                              nl_route_op_t op, in_addr_t dst,
+                              in_addr_t gateway, uint32_t metric) {
+    memset(buf, 0, NL_ROUTE_MSG_SPACE);
+    
+    struct nlmsghdr *msg = (struct nlmsghdr *)buf;
+    msg->nlmsg_len = NLMSG_LENGTH(sizeof(struct rtmsg));
+    msg->nlmsg_seq = seq;
+    msg->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK;
+    
+    struct rtmsg *rtm = NLMSG_DATA(msg);
+    rtm->rtm_family = AF_INET;
+    rtm->rtm_dst_len = 32;
+    rtm->rtm_table = RT_TABLE_MAIN;
+    
+    if (op == NL_ROUTE_DELETE) {
+        // Como "ip route del": casa com qualquer protocolo/scope
+        msg->nlmsg_type = RTM_DELROUTE;
+        rtm->rtm_scope = RT_SCOPE_NOWHERE;
+    } else {
+        msg->nlmsg_type = RTM_NEWROUTE;
+        msg->nlmsg_flags |= NLM_F_CREATE |
+                            (op == NL_ROUTE_REPLACE ? NLM_F_REPLACE : NLM_F_EXCL);
+        rtm->rtm_protocol = NL_ROUTE_PROTO;
+        rtm->rtm_scope = gateway ? RT_SCOPE_UNIVERSE : RT_SCOPE_LINK;
+        rtm->rtm_type = RTN_UNICAST;
+    }
+    
+    add_attr(msg, RTA_DST, &dst, sizeof(dst));
+    if (gateway) {
+        if (op != NL_ROUTE_DELETE) rtm->rtm_flags |= RTNH_F_ONLINK;
+        add_attr(msg, RTA_GATEWAY, &gateway, sizeof(gateway));
+    }
+    add_attr(msg, RTA_PRIORITY, &metric, sizeof(metric));
+    
+    uint32_t ifindex = nl->ifindex;
+    add_attr(msg, RTA_OIF, &ifindex, sizeof(ifindex));
+    
+    return NLMSG_ALIGN(msg->nlmsg_len);
+}
+
+// Recolhe os acks das mensagens com seq em [first_seq, first_seq + count)
+static int collect_acks(nl_route_t *nl, uint32_t first_seq, uint32_t count,
+                        int *results, int max_results, uint32_t result_base) {
+    uint8_t buf[8192];
+    uint32_t pending = count;
+    int failed = 0;
+    
+    while (pending > 0) {
+        ssize_t len = recv(nl->fd, buf, sizeof(buf), 0);
+        if (len < 0) {
+            if (errno == EINTR) continue;
+            perror("[NETLINK] recv");
+            return -1;
+        }
+        
+        for (struct nlmsghdr *msg = (struct nlmsghdr *)buf;
+             NLMSG_OK(msg, (size_t)len);
+             msg = NLMSG_NEXT(msg, len)) {
+            
+            if (msg->nlmsg_type != NLMSG_ERROR) continue;
+            if (msg->nlmsg_seq < first_seq || msg->nlmsg_seq >= first_seq + count) continue;
+            
+            const struct nlmsgerr *err = NLMSG_DATA(msg);
+            uint32_t index = result_base + (msg->nlmsg_seq - first_seq);
+            if (results && index < (uint32_t)max_results) {
+                results[index] = err->error;
+            }
+            
+            if (err->error == 0) {
+                nl->acks_ok++;
+            } else {
+                nl->acks_failed++;
+                failed++;
+            }
+            pending--;
+        }
+    }
+    
+    return failed;
+}
+
+// ========================================
+// Lifecycle
+// ========================================
+
+int nl_route_open(nl_route_t *nl, const char *ifname) {
+    memset(nl, 0, sizeof(nl_route_t));
+    nl->fd = -1;
+    
+    nl->ifindex = if_nametoindex(ifname);
+    if (nl->ifindex == 0) {
+        fprintf(stderr, "[NETLINK] Interface %s not found\n", ifname);
+        return -1;
+    }
+    
+    nl->fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (nl->fd < 0) {
+        perror("[NETLINK] socket");
+        return -1;
+    }
+    
+    struct sockaddr_nl local = { .nl_family = AF_NETLINK };
+    if (bind(nl->fd, (struct sockaddr *)&local, sizeof(local)) < 0) {
+        perror("[NETLINK] bind");
+        close(nl->fd);
+        nl->fd = -1;
+        return -1;
+    }
+    
+    // Nunca bloquear indefinidamente à espera de um ack
+    struct timeval tv = {
+        .tv_sec = NL_ROUTE_ACK_TIMEOUT_MS / 1000,
+        .tv_usec = (NL_ROUTE_ACK_TIMEOUT_MS % 1000) * 1000
+    };
+    setsockopt(nl->fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    
+    nl->seq = (uint32_t)time(NULL);
+    return 0;
+}
+
+void nl_route_close(nl_route_t *nl) {
+    if (nl->fd >= 0) {
+        close(nl->fd);
+        nl->fd = -1;
+    }
+    free(nl->batch);
+    nl->batch = NULL;
+    nl->batch_cap = 0;
+    nl->batch_len = 0;
+    nl->batch_count = 0;
+}
+
+// ========================================
+// Operations
+// ========================================
+
+int nl_route_apply(nl_route_t *nl, nl_route_op_t op, in_addr_t dst,
+                   in_addr_t gateway, uint32_t metric) {
+    if (nl->fd < 0) return -EBADF;
+    
+    uint8_t buf[NL_ROUTE_MSG_SPACE];
+    uint32_t seq = ++nl->seq;
+    size_t len = build_route_msg(nl, buf, seq, op, dst, gateway, metric);
+    
+    uint64_t start_us = get_current_time_us();
+    
+    if (send(nl->fd, buf, len, 0) < 0) {
+        perror("[NETLINK] send");
+        return -errno;
+    }
+    nl->messages_sent++;
+    nl->sendmsg_calls++;
+    
+    int result = -ETIMEDOUT;
+    if (collect_acks(nl, seq, 1, &result, 1, 0) < 0) {
+        return -ETIMEDOUT;
+    }
+    
+    nl->total_ack_time_us += get_current_time_us() - start_us;
+    return result;
+}
+
+void nl_route_batch_begin(nl_route_t *nl) {
+    nl->batch_len = 0;
+    nl->batch_count = 0;
+}
+
+int nl_route_batch_add(nl_route_t *nl, nl_route_op_t op, in_addr_t dst,
+                       in_addr_t gateway, uint32_t metric) {
+    if (nl->batch_len + NL_ROUTE_MSG_SPACE > nl->batch_cap) {
+        size_t new_cap = nl->batch_cap ? nl->batch_cap * 2 : 64 * NL_ROUTE_MSG_SPACE;
+        uint8_t *grown = realloc(nl->batch, new_cap);
+        if (!grown) return -1;
+        nl->batch = grown;
+        nl->batch_cap = new_cap;
+    }
+    
+    // Sequence numbers do batch são contíguos a partir da 1ª mensagem
+    if (nl->batch_count == 0) {
+        nl->batch_first_seq = nl->seq + 1;
+    }
+    
+    nl->batch_len += build_route_msg(nl, nl->batch + nl->batch_len, ++nl->seq,
+                                     op, dst, gateway, metric);
+    return nl->batch_count++;
+}
+
+int nl_route_batch_commit(nl_route_t *nl, int *results, int max_results) {
+    if (nl->batch_count == 0) return 0;
+    if (nl->fd < 0) return -1;
+    
+    uint64_t start_us = get_current_time_us();
+    int failed = 0;
+    
+    // Envia em chunks de mensagens inteiras; acks recolhidos por chunk
+    size_t offset = 0;
+    uint32_t sent_msgs = 0;
+    while (offset < nl->batch_len) {
+        size_t chunk_len = 0;
+        uint32_t chunk_msgs = 0;
+        
+        while (offset + chunk_len < nl->batch_len && chunk_msgs < NL_ROUTE_CHUNK_MSGS) {
+            struct nlmsghdr *msg = (struct nlmsghdr *)(nl->batch + offset + chunk_len);
+            chunk_len += NLMSG_ALIGN(msg->nlmsg_len);
+            chunk_msgs++;
+        }
+        
+        if (send(nl->fd, nl->batch + offset, chunk_len, 0) < 0) {
+            perror("[NETLINK] send batch");
+            return -1;
+        }
+        nl->sendmsg_calls++;
+        nl->messages_sent += chunk_msgs;
+        
+        int ret = collect_acks(nl, nl->batch_first_seq + sent_msgs, chunk_msgs,
+                               results, max_results, sent_msgs);
+        if (ret < 0) return -1;
+        failed += ret;
+        
+        offset += chunk_len;
+        sent_msgs += chunk_msgs;
+    }
+    
+    nl->total_ack_time_us += get_current_time_us() - start_us;
+    nl->batch_len = 0;
+    nl->batch_count = 0;
+    return failed;
+}
+
+// ========================================
+// Kernel Table Dump
+// ========================================
+
+static void parse_route(const struct nlmsghdr *msg, nl_route_info_t *route,
+                        uint32_t *table) {
+    const struct rtmsg *rtm = NLMSG_DATA(msg);
+    memset(route, 0, sizeof(*route));
+    route->dst_len = rtm->rtm_dst_len;
+    route->protocol = rtm->rtm_protocol;
+    *table = rtm->rtm_table;
+    
+    int attr_len = RTM_PAYLOAD(msg);
+    for (const struct rtattr *rta = RTM_RTA(rtm); RTA_OK(rta, attr_len);
+         rta = RTA_NEXT(rta, attr_len)) {
+        switch (rta->rta_type) {
+            case RTA_DST:      memcpy(&route->dst, RTA_DATA(rta), sizeof(in_addr_t)); break;
+            case RTA_GATEWAY:  memcpy(&route->gateway, RTA_DATA(rta), sizeof(in_addr_t)); break;
+            case RTA_PRIORITY: memcpy(&route->metric, RTA_DATA(rta), sizeof(uint32_t)); break;
+            case RTA_OIF:      memcpy(&route->ifindex, RTA_DATA(rta), sizeof(int)); break;
+            case RTA_TABLE:    memcpy(table, RTA_DATA(rta), sizeof(uint32_t)); break;
+            default: break;
+        }
+    }
+}
+
+int nl_route_dump(nl_route_t *nl, nl_route_dump_cb callback, void *ctx) {
+    if (nl->fd < 0) return -1;
+    
+    struct {
+        struct nlmsghdr hdr;
+        struct rtmsg rtm;
+    } req;
+    memset(&req, 0, sizeof(req));
+    req.hdr.nlmsg_len = NLMSG_LENGTH(sizeof(struct rtmsg));
+    req.hdr.nlmsg_type = RTM_GETROUTE;
+    req.hdr.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    req.hdr.nlmsg_seq = ++nl->seq;
+    req.rtm.rtm_family = AF_INET;
+    
+    if (send(nl->fd, &req, req.hdr.nlmsg_len, 0) < 0) {
+        perror("[NETLINK] send dump");
+        return -1;
+    }
+    nl->sendmsg_calls++;
+    
+    uint8_t buf[16384];
+    int count = 0;
+    
+    while (true) {
+        ssize_t len = recv(nl->fd, buf, sizeof(buf), 0);
+        if (len < 0) {
+            if (errno == EINTR) continue;
+            perror("[NETLINK] recv dump");
+            return -1;
+        }
+        
+        for (struct nlmsghdr *msg = (struct nlmsghdr *)buf;
+             NLMSG_OK(msg, (size_t)len);
+             msg = NLMSG_NEXT(msg, len)) {
+            
+            if (msg->nlmsg_seq != req.hdr.nlmsg_seq) continue;
+            if (msg->nlmsg_type == NLMSG_DONE) return count;
+            if (msg->nlmsg_type == NLMSG_ERROR) return -1;
+            if (msg->nlmsg_type != RTM_NEWROUTE) continue;
+            
+            nl_route_info_t route;
+            uint32_t table;
+            parse_route(msg, &route, &table);
+            if (table != RT_TABLE_MAIN) continue;
+            
+            callback(&route, ctx);
+            count++;
+        }
+    }
+}
+
+void nl_route_print_stats(nl_route_t *nl) {
+    printf("Netlink:  %lu msgs in %lu sendmsg() | acks ok %lu, failed %lu",
+           nl->messages_sent, nl->sendmsg_calls, nl->acks_ok, nl->acks_failed);
+    if (nl->sendmsg_calls > 0) {
+        printf(" | %.1f us/call", (double)nl->total_ack_time_us / nl->sendmsg_calls);
+    }
+    printf("\n");
+}
@@ -0,0 +1,569 @@
+// src/network/shm_link.c
+#define _GNU_SOURCE  // ppoll()
+#include "shm_link.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SHM_LINK_MASK (SHM_LINK_RING_SIZE - 1)
+
+_Static_assert((SHM_LINK_RING_SIZE & SHM_LINK_MASK) == 0,
+               "SHM_LINK_RING_SIZE must be a power of 2");
+
+// ========================================
+// Helper Functions
+// ========================================
+
+static uint64_t monotonic_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint64_t fabric_now_us(const shm_fabric_t *fabric) {
+    return fabric->clock ? fabric->clock(fabric->hook_ctx) : monotonic_us();
+}
+
+static uint64_t rng_next(uint64_t *s) {
+    uint64_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *s = x;
+}
+
+// splitmix64: seeds distintas (e nunca zero) por link a partir da seed da fabric
+static uint64_t link_seed(uint64_t seed, node_id_t src, node_id_t dst) {
+    uint64_t z = seed + ((uint64_t)src << 16 | dst) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return z ? z : 1;
+}
+
+static bool valid_id(const shm_fabric_t *fabric, node_id_t id) {
+    return id >= 1 && id <= fabric->max_nodes;
+}
+
+static _Atomic(shm_link_t *) *link_slot(shm_fabric_t *fabric, node_id_t src, node_id_t dst) {
+    return &fabric->links[(size_t)(src - 1) * fabric->max_nodes + (dst - 1)];
+}
+
+static void link_apply(shm_link_t *link, const shm_link_params_t *params) {
+    double loss = params->loss < 0.0 ? 0.0 : params->loss > 1.0 ? 1.0 : params->loss;
+    
+    atomic_store_explicit(&link->loss_ppm,
+                          (uint32_t)(loss * SHM_LINK_LOSS_SCALE + 0.5),
+                          memory_order_relaxed);
+    atomic_store_explicit(&link->delay_us, params->delay_us, memory_order_relaxed);
+    atomic_store_explicit(&link->jitter_us, params->jitter_us, memory_order_relaxed);
+    atomic_store_explicit(&link->down, params->down, memory_order_relaxed);
+}
+
+/**
+ * Link src → dst, criado no primeiro uso
+ *
+ * Só a criação usa o lock; depois é uma load acquire. O link entra na
+ * lista de entrada do destino já inicializado (store release).
+ */
+static shm_link_t *get_link(shm_fabric_t *fabric, node_id_t src, node_id_t dst) {
+    _Atomic(shm_link_t *) *slot = link_slot(fabric, src, dst);
+    shm_link_t *link = atomic_load_explicit(slot, memory_order_acquire);
+    if (link) return link;
+    
+    pthread_mutex_lock(&fabric->lock);
+    
+    link = atomic_load_explicit(slot, memory_order_relaxed);
+    if (!link) {
+        void *mem = NULL;
+        if (posix_memalign(&mem, 64, sizeof(shm_link_t)) == 0) {
+            link = mem;
+            memset(link, 0, sizeof(shm_link_t));
+            link->src = src;
+            link->dst = dst;
+            link->rng = link_seed(fabric->seed, src, dst);
+            link_apply(link, &fabric->defaults);
+            
+            shm_inbound_t *inbound = &fabric->inbound[dst - 1];
+            uint32_t index = atomic_load_explicit(&inbound->count, memory_order_relaxed);
+            atomic_store_explicit(&inbound->links[index], link, memory_order_release);
+            atomic_store_explicit(&inbound->count, index + 1, memory_order_release);
+            atomic_store_explicit(slot, link, memory_order_release);
+        }
+    }
+    
+    pthread_mutex_unlock(&fabric->lock);
+    return link;
+}
+
+// Acorda o recetor de 'peer' se está bloqueado em wait() (um só produtor escreve)
+static void wake_peer(udp_transport_t *peer) {
+    shm_endpoint_t *ep = peer->shm;
+    
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&ep->sleeping, memory_order_relaxed) &&
+        atomic_exchange_explicit(&ep->sleeping, false, memory_order_relaxed)) {
+        uint64_t one = 1;
+        if (write(peer->wake_fd, &one, sizeof(one)) < 0) {
+            // EAGAIN: o contador já está a sinalizar
+        }
+    }
+}
+
+// ========================================
+// Fabric
+// ========================================
+
+int shm_fabric_init(shm_fabric_t *fabric, uint32_t max_nodes, uint64_t seed) {
+    memset(fabric, 0, sizeof(shm_fabric_t));
+    
+    if (max_nodes < 1 || max_nodes > MAX_NETWORK_NODES) {
+        fprintf(stderr, "[SHM] Invalid node count: %u\n", max_nodes);
+        return -1;
+    }
+    
+    fabric->max_nodes = max_nodes;
+    fabric->seed = seed;
+    fabric->links = calloc((size_t)max_nodes * max_nodes, sizeof(*fabric->links));
+    fabric->inbound = calloc(max_nodes, sizeof(shm_inbound_t));
+    fabric->ports = calloc(max_nodes + 1, sizeof(*fabric->ports));
+    
+    if (!fabric->links || !fabric->inbound || !fabric->ports) {
+        shm_fabric_destroy(fabric);
+        return -1;
+    }
+    
+    for (uint32_t i = 0; i < max_nodes; i++) {
+        fabric->inbound[i].links = calloc(max_nodes, sizeof(*fabric->inbound[i].links));
+        if (!fabric->inbound[i].links) {
+            shm_fabric_destroy(fabric);
+            return -1;
+        }
+    }
+    
+    pthread_mutex_init(&fabric->lock, NULL);
+    
+    printf("[SHM] Fabric for %u nodes (%d packets per link, seed %lu)\n",
+           max_nodes, SHM_LINK_RING_SIZE, seed);
+    return 0;
+}
+
+void shm_fabric_destroy(shm_fabric_t *fabric) {
+    if (fabric->links) {
+        for (size_t i = 0; i < (size_t)fabric->max_nodes * fabric->max_nodes; i++) {
+            free(atomic_load(&fabric->links[i]));
+        }
+        pthread_mutex_destroy(&fabric->lock);
+    }
+    if (fabric->inbound) {
+        for (uint32_t i = 0; i < fabric->max_nodes; i++) {
+            free(fabric->inbound[i].links);
+        }
+    }
+    
+    free(fabric->links);
+    free(fabric->inbound);
+    free(fabric->ports);
+    fabric->links = NULL;
+    fabric->inbound = NULL;
+    fabric->ports = NULL;
+    fabric->max_nodes = 0;
+}
+
+void shm_fabric_set_defaults(shm_fabric_t *fabric, const shm_link_params_t *params) {
+    pthread_mutex_lock(&fabric->lock);
+    
+    fabric->defaults = *params;
+    for (size_t i = 0; i < (size_t)fabric->max_nodes * fabric->max_nodes; i++) {
+        shm_link_t *link = atomic_load_explicit(&fabric->links[i], memory_order_relaxed);
+        if (link) link_apply(link, params);
+    }
+    
+    pthread_mutex_unlock(&fabric->lock);
+}
+
+int shm_fabric_set_link(shm_fabric_t *fabric, node_id_t src, node_id_t dst,
+                        const shm_link_params_t *params) {
+    if (!valid_id(fabric, src) || !valid_id(fabric, dst) || src == dst) {
+        return -1;
+    }
+    
+    shm_link_t *link = get_link(fabric, src, dst);
+    if (!link) return -1;
+    
+    link_apply(link, params);
+    return 0;
+}
+
+int shm_fabric_set_link_pair(shm_fabric_t *fabric, node_id_t a, node_id_t b,
+                             const shm_link_params_t *params) {
+    if (shm_fabric_set_link(fabric, a, b, params) < 0) return -1;
+    return shm_fabric_set_link(fabric, b, a, params);
+}
+
+void shm_fabric_get_link_stats(shm_fabric_t *fabric, node_id_t src, node_id_t dst,
+                               shm_link_stats_t *stats) {
+    memset(stats, 0, sizeof(shm_link_stats_t));
+    if (!valid_id(fabric, src) || !valid_id(fabric, dst)) return;
+    
+    shm_link_t *link = atomic_load_explicit(link_slot(fabric, src, dst),
+                                            memory_order_acquire);
+    if (link) *stats = link->stats;
+}
+
+void shm_fabric_get_totals(shm_fabric_t *fabric, shm_link_stats_t *stats) {
+    memset(stats, 0, sizeof(shm_link_stats_t));
+    
+    for (size_t i = 0; i < (size_t)fabric->max_nodes * fabric->max_nodes; i++) {
+        shm_link_t *link = atomic_load_explicit(&fabric->links[i], memory_order_acquire);
+        if (!link) continue;
+        
+        stats->sent += link->stats.sent;
+        stats->delivered += link->stats.delivered;
+        stats->lost += link->stats.lost;
+        stats->down_drops += link->stats.down_drops;
+        stats->overflows += link->stats.overflows;
+    }
+}
+
+void shm_fabric_print_stats(shm_fabric_t *fabric) {
+    uint32_t links = 0;
+    for (uint32_t i = 0; i < fabric->max_nodes; i++) {
+        links += atomic_load(&fabric->inbound[i].count);
+    }
+    
+    shm_link_stats_t totals;
+    shm_fabric_get_totals(fabric, &totals);
+    
+    printf("\n=== Shared-Memory Fabric Stats ===\n");
+    printf("Nodes:        %u (%u directed links in use)\n", fabric->max_nodes, links);
+    printf("Link params:  loss %.3f, delay %u us, jitter %u us\n",
+           fabric->defaults.loss, fabric->defaults.delay_us, fabric->defaults.jitter_us);
+    printf("Sent:         %lu packets\n", totals.sent);
+    printf("Delivered:    %lu packets\n", totals.delivered);
+    printf("Lost:         %lu (link down: %lu, ring full: %lu)\n",
+           totals.lost, totals.down_drops, totals.overflows);
+    printf("\n");
+}
+
+void shm_fabric_set_virtual_time(shm_fabric_t *fabric, shm_clock_fn clock,
+                                 shm_enqueue_fn on_enqueue, void *ctx) {
+    pthread_mutex_lock(&fabric->lock);
+    fabric->clock = clock;
+    fabric->on_enqueue = on_enqueue;
+    fabric->hook_ctx = ctx;
+    pthread_mutex_unlock(&fabric->lock);
+}
+
+// ========================================
+// Endpoints
+// ========================================
+
+int shm_endpoint_attach(udp_transport_t *transport, shm_fabric_t *fabric) {
+    node_id_t id = transport->my_node_id;
+    if (!valid_id(fabric, id)) {
+        fprintf(stderr, "[SHM] Node %d outside the fabric (1-%u)\n", id, fabric->max_nodes);
+        return -1;
+    }
+    
+    shm_endpoint_t *ep = calloc(1, sizeof(shm_endpoint_t));
+    if (!ep) return -1;
+    
+    ep->fabric = fabric;
+    pthread_mutex_init(&ep->tx_lock, NULL);
+    transport->shm = ep;
+    
+    // Publicado por último: produtores só veem o transporte completo
+    udp_transport_t *expected = NULL;
+    if (!atomic_compare_exchange_strong(&fabric->ports[id], &expected, transport)) {
+        fprintf(stderr, "[SHM] Node %d already attached\n", id);
+        pthread_mutex_destroy(&ep->tx_lock);
+        free(ep);
+        transport->shm = NULL;
+        return -1;
+    }
+    
+    return 0;
+}
+
+void shm_endpoint_detach(udp_transport_t *transport) {
+    shm_endpoint_t *ep = transport->shm;
+    if (!ep) return;
+    
+    shm_fabric_t *fabric = ep->fabric;
+    node_id_t id = transport->my_node_id;
+    atomic_store(&fabric->ports[id], NULL);
+    
+    for (int i = 0; i < ep->num_held; i++) {
+        buffer_pool_release(transport->pool, ep->held[i]);
+    }
+    
+    // Pacotes ainda em voo para este nó voltam ao seu pool
+    shm_inbound_t *inbound = &fabric->inbound[id - 1];
+    uint32_t count = atomic_load(&inbound->count);
+    for (uint32_t i = 0; i < count; i++) {
+        shm_link_t *link = atomic_load(&inbound->links[i]);
+        uint32_t head = atomic_load(&link->head);
+        uint32_t tail = atomic_load(&link->tail);
+        
+        for (; tail != head; tail++) {
+            buffer_pool_release(transport->pool, link->slots[tail & SHM_LINK_MASK].buffer);
+        }
+        atomic_store(&link->tail, tail);
+    }
+    
+    pthread_mutex_destroy(&ep->tx_lock);
+    free(ep);
+    transport->shm = NULL;
+}
+
+int shm_endpoint_send_batch(udp_transport_t *transport,
+                            const udp_tx_packet_t *packets, int count, bool *sent_ok) {
+    shm_endpoint_t *ep = transport->shm;
+    shm_fabric_t *fabric = ep->fabric;
+    node_id_t src = transport->my_node_id;
+    int sent = 0;
+    
+    pthread_mutex_lock(&ep->tx_lock);
+    uint64_t now_us = fabric_now_us(fabric);
+    
+    for (int i = 0; i < count; i++) {
+        const udp_tx_packet_t *pkt = &packets[i];
+        
+        size_t payload_len = 0;
+        for (int s = 0; s < pkt->num_segments; s++) {
+            payload_len += pkt->segments[s].iov_len;
+        }
+        
+        if (payload_len > MAX_PACKET_SIZE - sizeof(udp_header_t) ||
+            !valid_id(fabric, pkt->dst) || pkt->dst == src) {
+            udp_transport_count_error(transport);
+            continue;
+        }
+        
+        shm_link_t *link = get_link(fabric, src, pkt->dst);
+        if (!link) {
+            udp_transport_count_error(transport);
+            continue;
+        }
+        
+        // Como no UDP, o envio conta mesmo que o pacote se perca no caminho
+        size_t len = sizeof(udp_header_t) + payload_len;
+        uint16_t sequence = transport->packets_sent & 0xFFFF;
+        udp_transport_count_tx(transport, 1, len);
+        sent++;
+        if (sent_ok) sent_ok[i] = true;
+        
+        udp_transport_t *peer = atomic_load_explicit(&fabric->ports[pkt->dst],
+                                                     memory_order_acquire);
+        if (!peer || atomic_load_explicit(&link->down, memory_order_relaxed)) {
+            link->stats.down_drops++;
+            continue;
+        }
+        
+        uint32_t loss_ppm = atomic_load_explicit(&link->loss_ppm, memory_order_relaxed);
+        if (loss_ppm > 0 && rng_next(&link->rng) % SHM_LINK_LOSS_SCALE < loss_ppm) {
+            link->stats.lost++;
+            continue;
+        }
+        
+        uint32_t head = atomic_load_explicit(&link->head, memory_order_relaxed);
+        if (head - atomic_load_explicit(&link->tail, memory_order_acquire) == SHM_LINK_RING_SIZE) {
+            link->stats.overflows++;
+            continue;
+        }
+        
+        // Buffer do pool do destino: o recetor pode reclamá-lo sem cópia
+        uint8_t *buffer = buffer_pool_alloc(peer->pool, len);
+        if (!buffer) {
+            udp_transport_count_error(transport);
+            continue;
+        }
+        
+        udp_header_t *header = (udp_header_t *)buffer;
+        header->version = 1;
+        header->type = pkt->type;
+        header->src = src;
+        header->dst = pkt->dst;
+        header->sequence = sequence;
+        header->payload_len = payload_len;
+        header->tx_timestamp_us = pkt->tx_timestamp_us;
+        
+        uint8_t *p = buffer + sizeof(udp_header_t);
+        for (int s = 0; s < pkt->num_segments; s++) {
+            memcpy(p, pkt->segments[s].iov_base, pkt->segments[s].iov_len);
+            p += pkt->segments[s].iov_len;
+        }
+        
+        uint64_t deliver_at_us = now_us + atomic_load_explicit(&link->delay_us,
+                                                               memory_order_relaxed);
+        uint32_t jitter_us = atomic_load_explicit(&link->jitter_us, memory_order_relaxed);
+        if (jitter_us > 0) {
+            deliver_at_us += rng_next(&link->rng) % (jitter_us + 1);
+        }
+        if (deliver_at_us < link->last_deliver_us) {
+            deliver_at_us = link->last_deliver_us;
+        }
+        link->last_deliver_us = deliver_at_us;
+        
+        shm_link_slot_t *slot = &link->slots[head & SHM_LINK_MASK];
+        slot->buffer = buffer;
+        slot->deliver_at_us = deliver_at_us;
+        atomic_store_explicit(&link->head, head + 1, memory_order_release);
+        link->stats.sent++;
+        
+        if (fabric->on_enqueue) {
+            fabric->on_enqueue(fabric->hook_ctx, pkt->dst, deliver_at_us);
+        }
+        wake_peer(peer);
+    }
+    
+    if (sent > 0) transport->tx_batches++;
+    pthread_mutex_unlock(&ep->tx_lock);
+    
+    return (sent == 0 && count > 0) ? -1 : sent;
+}
+
+/**
+ * Há algum pacote entregável agora? Senão, quando fica o próximo
+ * (*next_us = UINT64_MAX se os anéis estão vazios)
+ */
+static bool inbound_ready(udp_transport_t *transport, uint64_t now_us, uint64_t *next_us) {
+    shm_fabric_t *fabric = transport->shm->fabric;
+    shm_inbound_t *inbound = &fabric->inbound[transport->my_node_id - 1];
+    uint32_t count = atomic_load_explicit(&inbound->count, memory_order_acquire);
+    
+    *next_us = UINT64_MAX;
+    
+    for (uint32_t i = 0; i < count; i++) {
+        shm_link_t *link = atomic_load_explicit(&inbound->links[i], memory_order_acquire);
+        uint32_t tail = atomic_load_explicit(&link->tail, memory_order_relaxed);
+        if (tail == atomic_load_explicit(&link->head, memory_order_acquire)) continue;
+        
+        uint64_t deliver_at_us = link->slots[tail & SHM_LINK_MASK].deliver_at_us;
+        if (deliver_at_us <= now_us) return true;
+        if (deliver_at_us < *next_us) *next_us = deliver_at_us;
+    }
+    
+    return false;
+}
+
+int shm_endpoint_wait(udp_transport_t *transport, int timeout_ms) {
+    shm_endpoint_t *ep = transport->shm;
+    uint64_t now_us = fabric_now_us(ep->fabric);
+    uint64_t next_us;
+    
+    if (inbound_ready(transport, now_us, &next_us)) return 1;
+    
+    // Anuncia que vai dormir e volta a ver: um envio entre as duas
+    // verificações encontra sleeping = true e escreve no eventfd
+    atomic_store(&ep->sleeping, true);
+    atomic_thread_fence(memory_order_seq_cst);
+    
+    if (inbound_ready(transport, now_us, &next_us)) {
+        atomic_store(&ep->sleeping, false);
+        return 1;
+    }
+    
+    uint64_t wait_us = timeout_ms < 0 ? UINT64_MAX : (uint64_t)timeout_ms * 1000;
+    if (next_us != UINT64_MAX && next_us - now_us < wait_us) {
+        wait_us = next_us - now_us;
+    }
+    
+    struct timespec ts = {
+        .tv_sec = wait_us / 1000000,
+        .tv_nsec = (wait_us % 1000000) * 1000
+    };
+    struct pollfd pfd = { .fd = transport->wake_fd, .events = POLLIN };
+    
+    int n = ppoll(&pfd, 1, wait_us == UINT64_MAX ? NULL : &ts, NULL);
+    atomic_store(&ep->sleeping, false);
+    
+    if (n < 0 && errno != EINTR) {
+        perror("ppoll");
+        return -1;
+    }
+    if (n > 0) {
+        uint64_t value;
+        if (read(transport->wake_fd, &value, sizeof(value)) < 0) {
+            // EAGAIN: outro waiter já consumiu o wakeup
+        }
+    }
+    
+    return inbound_ready(transport, fabric_now_us(ep->fabric), &next_us) ? 1 : 0;
+}
+
+int shm_endpoint_receive_batch(udp_transport_t *transport,
+                               udp_rx_packet_t *packets, int max_packets) {
+    shm_endpoint_t *ep = transport->shm;
+    shm_inbound_t *inbound = &ep->fabric->inbound[transport->my_node_id - 1];
+    
+    if (max_packets > UDP_RX_BATCH) max_packets = UDP_RX_BATCH;
+    if (max_packets <= 0) return -1;
+    
+    // Os payloads da chamada anterior deixam de ser válidos
+    for (int i = 0; i < ep->num_held; i++) {
+        buffer_pool_release(transport->pool, ep->held[i]);
+    }
+    ep->num_held = 0;
+    
+    uint32_t links = atomic_load_explicit(&inbound->count, memory_order_acquire);
+    if (links == 0) return 0;
+    
+    uint64_t now_us = fabric_now_us(ep->fabric);
+    int count = 0;
+    
+    // Começa num link diferente a cada chamada: nenhum vizinho monopoliza o batch
+    for (uint32_t k = 0; k < links && count < max_packets; k++) {
+        shm_link_t *link = atomic_load_explicit(
+            &inbound->links[(ep->next_inbound + k) % links], memory_order_acquire);
+        uint32_t tail = atomic_load_explicit(&link->tail, memory_order_relaxed);
+        uint32_t head = atomic_load_explicit(&link->head, memory_order_acquire);
+        uint32_t start = tail;
+        
+        while (tail != head && count < max_packets) {
+            shm_link_slot_t *slot = &link->slots[tail & SHM_LINK_MASK];
+            if (slot->deliver_at_us > now_us) break;   // FIFO: os seguintes também esperam
+            
+            udp_rx_packet_t *pkt = &packets[count++];
+            memcpy(&pkt->header, slot->buffer, sizeof(udp_header_t));
+            pkt->payload = slot->buffer + sizeof(udp_header_t);
+            pkt->payload_len = pkt->header.payload_len;
+            
+            ep->held[ep->num_held++] = slot->buffer;
+            udp_transport_count_rx(transport, sizeof(udp_header_t) + pkt->payload_len);
+            tail++;
+        }
+        
+        if (tail != start) {
+            link->stats.delivered += tail - start;
+            atomic_store_explicit(&link->tail, tail, memory_order_release);
+        }
+    }
+    
+    ep->next_inbound = (ep->next_inbound + 1) % links;
+    if (count > 0) transport->rx_batches++;
+    
+    return count;
+}
+
+uint8_t *shm_endpoint_claim_rx_buffer(udp_transport_t *transport,
+                                      const uint8_t *payload) {
+    shm_endpoint_t *ep = transport->shm;
+    if (!payload) return NULL;
+    
+    for (int i = 0; i < ep->num_held; i++) {
+        uint8_t *buffer = ep->held[i];
+        if (!buffer || payload != buffer + sizeof(udp_header_t)) continue;
+        
+        // Já é do pool deste nó: só deixa de ser libertado no próximo batch
+        ep->held[i] = NULL;
+        return buffer;
+    }
+    
+    return NULL;
+}
@@ -0,0 +1,126 @@
+// src/network/stream_arq.c
+#include "stream_arq.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int arq_window_init(arq_window_t *window) {
+    memset(window, 0, sizeof(arq_window_t));
+
+    if (pthread_mutex_init(&window->lock, NULL) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+void arq_window_destroy(arq_window_t *window) {
+    for (int i = 0; i < ARQ_WINDOW_STREAMS; i++) {
+        free(window->streams[i].data);
+    }
+    memset(window->streams, 0, sizeof(window->streams));
+    pthread_mutex_destroy(&window->lock);
+}
+
+int arq_window_retain(arq_window_t *window, node_id_t dst, uint32_t stream_id,
+                      uint8_t type, const uint8_t *data, uint32_t size,
+                      uint32_t chunk_stride, uint64_t origin_us,
+                      uint64_t deadline_us) {
+    if (size == 0 || chunk_stride == 0) return -1;
+
+    pthread_mutex_lock(&window->lock);
+
+    arq_stream_t *entry = &window->streams[window->next];
+
+    if (size > entry->capacity) {
+        uint8_t *buf = realloc(entry->data, size);
+        if (!buf) {
+            entry->active = false;
+            pthread_mutex_unlock(&window->lock);
+            return -1;
+        }
+        entry->data = buf;
+        entry->capacity = size;
+    }
+    memcpy(entry->data, data, size);
+
+    entry->active = true;
+    entry->dst = dst;
+    entry->stream_id = stream_id;
+    entry->type = type;
+    entry->size = size;
+    entry->chunk_stride = chunk_stride;
+    entry->total_chunks = (size + chunk_stride - 1) / chunk_stride;
+    entry->origin_us = origin_us;
+    entry->deadline_us = deadline_us;
+    entry->retransmitted = 0;
+
+    window->next = (window->next + 1) % ARQ_WINDOW_STREAMS;
+    window->streams_retained++;
+
+    pthread_mutex_unlock(&window->lock);
+    return 0;
+}
+
+int arq_window_on_nack(arq_window_t *window, node_id_t src, uint32_t stream_id,
+                       uint32_t base_seq, uint32_t num_chunks,
+                       const uint64_t *missing, uint64_t now_us,
+                       arq_retransmit_cb retransmit, void *ctx) {
+    pthread_mutex_lock(&window->lock);
+    window->nacks_received++;
+
+    arq_stream_t *entry = NULL;
+    for (int i = 0; i < ARQ_WINDOW_STREAMS; i++) {
+        arq_stream_t *s = &window->streams[i];
+        if (s->active && s->dst == src && s->stream_id == stream_id) {
+            entry = s;
+            break;
+        }
+    }
+
+    if (!entry) {
+        window->nacks_unknown++;
+        pthread_mutex_unlock(&window->lock);
+        return -1;
+    }
+
+    // Para tempo real, um chunk fora do prazo já não serve ao recetor
+    if (entry->deadline_us && now_us > entry->deadline_us) {
+        window->nacks_late++;
+        entry->active = false;
+        pthread_mutex_unlock(&window->lock);
+        return -1;
+    }
+
+    int resent = 0;
+    for (uint32_t bit = 0; bit < num_chunks; bit++) {
+        if (!(missing[bit / 64] & (1ULL << (bit % 64)))) continue;
+
+        uint32_t seq = base_seq + bit;
+        if (seq >= entry->total_chunks) break;
+
+        uint32_t offset = seq * entry->chunk_stride;
+        uint32_t len = entry->size - offset < entry->chunk_stride ?
+                       entry->size - offset : entry->chunk_stride;
+
+        if (retransmit(entry, seq, entry->data + offset, len, ctx) < 0) {
+            window->retransmit_failed++;
+            break;   // Fila cheia: o resto fica para o próximo NACK
+        }
+        entry->retransmitted++;
+        window->chunks_retransmitted++;
+        resent++;
+    }
+
+    pthread_mutex_unlock(&window->lock);
+    return resent;
+}
+
+void arq_window_print_stats(arq_window_t *window) {
+    printf("\n🔁 Retransmission (ARQ):\n");
+    printf("   Retained:      %lu streams (window %d)\n",
+           window->streams_retained, ARQ_WINDOW_STREAMS);
+    printf("   NACKs:         %lu received | %lu unknown | %lu late\n",
+           window->nacks_received, window->nacks_unknown, window->nacks_late);
+    printf("   Retransmitted: %lu chunks (failed: %lu)\n",
+           window->chunks_retransmitted, window->retransmit_failed);
+}
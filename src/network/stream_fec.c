@@ -0,0 +1,226 @@
+// src/network/stream_fec.c
+#include "stream_fec.h"
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FEC_HAVE_SSSE3 1
+#endif
+
+#define GF_POLY 0x11D                 // x^8 + x^4 + x^3 + x^2 + 1
+
+static uint8_t gf_exp[512];
+static uint8_t gf_log[256];
+static bool use_ssse3 = false;
+static pthread_once_t tables_once = PTHREAD_ONCE_INIT;
+
+// ========================================
+// GF(256) Arithmetic
+// ========================================
+
+static void init_tables(void) {
+    uint32_t x = 1;
+    for (int i = 0; i < 255; i++) {
+        gf_exp[i] = (uint8_t)x;
+        gf_log[x] = (uint8_t)i;
+        x <<= 1;
+        if (x & 0x100) x ^= GF_POLY;
+    }
+    // Duplicada: exp[log a + log b] sem módulo
+    for (int i = 255; i < 512; i++) {
+        gf_exp[i] = gf_exp[i - 255];
+    }
+
+#ifdef FEC_HAVE_SSSE3
+    __builtin_cpu_init();
+    use_ssse3 = __builtin_cpu_supports("ssse3");
+#endif
+}
+
+static inline uint8_t gf_mul(uint8_t a, uint8_t b) {
+    if (a == 0 || b == 0) return 0;
+    return gf_exp[gf_log[a] + gf_log[b]];
+}
+
+static inline uint8_t gf_inv(uint8_t a) {
+    return gf_exp[255 - gf_log[a]];
+}
+
+// Matriz de Cauchy 1 / (x_j + y_i), x_j = FEC_MAX_DATA + j, y_i = i:
+// qualquer submatriz quadrada é invertível
+static inline uint8_t cauchy(uint32_t j, uint32_t i) {
+    return gf_inv((uint8_t)((FEC_MAX_DATA + j) ^ i));
+}
+
+// ========================================
+// Multiply-Accumulate (split nibble tables)
+// ========================================
+
+#ifdef FEC_HAVE_SSSE3
+// 16 bytes por iteração: pshufb faz 16 lookups de 4 bits de uma vez
+__attribute__((target("ssse3")))
+static uint32_t mul_add_ssse3(uint8_t *dst, const uint8_t *src,
+                              const uint8_t *lo, const uint8_t *hi, uint32_t len) {
+    __m128i tlo = _mm_loadu_si128((const __m128i *)lo);
+    __m128i thi = _mm_loadu_si128((const __m128i *)hi);
+    __m128i mask = _mm_set1_epi8(0x0F);
+    
+    uint32_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i l = _mm_shuffle_epi8(tlo, _mm_and_si128(s, mask));
+        __m128i h = _mm_shuffle_epi8(thi, _mm_and_si128(_mm_srli_epi64(s, 4), mask));
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_xor_si128(d, _mm_xor_si128(l, h)));
+    }
+    return i;
+}
+#endif
+
+void gf256_mul_add(uint8_t *dst, const uint8_t *src, uint8_t c, uint32_t len) {
+    pthread_once(&tables_once, init_tables);
+    
+    if (c == 0) return;
+    
+    uint32_t i = 0;
+    if (c == 1) {
+        for (; i < len; i++) dst[i] ^= src[i];
+        return;
+    }
+    
+    // c * s = c * (s & 0x0F) ^ c * (s & 0xF0)
+    uint8_t lo[16], hi[16];
+    for (int x = 0; x < 16; x++) {
+        lo[x] = gf_mul(c, (uint8_t)x);
+        hi[x] = gf_mul(c, (uint8_t)(x << 4));
+    }
+
+#ifdef FEC_HAVE_SSSE3
+    if (use_ssse3) {
+        i = mul_add_ssse3(dst, src, lo, hi, len);
+    }
+#endif
+    
+    for (; i < len; i++) {
+        dst[i] ^= lo[src[i] & 0x0F] ^ hi[src[i] >> 4];
+    }
+}
+
+// ========================================
+// Encode / Decode
+// ========================================
+
+int fec_encode(const uint8_t *const *data, uint32_t n,
+               uint8_t *const *parity, uint32_t k, uint32_t len) {
+    if (n == 0 || n > FEC_MAX_DATA || k == 0 || k > FEC_MAX_PARITY) {
+        return -1;
+    }
+    pthread_once(&tables_once, init_tables);
+    
+    for (uint32_t j = 0; j < k; j++) {
+        memset(parity[j], 0, len);
+        for (uint32_t i = 0; i < n; i++) {
+            gf256_mul_add(parity[j], data[i], cauchy(j, i), len);
+        }
+    }
+    return 0;
+}
+
+// Inverte a (e x e) por Gauss-Jordan; a é destruída
+static int invert_matrix(uint8_t a[][FEC_MAX_PARITY], uint8_t inv[][FEC_MAX_PARITY],
+                         uint32_t e) {
+    for (uint32_t r = 0; r < e; r++) {
+        memset(inv[r], 0, FEC_MAX_PARITY);
+        inv[r][r] = 1;
+    }
+    
+    for (uint32_t col = 0; col < e; col++) {
+        uint32_t pivot = col;
+        while (pivot < e && a[pivot][col] == 0) pivot++;
+        if (pivot == e) return -1;
+        
+        if (pivot != col) {
+            uint8_t tmp[FEC_MAX_PARITY];
+            memcpy(tmp, a[col], FEC_MAX_PARITY);
+            memcpy(a[col], a[pivot], FEC_MAX_PARITY);
+            memcpy(a[pivot], tmp, FEC_MAX_PARITY);
+            memcpy(tmp, inv[col], FEC_MAX_PARITY);
+            memcpy(inv[col], inv[pivot], FEC_MAX_PARITY);
+            memcpy(inv[pivot], tmp, FEC_MAX_PARITY);
+        }
+        
+        uint8_t scale = gf_inv(a[col][col]);
+        for (uint32_t c = 0; c < e; c++) {
+            a[col][c] = gf_mul(a[col][c], scale);
+            inv[col][c] = gf_mul(inv[col][c], scale);
+        }
+        
+        for (uint32_t r = 0; r < e; r++) {
+            uint8_t f = a[r][col];
+            if (r == col || f == 0) continue;
+            for (uint32_t c = 0; c < e; c++) {
+                a[r][c] ^= gf_mul(f, a[col][c]);
+                inv[r][c] ^= gf_mul(f, inv[col][c]);
+            }
+        }
+    }
+    return 0;
+}
+
+int fec_decode(uint8_t *const *data, const bool *present, uint32_t n,
+               const uint8_t *const *parity, uint32_t k, uint32_t len) {
+    if (n == 0 || n > FEC_MAX_DATA || k == 0 || k > FEC_MAX_PARITY ||
+        len > FEC_MAX_LEN) {
+        return -1;
+    }
+    pthread_once(&tables_once, init_tables);
+    
+    uint32_t missing[FEC_MAX_PARITY];
+    uint32_t rows[FEC_MAX_PARITY];
+    uint32_t e = 0, r = 0;
+    
+    for (uint32_t i = 0; i < n; i++) {
+        if (present[i]) continue;
+        if (e == FEC_MAX_PARITY) return -1;
+        missing[e++] = i;
+    }
+    if (e == 0) return 0;
+    
+    for (uint32_t j = 0; j < k && r < e; j++) {
+        if (parity[j]) rows[r++] = j;
+    }
+    if (r < e) return -1;
+    
+    // rhs_t = p_rows[t] - soma dos dados presentes
+    static __thread uint8_t rhs[FEC_MAX_PARITY][FEC_MAX_LEN];
+    for (uint32_t t = 0; t < e; t++) {
+        memcpy(rhs[t], parity[rows[t]], len);
+        for (uint32_t i = 0; i < n; i++) {
+            if (present[i]) {
+                gf256_mul_add(rhs[t], data[i], cauchy(rows[t], i), len);
+            }
+        }
+    }
+    
+    // A[t][u] = C[rows[t]][missing[u]]; dados em falta = A^-1 * rhs
+    uint8_t a[FEC_MAX_PARITY][FEC_MAX_PARITY];
+    uint8_t inv[FEC_MAX_PARITY][FEC_MAX_PARITY];
+    for (uint32_t t = 0; t < e; t++) {
+        for (uint32_t u = 0; u < e; u++) {
+            a[t][u] = cauchy(rows[t], missing[u]);
+        }
+    }
+    if (invert_matrix(a, inv, e) < 0) return -1;
+    
+    for (uint32_t u = 0; u < e; u++) {
+        uint8_t *out = data[missing[u]];
+        memset(out, 0, len);
+        for (uint32_t t = 0; t < e; t++) {
+            gf256_mul_add(out, rhs[t], inv[u][t], len);
+        }
+    }
+    
+    return (int)e;
+}
@@ -0,0 +1,457 @@
+// src/network/stream_reassembly.c
+#include "stream_reassembly.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ========================================
+// Slot Management
+// ========================================
+
+static void release_slot(reasm_engine_t *engine, reasm_slot_t *slot, bool completed,
+                         uint64_t now_ms) {
+    if (!completed) {
+        engine->chunks_lost += slot->total_chunks - slot->chunks_received;
+    }
+    slot->active = false;
+    
+    // Chunks que ainda cheguem deste stream já não o reabrem
+    engine->closed[engine->closed_next] = (reasm_closed_t){
+        .src = slot->src,
+        .stream_id = slot->stream_id,
+        .closed_ms = now_ms
+    };
+    engine->closed_next = (engine->closed_next + 1) % REASM_RECENT_STREAMS;
+}
+
+// Só dentro de timeout_ms: um emissor reiniciado volta a usar os mesmos stream_id
+static bool recently_closed(const reasm_engine_t *engine, const reasm_chunk_t *chunk,
+                            uint64_t now_ms) {
+    for (int i = 0; i < REASM_RECENT_STREAMS; i++) {
+        const reasm_closed_t *closed = &engine->closed[i];
+        if (closed->stream_id == chunk->stream_id && closed->src == chunk->src &&
+            closed->closed_ms > 0 && now_ms - closed->closed_ms <= engine->timeout_ms) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Prepara o slot para um stream novo (reutiliza buffer/bitmap se couberem)
+static int open_slot(reasm_slot_t *slot, const reasm_chunk_t *chunk,
+                     uint32_t capacity, uint64_t now_ms) {
+    if (capacity > slot->capacity) {
+        uint8_t *data = realloc(slot->data, capacity);
+        if (!data) return -1;
+        slot->data = data;
+        slot->capacity = capacity;
+    }
+    
+    uint32_t words = (chunk->total_chunks + 63) / 64;
+    if (words > slot->bitmap_words) {
+        uint64_t *bitmap = realloc(slot->received, words * sizeof(uint64_t));
+        if (!bitmap) return -1;
+        slot->received = bitmap;
+        slot->bitmap_words = words;
+    }
+    memset(slot->received, 0, words * sizeof(uint64_t));
+    
+    slot->active = true;
+    slot->src = chunk->src;
+    slot->stream_id = chunk->stream_id;
+    slot->type = chunk->type;
+    slot->total_chunks = chunk->total_chunks;
+    slot->chunk_stride = chunk->chunk_stride;
+    slot->chunks_received = 0;
+    slot->size = 0;
+    slot->next_expected = 0;
+    slot->highest_seq = 0;
+    slot->out_of_order = 0;
+    slot->first_rx_ms = now_ms;
+    slot->last_rx_ms = now_ms;
+    slot->deadline_ms = chunk->deadline_ms ? now_ms + chunk->deadline_ms : 0;
+    slot->last_nack_ms = 0;
+    slot->origin_us = chunk->origin_us;
+    slot->hops = chunk->hops;
+    slot->fec_n = 0;
+    slot->fec_k = 0;
+    slot->recovered = 0;
+    return 0;
+}
+
+// ========================================
+// FEC
+// ========================================
+
+// Guarda uma paridade; devolve o bloco a que pertence, -1 se inválida/duplicada
+static int store_parity(reasm_slot_t *slot, const reasm_chunk_t *chunk) {
+    uint32_t blocks = (slot->total_chunks + chunk->fec_n - 1) / chunk->fec_n;
+    uint32_t count = blocks * chunk->fec_k;
+    
+    if (slot->fec_k == 0) {
+        // Primeira paridade do stream: fixa a geometria
+        uint32_t capacity = count * slot->chunk_stride;
+        if (capacity > slot->parity_capacity) {
+            uint8_t *parity = realloc(slot->parity, capacity);
+            if (!parity) return -1;
+            slot->parity = parity;
+            slot->parity_capacity = capacity;
+        }
+        
+        uint32_t words = (count + 63) / 64;
+        if (words > slot->parity_words) {
+            uint64_t *bitmap = realloc(slot->parity_received, words * sizeof(uint64_t));
+            if (!bitmap) return -1;
+            slot->parity_received = bitmap;
+            slot->parity_words = words;
+        }
+        memset(slot->parity_received, 0, words * sizeof(uint64_t));
+        
+        slot->fec_n = chunk->fec_n;
+        slot->fec_k = chunk->fec_k;
+    } else if (slot->fec_n != chunk->fec_n || slot->fec_k != chunk->fec_k) {
+        return -1;
+    }
+    
+    uint32_t index = chunk->sequence - slot->total_chunks;
+    uint64_t bit = 1ULL << (index % 64);
+    if (slot->parity_received[index / 64] & bit) return -1;
+    slot->parity_received[index / 64] |= bit;
+    
+    memcpy(slot->parity + (size_t)index * slot->chunk_stride, chunk->data, chunk->len);
+    
+    if (slot->size == 0) {
+        slot->size = chunk->frame_size;
+    }
+    return index / slot->fec_k;
+}
+
+// Reconstrói o bloco se já há paridades para todos os chunks em falta
+static uint32_t try_recover(reasm_slot_t *slot, uint32_t block) {
+    uint32_t n = slot->fec_n, k = slot->fec_k, stride = slot->chunk_stride;
+    uint32_t first = block * n;
+    uint32_t count = slot->total_chunks - first < n ? slot->total_chunks - first : n;
+    
+    uint8_t *data[FEC_MAX_DATA];
+    bool present[FEC_MAX_DATA];
+    const uint8_t *parity[FEC_MAX_PARITY];
+    uint32_t missing = 0, parities = 0;
+    
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t seq = first + i;
+        present[i] = slot->received[seq / 64] & (1ULL << (seq % 64));
+        data[i] = slot->data + (size_t)seq * stride;
+        if (!present[i]) missing++;
+    }
+    if (missing == 0) return 0;
+    
+    for (uint32_t j = 0; j < k; j++) {
+        uint32_t index = block * k + j;
+        bool got = slot->parity_received[index / 64] & (1ULL << (index % 64));
+        parity[j] = got ? slot->parity + (size_t)index * stride : NULL;
+        if (got) parities++;
+    }
+    if (parities < missing) return 0;
+    
+    if (fec_decode(data, present, count, parity, k, stride) != (int)missing) {
+        return 0;
+    }
+    
+    for (uint32_t i = 0; i < count; i++) {
+        if (present[i]) continue;
+        uint32_t seq = first + i;
+        slot->received[seq / 64] |= 1ULL << (seq % 64);
+    }
+    slot->chunks_received += missing;
+    slot->recovered += missing;
+    return missing;
+}
+
+static reasm_slot_t *find_slot(reasm_engine_t *engine, const reasm_chunk_t *chunk,
+                               uint64_t now_ms) {
+    reasm_slot_t *free_slot = NULL;
+    reasm_slot_t *oldest = NULL;
+    
+    for (int i = 0; i < REASM_MAX_STREAMS; i++) {
+        reasm_slot_t *slot = &engine->slots[i];
+        
+        if (!slot->active) {
+            if (!free_slot) free_slot = slot;
+            continue;
+        }
+        
+        if (slot->src == chunk->src && slot->stream_id == chunk->stream_id) {
+            return slot;
+        }
+        
+        if (!oldest || slot->last_rx_ms < oldest->last_rx_ms) {
+            oldest = slot;
+        }
+    }
+    
+    // Sem slots livres: despeja o stream parado há mais tempo
+    if (!free_slot) {
+        engine->frames_evicted++;
+        release_slot(engine, oldest, false, now_ms);
+        free_slot = oldest;
+    }
+    
+    uint32_t capacity = chunk->total_chunks * chunk->chunk_stride;
+    if (open_slot(free_slot, chunk, capacity, now_ms) < 0) {
+        return NULL;
+    }
+    return free_slot;
+}
+
+// ========================================
+// API
+// ========================================
+
+void reasm_init(reasm_engine_t *engine, uint32_t max_frame_size,
+                reasm_deliver_cb deliver, void *ctx) {
+    memset(engine, 0, sizeof(reasm_engine_t));
+    engine->max_frame_size = max_frame_size;
+    engine->deliver = deliver;
+    engine->ctx = ctx;
+    engine->timeout_ms = REASM_TIMEOUT_MS;
+    engine->nack_interval_ms = REASM_TIMEOUT_MS;
+}
+
+void reasm_destroy(reasm_engine_t *engine) {
+    for (int i = 0; i < REASM_MAX_STREAMS; i++) {
+        free(engine->slots[i].data);
+        free(engine->slots[i].received);
+        free(engine->slots[i].parity);
+        free(engine->slots[i].parity_received);
+    }
+    memset(engine->slots, 0, sizeof(engine->slots));
+}
+
+static bool chunk_valid(const reasm_engine_t *engine, const reasm_chunk_t *chunk) {
+    if (chunk->total_chunks == 0 || chunk->chunk_stride == 0 ||
+        chunk->len > chunk->chunk_stride ||
+        (uint64_t)chunk->total_chunks * chunk->chunk_stride > engine->max_frame_size) {
+        return false;
+    }
+    
+    if (chunk->parity) {
+        // Paridade: ocupa um chunk inteiro e o frame_size tem de bater certo
+        if (chunk->fec_n == 0 || chunk->fec_n > FEC_MAX_DATA ||
+            chunk->fec_k == 0 || chunk->fec_k > FEC_MAX_PARITY ||
+            chunk->sequence < chunk->total_chunks ||
+            chunk->len != chunk->chunk_stride ||
+            chunk->frame_size <= (chunk->total_chunks - 1) * chunk->chunk_stride ||
+            chunk->frame_size > chunk->total_chunks * chunk->chunk_stride) {
+            return false;
+        }
+        uint32_t blocks = (chunk->total_chunks + chunk->fec_n - 1) / chunk->fec_n;
+        return chunk->sequence - chunk->total_chunks < blocks * chunk->fec_k;
+    }
+    
+    // Dados: o chunk tem de caber na posição que o sequence indica
+    return chunk->sequence < chunk->total_chunks &&
+           (chunk->sequence + 1 == chunk->total_chunks || chunk->len == chunk->chunk_stride);
+}
+
+// Frame completo: entregue a partir do buffer do slot, sem cópia
+static void deliver_frame(reasm_engine_t *engine, reasm_slot_t *slot) {
+    reasm_frame_t frame = {
+        .src = slot->src,
+        .stream_id = slot->stream_id,
+        .type = slot->type,
+        .data = slot->data,
+        .size = slot->size,
+        .chunks = slot->total_chunks,
+        .out_of_order = slot->out_of_order,
+        .recovered = slot->recovered,
+        .duration_ms = slot->last_rx_ms - slot->first_rx_ms,
+        .origin_us = slot->origin_us,
+        .hops = slot->hops
+    };
+    
+    engine->frames_completed++;
+    if (slot->recovered > 0) {
+        engine->frames_recovered++;
+    }
+    release_slot(engine, slot, true, slot->last_rx_ms);
+    
+    if (engine->deliver) {
+        engine->deliver(&frame, engine->ctx);
+    }
+}
+
+int reasm_on_chunk(reasm_engine_t *engine, const reasm_chunk_t *chunk,
+                   uint64_t now_ms) {
+    if (!chunk_valid(engine, chunk)) {
+        engine->chunks_rejected++;
+        return -1;
+    }
+    
+    // Paridade ou retransmissão de um frame que já fechou
+    if (recently_closed(engine, chunk, now_ms)) {
+        engine->chunks_duplicate++;
+        return -1;
+    }
+    
+    reasm_slot_t *slot = find_slot(engine, chunk, now_ms);
+    if (!slot || slot->total_chunks != chunk->total_chunks ||
+        slot->chunk_stride != chunk->chunk_stride) {
+        engine->chunks_rejected++;
+        return -1;
+    }
+    
+    // Chunks de um frame podem seguir caminhos diferentes (reencaminhamento)
+    if (chunk->hops > slot->hops) {
+        slot->hops = chunk->hops;
+    }
+    
+    if (chunk->parity) {
+        int block = store_parity(slot, chunk);
+        if (block < 0) {
+            engine->chunks_duplicate++;
+            return -1;
+        }
+        
+        slot->last_rx_ms = now_ms;
+        engine->parity_accepted++;
+        engine->chunks_recovered += try_recover(slot, block);
+        
+        if (slot->chunks_received < slot->total_chunks) {
+            return 0;
+        }
+        deliver_frame(engine, slot);
+        return 1;
+    }
+    
+    uint64_t bit = 1ULL << (chunk->sequence % 64);
+    uint64_t *word = &slot->received[chunk->sequence / 64];
+    if (*word & bit) {
+        engine->chunks_duplicate++;
+        return -1;
+    }
+    *word |= bit;
+    
+    uint8_t *dst = slot->data + (size_t)chunk->sequence * chunk->chunk_stride;
+    memcpy(dst, chunk->data, chunk->len);
+    
+    // Último chunk: padding a zeros, como no encoder FEC
+    if (chunk->len < chunk->chunk_stride) {
+        memset(dst + chunk->len, 0, chunk->chunk_stride - chunk->len);
+    }
+    
+    if (chunk->sequence != slot->next_expected) {
+        slot->out_of_order++;
+        engine->chunks_out_of_order++;
+    }
+    slot->next_expected = chunk->sequence + 1;
+    if (chunk->sequence > slot->highest_seq) {
+        slot->highest_seq = chunk->sequence;
+    }
+    
+    if (chunk->sequence == chunk->total_chunks - 1) {
+        slot->size = chunk->sequence * chunk->chunk_stride + chunk->len;
+    }
+    
+    slot->chunks_received++;
+    slot->last_rx_ms = now_ms;
+    engine->chunks_accepted++;
+    
+    if (slot->fec_k > 0) {
+        engine->chunks_recovered += try_recover(slot, chunk->sequence / slot->fec_n);
+    }
+    
+    if (slot->chunks_received < slot->total_chunks) {
+        return 0;
+    }
+    deliver_frame(engine, slot);
+    return 1;
+}
+
+int reasm_expire(reasm_engine_t *engine, uint64_t now_ms) {
+    int expired = 0;
+    
+    for (int i = 0; i < REASM_MAX_STREAMS; i++) {
+        reasm_slot_t *slot = &engine->slots[i];
+        if (!slot->active) continue;
+        
+        if (slot->deadline_ms && now_ms > slot->deadline_ms) {
+            engine->frames_late++;
+        } else if (now_ms - slot->last_rx_ms > engine->timeout_ms) {
+            engine->frames_expired++;
+        } else {
+            continue;
+        }
+        release_slot(engine, slot, false, now_ms);
+        expired++;
+    }
+    
+    return expired;
+}
+
+int reasm_collect_gaps(reasm_engine_t *engine, uint64_t now_ms,
+                       reasm_gap_t *gaps, int max_gaps) {
+    int count = 0;
+    
+    for (int i = 0; i < REASM_MAX_STREAMS && count < max_gaps; i++) {
+        reasm_slot_t *slot = &engine->slots[i];
+        if (!slot->active || now_ms - slot->last_nack_ms < engine->nack_interval_ms ||
+            (slot->deadline_ms && now_ms > slot->deadline_ms)) {
+            continue;
+        }
+        
+        // Sem chunks há um intervalo: a cauda também se perdeu
+        bool idle = now_ms - slot->last_rx_ms >= engine->nack_interval_ms;
+        uint32_t end = idle ? slot->total_chunks : slot->highest_seq;
+        
+        reasm_gap_t *gap = &gaps[count];
+        memset(gap, 0, sizeof(reasm_gap_t));
+        
+        for (uint32_t seq = 0; seq < end; seq++) {
+            if (slot->received[seq / 64] & (1ULL << (seq % 64))) continue;
+            
+            if (gap->missing_count == 0) {
+                gap->base_seq = seq;
+            }
+            uint32_t bit = seq - gap->base_seq;
+            if (bit >= REASM_GAP_MAX_CHUNKS) break;   // Resto no próximo NACK
+            
+            gap->missing[bit / 64] |= 1ULL << (bit % 64);
+            gap->num_chunks = bit + 1;
+            gap->missing_count++;
+        }
+        
+        if (gap->missing_count == 0) continue;
+        
+        gap->src = slot->src;
+        gap->stream_id = slot->stream_id;
+        slot->last_nack_ms = now_ms;
+        engine->gaps_reported++;
+        count++;
+    }
+    
+    return count;
+}
+
+int reasm_active_streams(const reasm_engine_t *engine) {
+    int count = 0;
+    for (int i = 0; i < REASM_MAX_STREAMS; i++) {
+        if (engine->slots[i].active) count++;
+    }
+    return count;
+}
+
+void reasm_print_stats(const reasm_engine_t *engine) {
+    printf("\n📦 Reassembly:\n");
+    printf("   Active:        %d / %d streams\n",
+           reasm_active_streams(engine), REASM_MAX_STREAMS);
+    printf("   Chunks:        %lu accepted | %lu out of order | %lu dup | %lu rejected\n",
+           engine->chunks_accepted, engine->chunks_out_of_order,
+           engine->chunks_duplicate, engine->chunks_rejected);
+    printf("   Frames:        %lu completed | %lu expired | %lu late | %lu evicted "
+           "(%lu chunks lost)\n",
+           engine->frames_completed, engine->frames_expired, engine->frames_late,
+           engine->frames_evicted, engine->chunks_lost);
+    printf("   Gaps:          %lu reported (NACK)\n", engine->gaps_reported);
+    printf("   FEC:           %lu parity | %lu chunks recovered | %lu frames recovered\n",
+           engine->parity_accepted, engine->chunks_recovered, engine->frames_recovered);
+}
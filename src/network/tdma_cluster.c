@@ -0,0 +1,133 @@
+// src/network/tdma_cluster.c
+#include "tdma_cluster.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ========================================
+// Lifecycle
+// ========================================
+
+int tdma_cluster_init(tdma_cluster_t *cluster, int num_nodes,
+                      routing_strategy_t strategy, uint64_t seed) {
+    memset(cluster, 0, sizeof(tdma_cluster_t));
+    
+    if (num_nodes < 2 || num_nodes > MAX_NETWORK_NODES) {
+        fprintf(stderr, "[CLUSTER] Invalid node count: %d\n", num_nodes);
+        return -1;
+    }
+    
+    if (shm_fabric_init(&cluster->fabric, num_nodes, seed) < 0) {
+        return -1;
+    }
+    
+    cluster->nodes = calloc(num_nodes, sizeof(tdma_node_t));
+    if (!cluster->nodes) {
+        shm_fabric_destroy(&cluster->fabric);
+        return -1;
+    }
+    
+    for (int i = 0; i < num_nodes; i++) {
+        if (tdma_node_init_shm(&cluster->nodes[i], i + 1, num_nodes,
+                               strategy, &cluster->fabric) < 0) {
+            fprintf(stderr, "[CLUSTER] Failed to init node %d\n", i + 1);
+            cluster->num_nodes = i;       // Só os que inicializaram por completo
+            tdma_cluster_destroy(cluster);
+            return -1;
+        }
+    }
+    
+    cluster->num_nodes = num_nodes;
+    printf("[CLUSTER] %d nodes on a shared-memory fabric\n", num_nodes);
+    return 0;
+}
+
+tdma_node_t *tdma_cluster_node(tdma_cluster_t *cluster, node_id_t id) {
+    if (id < 1 || id > cluster->num_nodes) return NULL;
+    return &cluster->nodes[id - 1];
+}
+
+int tdma_cluster_start(tdma_cluster_t *cluster) {
+    for (int i = 0; i < cluster->num_nodes; i++) {
+        if (tdma_node_start(&cluster->nodes[i]) < 0) {
+            fprintf(stderr, "[CLUSTER] Failed to start node %d\n", i + 1);
+            cluster->running = true;      // Para parar os que já arrancaram
+            tdma_cluster_stop(cluster);
+            return -1;
+        }
+    }
+    
+    cluster->running = true;
+    return 0;
+}
+
+void tdma_cluster_stop(tdma_cluster_t *cluster) {
+    if (!cluster->running) return;
+    
+    for (int i = 0; i < cluster->num_nodes; i++) {
+        if (cluster->nodes[i].running) {
+            tdma_node_stop(&cluster->nodes[i]);
+        }
+    }
+    
+    cluster->running = false;
+}
+
+void tdma_cluster_destroy(tdma_cluster_t *cluster) {
+    tdma_cluster_stop(cluster);
+    
+    // Cada nó desliga-se da fabric e devolve os pacotes em voo ao seu pool
+    for (int i = 0; i < cluster->num_nodes; i++) {
+        tdma_node_destroy(&cluster->nodes[i]);
+    }
+    
+    free(cluster->nodes);
+    cluster->nodes = NULL;
+    cluster->num_nodes = 0;
+    shm_fabric_destroy(&cluster->fabric);
+}
+
+// ========================================
+// Status
+// ========================================
+
+int tdma_cluster_synchronized(tdma_cluster_t *cluster) {
+    int count = 0;
+    for (int i = 0; i < cluster->num_nodes; i++) {
+        if (cluster->nodes[i].ra_sync.is_synchronized) count++;
+    }
+    return count;
+}
+
+void tdma_cluster_print_summary(tdma_cluster_t *cluster) {
+    uint64_t hb_sent = 0, hb_received = 0;
+    uint64_t pkts_sent = 0, pkts_received = 0;
+    uint64_t forwarded = 0, delivered = 0, recomputations = 0;
+    uint32_t min_round = UINT32_MAX, max_round = 0;
+    
+    for (int i = 0; i < cluster->num_nodes; i++) {
+        tdma_node_t *node = &cluster->nodes[i];
+        
+        hb_sent += metrics_value(&node->metrics, node->metric_ids.heartbeats_sent);
+        hb_received += metrics_value(&node->metrics, node->metric_ids.heartbeats_received);
+        pkts_sent += node->transport.packets_sent;
+        pkts_received += node->transport.packets_received;
+        forwarded += node->forwarding.forwarded;
+        delivered += node->forwarding.delivered;
+        recomputations += node->routing_mgr.recomputations;
+        
+        if (node->ra_sync.round_number < min_round) min_round = node->ra_sync.round_number;
+        if (node->ra_sync.round_number > max_round) max_round = node->ra_sync.round_number;
+    }
+    
+    printf("\n=== Cluster Summary (%d nodes) ===\n", cluster->num_nodes);
+    printf("Synchronized:      %d/%d\n", tdma_cluster_synchronized(cluster),
+           cluster->num_nodes);
+    printf("Rounds:            %u-%u\n", min_round, max_round);
+    printf("Heartbeats:        %lu sent, %lu received\n", hb_sent, hb_received);
+    printf("Packets:           %lu sent, %lu received\n", pkts_sent, pkts_received);
+    printf("Mesh packets:      %lu delivered, %lu relayed\n", delivered, forwarded);
+    printf("Recomputations:    %lu\n", recomputations);
+    
+    shm_fabric_print_stats(&cluster->fabric);
+}
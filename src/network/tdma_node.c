@@ -3,6 +3,7 @@
 #include "connectivity_matrix.h"
 #include "ip_routing_manager.h"
 #include "data_streaming.h"
+#include "async_log.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -14,8 +15,9 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 
-#define TIMEOUT_MS 5000
 #define INITIAL_SETTLE_TIME_SEC 10
+#define RX_WAIT_TIMEOUT_MS 100   // Rede de segurança; o stop acorda via eventfd
+#define NODE_BUFFER_POOL_SIZE (TX_QUEUE_DEFAULT_CAPACITY + 2 * UDP_RX_BATCH)
 
 uint64_t current_time_ms() {
     struct timespec ts;
@@ -29,7 +31,7 @@ uint64_t current_time_ms() {
 
 static bool check_network_ready(node_id_t my_id, int total_nodes) {
     char my_ip[32];  // ← CORRIGIDO: Buffer aumentado de 16 para 32
-    snprintf(my_ip, sizeof(my_ip), "192.168.2.%d", 10 + my_id);
+    node_id_to_ip(my_id, my_ip, sizeof(my_ip));
     
     // Cria socket de teste
     int test_sock = socket(AF_INET, SOCK_DGRAM, 0);
@@ -58,7 +60,7 @@ static bool check_network_ready(node_id_t my_id, int total_nodes) {
         if (target == my_id) continue;
         
         char dst_ip[32];  // ← CORRIGIDO: Buffer aumentado de 16 para 32
-        snprintf(dst_ip, sizeof(dst_ip), "192.168.2.%d", 10 + target);
+        node_id_to_ip(target, dst_ip, sizeof(dst_ip));
         
         struct sockaddr_in dst_addr;
         memset(&dst_addr, 0, sizeof(dst_addr));
@@ -90,30 +92,8 @@ static bool check_network_ready(node_id_t my_id, int total_nodes) {
     return false;  // Não conseguiu enviar para nenhum nó
 }
 
-// ========================================
-// Inicialização
-// ========================================
-
-int tdma_node_init(tdma_node_t *node, node_id_t my_id,
-                   int total_nodes, routing_strategy_t strategy) {
-    memset(node, 0, sizeof(tdma_node_t));
-    
-    node->my_id = my_id;
-    node->total_nodes = total_nodes;
-    node->state = NODE_STATE_INIT;
-    node->heartbeat_interval_ms = TDMA_ROUND_PERIOD_MS;
-    node->running = false;
-    
-    uint64_t now = current_time_ms();
-    for(int i = 0; i < MAX_NODES; i++) {
-        node->last_seen_ms[i] = now;
-    }
-    
-    printf("[NODE %d] Initializing...\n", my_id);
-
-    // ============================================
-    // CRITICAL FIX: Wait for network interface
-    // ============================================
+// Espera até 15 s que a veth do nó esteja UP e com IP
+static int wait_for_network(node_id_t my_id, int total_nodes) {
     printf("[NODE %d] Waiting for network interface (veth%d)...\n", my_id, my_id);
     
     bool net_ready = false;
@@ -141,83 +121,411 @@ int tdma_node_init(tdma_node_t *node, node_id_t my_id,
         fprintf(stderr, "[NODE %d] This usually means:\n", my_id);
         fprintf(stderr, "  1. Network namespace not created correctly\n");
         fprintf(stderr, "  2. Interface veth%d is not UP\n", my_id);
-        fprintf(stderr, "  3. IP 192.168.2.%d not configured\n", 10 + my_id);
+        char ip[32];
+        node_id_to_ip(my_id, ip, sizeof(ip));
+        fprintf(stderr, "  3. IP %s not configured\n", ip);
         fprintf(stderr, "\n");
         fprintf(stderr, "Debug commands:\n");
         fprintf(stderr, "  sudo ip netns exec node%d ip addr\n", my_id);
         fprintf(stderr, "  sudo ip netns exec node%d ip route\n", my_id);
-        fprintf(stderr, "  sudo ip netns exec node%d ping -c 1 192.168.2.1%d\n", 
-                my_id, (my_id % total_nodes) + 1);
+        node_id_to_ip((my_id % total_nodes) + 1, ip, sizeof(ip));
+        fprintf(stderr, "  sudo ip netns exec node%d ping -c 1 %s\n", my_id, ip);
         fprintf(stderr, "\n");
         return -1;
     }
-    // ============================================
+    
+    return 0;
+}
+
+// ========================================
+// Spanning Tree → vizinhos de sincronização
+// ========================================
+
+static void update_sync_tree(tdma_node_t *node) {
+    topology_graph_t *topo = &node->topology;
+    uint32_t n = topo->num_nodes;
+    
+    int32_t *parent = malloc(n * sizeof(int32_t));
+    node_id_t *neighbors = malloc(n * sizeof(node_id_t));
+    
+    if (!parent || !neighbors ||
+        spanning_tree_compute_graph(topo, parent) < 0) {
+        free(parent);
+        free(neighbors);
+        return;
+    }
+    
+    int my_idx = topology_graph_index_of(topo, node->my_id);
+    uint32_t count = 0;
+    
+    for (uint32_t i = 0; i < n; i++) {
+        if ((int)i == my_idx) continue;
+        
+        // Vizinho na MST = meu pai ou meu filho
+        if (parent[i] == my_idx || (my_idx != -1 && parent[my_idx] == (int32_t)i)) {
+            neighbors[count++] = topo->node_ids[i];
+        }
+    }
+    
+    ra_tdmas_set_sync_neighbors(&node->ra_sync, neighbors, count);
+    
+    free(parent);
+    free(neighbors);
+}
+
+// ========================================
+// Métricas
+// ========================================
+
+#define EXPOSE(name, help, type, field) \
+    metrics_register_source(reg, name, help, type, &(field), sizeof(field))
+
+static void register_metrics(tdma_node_t *node) {
+    metrics_registry_t *reg = &node->metrics;
+    tdma_node_metric_ids_t *ids = &node->metric_ids;
+    
+    // Incrementados nas threads do nó (um shard por thread)
+    ids->heartbeats_sent = metrics_register_counter(reg,
+        "heartbeats_sent_total", "Heartbeats broadcast in our slot");
+    ids->heartbeats_received = metrics_register_counter(reg,
+        "heartbeats_received_total", "Heartbeats received from any neighbor");
+    ids->topology_updates = metrics_register_counter(reg,
+        "topology_updates_total", "MSG_TOPOLOGY_UPDATE messages received");
+    ids->link_weight_updates = metrics_register_counter(reg,
+        "link_weight_updates_total", "Link ETX weights pushed to routing");
+    ids->heartbeat_delay_us = metrics_register_histogram(reg,
+        "heartbeat_delay_us", "Neighbor TX timestamp to local RX, microseconds");
+    ids->rx_batch_packets = metrics_register_histogram(reg,
+        "rx_batch_packets", "Packets returned per recvmmsg() call");
+    ids->slot_packets = metrics_register_histogram(reg,
+        "slot_packets", "Packets sent per TDMA slot");
+    
+    // Campos de escritor único nos módulos, lidos em cada snapshot. Os
+    // contadores de transporte, forwarding e fila vão para os shards
+    // (ver *_set_metrics em tdma_node_init)
+    EXPOSE("heartbeats_malformed_total", "Heartbeats without a valid link quality payload",
+           METRIC_COUNTER, node->link_quality.malformed);
+    
+    EXPOSE("lsa_originated_total", "LSAs originated for our own links",
+           METRIC_COUNTER, node->link_state.originated);
+    EXPOSE("lsa_installed_total", "New LSAs installed from other nodes",
+           METRIC_COUNTER, node->link_state.installed);
+    EXPOSE("lsa_duplicates_total", "LSAs already known, not flooded again",
+           METRIC_COUNTER, node->link_state.duplicates);
+    EXPOSE("lsa_flooded_total", "LSAs sent in our slot (own and relayed)",
+           METRIC_COUNTER, node->link_state.flooded);
+    EXPOSE("lsa_expired_total", "LSAs dropped after LS_MAX_AGE_ROUNDS without refresh",
+           METRIC_COUNTER, node->link_state.expired);
+    EXPOSE("lsa_malformed_total", "Invalid MSG_TOPOLOGY_UPDATE payloads",
+           METRIC_COUNTER, node->link_state.malformed);
+    
+    EXPOSE("sync_slot_adjustments_total", "RA-TDMAs+ slot adjustments applied",
+           METRIC_COUNTER, node->ra_sync.slot_adjustments);
+    EXPOSE("sync_round_number", "Current TDMA round",
+           METRIC_GAUGE, node->ra_sync.round_number);
+    EXPOSE("tx_slots_served_total", "TDMA slots the TX scheduler woke up for",
+           METRIC_COUNTER, node->tx_sched.slots_served);
+    
+    EXPOSE("routing_topology_version", "Routing topology version",
+           METRIC_GAUGE, node->routing_mgr.topology_version);
+    EXPOSE("routing_recomputations_total", "Full route recomputations",
+           METRIC_COUNTER, node->routing_mgr.recomputations);
+    EXPOSE("routing_incremental_updates_total", "Link changes repaired incrementally",
+           METRIC_COUNTER, node->routing_mgr.incremental_updates);
+    EXPOSE("routing_recompute_time_us_total", "Time spent recomputing routes",
+           METRIC_COUNTER, node->routing_mgr.total_recompute_time_us);
+    
+    EXPOSE("tx_queue_pending", "Packets waiting for our slot",
+           METRIC_GAUGE, node->tx_queue.count);
+    EXPOSE("buffer_pool_in_use", "Packet buffers currently in use",
+           METRIC_GAUGE, node->buffers.in_use);
+    EXPOSE("buffer_pool_alloc_failures_total", "Packet buffer allocations that failed",
+           METRIC_COUNTER, node->buffers.alloc_failures);
+    
+    EXPOSE("streaming_frames_delivered_total", "Stream frames delivered complete",
+           METRIC_COUNTER, node->streaming.frames_delivered);
+    EXPOSE("streaming_bytes_delivered_total", "Stream bytes delivered",
+           METRIC_COUNTER, node->streaming.bytes_delivered);
+    EXPOSE("streaming_nacks_sent_total", "Stream NACKs sent",
+           METRIC_COUNTER, node->streaming.nacks_sent);
+    EXPOSE("streaming_parity_sent_total", "FEC parity chunks sent",
+           METRIC_COUNTER, node->streaming.parity_sent);
+}
+
+#undef EXPOSE
+
+// ========================================
+// Inicialização
+// ========================================
+
+static int node_init(tdma_node_t *node, node_id_t my_id, int total_nodes,
+                     routing_strategy_t strategy, shm_fabric_t *fabric) {
+    memset(node, 0, sizeof(tdma_node_t));
+    
+    if (total_nodes < 1 || total_nodes > MAX_NETWORK_NODES) {
+        fprintf(stderr, "[NODE %d] Invalid node count: %d\n", my_id, total_nodes);
+        return -1;
+    }
+    
+    node->my_id = my_id;
+    node->total_nodes = total_nodes;
+    node->state = NODE_STATE_INIT;
+    node->heartbeat_interval_ms = TDMA_ROUND_PERIOD_MS;
+    node->settle_time_ms = fabric ? 0 : INITIAL_SETTLE_TIME_SEC * 1000;
+    node->fabric = fabric;
+    node->running = false;
+    
+    if (metrics_registry_init(&node->metrics, my_id) < 0) {
+        fprintf(stderr, "[NODE %d] Failed to init metrics registry\n", my_id);
+        return -1;
+    }
+    register_metrics(node);
+    
+    if (link_quality_init(&node->link_quality, my_id, total_nodes) < 0) {
+        fprintf(stderr, "[NODE %d] Out of memory\n", my_id);
+        goto fail_metrics;
+    }
+    if (link_state_init(&node->link_state, my_id, total_nodes) < 0) {
+        fprintf(stderr, "[NODE %d] Out of memory\n", my_id);
+        goto fail_link_quality;
+    }
+    
+    printf("[NODE %d] Initializing...\n", my_id);
+    
+    // Em cluster não há veth: a fabric já liga todos os nós
+    if (!fabric && wait_for_network(my_id, total_nodes) < 0) {
+        goto fail_link_state;
+    }
+    
+    // Pool de buffers de pacote: anel de RX, forwarding e fila de TX
+    if (buffer_pool_init(&node->buffers, NODE_BUFFER_POOL_SIZE, BUFFER_POOL_BUF_SIZE) < 0) {
+        fprintf(stderr, "[NODE %d] Failed to init buffer pool\n", my_id);
+        goto fail_link_state;
+    }
     
     // Init transport
-    if (udp_transport_init(&node->transport, my_id) < 0) {
+    int transport_ret = fabric ? udp_transport_init_shm(&node->transport, my_id, fabric)
+                               : udp_transport_init(&node->transport, my_id);
+    if (transport_ret < 0) {
         fprintf(stderr, "[NODE %d] Failed to init transport\n", my_id);
-        return -1;
+        goto fail_buffers;
     }
+    udp_transport_set_pool(&node->transport, &node->buffers);
+    udp_transport_set_metrics(&node->transport, &node->metrics);
     
-    // Init connectivity matrix
-    connectivity_matrix_init();
+    if (udp_transport_set_peers(&node->transport, total_nodes) < 0) {
+        fprintf(stderr, "[NODE %d] Failed to build peer address table\n", my_id);
+        goto fail_transport;
+    }
     
     // Init routing manager
     routing_manager_init(&node->routing_mgr, my_id, strategy);
     
-    // Init IP Routing Manager
-    char interface[16];
-    snprintf(interface, sizeof(interface), "veth%d", my_id);
+    // Link flaps são o evento mais frequente: repara a SPT em vez de recomputar
+    routing_manager_set_incremental(&node->routing_mgr, true);
     
-    if (ip_routing_manager_init(&node->ip_routing_mgr, my_id, 
-                                interface, total_nodes) < 0) {
-        fprintf(stderr, "[NODE %d] ERROR: IP routing init failed\n", my_id);
-        return -1;
+    // Os pesos dos links são ETX: rotas pelo custo real, não por hops
+    routing_manager_set_path_engine(&node->routing_mgr, PATH_ENGINE_WEIGHTED);
+    
+    // Init IP Routing Manager (em cluster as rotas ficam só no routing manager)
+    if (!fabric) {
+        char interface[16];
+        snprintf(interface, sizeof(interface), "veth%d", my_id);
+        
+        if (ip_routing_manager_init(&node->ip_routing_mgr, my_id, 
+                                    interface, total_nodes) < 0) {
+            fprintf(stderr, "[NODE %d] ERROR: IP routing init failed\n", my_id);
+            goto fail_routing;
+        }
+        
+        // Rotas deixadas por uma execução anterior entram no mirror
+        ip_routing_manager_reconcile(&node->ip_routing_mgr);
     }
     
     // Init Data Streaming
     if (data_streaming_init(&node->streaming, my_id, &node->transport) < 0) {
         fprintf(stderr, "[NODE %d] ERROR: Streaming init failed\n", my_id);
-        return -1;
+        goto fail_ip_routing;
     }
     
     // RA-TDMAs+ Init
-    node_id_t all_nodes[MAX_NODES];
+    node_id_t *all_nodes = malloc(total_nodes * sizeof(node_id_t));
+    if (!all_nodes) {
+        fprintf(stderr, "[NODE %d] Out of memory\n", my_id);
+        goto fail_streaming;
+    }
     for (int i = 0; i < total_nodes; i++) {
         all_nodes[i] = i + 1;
     }
     
-    if (ra_tdmas_init(&node->ra_sync, my_id, all_nodes, total_nodes) < 0) {
+    int sync_ret = ra_tdmas_init(&node->ra_sync, my_id, all_nodes, total_nodes);
+    free(all_nodes);
+    
+    if (sync_ret < 0) {
         fprintf(stderr, "[NODE %d] Failed to init RA-TDMAs+\n", my_id);
-        return -1;
+        goto fail_streaming;
     }
     
-    // Initial topology (FULL MESH)
-    for (int i = 0; i < total_nodes; i++) {
-        node->topology.node_ids[i] = i + 1;
-        
-        for (int j = 0; j < total_nodes; j++) {
-            if (i != j) {
-                node->topology.matrix[i][j] = 1;
-            } else {
-                node->topology.matrix[i][j] = 0;
-            }
-        }
+    if (tx_scheduler_init(&node->tx_sched, &node->ra_sync) < 0) {
+        fprintf(stderr, "[NODE %d] Failed to init TX scheduler\n", my_id);
+        goto fail_sync;
+    }
+    
+    if (tx_queue_init(&node->tx_queue, TX_QUEUE_DEFAULT_CAPACITY) < 0) {
+        fprintf(stderr, "[NODE %d] Failed to init TX queue\n", my_id);
+        goto fail_tx_sched;
+    }
+    tx_queue_set_pool(&node->tx_queue, &node->buffers);
+    tx_queue_set_metrics(&node->tx_queue, &node->metrics);
+    
+    forwarding_init(&node->forwarding, my_id, &node->routing_mgr,
+                    &node->tx_queue, &node->transport);
+    forwarding_set_metrics(&node->forwarding, &node->metrics);
+    data_streaming_set_forwarding(&node->streaming, &node->forwarding);
+    
+    // Initial topology (FULL MESH, links perfeitos até haver medições e LSAs)
+    if (topology_graph_init(&node->topology, total_nodes) < 0 ||
+        topology_graph_full_mesh_weighted(&node->topology, total_nodes, LQ_ETX_SCALE) < 0) {
+        fprintf(stderr, "[NODE %d] Failed to build initial topology\n", my_id);
+        topology_graph_destroy(&node->topology);
+        goto fail_tx_queue;
     }
-    node->topology.num_nodes = total_nodes;
     
     printf("[NODE %d] Initial topology: FULL MESH\n", my_id);
     
     // Compute MST
-    spanning_tree_t mst;
-    spanning_tree_compute(&node->topology, &mst);
-    ra_tdmas_set_spanning_tree(&node->ra_sync, &mst);
+    update_sync_tree(node);
     
     // Update routing
-    routing_manager_update_topology(&node->routing_mgr, &node->topology);
+    routing_manager_update_graph(&node->routing_mgr, &node->topology);
     
     printf("[NODE %d] Initialized successfully\n", my_id);
     return 0;
+    
+    // Desfaz pela ordem inversa da inicialização
+fail_tx_queue:
+    tx_queue_destroy(&node->tx_queue);
+fail_tx_sched:
+    tx_scheduler_destroy(&node->tx_sched);
+fail_sync:
+    ra_tdmas_destroy(&node->ra_sync);
+fail_streaming:
+    data_streaming_destroy(&node->streaming);
+fail_ip_routing:
+    if (!fabric) {
+        ip_routing_manager_destroy(&node->ip_routing_mgr);
+    }
+fail_routing:
+    routing_manager_destroy(&node->routing_mgr);
+fail_transport:
+    udp_transport_destroy(&node->transport);
+fail_buffers:
+    buffer_pool_destroy(&node->buffers);
+fail_link_state:
+    link_state_destroy(&node->link_state);
+fail_link_quality:
+    link_quality_destroy(&node->link_quality);
+fail_metrics:
+    metrics_registry_destroy(&node->metrics);
+    return -1;
+}
+
+int tdma_node_init(tdma_node_t *node, node_id_t my_id,
+                   int total_nodes, routing_strategy_t strategy) {
+    return node_init(node, my_id, total_nodes, strategy, NULL);
+}
+
+int tdma_node_init_shm(tdma_node_t *node, node_id_t my_id,
+                       int total_nodes, routing_strategy_t strategy,
+                       shm_fabric_t *fabric) {
+    return node_init(node, my_id, total_nodes, strategy, fabric);
+}
+
+// ========================================
+// Link State (LSAs)
+// ========================================
+
+// Grafo alterado: árvore de sync, rotas e (fora do cluster) rotas IP
+static void apply_topology_change(tdma_node_t *node) {
+    update_sync_tree(node);
+    
+    routing_manager_update_graph(&node->routing_mgr, &node->topology);
+    
+    if (!node->fabric) {
+        ip_routing_manager_update_from_routing(&node->ip_routing_mgr,
+                                              &node->routing_mgr);
+    }
+}
+
+// O meu LSA: vizinhos já medidos, com o peso que está na topologia
+static void advertise_local_links(tdma_node_t *node) {
+    lsa_link_t *links = malloc(node->total_nodes * sizeof(lsa_link_t));
+    if (!links) return;
+    
+    uint32_t count = 0;
+    for (int i = 0; i < node->total_nodes; i++) {
+        node_id_t neighbor = i + 1;
+        if (neighbor == node->my_id) continue;
+        
+        uint16_t weight = topology_graph_link_weight(&node->topology,
+                                                     node->my_id, neighbor);
+        if (weight == 0 || !link_quality_known(&node->link_quality, neighbor)) continue;
+        
+        links[count++] = (lsa_link_t){ .neighbor = neighbor, .weight = weight };
+    }
+    
+    if (link_state_update_local(&node->link_state, links, count)) {
+        LOG_DEBUG("[NODE %d] LSA originated: %u links\n", node->my_id, count);
+    }
+    free(links);
+}
+
+static void flood_link_state(tdma_node_t *node) {
+    uint8_t lsa[LSA_MAX_SIZE];
+    
+    for (int i = 0; i < LS_FLOOD_PER_SLOT; i++) {
+        int len = link_state_next_flood(&node->link_state, lsa, sizeof(lsa));
+        if (len <= 0) break;
+        
+        if (udp_transport_broadcast(&node->transport, MSG_TOPOLOGY_UPDATE,
+                                    lsa, len, node->total_nodes,
+                                    ra_tdmas_get_current_time_us()) > 0) {
+            node->packets_sent_in_slot++;
+        }
+    }
+}
+
+// Links entre os outros nós a partir da LSDB (os meus vêm do link_quality)
+static void merge_link_state(tdma_node_t *node) {
+    bool changed = false;
+    node_id_t origin;
+    
+    while ((origin = link_state_next_changed(&node->link_state)) != 0) {
+        uint32_t links_changed = 0;
+        
+        for (int i = 0; i < node->total_nodes; i++) {
+            node_id_t other = i + 1;
+            if (other == origin || other == node->my_id) continue;
+            
+            uint16_t weight = link_state_link_weight(&node->link_state, origin, other);
+            if (topology_graph_link_weight(&node->topology, origin, other) == weight) {
+                continue;
+            }
+            
+            topology_graph_set_link(&node->topology, origin, other, weight);
+            links_changed++;
+        }
+        
+        if (links_changed > 0) {
+            LOG_DEBUG("[NODE %d] LSA from node %d: %u links changed\n",
+                      node->my_id, origin, links_changed);
+            changed = true;
+        }
+    }
+    
+    if (changed) {
+        apply_topology_change(node);
+    }
 }
 
 // ========================================
@@ -236,20 +544,22 @@ void* tdma_node_heartbeat_thread(void *arg) {
         // ============================================
         // CHECK TIMEOUTS PERIODICALLY (NOVO!)
         // ============================================
+        // Só esta thread mexe na topologia; na descoberta verifica mais vezes
         uint64_t now_ms = current_time_ms();
-        if (now_ms - last_timeout_check_ms >= 1000) {  // A cada 1 segundo
+        uint64_t check_interval_ms = node->state == NODE_STATE_DISCOVERING ? 100 : 1000;
+        if (now_ms - last_timeout_check_ms >= check_interval_ms) {
             tdma_node_check_timeouts(node);
             last_timeout_check_ms = now_ms;
         }
         // ============================================
         
         // Update IP routing when topology changes
-        if (node->state == NODE_STATE_RUNNING) {
+        if (node->state == NODE_STATE_RUNNING && !node->fabric) {
             uint64_t current_version = node->routing_mgr.topology_version;
             
             if (current_version != last_routing_version) {
-                printf("[NODE %d] 🔄 Routing changed (v%lu → v%lu)\n",
-                       node->my_id, last_routing_version, current_version);
+                LOG_INFO("[NODE %d] 🔄 Routing changed (v%lu → v%lu)\n",
+                         node->my_id, last_routing_version, current_version);
                 
                 ip_routing_manager_update_from_routing(&node->ip_routing_mgr,
                                                       &node->routing_mgr);
@@ -257,9 +567,10 @@ void* tdma_node_heartbeat_thread(void *arg) {
             }
         }
         
-        // Wait for my slot
-        while (!ra_tdmas_can_transmit(&node->ra_sync) && node->running) {
-            usleep(100);
+        // Wait for my slot (deadline absoluto, uma wakeup por slot)
+        uint64_t slot_start_us, slot_end_us;
+        if (tx_scheduler_wait_slot(&node->tx_sched, &slot_start_us, &slot_end_us) < 0) {
+            continue;  // Cancelado (shutdown) ou erro: volta a verificar running
         }
         
         if (!node->running) break;
@@ -267,24 +578,38 @@ void* tdma_node_heartbeat_thread(void *arg) {
         // Calculate slot adjustment
         ra_tdmas_calculate_slot_adjustment(&node->ra_sync);
         
-        // Send heartbeat
+        // Send heartbeat (sequência + o que ouvi de cada vizinho)
+        uint8_t payload[LQ_HEARTBEAT_MAX_SIZE];
+        int payload_len = link_quality_build_heartbeat(&node->link_quality,
+                                                       payload, sizeof(payload));
         uint64_t tx_time_us = ra_tdmas_get_current_time_us();
-        uint8_t payload = 0xFF;
         
         int sent = udp_transport_broadcast(&node->transport, MSG_HEARTBEAT,
-                                          &payload, 1, node->total_nodes, 
+                                          payload, payload_len, node->total_nodes, 
                                           tx_time_us);
         
         if (sent > 0) {
-            node->heartbeats_sent++;
+            metrics_inc(&node->metrics, node->metric_ids.heartbeats_sent);
             node->packets_sent_in_slot++;
         }
         
-        // Wait for round end
-        uint32_t wait_us = ra_tdmas_time_until_my_slot_us(&node->ra_sync);
-        usleep(wait_us);
+        // LSAs novos (o meu e os que chegaram desde o último slot)
+        flood_link_state(node);
+        
+        // NACKs dos streams com chunks em falta saem neste slot
+        data_streaming_on_round(&node->streaming, current_time_ms());
+        
+        // Drain data queue while the slot lasts (guard before slot end)
+        node->packets_sent_in_slot += tx_queue_drain(&node->tx_queue, &node->transport,
+                                                     tx_queue_slot_deadline(slot_start_us,
+                                                                            slot_end_us));
         
         ra_tdmas_on_round_end(&node->ra_sync);
+        link_quality_on_round(&node->link_quality);
+        link_state_on_round(&node->link_state);
+        merge_link_state(node);
+        metrics_observe(&node->metrics, node->metric_ids.slot_packets,
+                        node->packets_sent_in_slot);
         node->packets_sent_in_slot = 0;
     }
     
@@ -296,31 +621,40 @@ void* tdma_node_receiver_thread(void *arg) {
     tdma_node_t *node = (tdma_node_t*)arg;
     printf("[NODE %d] Receiver thread started\n", node->my_id);
     
+    udp_rx_packet_t batch[UDP_RX_BATCH];
+    
     while (node->running) {
-        udp_header_t header;
-        uint8_t payload[MAX_PACKET_SIZE];
-        
-        int len = udp_transport_receive(&node->transport, &header,
-                                       payload, sizeof(payload), false);
+        // Bloqueia até haver dados (sem polling nem usleep)
+        if (udp_transport_wait(&node->transport, RX_WAIT_TIMEOUT_MS) <= 0) {
+            continue;
+        }
         
-        if (len > 0) {
-            uint64_t rx_time_us = ra_tdmas_get_current_time_us();
-            
-            // Process message
-            tdma_node_process_message(node, &header, payload, len);
+        // Drena o burst: um recvmmsg() por até UDP_RX_BATCH pacotes
+        int count;
+        do {
+            count = udp_transport_receive_batch(&node->transport, batch, UDP_RX_BATCH);
+            if (count <= 0) break;
             
-            // Update RA-TDMAs+ delays
-            ra_tdmas_on_packet_received(&node->ra_sync, header.src,
-                                       header.tx_timestamp_us, rx_time_us);
+            uint64_t rx_time_us = ra_tdmas_get_current_time_us();
+            metrics_observe(&node->metrics, node->metric_ids.rx_batch_packets, count);
             
-            // Update last seen
-            if (header.src > 0 && header.src <= MAX_NODES) {
-                node->last_seen_ms[header.src - 1] = current_time_ms();
+            for (int i = 0; i < count; i++) {
+                udp_header_t *header = &batch[i].header;
+                
+                // Process message
+                tdma_node_process_message(node, header, (void *)batch[i].payload,
+                                          batch[i].payload_len);
+                
+                // Update RA-TDMAs+ delays
+                ra_tdmas_on_packet_received(&node->ra_sync, header->src,
+                                           header->tx_timestamp_us, rx_time_us);
+                
+                if (header->type == MSG_HEARTBEAT && rx_time_us >= header->tx_timestamp_us) {
+                    metrics_observe(&node->metrics, node->metric_ids.heartbeat_delay_us,
+                                    rx_time_us - header->tx_timestamp_us);
+                }
             }
-            
-        } else if (len == 0) {
-            usleep(1000);
-        }
+        } while (count == UDP_RX_BATCH && node->running);
     }
     
     printf("[NODE %d] Receiver thread stopped\n", node->my_id);
@@ -338,17 +672,41 @@ void tdma_node_process_message(tdma_node_t *node,
     
     switch (header->type) {
         case MSG_HEARTBEAT:
-            node->heartbeats_received++;
+            metrics_inc(&node->metrics, node->metric_ids.heartbeats_received);
+            link_quality_on_heartbeat(&node->link_quality, header->src,
+                                      payload, payload_len);
             break;
             
         case MSG_TOPOLOGY_UPDATE:
-            node->topology_updates++;
+            metrics_inc(&node->metrics, node->metric_ids.topology_updates);
+            link_state_on_lsa(&node->link_state, payload, payload_len);
             break;
             
         case MSG_DATA:
-            data_streaming_receive(&node->streaming, 
-                                 (uint8_t*)payload, 
-                                 payload_len);
+            // Relay se o destino final não for este nó
+            if (forwarding_on_receive(&node->forwarding, header, payload,
+                                      payload_len,
+                                      ra_tdmas_get_current_time_us()) != FWD_DELIVER) {
+                break;
+            }
+            // hops conta os relays; o caminho tem mais um hop (o último)
+            data_streaming_receive_from(&node->streaming,
+                                      ((const mesh_header_t *)payload)->origin,
+                                      ((const mesh_header_t *)payload)->hops + 1,
+                                      (const uint8_t *)payload + sizeof(mesh_header_t),
+                                      payload_len - sizeof(mesh_header_t));
+            break;
+            
+        case MSG_STREAM_NACK:
+            if (forwarding_on_receive(&node->forwarding, header, payload,
+                                      payload_len,
+                                      ra_tdmas_get_current_time_us()) != FWD_DELIVER) {
+                break;
+            }
+            data_streaming_on_nack(&node->streaming,
+                                 ((const mesh_header_t *)payload)->origin,
+                                 (const uint8_t *)payload + sizeof(mesh_header_t),
+                                 payload_len - sizeof(mesh_header_t));
             break;
             
         default:
@@ -356,72 +714,78 @@ void tdma_node_process_message(tdma_node_t *node,
     }
 }
 
+// Só muda o grafo; apply_topology_change() leva-o ao routing
+static bool set_link_weight(tdma_node_t *node, node_id_t neighbor, uint16_t weight) {
+    if (topology_graph_index_of(&node->topology, neighbor) == -1 ||
+        neighbor == node->my_id) {
+        return false;
+    }
+    
+    uint16_t old_value = topology_graph_link_weight(&node->topology,
+                                                    node->my_id, neighbor);
+    if (old_value == weight) return false;
+    
+    if ((old_value != 0) != (weight != 0)) {
+        LOG_INFO("[NODE %d] Link to node %d changed: %d → %d\n",
+                 node->my_id, neighbor, old_value, weight);
+    } else {
+        LOG_DEBUG("[NODE %d] Link to node %d: ETX %.1f → %.1f\n", node->my_id, neighbor,
+                  (double)old_value / LQ_ETX_SCALE, (double)weight / LQ_ETX_SCALE);
+    }
+    
+    topology_graph_set_link(&node->topology, node->my_id, neighbor, weight);
+    metrics_inc(&node->metrics, node->metric_ids.link_weight_updates);
+    return true;
+}
+
 void tdma_node_update_connectivity(tdma_node_t *node,
                                   node_id_t neighbor,
                                   bool is_alive) {
-    int my_idx = node->my_id - 1;
-    int neighbor_idx = neighbor - 1;
-    
-    if (neighbor_idx < 0 || neighbor_idx >= node->total_nodes) {
-        return;
-    }
+    uint16_t old_value = topology_graph_link_weight(&node->topology,
+                                                    node->my_id, neighbor);
     
-    uint8_t old_value = node->topology.matrix[my_idx][neighbor_idx];
-    uint8_t new_value = is_alive ? 1 : 0;
+    // Um link vivo mantém o peso medido
+    if ((old_value != 0) == is_alive) return;
     
-    if (old_value != new_value) {
-        printf("[NODE %d] Link to node %d changed: %d → %d\n",
-               node->my_id, neighbor, old_value, new_value);
-        
-        node->topology.matrix[my_idx][neighbor_idx] = new_value;
-        node->topology.matrix[neighbor_idx][my_idx] = new_value;
-        
-        connectivity_matrix_set_topology(node->topology.matrix,
-                                        node->topology.node_ids,
-                                        node->topology.num_nodes);
-        
-        spanning_tree_t mst;
-        spanning_tree_compute(&node->topology, &mst);
-        ra_tdmas_set_spanning_tree(&node->ra_sync, &mst);
-        
-        connectivity_matrix_get(&node->topology);
-        routing_manager_update_topology(&node->routing_mgr, &node->topology);
-        
-        ip_routing_manager_update_from_routing(&node->ip_routing_mgr,
-                                              &node->routing_mgr);
+    if (set_link_weight(node, neighbor, is_alive ? LQ_ETX_SCALE : 0)) {
+        apply_topology_change(node);
     }
 }
 
 // ========================================
-// Timeout Detection
+// Link Quality → Topology
 // ========================================
 
 void tdma_node_check_timeouts(tdma_node_t *node) {
-    uint64_t now = current_time_ms();
+    bool changed = false;
     
     for (int i = 0; i < node->total_nodes; i++) {
         node_id_t neighbor = i + 1;
         if (neighbor == node->my_id) continue;
         
-        uint64_t last_seen = node->last_seen_ms[i];
-        uint64_t elapsed = now - last_seen;
+        uint16_t current = topology_graph_link_weight(&node->topology,
+                                                      node->my_id, neighbor);
+        uint16_t weight = link_quality_weight(&node->link_quality, neighbor);
         
-        int my_idx = node->my_id - 1;
-        bool currently_connected = (node->topology.matrix[my_idx][i] != 0);
+        if (!link_quality_significant(current, weight)) continue;
         
-        if (elapsed > TIMEOUT_MS && currently_connected) {
-            printf("[NODE %d] ⚠️  TIMEOUT: Node %d (last seen %lu ms ago)\n",
-                   node->my_id, neighbor, elapsed);
-            
-            tdma_node_update_connectivity(node, neighbor, false);
-        }
-        else if (elapsed <= TIMEOUT_MS && !currently_connected) {
-            printf("[NODE %d] ✅ RECOVERED: Node %d\n",
-                   node->my_id, neighbor);
-            
-            tdma_node_update_connectivity(node, neighbor, true);
+        if (current != 0 && weight == 0) {
+            LOG_WARN("[NODE %d] ⚠️  TIMEOUT: Node %d (in %.0f%%, out %.0f%%)\n",
+                     node->my_id, neighbor,
+                     link_quality_delivery(&node->link_quality, neighbor, true) * 100.0,
+                     link_quality_delivery(&node->link_quality, neighbor, false) * 100.0);
+        } else if (current == 0) {
+            LOG_INFO("[NODE %d] ✅ RECOVERED: Node %d\n", node->my_id, neighbor);
         }
+        
+        changed |= set_link_weight(node, neighbor, weight);
     }
+    
+    if (changed) {
+        apply_topology_change(node);
+    }
+    
+    advertise_local_links(node);
 }
 
 // ========================================
@@ -446,13 +810,14 @@ int tdma_node_start(tdma_node_t *node) {
         return -1;
     }
     
-    printf("[NODE %d] Topology discovery (%d seconds)...\n",
-           node->my_id, INITIAL_SETTLE_TIME_SEC);
+    if (node->settle_time_ms > 0) {
+        printf("[NODE %d] Topology discovery (%u ms)...\n",
+               node->my_id, node->settle_time_ms);
+    }
     
-    int steps = INITIAL_SETTLE_TIME_SEC * 10;
-    for (int i = 0; i < steps; i++) {
+    // As verificações da descoberta correm na thread de heartbeat (dona da topologia)
+    for (uint32_t waited = 0; waited < node->settle_time_ms; waited += 100) {
         usleep(100000);
-        tdma_node_check_timeouts(node);
     }
     
     node->state = NODE_STATE_RUNNING;
@@ -465,6 +830,9 @@ void tdma_node_stop(tdma_node_t *node) {
     
     node->running = false;
     node->state = NODE_STATE_SHUTDOWN;
+    udp_transport_wakeup(&node->transport);
+    tx_scheduler_cancel(&node->tx_sched);
+    tx_queue_close(&node->tx_queue);
     
     pthread_join(node->heartbeat_thread, NULL);
     pthread_join(node->receiver_thread, NULL);
@@ -481,20 +849,43 @@ void tdma_node_print_status(tdma_node_t *node) {
     printf("State:           %s\n", state_str[node->state]);
     printf("Synchronized:    %s\n", 
            node->ra_sync.is_synchronized ? "YES" : "NO");
-    printf("Heartbeats sent: %lu\n", node->heartbeats_sent);
-    printf("Heartbeats recv: %lu\n", node->heartbeats_received);
+    printf("Heartbeats sent: %lu\n",
+           metrics_value(&node->metrics, node->metric_ids.heartbeats_sent));
+    printf("Heartbeats recv: %lu\n",
+           metrics_value(&node->metrics, node->metric_ids.heartbeats_received));
     
     routing_manager_print_table(&node->routing_mgr);
     udp_transport_print_stats(&node->transport);
+    tx_scheduler_print_stats(&node->tx_sched);
+    tx_queue_print_stats(&node->tx_queue);
+    buffer_pool_print_stats(&node->buffers);
+    forwarding_print_stats(&node->forwarding);
+    link_quality_print(&node->link_quality);
+    link_state_print(&node->link_state);
     routing_manager_print_performance(&node->routing_mgr);
 }
 
 void tdma_node_destroy(tdma_node_t *node) {
     printf("[NODE %d] Destroying...\n", node->my_id);
     
-    ip_routing_manager_destroy(&node->ip_routing_mgr);
+    // Último snapshot enquanto os campos expostos ainda são válidos
+    metrics_export_stop(&node->metrics);
+    
+    if (!node->fabric) {
+        ip_routing_manager_destroy(&node->ip_routing_mgr);
+    }
+    data_streaming_destroy(&node->streaming);
     udp_transport_destroy(&node->transport);
     routing_manager_destroy(&node->routing_mgr);
+    tx_scheduler_destroy(&node->tx_sched);
+    tx_queue_destroy(&node->tx_queue);
+    ra_tdmas_destroy(&node->ra_sync);
+    topology_graph_destroy(&node->topology);
+    buffer_pool_destroy(&node->buffers);   // Depois de quem lhe devolve buffers
+    
+    link_quality_destroy(&node->link_quality);
+    link_state_destroy(&node->link_state);
+    metrics_registry_destroy(&node->metrics);
     
     printf("[NODE %d] Destroyed\n", node->my_id);
 }
\ No newline at end of file
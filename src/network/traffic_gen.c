@@ -0,0 +1,650 @@
+// src/network/traffic_gen.c
+#include "traffic_gen.h"
+#include "ra_tdmas_sync.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TRAFFIC_SLEEP_SLICE_US 100000     // Verifica 'stop' pelo menos a cada 100 ms
+#define TRAFFIC_GOP_SIZE 30
+#define TRAFFIC_GOP_I_TO_P 5
+#define TRAFFIC_POLL_MAX_FRAMES 64        // Frames por poll (saturação: volta ao chamador)
+
+// ========================================
+// Helper Functions
+// ========================================
+
+// Relógio TDMA (CLOCK_MONOTONIC, ou o tempo virtual no simulador)
+static uint64_t monotonic_us(void) {
+    return ra_tdmas_get_current_time_us();
+}
+
+static uint64_t rng_next(uint64_t *s) {
+    uint64_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *s = x;
+}
+
+// Uniforme em (0, 1]
+static double rng_unit(uint64_t *s) {
+    return ((rng_next(s) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+static const char *pattern_name(traffic_pattern_t pattern) {
+    switch (pattern) {
+        case TRAFFIC_PATTERN_BURSTY:  return "bursty";
+        case TRAFFIC_PATTERN_POISSON: return "poisson";
+        default:                      return "cbr";
+    }
+}
+
+// ========================================
+// Parsing
+// ========================================
+
+static int parse_uint(const char *value, uint64_t max, uint64_t *out) {
+    char *end;
+    unsigned long long v = strtoull(value, &end, 10);
+    if (end == value || *end != '\0' || v > max) return -1;
+    *out = v;
+    return 0;
+}
+
+static int parse_double(const char *value, double *out) {
+    char *end;
+    double v = strtod(value, &end);
+    if (end == value || *end != '\0' || v < 0 || !isfinite(v)) return -1;
+    *out = v;
+    return 0;
+}
+
+static int parse_size(traffic_flow_t *flow, const char *value) {
+    uint64_t lo, hi;
+    
+    if (strcasecmp(value, "gop") == 0) {
+        flow->size_dist = TRAFFIC_SIZE_GOP;
+        return 0;
+    }
+    
+    const char *dash = strchr(value, '-');
+    if (dash) {
+        char first[32];
+        size_t len = dash - value;
+        if (len == 0 || len >= sizeof(first)) return -1;
+        memcpy(first, value, len);
+        first[len] = '\0';
+        
+        if (parse_uint(first, MAX_STREAM_BUFFER, &lo) < 0 ||
+            parse_uint(dash + 1, MAX_STREAM_BUFFER, &hi) < 0 || lo > hi) {
+            return -1;
+        }
+        flow->size_dist = TRAFFIC_SIZE_UNIFORM;
+    } else {
+        if (parse_uint(value, MAX_STREAM_BUFFER, &lo) < 0) return -1;
+        hi = lo;
+        flow->size_dist = TRAFFIC_SIZE_FIXED;
+    }
+    
+    if (lo < sizeof(traffic_header_t)) return -1;
+    flow->size_min = (uint32_t)lo;
+    flow->size_max = (uint32_t)hi;
+    return 0;
+}
+
+static int parse_pair(traffic_flow_t *flow, const char *key, const char *value) {
+    uint64_t v;
+    
+    if (strcmp(key, "src") == 0 || strcmp(key, "dst") == 0) {
+        if (parse_uint(value, MAX_NETWORK_NODES, &v) < 0 || v == 0) return -1;
+        if (key[0] == 's') flow->src = (node_id_t)v;
+        else flow->dst = (node_id_t)v;
+    } else if (strcmp(key, "rate") == 0) {
+        return parse_double(value, &flow->rate_fps);
+    } else if (strcmp(key, "pattern") == 0) {
+        if (strcasecmp(value, "cbr") == 0) flow->pattern = TRAFFIC_PATTERN_CBR;
+        else if (strcasecmp(value, "bursty") == 0) flow->pattern = TRAFFIC_PATTERN_BURSTY;
+        else if (strcasecmp(value, "poisson") == 0) flow->pattern = TRAFFIC_PATTERN_POISSON;
+        else return -1;
+    } else if (strcmp(key, "burst") == 0) {
+        if (parse_uint(value, 1000, &v) < 0 || v == 0) return -1;
+        flow->burst = (uint32_t)v;
+    } else if (strcmp(key, "size") == 0) {
+        return parse_size(flow, value);
+    } else if (strcmp(key, "bitrate") == 0) {
+        if (parse_uint(value, UINT32_MAX, &v) < 0 || v == 0) return -1;
+        flow->bitrate_bps = (uint32_t)v;
+    } else if (strcmp(key, "type") == 0) {
+        if (strcasecmp(value, "video") == 0) flow->type = STREAM_TYPE_VIDEO;
+        else if (strcasecmp(value, "audio") == 0) flow->type = STREAM_TYPE_AUDIO;
+        else if (strcasecmp(value, "data") == 0) flow->type = STREAM_TYPE_DATA;
+        else return -1;
+    } else if (strcmp(key, "start") == 0) {
+        return parse_double(value, &flow->start_sec);
+    } else if (strcmp(key, "duration") == 0) {
+        return parse_double(value, &flow->duration_sec);
+    } else if (strcmp(key, "seed") == 0) {
+        if (parse_uint(value, UINT64_MAX, &v) < 0) return -1;
+        flow->seed = v;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+int traffic_flow_parse(traffic_flow_t *flow, const char *spec) {
+    memset(flow, 0, sizeof(traffic_flow_t));
+    flow->type = STREAM_TYPE_VIDEO;
+    flow->pattern = TRAFFIC_PATTERN_CBR;
+    flow->rate_fps = 30;
+    flow->burst = 5;
+    flow->size_dist = TRAFFIC_SIZE_FIXED;
+    flow->size_min = flow->size_max = 8192;
+    flow->bitrate_bps = 2000000;
+    flow->duration_sec = 3;
+    
+    char buf[512];
+    if (strlen(spec) >= sizeof(buf)) {
+        fprintf(stderr, "[TRAFFIC] Flow spec too long\n");
+        return -1;
+    }
+    strcpy(buf, spec);
+    
+    char *save = NULL;
+    for (char *tok = strtok_r(buf, ", \t\r\n", &save); tok;
+         tok = strtok_r(NULL, ", \t\r\n", &save)) {
+        char *eq = strchr(tok, '=');
+        if (!eq) {
+            fprintf(stderr, "[TRAFFIC] Expected key=value, got '%s'\n", tok);
+            return -1;
+        }
+        *eq = '\0';
+        
+        if (parse_pair(flow, tok, eq + 1) < 0) {
+            fprintf(stderr, "[TRAFFIC] Invalid value for '%s': '%s'\n", tok, eq + 1);
+            return -1;
+        }
+    }
+    
+    if (flow->src == 0 || flow->dst == 0 || flow->src == flow->dst) {
+        fprintf(stderr, "[TRAFFIC] Flow needs distinct src and dst\n");
+        return -1;
+    }
+    return 0;
+}
+
+// ========================================
+// Engine
+// ========================================
+
+void traffic_engine_init(traffic_engine_t *engine, data_streaming_t *stream,
+                         node_id_t my_id) {
+    memset(engine, 0, sizeof(traffic_engine_t));
+    engine->stream = stream;
+    engine->my_id = my_id;
+    engine->warmup_sec = TRAFFIC_DEFAULT_WARMUP_SEC;
+}
+
+void traffic_engine_destroy(traffic_engine_t *engine) {
+    traffic_engine_stop(engine);
+    free(engine->frame_buf);
+    engine->frame_buf = NULL;
+}
+
+int traffic_engine_add_flow(traffic_engine_t *engine, const traffic_flow_t *flow) {
+    if (engine->num_flows >= TRAFFIC_MAX_FLOWS) {
+        fprintf(stderr, "[TRAFFIC] Too many flows (max %d)\n", TRAFFIC_MAX_FLOWS);
+        return -1;
+    }
+    
+    traffic_flow_t *f = &engine->flows[engine->num_flows];
+    *f = *flow;
+    f->id = (uint16_t)engine->num_flows;
+    if (f->seed == 0) {
+        f->seed = FRAME_GEN_DEFAULT_SEED + f->id;   // Fluxos distintos, reprodutíveis
+    }
+    
+    engine->num_flows++;
+    return f->id;
+}
+
+int traffic_engine_load_file(traffic_engine_t *engine, const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror("[TRAFFIC] fopen");
+        return -1;
+    }
+    
+    char line[512];
+    int line_no = 0;
+    int loaded = 0;
+    
+    while (fgets(line, sizeof(line), file)) {
+        line_no++;
+        
+        char *comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+        if (strspn(line, " \t\r\n") == strlen(line)) continue;
+        
+        traffic_flow_t flow;
+        if (traffic_flow_parse(&flow, line) < 0 ||
+            traffic_engine_add_flow(engine, &flow) < 0) {
+            fprintf(stderr, "[TRAFFIC] %s:%d: invalid flow\n", path, line_no);
+            fclose(file);
+            return -1;
+        }
+        loaded++;
+    }
+    
+    fclose(file);
+    return loaded;
+}
+
+// ========================================
+// TX
+// ========================================
+
+static uint32_t flow_max_frame(const traffic_flow_t *flow, const traffic_tx_state_t *tx) {
+    if (flow->size_dist == TRAFFIC_SIZE_GOP) {
+        return frame_generator_max_frame_size(&tx->gen);
+    }
+    return flow->size_max;
+}
+
+static void advance_schedule(const traffic_flow_t *flow, traffic_tx_state_t *tx,
+                             uint64_t now) {
+    if (flow->rate_fps <= 0) {
+        tx->next_us = now;        // Saturação: limitado só pelo backpressure
+        return;
+    }
+    
+    double interval_us = 1e6 / flow->rate_fps;
+    
+    switch (flow->pattern) {
+        case TRAFFIC_PATTERN_POISSON:
+            tx->next_us += (uint64_t)(-log(rng_unit(&tx->rng)) * interval_us);
+            break;
+        
+        case TRAFFIC_PATTERN_BURSTY:
+            // Frames da rajada seguidos; a pausa repõe a taxa média
+            if (--tx->burst_left > 0) break;
+            tx->burst_left = flow->burst;
+            tx->next_us += (uint64_t)(flow->burst * interval_us);
+            break;
+        
+        default:
+            tx->next_us += (uint64_t)interval_us;
+            break;
+    }
+}
+
+static int build_frame(traffic_engine_t *engine, const traffic_flow_t *flow,
+                       traffic_tx_state_t *tx) {
+    uint8_t *buf = engine->frame_buf;
+    int size;
+    
+    if (flow->size_dist == TRAFFIC_SIZE_GOP) {
+        size = frame_generator_next_video(&tx->gen, buf, engine->frame_buf_size, NULL);
+    } else {
+        uint32_t len = flow->size_min;
+        if (flow->size_dist == TRAFFIC_SIZE_UNIFORM) {
+            len += rng_next(&tx->rng) % (flow->size_max - flow->size_min + 1);
+        }
+        size = frame_generator_video(&tx->gen, buf, len, false);
+    }
+    if (size < (int)sizeof(traffic_header_t)) return -1;
+    
+    traffic_header_t header = {
+        .magic = TRAFFIC_MAGIC,
+        .flow_id = flow->id,
+        .seq = (uint32_t)tx->frames_sent,   // Um envio falhado não deixa lacuna
+        .tx_time_us = ra_tdmas_get_current_time_us()
+    };
+    memcpy(buf, &header, sizeof(header));
+    return size;
+}
+
+static void send_one(traffic_engine_t *engine, int i, uint64_t now) {
+    const traffic_flow_t *flow = &engine->flows[i];
+    traffic_tx_state_t *tx = &engine->tx[i];
+    
+    int size = build_frame(engine, flow, tx);
+    if (size > 0 &&
+        data_streaming_send(engine->stream, flow->dst, engine->frame_buf,
+                            size, flow->type) > 0) {
+        if (tx->frames_sent == 0) tx->first_tx_us = now;
+        tx->frames_sent++;
+        tx->bytes_sent += size;
+        tx->last_tx_us = monotonic_us();
+    } else {
+        tx->frames_failed++;
+    }
+    
+    advance_schedule(flow, tx, now);
+}
+
+// Fim do fluxo: o recetor fica a saber quantos frames esperar
+static void send_report(traffic_engine_t *engine, int i) {
+    const traffic_flow_t *flow = &engine->flows[i];
+    traffic_report_t report = {
+        .magic = TRAFFIC_REPORT_MAGIC,
+        .flow_id = flow->id,
+        .frames_sent = (uint32_t)engine->tx[i].frames_sent
+    };
+    
+    if (data_streaming_send(engine->stream, flow->dst, (const uint8_t *)&report,
+                            sizeof(report), STREAM_TYPE_DATA) <= 0) {
+        printf("[TRAFFIC] Flow %u: end-of-flow report not sent\n", flow->id);
+    }
+}
+
+uint64_t traffic_engine_poll(traffic_engine_t *engine, uint64_t now) {
+    for (int sent = 0; sent < TRAFFIC_POLL_MAX_FRAMES; ) {
+        // Fluxo local com o envio mais próximo
+        int next = -1;
+        for (int i = 0; i < engine->num_flows; i++) {
+            if (engine->flows[i].src != engine->my_id || engine->tx[i].done) continue;
+            if (next < 0 || engine->tx[i].next_us < engine->tx[next].next_us) next = i;
+        }
+        if (next < 0) return UINT64_MAX;
+        
+        traffic_tx_state_t *tx = &engine->tx[next];
+        if (tx->next_us >= tx->end_us) {
+            send_report(engine, next);
+            tx->done = true;
+            printf("[TRAFFIC] Flow %u finished: %lu frames sent, %lu failed\n",
+                   engine->flows[next].id, tx->frames_sent, tx->frames_failed);
+            continue;
+        }
+        
+        if (now < tx->next_us) return tx->next_us;
+        
+        send_one(engine, next, now);
+        sent++;
+    }
+    
+    return now;
+}
+
+static void* traffic_tx_thread(void *arg) {
+    traffic_engine_t *engine = arg;
+    
+    while (!engine->stop) {
+        uint64_t now = monotonic_us();
+        uint64_t next = traffic_engine_poll(engine, now);
+        if (next == UINT64_MAX) break;
+        
+        if (now < next) {
+            uint64_t wait = next - now;
+            usleep(wait < TRAFFIC_SLEEP_SLICE_US ? wait : TRAFFIC_SLEEP_SLICE_US);
+        }
+    }
+    
+    return NULL;
+}
+
+// ========================================
+// RX
+// ========================================
+
+// Fluxo 'flow_id' vai de frame->src para este nó
+static bool flow_matches(traffic_engine_t *engine, uint16_t flow_id, node_id_t src) {
+    return flow_id < engine->num_flows && engine->flows[flow_id].src == src &&
+           engine->flows[flow_id].dst == engine->my_id;
+}
+
+static void on_report(traffic_engine_t *engine, const reasm_frame_t *frame) {
+    traffic_report_t report;
+    memcpy(&report, frame->data, sizeof(report));
+    
+    if (!flow_matches(engine, report.flow_id, frame->src)) {
+        engine->frames_unknown++;
+        return;
+    }
+    engine->rx[report.flow_id].sender_frames_sent = report.frames_sent;
+    engine->rx[report.flow_id].report_received = true;
+}
+
+// Marca 'seq' como recebida; false se já tinha chegado
+static bool mark_seq(traffic_rx_state_t *rx, uint32_t seq) {
+    if (seq >= rx->next_seq) {
+        // Janela avança: as posições das seqs saltadas ficam livres
+        if (seq - rx->next_seq >= TRAFFIC_SEQ_WINDOW) {
+            memset(rx->seen, 0, sizeof(rx->seen));
+        } else {
+            for (uint32_t s = rx->next_seq; s < seq; s++) {
+                rx->seen[(s % TRAFFIC_SEQ_WINDOW) / 64] &= ~(1ULL << (s % 64));
+            }
+        }
+        rx->next_seq = seq + 1;
+    } else if (rx->next_seq - seq > TRAFFIC_SEQ_WINDOW) {
+        return true;                      // Fora da janela: conta como nova
+    } else if (rx->seen[(seq % TRAFFIC_SEQ_WINDOW) / 64] & (1ULL << (seq % 64))) {
+        return false;
+    }
+    
+    rx->seen[(seq % TRAFFIC_SEQ_WINDOW) / 64] |= 1ULL << (seq % 64);
+    return true;
+}
+
+static void traffic_on_frame(const reasm_frame_t *frame, void *ctx) {
+    traffic_engine_t *engine = ctx;
+    
+    uint16_t magic = 0;
+    if (frame->size >= sizeof(traffic_report_t)) {
+        memcpy(&magic, frame->data, sizeof(magic));
+    }
+    if (magic == TRAFFIC_REPORT_MAGIC) {
+        on_report(engine, frame);
+        return;
+    }
+    
+    traffic_header_t header;
+    if (frame->size < sizeof(header)) {
+        engine->frames_unknown++;
+        return;
+    }
+    memcpy(&header, frame->data, sizeof(header));
+    
+    if (header.magic != TRAFFIC_MAGIC || !flow_matches(engine, header.flow_id, frame->src)) {
+        engine->frames_unknown++;
+        return;
+    }
+    
+    traffic_rx_state_t *rx = &engine->rx[header.flow_id];
+    if (!mark_seq(rx, header.seq)) {
+        rx->frames_duplicate++;
+        return;
+    }
+    
+    uint64_t now = ra_tdmas_get_current_time_us();
+    latency_hist_record(&rx->latency, now > header.tx_time_us ? now - header.tx_time_us : 0);
+    
+    if (rx->frames_received == 0) rx->first_rx_us = monotonic_us();
+    rx->last_rx_us = monotonic_us();
+    rx->frames_received++;
+    rx->bytes_received += frame->size;
+}
+
+// ========================================
+// Control
+// ========================================
+
+int traffic_engine_arm(traffic_engine_t *engine) {
+    data_streaming_set_frame_callback(engine->stream, traffic_on_frame, engine);
+    
+    uint64_t base = monotonic_us() + (uint64_t)engine->warmup_sec * 1000000;
+    uint32_t buf_size = 0;
+    engine->num_local_tx = 0;
+    
+    for (int i = 0; i < engine->num_flows; i++) {
+        const traffic_flow_t *flow = &engine->flows[i];
+        traffic_tx_state_t *tx = &engine->tx[i];
+        if (flow->src != engine->my_id) continue;
+        
+        frame_model_t model;
+        frame_model_default(&model);
+        model.fps = flow->rate_fps >= 1 ? (uint32_t)flow->rate_fps : model.fps;
+        model.bitrate_bps = flow->bitrate_bps;
+        model.gop_size = TRAFFIC_GOP_SIZE;
+        model.i_to_p_ratio = TRAFFIC_GOP_I_TO_P;
+        model.seed = flow->seed;
+        if (frame_generator_init(&tx->gen, &model) < 0) return -1;
+        
+        tx->rng = flow->seed | 1;
+        tx->start_us = base + (uint64_t)(flow->start_sec * 1e6);
+        tx->end_us = tx->start_us + (uint64_t)(flow->duration_sec * 1e6);
+        tx->next_us = tx->start_us;
+        tx->burst_left = flow->burst;
+        
+        uint32_t max_frame = flow_max_frame(flow, tx);
+        if (max_frame > buf_size) buf_size = max_frame;
+        engine->num_local_tx++;
+    }
+    
+    if (engine->num_local_tx == 0) return 0;
+    
+    engine->frame_buf = malloc(buf_size);
+    if (!engine->frame_buf) return -1;
+    engine->frame_buf_size = buf_size;
+    
+    printf("[TRAFFIC] %d local flow(s) start in %u s\n",
+           engine->num_local_tx, engine->warmup_sec);
+    return 0;
+}
+
+int traffic_engine_start(traffic_engine_t *engine) {
+    if (traffic_engine_arm(engine) < 0) return -1;
+    if (engine->num_local_tx == 0) return 0;
+    
+    engine->stop = false;
+    if (pthread_create(&engine->thread, NULL, traffic_tx_thread, engine) != 0) {
+        perror("[TRAFFIC] pthread_create");
+        return -1;
+    }
+    engine->running = true;
+    return 0;
+}
+
+void traffic_engine_stop(traffic_engine_t *engine) {
+    if (!engine->running) return;
+    engine->stop = true;
+    pthread_join(engine->thread, NULL);
+    engine->running = false;
+}
+
+bool traffic_engine_tx_done(traffic_engine_t *engine) {
+    for (int i = 0; i < engine->num_flows; i++) {
+        if (engine->flows[i].src == engine->my_id && !engine->tx[i].done) return false;
+    }
+    return true;
+}
+
+// ========================================
+// Stats
+// ========================================
+
+static double rx_mbps(const traffic_flow_t *flow, const traffic_rx_state_t *rx) {
+    uint64_t span_us = rx->last_rx_us - rx->first_rx_us;
+    double seconds = span_us > 0 ? span_us / 1e6 : flow->duration_sec;
+    return seconds > 0 ? rx->bytes_received * 8 / seconds / 1e6 : 0;
+}
+
+double traffic_engine_rx_fairness(traffic_engine_t *engine) {
+    double sum = 0, sum_sq = 0;
+    int n = 0;
+    
+    for (int i = 0; i < engine->num_flows; i++) {
+        if (engine->flows[i].dst != engine->my_id) continue;
+        double x = rx_mbps(&engine->flows[i], &engine->rx[i]);
+        sum += x;
+        sum_sq += x * x;
+        n++;
+    }
+    
+    return n > 0 && sum_sq > 0 ? sum * sum / (n * sum_sq) : 0;
+}
+
+uint64_t traffic_engine_rx_lost(traffic_engine_t *engine, int flow) {
+    const traffic_rx_state_t *rx = &engine->rx[flow];
+    uint64_t expected = rx->report_received ? rx->sender_frames_sent : rx->next_seq;
+    return expected > rx->frames_received ? expected - rx->frames_received : 0;
+}
+
+int traffic_engine_print_report(traffic_engine_t *engine) {
+    int printed = 0;
+    int received = 0;
+    
+    for (int i = 0; i < engine->num_flows; i++) {
+        const traffic_flow_t *flow = &engine->flows[i];
+        if (flow->src != engine->my_id && flow->dst != engine->my_id) continue;
+        
+        if (printed == 0) {
+            printf("\n🚦 Traffic Flows (node %d):\n", engine->my_id);
+        }
+        printed++;
+        
+        printf("   Flow %u: %d → %d, %s %.1f fps, ", flow->id, flow->src, flow->dst,
+               pattern_name(flow->pattern), flow->rate_fps);
+        if (flow->size_dist == TRAFFIC_SIZE_GOP) {
+            printf("GOP %.1f Mbps\n", flow->bitrate_bps / 1e6);
+        } else {
+            printf("%u-%u bytes\n", flow->size_min, flow->size_max);
+        }
+        
+        if (flow->src == engine->my_id) {
+            const traffic_tx_state_t *tx = &engine->tx[i];
+            uint64_t span_us = tx->last_tx_us - tx->first_tx_us;
+            printf("      TX: %lu frames (failed: %lu), %.2f KB, %.2f Mbps offered\n",
+                   tx->frames_sent, tx->frames_failed, tx->bytes_sent / 1024.0,
+                   span_us > 0 ? tx->bytes_sent * 8.0 / span_us : 0);
+        }
+        
+        if (flow->dst == engine->my_id) {
+            const traffic_rx_state_t *rx = &engine->rx[i];
+            uint64_t lost = traffic_engine_rx_lost(engine, i);
+            uint64_t expected = rx->frames_received + lost;
+            received++;
+            
+            printf("      RX: %lu frames, %.2f KB, %.2f Mbps, loss %.1f%% (%lu%s), "
+                   "%lu duplicates\n",
+                   rx->frames_received, rx->bytes_received / 1024.0, rx_mbps(flow, rx),
+                   expected ? lost * 100.0 / expected : 0.0, lost,
+                   rx->report_received ? "" : ", no sender report", rx->frames_duplicate);
+            latency_hist_print(&rx->latency, "   Latency");
+        }
+    }
+    
+    if (received > 1) {
+        printf("   Fairness (Jain, RX): %.3f\n", traffic_engine_rx_fairness(engine));
+    }
+    if (engine->frames_unknown > 0) {
+        printf("   Unknown frames: %lu\n", engine->frames_unknown);
+    }
+    
+    return printed;
+}
+
+int traffic_engine_export_latency_csv(traffic_engine_t *engine, const char *filename) {
+    FILE *fp = fopen(filename, "w");
+    if (!fp) {
+        printf("[ERROR] Cannot open %s for writing\n", filename);
+        return -1;
+    }
+    
+    latency_hist_csv_header(fp);
+    for (int i = 0; i < engine->num_flows; i++) {
+        if (engine->flows[i].dst == engine->my_id) {
+            latency_hist_csv_row(fp, "flow", engine->flows[i].id, &engine->rx[i].latency);
+        }
+    }
+    
+    fclose(fp);
+    printf("[TRAFFIC] Flow latency exported to %s\n", filename);
+    return 0;
+}
@@ -0,0 +1,242 @@
+// src/network/tx_queue.c
+#include "tx_queue.h"
+#include "ra_tdmas_sync.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+// Relógio TDMA: os deadlines de drain vêm do escalonador de slots
+static uint64_t get_current_time_us(void) {
+    return ra_tdmas_get_current_time_us();
+}
+
+int tx_queue_init(tx_queue_t *queue, uint32_t capacity) {
+    memset(queue, 0, sizeof(tx_queue_t));
+    
+    queue->frames = calloc(capacity, sizeof(tx_frame_t));
+    if (!queue->frames) return -1;
+    queue->capacity = capacity;
+    queue->max_wait_ms = -1;
+    
+    // Timeouts do push medidos em CLOCK_MONOTONIC
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&queue->not_full, &attr);
+    pthread_condattr_destroy(&attr);
+    
+    pthread_mutex_init(&queue->lock, NULL);
+    return 0;
+}
+
+void tx_queue_destroy(tx_queue_t *queue) {
+    // Liberta frames que ficaram por enviar
+    for (uint32_t i = 0; i < queue->count; i++) {
+        buffer_pool_release(queue->pool,
+                            queue->frames[(queue->head + i) % queue->capacity].data);
+    }
+    
+    free(queue->frames);
+    queue->frames = NULL;
+    queue->count = 0;
+    
+    pthread_cond_destroy(&queue->not_full);
+    pthread_mutex_destroy(&queue->lock);
+}
+
+void tx_queue_set_pool(tx_queue_t *queue, buffer_pool_t *pool) {
+    queue->pool = pool;
+}
+
+void tx_queue_set_metrics(tx_queue_t *queue, metrics_registry_t *reg) {
+    queue->metric_ids.sent = metrics_register_counter(reg,
+        "tx_queue_sent_total", "Packets drained from the TX queue");
+    queue->metric_ids.rejected = metrics_register_counter(reg,
+        "tx_queue_rejected_total", "TX queue pushes that failed");
+    queue->metrics = reg;
+}
+
+void tx_queue_set_max_wait(tx_queue_t *queue, int max_wait_ms) {
+    pthread_mutex_lock(&queue->lock);
+    queue->max_wait_ms = max_wait_ms;
+    pthread_mutex_unlock(&queue->lock);
+}
+
+int tx_queue_push(tx_queue_t *queue, const tx_frame_t *frame, int timeout_ms) {
+    pthread_mutex_lock(&queue->lock);
+    
+    if (queue->max_wait_ms >= 0 && (timeout_ms < 0 || timeout_ms > queue->max_wait_ms)) {
+        timeout_ms = queue->max_wait_ms;
+    }
+    
+    if (queue->count == queue->capacity && !queue->closed && timeout_ms != 0) {
+        queue->producer_waits++;
+        
+        struct timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+        
+        // Backpressure: espera que o slot drene espaço
+        while (queue->count == queue->capacity && !queue->closed) {
+            if (timeout_ms < 0) {
+                pthread_cond_wait(&queue->not_full, &queue->lock);
+            } else if (pthread_cond_timedwait(&queue->not_full, &queue->lock,
+                                              &deadline) == ETIMEDOUT) {
+                break;
+            }
+        }
+    }
+    
+    if (queue->count == queue->capacity || queue->closed) {
+        queue->rejected++;
+        metrics_inc(queue->metrics, queue->metric_ids.rejected);
+        pthread_mutex_unlock(&queue->lock);
+        return -1;
+    }
+    
+    tx_frame_t *slot = &queue->frames[(queue->head + queue->count) % queue->capacity];
+    *slot = *frame;
+    slot->enqueue_time_us = get_current_time_us();
+    queue->count++;
+    queue->enqueued++;
+    
+    pthread_mutex_unlock(&queue->lock);
+    return 0;
+}
+
+uint64_t tx_queue_slot_deadline(uint64_t slot_start_us, uint64_t slot_end_us) {
+    if (slot_end_us <= slot_start_us) return slot_start_us;
+    
+    uint64_t guard = (slot_end_us - slot_start_us) / TX_SLOT_GUARD_FRACTION;
+    if (guard > TX_SLOT_GUARD_US) guard = TX_SLOT_GUARD_US;
+    return slot_end_us - guard;
+}
+
+int tx_queue_drain(tx_queue_t *queue, udp_transport_t *transport,
+                   uint64_t deadline_us) {
+    tx_frame_t frames[UDP_TX_BATCH];
+    udp_tx_packet_t packets[UDP_TX_BATCH];
+    uint64_t slot_bytes = 0;
+    int total = 0;
+    
+    while (true) {
+        uint64_t now = get_current_time_us();
+        if (now >= deadline_us) break;
+        
+        // Retira um batch da fila
+        pthread_mutex_lock(&queue->lock);
+        uint32_t n = queue->count < UDP_TX_BATCH ? queue->count : UDP_TX_BATCH;
+        for (uint32_t i = 0; i < n; i++) {
+            frames[i] = queue->frames[queue->head];
+            queue->head = (queue->head + 1) % queue->capacity;
+        }
+        queue->count -= n;
+        if (n > 0) pthread_cond_broadcast(&queue->not_full);
+        pthread_mutex_unlock(&queue->lock);
+        
+        if (n == 0) break;
+        
+        // Timestamp de TX real (usado pelo RA-TDMAs+ no receptor)
+        for (uint32_t i = 0; i < n; i++) {
+            packets[i].dst = frames[i].dst;
+            packets[i].type = frames[i].type;
+            packets[i].tx_timestamp_us = now;
+            packets[i].segments[0].iov_base = frames[i].data + frames[i].offset;
+            packets[i].segments[0].iov_len = frames[i].len;
+            packets[i].num_segments = 1;
+        }
+        
+        // Um pacote a meio do batch pode falhar: conta-se cada um
+        bool ok[UDP_TX_BATCH];
+        udp_transport_send_batch_status(transport, packets, n, ok);
+        
+        int sent = 0;
+        uint64_t bytes = 0;
+        uint64_t queue_delay_us = 0;   // Só dos enviados: a média divide por 'sent'
+        for (uint32_t i = 0; i < n; i++) {
+            if (ok[i]) {
+                sent++;
+                bytes += frames[i].len;
+                queue_delay_us += now - frames[i].enqueue_time_us;
+            }
+            buffer_pool_release(queue->pool, frames[i].data);
+        }
+        
+        pthread_mutex_lock(&queue->lock);
+        queue->sent += sent;
+        queue->send_errors += n - sent;
+        queue->bytes_sent += bytes;
+        queue->total_queue_delay_us += queue_delay_us;
+        if (queue->first_send_us == 0) queue->first_send_us = now;
+        queue->last_send_us = get_current_time_us();
+        pthread_mutex_unlock(&queue->lock);
+        
+        metrics_add(queue->metrics, queue->metric_ids.sent, sent);
+        slot_bytes += bytes;
+        total += sent;
+    }
+    
+    if (total > 0) {
+        pthread_mutex_lock(&queue->lock);
+        queue->slots_with_data++;
+        queue->last_slot_bytes = slot_bytes;
+        if (slot_bytes > queue->max_slot_bytes) {
+            queue->max_slot_bytes = slot_bytes;
+        }
+        pthread_mutex_unlock(&queue->lock);
+    }
+    
+    return total;
+}
+
+uint32_t tx_queue_pending(tx_queue_t *queue) {
+    pthread_mutex_lock(&queue->lock);
+    uint32_t count = queue->count;
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
+
+void tx_queue_close(tx_queue_t *queue) {
+    pthread_mutex_lock(&queue->lock);
+    queue->closed = true;
+    pthread_cond_broadcast(&queue->not_full);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+void tx_queue_print_stats(tx_queue_t *queue) {
+    pthread_mutex_lock(&queue->lock);
+    
+    printf("\n=== TX Queue Stats ===\n");
+    printf("Pending:        %u / %u frames\n", queue->count, queue->capacity);
+    printf("Enqueued:       %lu (waits: %lu, rejected: %lu)\n",
+           queue->enqueued, queue->producer_waits, queue->rejected);
+    printf("Sent:           %lu frames, %lu bytes (errors: %lu)\n",
+           queue->sent, queue->bytes_sent, queue->send_errors);
+    
+    if (queue->sent > 0) {
+        printf("Queue delay:    %.1f us avg\n",
+               (double)queue->total_queue_delay_us / queue->sent);
+    }
+    
+    if (queue->slots_with_data > 0) {
+        printf("Per slot:       %.0f bytes avg | %lu bytes max (%lu slots)\n",
+               (double)queue->bytes_sent / queue->slots_with_data,
+               queue->max_slot_bytes, queue->slots_with_data);
+        
+        uint64_t span_us = queue->last_send_us - queue->first_send_us;
+        if (span_us > 0) {
+            printf("Goodput:        %.2f Mbps\n",
+                   (queue->bytes_sent * 8.0) / span_us);
+        }
+    }
+    
+    printf("\n");
+    pthread_mutex_unlock(&queue->lock);
+}
@@ -1,5 +1,8 @@
 // src/network/udp_transport.c
+#define _GNU_SOURCE  // recvmmsg() / sendmmsg()
 #include "udp_transport.h"
+#include "shm_link.h"
+#include "async_log.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -7,19 +10,82 @@
 #include <errno.h>
 #include <arpa/inet.h>
 #include <sys/socket.h>
-#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+// Anel de RX: buffers preallocados reutilizados por cada recvmmsg()
+// (um buffer pode ser reclamado para forwarding e é substituído)
+struct udp_rx_ring {
+    uint8_t *buffers[UDP_RX_BATCH];
+    struct iovec iov[UDP_RX_BATCH];
+    struct sockaddr_in addr[UDP_RX_BATCH];
+    struct mmsghdr msgs[UDP_RX_BATCH];
+};
+
+// Falhas de envio: regista a primeira e depois uma a cada N (o resto só conta)
+#define TRANSPORT_ERROR_LOG_EVERY 1000
+
+// Octetos de host utilizáveis por /24: .0 (rede) e .255 (broadcast) ficam de fora
+#define HOSTS_PER_SUBNET 254
+
+uint32_t node_id_to_ipv4(node_id_t node_id) {
+    // 192.168.2.(10+id) para IDs até 244; os seguintes continuam em 192.168.3.1, ...
+    uint32_t index = 9 + (uint32_t)node_id;
+    uint32_t subnet = 2 + index / HOSTS_PER_SUBNET;
+    if (subnet > 255) return 0;
+    
+    return (192u << 24) | (168u << 16) | (subnet << 8) | (1 + index % HOSTS_PER_SUBNET);
+}
+
+node_id_t ipv4_to_node_id(uint32_t ip) {
+    uint32_t subnet = (ip >> 8) & 0xFF;
+    uint32_t host = ip & 0xFF;
+    
+    if ((ip >> 16) != ((192u << 8) | 168u) || subnet < 2 || host == 0 || host == 255) {
+        return NODE_ID_INVALID;
+    }
+    
+    uint32_t index = (subnet - 2) * HOSTS_PER_SUBNET + host - 1;
+    if (index <= 9 || index - 9 >= NODE_ID_INVALID) return NODE_ID_INVALID;
+    return (node_id_t)(index - 9);
+}
 
 void node_id_to_ip(node_id_t node_id, char *ip_str, size_t len) {
-    snprintf(ip_str, len, "192.168.2.%d", 10 + node_id);
+    uint32_t ip = node_id_to_ipv4(node_id);
+    snprintf(ip_str, len, "%u.%u.%u.%u",
+             ip >> 24, (ip >> 16) & 0xFF, (ip >> 8) & 0xFF, ip & 0xFF);
 }
 
 uint16_t node_id_to_port(node_id_t node_id) {
     return UDP_PORT_BASE + node_id;
 }
 
+void node_id_to_sockaddr(node_id_t node_id, struct sockaddr_in *addr) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_port = htons(node_id_to_port(node_id));
+    addr->sin_addr.s_addr = htonl(node_id_to_ipv4(node_id));
+}
+
+int udp_transport_set_peers(udp_transport_t *transport, uint32_t num_nodes) {
+    struct sockaddr_in *addrs = realloc(transport->peer_addrs,
+                                        (num_nodes + 1) * sizeof(struct sockaddr_in));
+    if (!addrs) return -1;
+    
+    for (uint32_t id = 0; id <= num_nodes; id++) {
+        node_id_to_sockaddr(id, &addrs[id]);
+    }
+    
+    transport->peer_addrs = addrs;
+    transport->num_peers = num_nodes;
+    return 0;
+}
+
 int udp_transport_init(udp_transport_t *transport, node_id_t my_id) {
     memset(transport, 0, sizeof(udp_transport_t));
     
+    transport->epoll_fd = -1;
+    transport->wake_fd = -1;
     transport->my_node_id = my_id;
     transport->port = node_id_to_port(my_id);
     
@@ -63,104 +129,285 @@ int udp_transport_init(udp_transport_t *transport, node_id_t my_id) {
         return -1;
     }
     
+    // Anel de RX para recvmmsg()
+    transport->rx_ring = calloc(1, sizeof(udp_rx_ring_t));
+    if (!transport->rx_ring) {
+        close(transport->socket_fd);
+        return -1;
+    }
+    
+    for (int i = 0; i < UDP_RX_BATCH; i++) {
+        transport->rx_ring->buffers[i] = malloc(MAX_PACKET_SIZE);
+        if (!transport->rx_ring->buffers[i]) {
+            for (int j = 0; j < i; j++) free(transport->rx_ring->buffers[j]);
+            free(transport->rx_ring);
+            transport->rx_ring = NULL;
+            close(transport->socket_fd);
+            return -1;
+        }
+        transport->rx_ring->iov[i].iov_base = transport->rx_ring->buffers[i];
+        transport->rx_ring->iov[i].iov_len = MAX_PACKET_SIZE;
+    }
+    
+    // epoll: socket + eventfd de wakeup
+    transport->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    transport->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    
+    if (transport->epoll_fd < 0 || transport->wake_fd < 0) {
+        perror("epoll/eventfd");
+        udp_transport_destroy(transport);
+        return -1;
+    }
+    
+    struct epoll_event ev = { .events = EPOLLIN, .data.fd = transport->socket_fd };
+    struct epoll_event wake_ev = { .events = EPOLLIN, .data.fd = transport->wake_fd };
+    
+    if (epoll_ctl(transport->epoll_fd, EPOLL_CTL_ADD, transport->socket_fd, &ev) < 0 ||
+        epoll_ctl(transport->epoll_fd, EPOLL_CTL_ADD, transport->wake_fd, &wake_ev) < 0) {
+        perror("epoll_ctl");
+        udp_transport_destroy(transport);
+        return -1;
+    }
+    
     printf("[TRANSPORT] Node %d listening on 0.0.0.0:%d (accepting on %s)\n", 
            my_id, transport->port, my_ip);
     
     return 0;
 }
 
+int udp_transport_init_shm(udp_transport_t *transport, node_id_t my_id,
+                           shm_fabric_t *fabric) {
+    memset(transport, 0, sizeof(udp_transport_t));
+    
+    transport->socket_fd = -1;
+    transport->epoll_fd = -1;
+    transport->my_node_id = my_id;
+    
+    // Só o eventfd: os produtores acordam o recetor quando há pacotes
+    transport->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (transport->wake_fd < 0) {
+        perror("eventfd");
+        return -1;
+    }
+    
+    if (shm_endpoint_attach(transport, fabric) < 0) {
+        close(transport->wake_fd);
+        transport->wake_fd = -1;
+        return -1;
+    }
+    
+    return 0;
+}
+
+int udp_transport_send_batch(udp_transport_t *transport,
+                             const udp_tx_packet_t *packets,
+                             int count) {
+    return udp_transport_send_batch_status(transport, packets, count, NULL);
+}
+
+int udp_transport_send_batch_status(udp_transport_t *transport,
+                                    const udp_tx_packet_t *packets,
+                                    int count, bool *sent_ok) {
+    if (sent_ok && count > 0) {
+        memset(sent_ok, 0, count * sizeof(bool));
+    }
+    
+    if (transport->shm) {
+        return shm_endpoint_send_batch(transport, packets, count, sent_ok);
+    }
+    
+    udp_header_t headers[UDP_TX_BATCH];
+    struct iovec iov[UDP_TX_BATCH][1 + UDP_TX_MAX_SEGMENTS];
+    struct sockaddr_in addrs[UDP_TX_BATCH];
+    struct mmsghdr msgs[UDP_TX_BATCH];
+    int origin[UDP_TX_BATCH];             // msgs[q] é packets[base + origin[q]]
+    
+    int total_sent = 0;
+    
+    for (int base = 0; base < count; base += UDP_TX_BATCH) {
+        int n = count - base < UDP_TX_BATCH ? count - base : UDP_TX_BATCH;
+        int queued = 0;
+        
+        for (int i = 0; i < n; i++) {
+            const udp_tx_packet_t *pkt = &packets[base + i];
+            
+            size_t payload_len = 0;
+            for (int s = 0; s < pkt->num_segments; s++) {
+                payload_len += pkt->segments[s].iov_len;
+            }
+            
+            if (payload_len > MAX_PACKET_SIZE - sizeof(udp_header_t)) {
+                fprintf(stderr, "[TRANSPORT] Payload too large: %zu\n", payload_len);
+                udp_transport_count_error(transport);
+                continue;
+            }
+            
+            // Build header
+            udp_header_t *header = &headers[queued];
+            header->version = 1;
+            header->type = pkt->type;
+            header->src = transport->my_node_id;
+            header->dst = pkt->dst;
+            header->sequence = (transport->packets_sent + total_sent + queued) & 0xFFFF;
+            header->payload_len = payload_len;
+            header->tx_timestamp_us = pkt->tx_timestamp_us;
+            
+            // Header + segmentos do payload, sem cópia
+            iov[queued][0].iov_base = header;
+            iov[queued][0].iov_len = sizeof(udp_header_t);
+            memcpy(&iov[queued][1], pkt->segments,
+                   pkt->num_segments * sizeof(struct iovec));
+            
+            // Destination address (tabela pré-calculada)
+            const struct sockaddr_in *dst_addr;
+            if (pkt->dst <= transport->num_peers && transport->peer_addrs) {
+                dst_addr = &transport->peer_addrs[pkt->dst];
+            } else {
+                node_id_to_sockaddr(pkt->dst, &addrs[queued]);
+                dst_addr = &addrs[queued];
+            }
+            
+            memset(&msgs[queued].msg_hdr, 0, sizeof(struct msghdr));
+            msgs[queued].msg_hdr.msg_name = (void *)dst_addr;
+            msgs[queued].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+            msgs[queued].msg_hdr.msg_iov = iov[queued];
+            msgs[queued].msg_hdr.msg_iovlen = 1 + pkt->num_segments;
+            origin[queued] = i;
+            queued++;
+        }
+        
+        // sendmmsg() pode enviar só parte: continua a partir do primeiro pendente
+        int done = 0;
+        while (done < queued) {
+            int sent = sendmmsg(transport->socket_fd, &msgs[done], queued - done, 0);
+            
+            if (sent < 0) {
+                if (errno == EINTR) continue;
+                
+                // Salta o pacote que falhou (ex.: destino inalcançável)
+                udp_transport_count_error(transport);
+                if (transport->errors % TRANSPORT_ERROR_LOG_EVERY == 1) {
+                    LOG_WARN("[TRANSPORT] sendmmsg() to node %d failed: errno %d (%lu errors)\n",
+                             packets[base + origin[done]].dst, errno, transport->errors);
+                }
+                done++;
+                continue;
+            }
+            
+            transport->tx_batches++;
+            uint64_t bytes = 0;
+            for (int i = done; i < done + sent; i++) {
+                bytes += msgs[i].msg_len;
+                if (sent_ok) sent_ok[base + origin[i]] = true;
+            }
+            udp_transport_count_tx(transport, sent, bytes);
+            total_sent += sent;
+            done += sent;
+        }
+    }
+    
+    return (total_sent == 0 && count > 0) ? -1 : total_sent;
+}
+
 int udp_transport_send(udp_transport_t *transport, node_id_t dst_node,
                       message_type_t msg_type, const void *payload,
                       uint16_t payload_len, uint64_t tx_timestamp_us) {
     
-    // Get destination IP
-    char dst_ip[16];
-    node_id_to_ip(dst_node, dst_ip, sizeof(dst_ip));
-    uint16_t dst_port = node_id_to_port(dst_node);
-    
-    // DEBUG: Print first send
-    static bool first_send = true;
-    if (first_send) {
-        printf("[TRANSPORT-DEBUG] First send from node %d to node %d\n",
-               transport->my_node_id, dst_node);
-        printf("[TRANSPORT-DEBUG] Destination: %s:%d\n", dst_ip, dst_port);
-        first_send = false;
-    }
-    
-    // Build header
-    udp_header_t header;
-    header.version = 1;
-    header.type = msg_type;
-    header.src = transport->my_node_id;
-    header.dst = dst_node;
-    header.sequence = transport->packets_sent & 0xFFFF;
-    header.payload_len = payload_len;
-    header.tx_timestamp_us = tx_timestamp_us;
-    
-    // Build packet
-    uint8_t buffer[MAX_PACKET_SIZE];
-    memcpy(buffer, &header, sizeof(udp_header_t));
+    udp_tx_packet_t pkt;
+    pkt.dst = dst_node;
+    pkt.type = msg_type;
+    pkt.tx_timestamp_us = tx_timestamp_us;
+    pkt.num_segments = 0;
+    
     if (payload && payload_len > 0) {
-        if (payload_len > MAX_PACKET_SIZE - sizeof(udp_header_t)) {
-            fprintf(stderr, "[TRANSPORT] Payload too large: %u\n", payload_len);
-            return -1;
-        }
-        memcpy(buffer + sizeof(udp_header_t), payload, payload_len);
+        pkt.segments[0].iov_base = (void *)payload;
+        pkt.segments[0].iov_len = payload_len;
+        pkt.num_segments = 1;
     }
     
-    size_t total_len = sizeof(udp_header_t) + payload_len;
-    
-    // Build destination address
-    struct sockaddr_in dst_addr;
-    memset(&dst_addr, 0, sizeof(dst_addr));
-    dst_addr.sin_family = AF_INET;
-    dst_addr.sin_port = htons(dst_port);
+    if (udp_transport_send_batch(transport, &pkt, 1) != 1) {
+        return -1;
+    }
     
-    if (inet_pton(AF_INET, dst_ip, &dst_addr.sin_addr) <= 0) {
-        fprintf(stderr, "[TRANSPORT] Invalid destination IP: %s\n", dst_ip);
+    return sizeof(udp_header_t) + payload_len;
+}
+
+/**
+ * Valida um pacote recebido e extrai o header
+ * @return 0 se válido, -1 se deve ser descartado
+ */
+static int parse_packet(udp_transport_t *transport, const uint8_t *buffer,
+                        ssize_t received, udp_header_t *header) {
+    // Validate packet size
+    if (received < (ssize_t)sizeof(udp_header_t)) {
+        fprintf(stderr, "[TRANSPORT] Packet too small: %zd bytes\n", received);
+        udp_transport_count_error(transport);
         return -1;
     }
     
-    // Send packet
-    ssize_t sent = sendto(transport->socket_fd, buffer, total_len, 0,
-                         (struct sockaddr*)&dst_addr, sizeof(dst_addr));
-    
-    if (sent < 0) {
-        // Print error details on first failure
-        static int error_count = 0;
-        if (error_count < 5) {
-            fprintf(stderr, "[TRANSPORT-DEBUG] sendto() failed:\n");
-            fprintf(stderr, "  Socket: %d\n", transport->socket_fd);
-            fprintf(stderr, "  Dest IP: %s\n", dst_ip);
-            fprintf(stderr, "  Dest Port: %d\n", dst_port);
-            fprintf(stderr, "  Error: %s (errno=%d)\n", strerror(errno), errno);
-            error_count++;
-        }
-        
-        transport->errors++;
+    // Parse header
+    memcpy(header, buffer, sizeof(udp_header_t));
+    
+    // Validate header
+    if (header->version != 1) {
+        fprintf(stderr, "[TRANSPORT] Invalid version: %u\n", header->version);
+        udp_transport_count_error(transport);
         return -1;
     }
     
-    transport->packets_sent++;
-    transport->bytes_sent += sent;
+    if (received < (ssize_t)(sizeof(udp_header_t) + header->payload_len)) {
+        fprintf(stderr, "[TRANSPORT] Incomplete packet\n");
+        udp_transport_count_error(transport);
+        return -1;
+    }
     
-    return sent;
+    return 0;
+}
+
+static void debug_first_receive(udp_transport_t *transport,
+                                const struct sockaddr_in *src_addr) {
+    // DEBUG: Print first receive
+    static bool first_recv = true;
+    if (first_recv) {
+        char src_ip[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &src_addr->sin_addr, src_ip, sizeof(src_ip));
+        printf("[TRANSPORT-DEBUG] First receive on node %d from %s:%d\n",
+               transport->my_node_id, src_ip, ntohs(src_addr->sin_port));
+        first_recv = false;
+    }
 }
 
 int udp_transport_receive(udp_transport_t *transport, udp_header_t *header,
                          void *payload, uint16_t max_payload_len, bool blocking) {
     
-    // Set non-blocking if requested
-    if (!blocking) {
-        int flags = fcntl(transport->socket_fd, F_GETFL, 0);
-        fcntl(transport->socket_fd, F_SETFL, flags | O_NONBLOCK);
+    if (transport->shm) {
+        udp_rx_packet_t pkt;
+        if (blocking) {
+            while (udp_transport_wait(transport, -1) == 0) {}
+        }
+        
+        int n = shm_endpoint_receive_batch(transport, &pkt, 1);
+        if (n <= 0) return n;
+        
+        *header = pkt.header;
+        if (pkt.payload_len > 0 && payload != NULL) {
+            if (pkt.payload_len > max_payload_len) {
+                udp_transport_count_error(transport);
+                return -1;
+            }
+            memcpy(payload, pkt.payload, pkt.payload_len);
+        }
+        return pkt.payload_len;
     }
     
+    // Non-blocking por chamada (sem fcntl no socket)
+    int flags = blocking ? 0 : MSG_DONTWAIT;
+    
     uint8_t buffer[MAX_PACKET_SIZE];
     struct sockaddr_in src_addr;
     socklen_t addr_len = sizeof(src_addr);
     
-    ssize_t received = recvfrom(transport->socket_fd, buffer, sizeof(buffer), 0,
+    ssize_t received = recvfrom(transport->socket_fd, buffer, sizeof(buffer), flags,
                                (struct sockaddr*)&src_addr, &addr_len);
     
     if (received < 0) {
@@ -168,34 +415,13 @@ int udp_transport_receive(udp_transport_t *transport, udp_header_t *header,
             return 0;  // No data available
         }
         perror("recvfrom");
-        transport->errors++;
-        return -1;
-    }
-    
-    // DEBUG: Print first receive
-    static bool first_recv = true;
-    if (first_recv) {
-        char src_ip[INET_ADDRSTRLEN];
-        inet_ntop(AF_INET, &src_addr.sin_addr, src_ip, sizeof(src_ip));
-        printf("[TRANSPORT-DEBUG] First receive on node %d from %s:%d\n",
-               transport->my_node_id, src_ip, ntohs(src_addr.sin_port));
-        first_recv = false;
-    }
-    
-    // Validate packet size
-    if (received < (ssize_t)sizeof(udp_header_t)) {
-        fprintf(stderr, "[TRANSPORT] Packet too small: %zd bytes\n", received);
-        transport->errors++;
+        udp_transport_count_error(transport);
         return -1;
     }
     
-    // Parse header
-    memcpy(header, buffer, sizeof(udp_header_t));
+    debug_first_receive(transport, &src_addr);
     
-    // Validate header
-    if (header->version != 1) {
-        fprintf(stderr, "[TRANSPORT] Invalid version: %u\n", header->version);
-        transport->errors++;
+    if (parse_packet(transport, buffer, received, header) < 0) {
         return -1;
     }
     
@@ -205,57 +431,257 @@ int udp_transport_receive(udp_transport_t *transport, udp_header_t *header,
         if (payload_len > max_payload_len) {
             fprintf(stderr, "[TRANSPORT] Payload too large: %u > %u\n",
                    payload_len, max_payload_len);
-            transport->errors++;
-            return -1;
-        }
-        
-        if (received < (ssize_t)(sizeof(udp_header_t) + payload_len)) {
-            fprintf(stderr, "[TRANSPORT] Incomplete packet\n");
-            transport->errors++;
+            udp_transport_count_error(transport);
             return -1;
         }
         
         memcpy(payload, buffer + sizeof(udp_header_t), payload_len);
     }
     
-    transport->packets_received++;
-    transport->bytes_received += received;
+    udp_transport_count_rx(transport, received);
     
     return payload_len;
 }
 
+int udp_transport_wait(udp_transport_t *transport, int timeout_ms) {
+    if (transport->shm) {
+        return shm_endpoint_wait(transport, timeout_ms);
+    }
+    
+    struct epoll_event events[2];
+    
+    int n = epoll_wait(transport->epoll_fd, events, 2, timeout_ms);
+    if (n < 0) {
+        if (errno == EINTR) return 0;
+        perror("epoll_wait");
+        return -1;
+    }
+    
+    int ready = 0;
+    for (int i = 0; i < n; i++) {
+        if (events[i].data.fd == transport->wake_fd) {
+            uint64_t value;
+            if (read(transport->wake_fd, &value, sizeof(value)) < 0) {
+                // EAGAIN: outro waiter já consumiu o wakeup
+            }
+        } else {
+            ready = 1;
+        }
+    }
+    
+    return ready;
+}
+
+int udp_transport_receive_batch(udp_transport_t *transport,
+                                udp_rx_packet_t *packets,
+                                int max_packets) {
+    if (transport->shm) {
+        return shm_endpoint_receive_batch(transport, packets, max_packets);
+    }
+    
+    udp_rx_ring_t *ring = transport->rx_ring;
+    
+    if (max_packets > UDP_RX_BATCH) max_packets = UDP_RX_BATCH;
+    if (!ring || max_packets <= 0) return -1;
+    
+    for (int i = 0; i < max_packets; i++) {
+        memset(&ring->msgs[i].msg_hdr, 0, sizeof(struct msghdr));
+        ring->msgs[i].msg_hdr.msg_iov = &ring->iov[i];
+        ring->msgs[i].msg_hdr.msg_iovlen = 1;
+        ring->msgs[i].msg_hdr.msg_name = &ring->addr[i];
+        ring->msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+    }
+    
+    int n = recvmmsg(transport->socket_fd, ring->msgs, max_packets,
+                     MSG_DONTWAIT, NULL);
+    
+    if (n < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;  // No data available
+        }
+        perror("recvmmsg");
+        udp_transport_count_error(transport);
+        return -1;
+    }
+    
+    if (n > 0) {
+        transport->rx_batches++;
+        debug_first_receive(transport, &ring->addr[0]);
+    }
+    
+    // Compacta os pacotes válidos no início do array de saída
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        ssize_t received = ring->msgs[i].msg_len;
+        udp_rx_packet_t *pkt = &packets[count];
+        
+        if (parse_packet(transport, ring->buffers[i], received, &pkt->header) < 0) {
+            continue;
+        }
+        
+        pkt->payload = ring->buffers[i] + sizeof(udp_header_t);
+        pkt->payload_len = pkt->header.payload_len;
+        
+        udp_transport_count_rx(transport, received);
+        count++;
+    }
+    
+    return count;
+}
+
+uint8_t *udp_transport_claim_rx_buffer(udp_transport_t *transport,
+                                       const uint8_t *payload) {
+    if (transport->shm) {
+        return shm_endpoint_claim_rx_buffer(transport, payload);
+    }
+    
+    udp_rx_ring_t *ring = transport->rx_ring;
+    if (!ring || !payload) return NULL;
+    
+    for (int i = 0; i < UDP_RX_BATCH; i++) {
+        uint8_t *buffer = ring->buffers[i];
+        if (payload != buffer + sizeof(udp_header_t)) continue;
+        
+        // Substitui o buffer do anel; o antigo passa para o chamador
+        uint8_t *replacement = buffer_pool_alloc(transport->pool, MAX_PACKET_SIZE);
+        if (!replacement) return NULL;
+        
+        ring->buffers[i] = replacement;
+        ring->iov[i].iov_base = replacement;
+        return buffer;
+    }
+    
+    return NULL;
+}
+
+int udp_transport_set_pool(udp_transport_t *transport, buffer_pool_t *pool) {
+    // Modo cluster: os emissores alocam os pacotes para este nó no pool
+    if (transport->shm) {
+        transport->pool = pool;
+        return 0;
+    }
+    
+    udp_rx_ring_t *ring = transport->rx_ring;
+    if (!ring) return -1;
+    
+    for (int i = 0; i < UDP_RX_BATCH; i++) {
+        uint8_t *buffer = buffer_pool_alloc(pool, MAX_PACKET_SIZE);
+        if (!buffer) return -1;
+        
+        buffer_pool_release(transport->pool, ring->buffers[i]);
+        ring->buffers[i] = buffer;
+        ring->iov[i].iov_base = buffer;
+    }
+    
+    transport->pool = pool;
+    return 0;
+}
+
+void udp_transport_set_metrics(udp_transport_t *transport, metrics_registry_t *reg) {
+    udp_transport_metric_ids_t *ids = &transport->metric_ids;
+    
+    ids->packets_sent = metrics_register_counter(reg,
+        "transport_packets_sent_total", "UDP packets sent");
+    ids->packets_received = metrics_register_counter(reg,
+        "transport_packets_received_total", "UDP packets received");
+    ids->bytes_sent = metrics_register_counter(reg,
+        "transport_bytes_sent_total", "UDP bytes sent");
+    ids->bytes_received = metrics_register_counter(reg,
+        "transport_bytes_received_total", "UDP bytes received");
+    ids->errors = metrics_register_counter(reg,
+        "transport_errors_total", "UDP send/receive errors");
+    transport->metrics = reg;
+}
+
+void udp_transport_wakeup(udp_transport_t *transport) {
+    uint64_t one = 1;
+    if (transport->wake_fd >= 0 &&
+        write(transport->wake_fd, &one, sizeof(one)) < 0) {
+        perror("eventfd write");
+    }
+}
+
 int udp_transport_broadcast(udp_transport_t *transport, message_type_t msg_type,
                            const void *payload, uint16_t payload_len,
                            int num_nodes, uint64_t tx_timestamp_us) {
+    udp_tx_packet_t batch[UDP_TX_BATCH];
+    int queued = 0;
     int sent_count = 0;
     
+    // Um sendmmsg() por grupo de UDP_TX_BATCH destinos
     for (int i = 1; i <= num_nodes; i++) {
         if (i == transport->my_node_id) continue;
         
-        if (udp_transport_send(transport, i, msg_type, payload, payload_len,
-                              tx_timestamp_us) > 0) {
-            sent_count++;
+        udp_tx_packet_t *pkt = &batch[queued++];
+        pkt->dst = i;
+        pkt->type = msg_type;
+        pkt->tx_timestamp_us = tx_timestamp_us;
+        pkt->segments[0].iov_base = (void *)payload;
+        pkt->segments[0].iov_len = payload_len;
+        pkt->num_segments = (payload && payload_len > 0) ? 1 : 0;
+        
+        if (queued == UDP_TX_BATCH || i == num_nodes) {
+            int sent = udp_transport_send_batch(transport, batch, queued);
+            if (sent > 0) sent_count += sent;
+            queued = 0;
         }
     }
     
+    if (queued > 0) {
+        int sent = udp_transport_send_batch(transport, batch, queued);
+        if (sent > 0) sent_count += sent;
+    }
+    
     return sent_count;
 }
 
 void udp_transport_print_stats(udp_transport_t *transport) {
     printf("\n=== UDP Transport Stats (Node %d) ===\n", transport->my_node_id);
-    printf("Port:         %d\n", transport->port);
+    if (transport->shm) {
+        printf("Links:        shared memory (%u-node fabric)\n",
+               transport->shm->fabric->max_nodes);
+    } else {
+        printf("Port:         %d\n", transport->port);
+    }
     printf("Sent:         %lu packets, %lu bytes\n", 
            transport->packets_sent, transport->bytes_sent);
     printf("Received:     %lu packets, %lu bytes\n",
            transport->packets_received, transport->bytes_received);
     printf("Errors:       %lu\n", transport->errors);
+    if (transport->tx_batches > 0) {
+        printf("TX batches:   %lu (%.1f packets/sendmmsg)\n", transport->tx_batches,
+               (double)transport->packets_sent / transport->tx_batches);
+    }
+    if (transport->rx_batches > 0) {
+        printf("RX batches:   %lu (%.1f packets/recvmmsg)\n", transport->rx_batches,
+               (double)transport->packets_received / transport->rx_batches);
+    }
     printf("\n");
 }
 
 void udp_transport_destroy(udp_transport_t *transport) {
+    shm_endpoint_detach(transport);   // Antes do wake_fd: devolve os pacotes em voo
     if (transport->socket_fd >= 0) {
         close(transport->socket_fd);
         transport->socket_fd = -1;
     }
+    if (transport->epoll_fd >= 0) {
+        close(transport->epoll_fd);
+        transport->epoll_fd = -1;
+    }
+    if (transport->wake_fd >= 0) {
+        close(transport->wake_fd);
+        transport->wake_fd = -1;
+    }
+    if (transport->rx_ring) {
+        for (int i = 0; i < UDP_RX_BATCH; i++) {
+            buffer_pool_release(transport->pool, transport->rx_ring->buffers[i]);
+        }
+    }
+    free(transport->rx_ring);
+    transport->rx_ring = NULL;
+    free(transport->peer_addrs);
+    transport->peer_addrs = NULL;
+    transport->num_peers = 0;
     printf("[TRANSPORT] Node %d destroyed\n", transport->my_node_id);
 }
\ No newline at end of file
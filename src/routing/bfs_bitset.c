@@ -0,0 +1,168 @@
+// src/routing/bfs_bitset.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bfs_bitset.h"
+
+int bfs_bitset_compute(node_id_t src,
+                       const adjacency_bitset_t *adj,
+                       dijkstra_result_t *results) {
+    
+    if (!adj || !results) {
+        return -1;
+    }
+    
+    int src_idx = -1;
+    for (uint32_t i = 0; i < adj->num_nodes; i++) {
+        if (adj->node_ids[i] == src) {
+            src_idx = i;
+            break;
+        }
+    }
+    
+    if (src_idx == -1) {
+        printf("[BFS-BITSET] Source node %d not found in topology\n", src);
+        return -1;
+    }
+    
+    uint32_t n = adj->num_nodes;
+    uint32_t words = adj->words_per_row;
+    
+    // visited | frontier | next | pending numa única alocação
+    bitset_word_t *sets = calloc(4 * (size_t)words, sizeof(bitset_word_t));
+    uint16_t *distance = malloc(n * sizeof(uint16_t));
+    uint32_t *first_hop = malloc(n * sizeof(uint32_t));  // Índice do primeiro hop
+    
+    if (!sets || !distance || !first_hop) {
+        free(sets);
+        free(distance);
+        free(first_hop);
+        return -1;
+    }
+    
+    bitset_word_t *visited = sets;
+    bitset_word_t *frontier = sets + words;
+    bitset_word_t *next = sets + 2 * words;
+    bitset_word_t *pending = sets + 3 * words;   // Descobertos ainda sem first hop
+    
+    for (uint32_t i = 0; i < n; i++) {
+        distance[i] = INFINITY_COST;
+    }
+    
+    distance[src_idx] = 0;
+    first_hop[src_idx] = src_idx;
+    visited[src_idx / BITSET_WORD_BITS] |= 1ULL << (src_idx % BITSET_WORD_BITS);
+    frontier[src_idx / BITSET_WORD_BITS] = visited[src_idx / BITSET_WORD_BITS];
+    
+    uint16_t level = 0;
+    bool frontier_empty = false;
+    
+    while (!frontier_empty && level < INFINITY_COST - 1) {
+        memset(next, 0, words * sizeof(bitset_word_t));
+        level++;
+        
+        // next = (OR das linhas da fronteira) & ~visited, palavra a palavra
+        for (uint32_t w = 0; w < words; w++) {
+            bitset_word_t bits = frontier[w];
+            
+            while (bits) {
+                uint32_t u = w * BITSET_WORD_BITS + __builtin_ctzll(bits);
+                bits &= bits - 1;
+                
+                const bitset_word_t *row = adjacency_bitset_row(adj, u);
+                for (uint32_t k = 0; k < words; k++) {
+                    next[k] |= row[k];
+                }
+            }
+        }
+        
+        frontier_empty = true;
+        for (uint32_t k = 0; k < words; k++) {
+            next[k] &= ~visited[k];
+            pending[k] = next[k];
+            if (next[k]) frontier_empty = false;
+        }
+        if (frontier_empty) break;
+        
+        // First hop: o pai é o vizinho de menor índice na fronteira (como
+        // no dijkstra_compute); para quando todo o nível tem pai
+        uint32_t left = 0;
+        for (uint32_t k = 0; k < words; k++) {
+            left += __builtin_popcountll(pending[k]);
+        }
+        
+        for (uint32_t w = 0; w < words && left > 0; w++) {
+            bitset_word_t bits = frontier[w];
+            
+            while (bits && left > 0) {
+                uint32_t u = w * BITSET_WORD_BITS + __builtin_ctzll(bits);
+                bits &= bits - 1;
+                
+                const bitset_word_t *row = adjacency_bitset_row(adj, u);
+                for (uint32_t k = 0; k < words; k++) {
+                    bitset_word_t claim = row[k] & pending[k];
+                    if (!claim) continue;
+                    
+                    pending[k] &= ~claim;
+                    left -= __builtin_popcountll(claim);
+                    
+                    while (claim) {
+                        uint32_t v = k * BITSET_WORD_BITS + __builtin_ctzll(claim);
+                        claim &= claim - 1;
+                        
+                        distance[v] = level;
+                        // Vizinhos diretos do source são o próprio first hop
+                        first_hop[v] = ((int)u == src_idx) ? v : first_hop[u];
+                    }
+                }
+            }
+        }
+        
+        for (uint32_t k = 0; k < words; k++) {
+            visited[k] |= next[k];
+            frontier[k] = next[k];
+        }
+    }
+    
+    // Build results (mesmo formato que dijkstra_compute)
+    for (uint32_t i = 0; i < n; i++) {
+        node_id_t dst = adj->node_ids[i];
+        
+        results[i].destination = dst;
+        results[i].distance = distance[i];
+        results[i].reachable = (distance[i] != INFINITY_COST);
+        results[i].cost = results[i].reachable ? distance[i] : INFINITY_PATH_COST;
+        
+        if ((int)i == src_idx) {
+            results[i].next_hop = dst;  // Self
+        } else if (results[i].reachable) {
+            results[i].next_hop = adj->node_ids[first_hop[i]];
+        } else {
+            results[i].next_hop = NODE_ID_INVALID;  // Unreachable
+        }
+    }
+    
+    free(sets);
+    free(distance);
+    free(first_hop);
+    return 0;
+}
+
+int bfs_bitset_compute_matrix(node_id_t src,
+                              connectivity_matrix_t *topology,
+                              dijkstra_result_t results[MAX_NODES]) {
+    if (!topology) {
+        return -1;
+    }
+    
+    adjacency_bitset_t adj;
+    adjacency_bitset_init(&adj);
+    
+    int ret = -1;
+    if (adjacency_bitset_from_matrix(&adj, topology) == 0) {
+        ret = bfs_bitset_compute(src, &adj, results);
+    }
+    
+    adjacency_bitset_destroy(&adj);
+    return ret;
+}
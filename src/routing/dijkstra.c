@@ -2,16 +2,18 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdlib.h>
 #include <limits.h>
 #include "dijkstra.h"
+#include "cost_heap.h"
 
 /**
  * Encontra índice do nó com menor distância não visitado
  */
-static int find_min_distance_node(uint8_t distance[MAX_NODES],
+static int find_min_distance_node(uint16_t distance[MAX_NODES],
                                    bool visited[MAX_NODES],
                                    int num_nodes) {
-    uint8_t min = INFINITY_COST;
+    uint16_t min = INFINITY_COST;
     int min_idx = -1;
     
     for (int i = 0; i < num_nodes; i++) {
@@ -45,7 +47,7 @@ static node_id_t get_next_hop(int src_idx, int dst_idx,
     }
     
     if (prev == -1) {
-        return 0xFF;  // No path
+        return NODE_ID_INVALID;  // No path
     }
     
     // 'current' is the first hop after source
@@ -75,7 +77,7 @@ int dijkstra_compute(node_id_t src,
     }
     
     // Initialize arrays
-    uint8_t distance[MAX_NODES];
+    uint16_t distance[MAX_NODES];
     int previous[MAX_NODES];
     bool visited[MAX_NODES];
     
@@ -102,7 +104,7 @@ int dijkstra_compute(node_id_t src,
         for (int v = 0; v < topology->num_nodes; v++) {
             // Check if there's an edge and node not visited
             if (topology->matrix[u][v] && !visited[v]) {
-                uint8_t alt = distance[u] + 1;  // hop count = 1
+                uint16_t alt = distance[u] + 1;  // hop count = 1
                 
                 if (alt < distance[v]) {
                     distance[v] = alt;
@@ -119,19 +121,207 @@ int dijkstra_compute(node_id_t src,
         results[i].destination = dst;
         results[i].distance = distance[i];
         results[i].reachable = (distance[i] != INFINITY_COST);
+        results[i].cost = results[i].reachable ? distance[i] : INFINITY_PATH_COST;
         
         if (i == src_idx) {
             results[i].next_hop = dst;  // Self
         } else if (results[i].reachable) {
             results[i].next_hop = get_next_hop(src_idx, i, previous, topology);
         } else {
-            results[i].next_hop = 0xFF;  // Unreachable
+            results[i].next_hop = NODE_ID_INVALID;  // Unreachable
         }
     }
     
     return 0;
 }
 
+static int compare_index(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+int dijkstra_compute_graph(node_id_t src,
+                           const topology_graph_t *graph,
+                           dijkstra_result_t *results) {
+    
+    if (!graph || !results) {
+        return -1;
+    }
+    
+    int src_idx = topology_graph_index_of(graph, src);
+    if (src_idx == -1) {
+        printf("[DIJKSTRA] Source node %d not found in topology\n", src);
+        return -1;
+    }
+    
+    uint32_t n = graph->num_nodes;
+    uint16_t *distance = malloc(n * sizeof(uint16_t));
+    uint32_t *first_hop = malloc(n * sizeof(uint32_t));
+    uint32_t *queue = malloc(n * sizeof(uint32_t));
+    
+    if (!distance || !first_hop || !queue) {
+        free(distance);
+        free(first_hop);
+        free(queue);
+        return -1;
+    }
+    
+    for (uint32_t i = 0; i < n; i++) {
+        distance[i] = INFINITY_COST;
+    }
+    
+    distance[src_idx] = 0;
+    first_hop[src_idx] = src_idx;
+    
+    uint32_t level_start = 0, level_end = 0, rear = 0;
+    queue[rear++] = src_idx;
+    
+    // BFS por níveis (custo unitário)
+    while (level_start < rear) {
+        level_end = rear;
+        
+        // Mesmo desempate do Dijkstra denso: menor índice primeiro
+        qsort(&queue[level_start], level_end - level_start,
+              sizeof(uint32_t), compare_index);
+        
+        for (uint32_t q = level_start; q < level_end; q++) {
+            uint32_t u = queue[q];
+            const graph_adj_list_t *list = &graph->adj[u];
+            
+            for (uint32_t e = 0; e < list->degree; e++) {
+                uint32_t v = list->edges[e].to;
+                
+                if (distance[v] != INFINITY_COST) continue;
+                
+                distance[v] = distance[u] + 1;
+                first_hop[v] = ((int)u == src_idx) ? v : first_hop[u];
+                queue[rear++] = v;
+            }
+        }
+        
+        level_start = level_end;
+    }
+    
+    for (uint32_t i = 0; i < n; i++) {
+        node_id_t dst = graph->node_ids[i];
+        
+        results[i].destination = dst;
+        results[i].distance = distance[i];
+        results[i].reachable = (distance[i] != INFINITY_COST);
+        results[i].cost = results[i].reachable ? distance[i] : INFINITY_PATH_COST;
+        
+        if ((int)i == src_idx) {
+            results[i].next_hop = dst;  // Self
+        } else if (results[i].reachable) {
+            results[i].next_hop = graph->node_ids[first_hop[i]];
+        } else {
+            results[i].next_hop = NODE_ID_INVALID;  // Unreachable
+        }
+    }
+    
+    free(distance);
+    free(first_hop);
+    free(queue);
+    return 0;
+}
+
+// ========================================
+// Dijkstra Pesado (heap binário indexado)
+// ========================================
+
+int dijkstra_compute_weighted(node_id_t src,
+                              const topology_graph_t *graph,
+                              dijkstra_result_t *results) {
+    
+    if (!graph || !results) {
+        return -1;
+    }
+    
+    int src_idx = topology_graph_index_of(graph, src);
+    if (src_idx == -1) {
+        printf("[DIJKSTRA] Source node %d not found in topology\n", src);
+        return -1;
+    }
+    
+    uint32_t n = graph->num_nodes;
+    uint32_t *cost = malloc(n * sizeof(uint32_t));
+    uint16_t *hops = malloc(n * sizeof(uint16_t));
+    uint32_t *first_hop = malloc(n * sizeof(uint32_t));
+    uint32_t *items = malloc(n * sizeof(uint32_t));
+    int32_t *pos = malloc(n * sizeof(int32_t));
+    bool *visited = calloc(n, sizeof(bool));
+    
+    if (!cost || !hops || !first_hop || !items || !pos || !visited) {
+        free(cost);
+        free(hops);
+        free(first_hop);
+        free(items);
+        free(pos);
+        free(visited);
+        return -1;
+    }
+    
+    for (uint32_t i = 0; i < n; i++) {
+        cost[i] = INFINITY_PATH_COST;
+        hops[i] = INFINITY_COST;
+        pos[i] = -1;
+    }
+    
+    cost_heap_t heap = { items, pos, cost, 0 };
+    
+    cost[src_idx] = 0;
+    hops[src_idx] = 0;
+    first_hop[src_idx] = src_idx;
+    cost_heap_push_or_decrease(&heap, src_idx);
+    
+    while (heap.size > 0) {
+        uint32_t u = cost_heap_pop(&heap);
+        visited[u] = true;
+        
+        const graph_adj_list_t *list = &graph->adj[u];
+        
+        for (uint32_t e = 0; e < list->degree; e++) {
+            uint32_t v = list->edges[e].to;
+            if (visited[v]) continue;
+            
+            uint32_t alt = cost[u] + list->edges[e].weight;
+            
+            if (alt < cost[v]) {
+                cost[v] = alt;
+                hops[v] = hops[u] + 1;
+                first_hop[v] = ((int)u == src_idx) ? v : first_hop[u];
+                cost_heap_push_or_decrease(&heap, v);
+            }
+        }
+    }
+    
+    for (uint32_t i = 0; i < n; i++) {
+        node_id_t dst = graph->node_ids[i];
+        
+        results[i].destination = dst;
+        results[i].distance = hops[i];
+        results[i].cost = cost[i];
+        results[i].reachable = (cost[i] != INFINITY_PATH_COST);
+        
+        if ((int)i == src_idx) {
+            results[i].next_hop = dst;  // Self
+        } else if (results[i].reachable) {
+            results[i].next_hop = graph->node_ids[first_hop[i]];
+        } else {
+            results[i].next_hop = NODE_ID_INVALID;  // Unreachable
+        }
+    }
+    
+    free(cost);
+    free(hops);
+    free(first_hop);
+    free(items);
+    free(pos);
+    free(visited);
+    return 0;
+}
+
 void dijkstra_print_results(node_id_t src, 
                            dijkstra_result_t results[MAX_NODES],
                            int num_nodes) {
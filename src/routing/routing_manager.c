@@ -1,10 +1,14 @@
 // src/routing/routing_manager.c
 #include "routing_manager.h"
+#include "bfs_bitset.h"
+#include "async_log.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <sys/time.h>  // <--- ADICIONADO para microsegundos
 #include <limits.h>    // <--- ADICIONADO para UINT64_MAX
+#include <sched.h>
 
 // ========================================
 // Funções de Timing (NOVAS)
@@ -26,11 +30,85 @@ static uint64_t get_current_time_ms(void) {
 // Funções Auxiliares
 // ========================================
 
-static int find_node_index(connectivity_matrix_t *topo, node_id_t node) {
-    for (int i = 0; i < topo->num_nodes; i++) {
-        if (topo->node_ids[i] == node) return i;
+// Garante routing table / caches com espaço para num_nodes entradas
+static int ensure_table_capacity(routing_manager_t *rm, uint32_t num_nodes) {
+    if (num_nodes <= rm->table_capacity) return 0;
+    
+    routing_entry_t *table = realloc(rm->routing_table,
+                                     num_nodes * sizeof(routing_entry_t));
+    if (!table) return -1;
+    rm->routing_table = table;
+    
+    dijkstra_result_t *cache = realloc(rm->dijkstra_cache,
+                                       num_nodes * sizeof(dijkstra_result_t));
+    if (!cache) return -1;
+    rm->dijkstra_cache = cache;
+    
+    int32_t *parent = realloc(rm->mst_parent, num_nodes * sizeof(int32_t));
+    if (!parent) return -1;
+    rm->mst_parent = parent;
+    
+    memset(rm->routing_table + rm->table_capacity, 0,
+           (num_nodes - rm->table_capacity) * sizeof(routing_entry_t));
+    memset(rm->dijkstra_cache + rm->table_capacity, 0,
+           (num_nodes - rm->table_capacity) * sizeof(dijkstra_result_t));
+    
+    rm->table_capacity = num_nodes;
+    return 0;
+}
+
+// ========================================
+// Snapshots (RCU)
+// ========================================
+
+static void snapshot_free(routing_snapshot_t *snap) {
+    if (!snap) return;
+    free(snap->by_dest);
+    free(snap);
+}
+
+/**
+ * Espera que todos os leitores que possam ter o snapshot antigo saiam
+ *
+ * Duas viragens de época: após cada uma, o contador da época anterior
+ * só recebe leitores atrasados, por isso drena sem starvation.
+ */
+static void rcu_synchronize(routing_manager_t *rm) {
+    for (int phase = 0; phase < 2; phase++) {
+        unsigned old = atomic_fetch_add(&rm->rcu_epoch, 1);
+        while (atomic_load(&rm->rcu_readers[old & 1]) != 0) {
+            sched_yield();
+        }
+    }
+}
+
+// Publica a routing table atual (chamado com rm->lock)
+static void publish_snapshot(routing_manager_t *rm) {
+    topology_graph_t *topo = &rm->current_topology;
+    
+    routing_snapshot_t *snap = malloc(sizeof(routing_snapshot_t));
+    if (!snap) return;
+    
+    snap->version = rm->topology_version;
+    snap->size = topo->index_of_size;
+    snap->by_dest = calloc(snap->size ? snap->size : 1, sizeof(routing_entry_t));
+    if (!snap->by_dest) {
+        free(snap);
+        return;
+    }
+    
+    for (uint32_t i = 0; i < topo->num_nodes; i++) {
+        node_id_t dest = topo->node_ids[i];
+        if (dest == rm->my_node_id) continue;
+        snap->by_dest[dest] = rm->routing_table[i];
+    }
+    
+    routing_snapshot_t *old = atomic_exchange(&rm->snapshot, snap);
+    
+    if (old) {
+        rcu_synchronize(rm);
+        snapshot_free(old);
     }
-    return -1;
 }
 
 // ========================================
@@ -46,8 +124,8 @@ bool topology_has_changed(connectivity_matrix_t *old,
     for (int i = 0; i < old->num_nodes; i++) {
         for (int j = 0; j < old->num_nodes; j++) {
             if (old->matrix[i][j] != new->matrix[i][j]) {
-                printf("[ROUTING] Topology change detected: link %d-%d changed\n",
-                       old->node_ids[i], old->node_ids[j]);
+                LOG_DEBUG("[ROUTING] Topology change detected: link %d-%d changed\n",
+                          old->node_ids[i], old->node_ids[j]);
                 return true;
             }
         }
@@ -60,98 +138,210 @@ bool topology_has_changed(connectivity_matrix_t *old,
 // Recomputation Logic
 // ========================================
 
-void update_table_from_dijkstra(routing_manager_t *rm) {
-    // Roda Dijkstra para todos os destinos
-    dijkstra_compute(rm->my_node_id, &rm->current_topology, rm->dijkstra_cache);
+// Copia o cache do Dijkstra para a routing table
+static void apply_dijkstra_cache(routing_manager_t *rm) {
+    topology_graph_t *topo = &rm->current_topology;
     
-    // Atualiza routing table
-    for (int i = 0; i < rm->current_topology.num_nodes; i++) {
+    // Atualiza routing table (cache e tabela partilham a indexação do grafo)
+    for (uint32_t i = 0; i < topo->num_nodes; i++) {
         node_id_t dest = rm->dijkstra_cache[i].destination;
         
         if (dest == rm->my_node_id) continue;  // Skip self
         
-        int idx = find_node_index(&rm->current_topology, dest);
-        if (idx == -1) continue;
+        rm->routing_table[i].destination = dest;
+        rm->routing_table[i].next_hop = rm->dijkstra_cache[i].next_hop;
+        rm->routing_table[i].distance = rm->dijkstra_cache[i].distance;
+        rm->routing_table[i].cost = rm->dijkstra_cache[i].cost;
+        rm->routing_table[i].valid = rm->dijkstra_cache[i].reachable;
+        rm->routing_table[i].state = rm->dijkstra_cache[i].reachable ? 
+                                     PATH_STATE_OPTIMAL : PATH_STATE_UNREACHABLE;
+    }
+}
+
+void update_table_from_dijkstra(routing_manager_t *rm) {
+    topology_graph_t *topo = &rm->current_topology;
+    
+    // Modo incremental: a SPT completa fica guardada para as próximas mudanças
+    if (rm->incremental_spt) {
+        bool unit_weights = (rm->path_engine != PATH_ENGINE_WEIGHTED);
         
-        rm->routing_table[idx].destination = dest;
-        rm->routing_table[idx].next_hop = rm->dijkstra_cache[i].next_hop;
-        rm->routing_table[idx].distance = rm->dijkstra_cache[i].distance;
-        rm->routing_table[idx].valid = rm->dijkstra_cache[i].reachable;
-        rm->routing_table[idx].state = rm->dijkstra_cache[i].reachable ? 
-                                       PATH_STATE_OPTIMAL : PATH_STATE_UNREACHABLE;
+        if (spt_compute(&rm->spt, topo, rm->my_node_id, unit_weights) == 0) {
+            spt_export(&rm->spt, topo, rm->dijkstra_cache);
+            rm->last_nodes_relaxed = rm->spt.last_relaxed;
+            rm->total_nodes_relaxed += rm->spt.last_relaxed;
+            apply_dijkstra_cache(rm);
+            return;
+        }
     }
+    
+    // Roda Dijkstra (hop count, pesado ou BFS em bitset) para todos os destinos
+    switch (rm->path_engine) {
+        case PATH_ENGINE_BITSET_BFS:
+            adjacency_bitset_from_graph(&rm->adjacency, topo);
+            bfs_bitset_compute(rm->my_node_id, &rm->adjacency, rm->dijkstra_cache);
+            break;
+            
+        case PATH_ENGINE_WEIGHTED:
+            dijkstra_compute_weighted(rm->my_node_id, topo, rm->dijkstra_cache);
+            break;
+            
+        default:
+            dijkstra_compute_graph(rm->my_node_id, topo, rm->dijkstra_cache);
+            break;
+    }
+    
+    apply_dijkstra_cache(rm);
 }
 
 void update_table_from_mst(routing_manager_t *rm) {
-    // Computa MST
-    spanning_tree_compute(&rm->current_topology, &rm->mst);
+    topology_graph_t *topo = &rm->current_topology;
+    uint32_t n = topo->num_nodes;
     
-    // BFS na MST para encontrar next hops
-    int my_idx = find_node_index(&rm->current_topology, rm->my_node_id);
+    // Computa MST (raiz no índice 0, igual para todos os nós)
+    spanning_tree_compute_graph(topo, rm->mst_parent);
+    
+    int my_idx = topology_graph_index_of(topo, rm->my_node_id);
     if (my_idx == -1) return;
     
-    bool visited[MAX_NODES] = {false};
-    int parent[MAX_NODES];
-    int queue[MAX_NODES];
-    int front = 0, rear = 0;
+    int32_t *parent = rm->mst_parent;
     
-    for (int i = 0; i < MAX_NODES; i++) parent[i] = -1;
+    // Distância (em hops na árvore) de mim até cada ancestral, -1 se não for
+    int32_t *anc_dist = malloc(n * sizeof(int32_t));
+    if (!anc_dist) return;
     
-    visited[my_idx] = true;
-    queue[rear++] = my_idx;
+    for (uint32_t i = 0; i < n; i++) anc_dist[i] = -1;
     
-    while (front < rear) {
-        int u = queue[front++];
-        
-        for (int v = 0; v < rm->mst.num_nodes; v++) {
-            if (rm->mst.tree[u][v] && !visited[v]) {
-                visited[v] = true;
-                parent[v] = u;
-                queue[rear++] = v;
-            }
-        }
+    // Só os nós da componente da raiz estão na árvore
+    bool my_in_tree = (my_idx == 0 || parent[my_idx] != -1);
+    
+    int hops = 0;
+    for (int a = my_idx; my_in_tree && a != -1; a = parent[a]) {
+        anc_dist[a] = hops++;
     }
     
     // Atualiza routing table
-    for (int i = 0; i < rm->current_topology.num_nodes; i++) {
-        if (i == my_idx) continue;
+    for (uint32_t i = 0; i < n; i++) {
+        if ((int)i == my_idx) continue;
         
-        // Encontra next hop (primeiro passo no caminho)
-        int curr = i;
-        int prev = parent[i];
+        rm->routing_table[i].destination = topo->node_ids[i];
         
-        if (prev == -1) {
+        bool dst_in_tree = (i == 0 || parent[i] != -1);
+        
+        if (!my_in_tree || !dst_in_tree) {
             // Unreachable
             rm->routing_table[i].valid = false;
             rm->routing_table[i].state = PATH_STATE_UNREACHABLE;
             continue;
         }
         
-        while (parent[prev] != my_idx && prev != my_idx) {
-            curr = prev;
-            prev = parent[prev];
+        // Sobe a partir do destino até ao primeiro ancestral comum (LCA)
+        int curr = i;
+        int below = -1;   // Nó imediatamente abaixo do LCA no ramo do destino
+        int up_hops = 0;
+        
+        while (anc_dist[curr] == -1) {
+            below = curr;
+            curr = parent[curr];
+            up_hops++;
         }
         
-        rm->routing_table[i].destination = rm->current_topology.node_ids[i];
-        rm->routing_table[i].next_hop = rm->current_topology.node_ids[curr];
+        // Destino na minha sub-árvore → desço por 'below'; senão subo
+        node_id_t next_hop = (curr == my_idx) ?
+                             topo->node_ids[below] :
+                             topo->node_ids[parent[my_idx]];
+        
+        rm->routing_table[i].next_hop = next_hop;
         rm->routing_table[i].valid = true;
         rm->routing_table[i].state = PATH_STATE_FALLBACK;
         
-        // Calcula distância (número de hops)
-        int hops = 0;
-        int node = i;
-        while (parent[node] != -1) {
-            hops++;
-            node = parent[node];
+        // Distância (número de hops) = subida do destino + descida até mim
+        rm->routing_table[i].distance = up_hops + anc_dist[curr];
+        rm->routing_table[i].cost = rm->routing_table[i].distance;
+    }
+    
+    free(anc_dist);
+}
+
+// HYBRID: se alguma rota falhou, usa MST como fallback
+static void apply_mst_fallback(routing_manager_t *rm) {
+    for (uint32_t i = 0; i < rm->current_topology.num_nodes; i++) {
+        if (!rm->routing_table[i].valid) {
+            LOG_DEBUG("[ROUTING] Using MST fallback for unreachable nodes\n");
+            uint64_t start_algo = get_current_time_us();
+            update_table_from_mst(rm);
+            rm->mst_compute_time_us = get_current_time_us() - start_algo;
+            break;
+        }
+    }
+}
+
+/**
+ * Tenta aplicar a mudança de topologia de forma incremental
+ *
+ * Só quando a SPT é válida, o conjunto de nós não mudou e poucos links
+ * (simétricos) mudaram. Aplica cada link a current_topology e repara a
+ * SPT; em caso de falha o caller faz o recompute completo.
+ */
+static bool try_incremental_update(routing_manager_t *rm,
+                                   const topology_graph_t *new_topology) {
+    if (!rm->incremental_spt || !rm->spt.valid ||
+        rm->strategy == ROUTING_STRATEGY_MST) {
+        return false;
+    }
+    
+    graph_link_change_t changes[ROUTING_INCREMENTAL_MAX_CHANGES];
+    int count = topology_graph_diff(&rm->current_topology, new_topology,
+                                    changes, ROUTING_INCREMENTAL_MAX_CHANGES);
+    if (count <= 0) return false;
+    
+    uint64_t start = get_current_time_us();
+    topology_graph_t *topo = &rm->current_topology;
+    uint32_t relaxed = 0;
+    
+    for (int i = 0; i < count; i++) {
+        const graph_link_change_t *c = &changes[i];
+        
+        if (topology_graph_set_edge(topo, c->a, c->b, c->new_weight) < 0 ||
+            topology_graph_set_edge(topo, c->b, c->a, c->new_weight) < 0) {
+            rm->spt.valid = false;
+            return false;
         }
-        rm->routing_table[i].distance = hops;
+        
+        int ret = spt_update_link(&rm->spt, topo, c);
+        if (ret < 0) return false;
+        relaxed += ret;
+    }
+    
+    topo->timestamp = new_topology->timestamp;
+    
+    spt_export(&rm->spt, topo, rm->dijkstra_cache);
+    apply_dijkstra_cache(rm);
+    
+    if (rm->strategy == ROUTING_STRATEGY_HYBRID) {
+        apply_mst_fallback(rm);
     }
+    
+    publish_snapshot(rm);
+    
+    uint64_t elapsed = get_current_time_us() - start;
+    
+    rm->incremental_updates++;
+    rm->last_nodes_relaxed = relaxed;
+    rm->total_nodes_relaxed += relaxed;
+    rm->last_incremental_time_us = elapsed;
+    rm->total_incremental_time_us += elapsed;
+    rm->last_update_time_ms = get_current_time_ms();
+    rm->needs_recomputation = false;
+    
+    LOG_INFO("[ROUTING] Incremental update: %d link(s), %u nodes re-relaxed - %lu μs\n",
+             count, relaxed, elapsed);
+    return true;
 }
 
 void recompute_routes(routing_manager_t *rm) {
     uint64_t start_total = get_current_time_us();  // <--- TIMING COMEÇA
     
-    printf("[ROUTING] Recomputing routes (strategy: %d)...\n", rm->strategy);
+    LOG_DEBUG("[ROUTING] Recomputing routes (strategy: %d)...\n", rm->strategy);
     
     uint64_t start_algo = 0;
     
@@ -174,16 +364,7 @@ void recompute_routes(routing_manager_t *rm) {
             update_table_from_dijkstra(rm);
             rm->dijkstra_compute_time_us = get_current_time_us() - start_algo;
             
-            // Se alguma rota falhou, usa MST como fallback
-            for (int i = 0; i < rm->current_topology.num_nodes; i++) {
-                if (!rm->routing_table[i].valid) {
-                    printf("[ROUTING] Using MST fallback for unreachable nodes\n");
-                    start_algo = get_current_time_us();
-                    update_table_from_mst(rm);
-                    rm->mst_compute_time_us = get_current_time_us() - start_algo;
-                    break;
-                }
-            }
+            apply_mst_fallback(rm);
             break;
     }
     
@@ -205,8 +386,10 @@ void recompute_routes(routing_manager_t *rm) {
         rm->max_recompute_time_us = elapsed;
     }
     
-    printf("[ROUTING] Recomputation complete (version %lu) - %lu μs\n", 
-           rm->topology_version, elapsed);
+    publish_snapshot(rm);
+    
+    LOG_INFO("[ROUTING] Recomputation complete (version %lu) - %lu μs\n", 
+             rm->topology_version, elapsed);
 }
 
 // ========================================
@@ -220,34 +403,57 @@ void routing_manager_init(routing_manager_t *rm,
     
     rm->my_node_id = my_id;
     rm->strategy = strategy;
+    rm->path_engine = PATH_ENGINE_DIJKSTRA;
     rm->topology_version = 0;
     rm->needs_recomputation = false;
     
     // Inicializa métricas de performance
     rm->min_recompute_time_us = UINT64_MAX;
     
+    topology_graph_init(&rm->current_topology, 0);
+    adjacency_bitset_init(&rm->adjacency);
+    spt_init(&rm->spt);
+    
+    atomic_init(&rm->snapshot, NULL);
+    atomic_init(&rm->rcu_epoch, 0);
+    atomic_init(&rm->rcu_readers[0], 0);
+    atomic_init(&rm->rcu_readers[1], 0);
+    
     pthread_mutex_init(&rm->lock, NULL);
     
     printf("[ROUTING] Manager initialized for node %d (strategy: %d)\n", 
            my_id, strategy);
 }
 
-bool routing_manager_update_topology(routing_manager_t *rm,
-                                    connectivity_matrix_t *new_topology) {
+bool routing_manager_update_graph(routing_manager_t *rm,
+                                 const topology_graph_t *new_topology) {
     pthread_mutex_lock(&rm->lock);
     
-    bool changed = topology_has_changed(&rm->current_topology, new_topology);
+    bool changed = !topology_graph_equals(&rm->current_topology, new_topology);
     
     if (changed) {
-        printf("[ROUTING] Topology version %lu → %lu\n", 
-               rm->topology_version, rm->topology_version + 1);
+        LOG_DEBUG("[ROUTING] Topology version %lu → %lu\n", 
+                  rm->topology_version, rm->topology_version + 1);
         
-        // Copia nova topologia
-        memcpy(&rm->current_topology, new_topology, sizeof(connectivity_matrix_t));
         rm->topology_version++;
         rm->needs_recomputation = true;
         rm->link_failures_detected++;
         
+        // Poucos links mudaram: repara só a parte afetada da SPT
+        if (try_incremental_update(rm, new_topology)) {
+            pthread_mutex_unlock(&rm->lock);
+            return changed;
+        }
+        
+        // Copia nova topologia
+        if (topology_graph_copy(&rm->current_topology, new_topology) < 0 ||
+            ensure_table_capacity(rm, new_topology->num_nodes) < 0) {
+            fprintf(stderr, "[ROUTING] Out of memory copying topology\n");
+            rm->spt.valid = false;
+            pthread_mutex_unlock(&rm->lock);
+            return false;
+        }
+        
         // Recomputa rotas
         recompute_routes(rm);
     }
@@ -256,18 +462,102 @@ bool routing_manager_update_topology(routing_manager_t *rm,
     return changed;
 }
 
-node_id_t routing_manager_get_next_hop(routing_manager_t *rm, 
-                                       node_id_t destination) {
+bool routing_manager_update_topology(routing_manager_t *rm,
+                                    connectivity_matrix_t *new_topology) {
+    topology_graph_t graph;
+    topology_graph_init(&graph, new_topology->num_nodes);
+    
+    bool changed = false;
+    if (topology_graph_from_matrix(&graph, new_topology) == 0) {
+        changed = routing_manager_update_graph(rm, &graph);
+    }
+    
+    topology_graph_destroy(&graph);
+    return changed;
+}
+
+uint32_t routing_manager_num_nodes(routing_manager_t *rm) {
+    pthread_mutex_lock(&rm->lock);
+    uint32_t n = rm->current_topology.num_nodes;
+    pthread_mutex_unlock(&rm->lock);
+    return n;
+}
+
+int routing_manager_copy_table(routing_manager_t *rm,
+                               routing_entry_t **entries) {
     pthread_mutex_lock(&rm->lock);
     
-    int idx = find_node_index(&rm->current_topology, destination);
-    node_id_t next_hop = 255;  // Invalid
+    int n = rm->current_topology.num_nodes;
+    *entries = NULL;
     
-    if (idx != -1 && rm->routing_table[idx].valid) {
-        next_hop = rm->routing_table[idx].next_hop;
+    if (n > 0) {
+        *entries = malloc(n * sizeof(routing_entry_t));
+        if (!*entries) {
+            pthread_mutex_unlock(&rm->lock);
+            return -1;
+        }
+        memcpy(*entries, rm->routing_table, n * sizeof(routing_entry_t));
     }
     
     pthread_mutex_unlock(&rm->lock);
+    return n;
+}
+
+void routing_manager_set_path_engine(routing_manager_t *rm,
+                                    path_engine_t engine) {
+    pthread_mutex_lock(&rm->lock);
+    
+    if (rm->path_engine != engine) {
+        rm->path_engine = engine;
+        
+        // Só recomputa se já houver topologia carregada
+        if (rm->current_topology.num_nodes > 0) {
+            recompute_routes(rm);
+        }
+    }
+    
+    pthread_mutex_unlock(&rm->lock);
+}
+
+void routing_manager_set_incremental(routing_manager_t *rm, bool enabled) {
+    pthread_mutex_lock(&rm->lock);
+    
+    if (rm->incremental_spt != enabled) {
+        rm->incremental_spt = enabled;
+        rm->spt.valid = false;
+        
+        // Recalcula para (re)construir a SPT guardada
+        if (enabled && rm->current_topology.num_nodes > 0) {
+            recompute_routes(rm);
+        }
+    }
+    
+    pthread_mutex_unlock(&rm->lock);
+}
+
+const routing_snapshot_t *routing_manager_snapshot_acquire(routing_manager_t *rm,
+                                                           unsigned *epoch) {
+    *epoch = atomic_load(&rm->rcu_epoch);
+    atomic_fetch_add(&rm->rcu_readers[*epoch & 1], 1);
+    return atomic_load(&rm->snapshot);
+}
+
+void routing_manager_snapshot_release(routing_manager_t *rm, unsigned epoch) {
+    atomic_fetch_sub(&rm->rcu_readers[epoch & 1], 1);
+}
+
+node_id_t routing_manager_get_next_hop(routing_manager_t *rm, 
+                                       node_id_t destination) {
+    unsigned epoch;
+    const routing_snapshot_t *snap = routing_manager_snapshot_acquire(rm, &epoch);
+    node_id_t next_hop = NODE_ID_INVALID;
+    
+    // Lookup direto por node_id, sem lock
+    if (snap && destination < snap->size && snap->by_dest[destination].valid) {
+        next_hop = snap->by_dest[destination].next_hop;
+    }
+    
+    routing_manager_snapshot_release(rm, epoch);
     return next_hop;
 }
 
@@ -291,19 +581,20 @@ void routing_manager_print_table(routing_manager_t *rm) {
     
     printf("\n=== Routing Table (Node %d) ===\n", rm->my_node_id);
     printf("Version: %lu | Strategy: %d\n", rm->topology_version, rm->strategy);
-    printf("Destination | Next Hop | Distance | State\n");
-    printf("------------|----------|----------|----------\n");
+    printf("Destination | Next Hop | Distance |   Cost   | State\n");
+    printf("------------|----------|----------|----------|----------\n");
     
-    for (int i = 0; i < rm->current_topology.num_nodes; i++) {
+    for (uint32_t i = 0; i < rm->current_topology.num_nodes; i++) {
         if (rm->routing_table[i].destination == 0) continue;
         if (rm->routing_table[i].destination == rm->my_node_id) continue;
         
         const char *state_str[] = {"OPTIMAL", "FALLBACK", "RECOMPUTING", "UNREACHABLE"};
         
-        printf("    %3d     |    %3d   |    %3d   | %s\n",
+        printf("    %3d     |    %3d   |    %3d   | %8u | %s\n",
                rm->routing_table[i].destination,
                rm->routing_table[i].next_hop,
                rm->routing_table[i].distance,
+               rm->routing_table[i].cost,
                state_str[rm->routing_table[i].state]);
     }
     printf("\n");
@@ -342,6 +633,9 @@ void routing_manager_print_performance(routing_manager_t *rm) {
     printf("   Strategy:             %s\n", 
            rm->strategy == 0 ? "DIJKSTRA" : 
            rm->strategy == 1 ? "MST" : "HYBRID");
+    printf("   Path Engine:          %s\n",
+           rm->path_engine == PATH_ENGINE_BITSET_BFS ? "BITSET-BFS" :
+           rm->path_engine == PATH_ENGINE_WEIGHTED ? "WEIGHTED-DIJKSTRA" : "DIJKSTRA");
     printf("   Topology Version:     %lu\n", rm->topology_version);
     printf("   Total Recomputations: %u\n", rm->recomputations);
     printf("   Link Failures:        %u\n\n", rm->link_failures_detected);
@@ -373,6 +667,17 @@ void routing_manager_print_performance(routing_manager_t *rm) {
                    rm->mst_compute_time_us / 1000.0);
         }
         
+        if (rm->incremental_spt) {
+            printf("\n🔁 Incremental SPT:\n");
+            printf("   Updates:        %u\n", rm->incremental_updates);
+            printf("   Last relaxed:   %u nodes\n", rm->last_nodes_relaxed);
+            printf("   Total relaxed:  %lu nodes\n", rm->total_nodes_relaxed);
+            if (rm->incremental_updates > 0) {
+                printf("   Avg update:     %6lu μs\n",
+                       rm->total_incremental_time_us / rm->incremental_updates);
+            }
+        }
+        
         printf("\n✅ Timing Analysis:\n");
         double avg_ms = (rm->total_recompute_time_us / rm->recomputations) / 1000.0;
         if (avg_ms < 1.0) {
@@ -436,6 +741,18 @@ void routing_manager_export_metrics_csv(routing_manager_t *rm, const char *filen
 }
 
 void routing_manager_destroy(routing_manager_t *rm) {
+    topology_graph_destroy(&rm->current_topology);
+    adjacency_bitset_destroy(&rm->adjacency);
+    spt_destroy(&rm->spt);
+    snapshot_free(atomic_exchange(&rm->snapshot, NULL));
+    free(rm->routing_table);
+    free(rm->dijkstra_cache);
+    free(rm->mst_parent);
+    rm->routing_table = NULL;
+    rm->dijkstra_cache = NULL;
+    rm->mst_parent = NULL;
+    rm->table_capacity = 0;
+    
     pthread_mutex_destroy(&rm->lock);
     printf("[ROUTING] Manager destroyed for node %d\n", rm->my_node_id);
 }
\ No newline at end of file
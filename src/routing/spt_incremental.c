@@ -0,0 +1,324 @@
+// src/routing/spt_incremental.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "spt_incremental.h"
+#include "cost_heap.h"
+
+// Estados de mark[] durante a marcação da sub-árvore
+#define MARK_UNKNOWN  0
+#define MARK_INSIDE   1
+#define MARK_OUTSIDE  2
+
+// ========================================
+// Funções Auxiliares
+// ========================================
+
+static inline uint32_t link_cost(const spt_state_t *spt, uint16_t weight) {
+    return spt->unit_weights ? 1 : weight;
+}
+
+static int ensure_capacity(spt_state_t *spt, uint32_t n) {
+    if (n <= spt->capacity) return 0;
+    
+    uint32_t *cost = realloc(spt->cost, n * sizeof(uint32_t));
+    if (!cost) return -1;
+    spt->cost = cost;
+    
+    int32_t *parent = realloc(spt->parent, n * sizeof(int32_t));
+    if (!parent) return -1;
+    spt->parent = parent;
+    
+    uint32_t *first_hop = realloc(spt->first_hop, n * sizeof(uint32_t));
+    if (!first_hop) return -1;
+    spt->first_hop = first_hop;
+    
+    uint16_t *hops = realloc(spt->hops, n * sizeof(uint16_t));
+    if (!hops) return -1;
+    spt->hops = hops;
+    
+    uint32_t *items = realloc(spt->heap_items, n * sizeof(uint32_t));
+    if (!items) return -1;
+    spt->heap_items = items;
+    
+    int32_t *pos = realloc(spt->heap_pos, n * sizeof(int32_t));
+    if (!pos) return -1;
+    spt->heap_pos = pos;
+    
+    uint8_t *mark = realloc(spt->mark, n * sizeof(uint8_t));
+    if (!mark) return -1;
+    spt->mark = mark;
+    
+    uint32_t *stack = realloc(spt->stack, n * sizeof(uint32_t));
+    if (!stack) return -1;
+    spt->stack = stack;
+    
+    spt->capacity = n;
+    return 0;
+}
+
+/**
+ * u é melhor pai para v do que o atual?
+ *
+ * Mesma regra do Dijkstra completo: menor custo; em empate, o vizinho
+ * que sairia primeiro do heap (menor (custo, índice)).
+ */
+static bool better_parent(const spt_state_t *spt, uint32_t alt,
+                          uint32_t u, uint32_t v) {
+    if (alt != spt->cost[v]) return alt < spt->cost[v];
+    
+    int32_t p = spt->parent[v];
+    if (p == -1 || p == (int32_t)u) return false;
+    
+    return spt->cost[u] < spt->cost[p] ||
+           (spt->cost[u] == spt->cost[p] && u < (uint32_t)p);
+}
+
+// Relaxa a aresta u → v; devolve true se o custo de v desceu
+static bool relax(spt_state_t *spt, uint32_t u, uint32_t v, uint16_t weight) {
+    if (spt->cost[u] == INFINITY_PATH_COST) return false;
+    
+    uint32_t alt = spt->cost[u] + link_cost(spt, weight);
+    if (!better_parent(spt, alt, u, v)) return false;
+    
+    bool decreased = alt < spt->cost[v];
+    spt->cost[v] = alt;
+    spt->parent[v] = u;
+    return decreased;
+}
+
+// Dijkstra a partir do que já está no heap; only_marked limita à sub-árvore
+static void run_heap(spt_state_t *spt, cost_heap_t *heap,
+                     const topology_graph_t *graph, bool only_marked) {
+    while (heap->size > 0) {
+        uint32_t x = cost_heap_pop(heap);
+        spt->last_relaxed++;
+        
+        const graph_adj_list_t *list = &graph->adj[x];
+        
+        for (uint32_t e = 0; e < list->degree; e++) {
+            uint32_t y = list->edges[e].to;
+            
+            if (only_marked && spt->mark[y] != MARK_INSIDE) continue;
+            
+            if (relax(spt, x, y, list->edges[e].weight)) {
+                cost_heap_push_or_decrease(heap, y);
+            }
+        }
+    }
+}
+
+// Recalcula first_hop / hops a partir dos pais (O(V), sem heap)
+static void rebuild_paths(spt_state_t *spt) {
+    uint32_t n = spt->num_nodes;
+    
+    memset(spt->mark, 0, n);
+    spt->first_hop[spt->src] = spt->src;
+    spt->hops[spt->src] = 0;
+    spt->mark[spt->src] = 1;
+    
+    for (uint32_t v = 0; v < n; v++) {
+        if (spt->mark[v]) continue;
+        
+        if (spt->cost[v] == INFINITY_PATH_COST) {
+            spt->mark[v] = 1;
+            continue;
+        }
+        
+        // Sobe até um nó já resolvido e desce a atribuir
+        uint32_t depth = 0;
+        uint32_t x = v;
+        while (!spt->mark[x]) {
+            spt->stack[depth++] = x;
+            x = spt->parent[x];
+        }
+        
+        while (depth > 0) {
+            uint32_t y = spt->stack[--depth];
+            uint32_t p = spt->parent[y];
+            
+            spt->first_hop[y] = (p == spt->src) ? y : spt->first_hop[p];
+            spt->hops[y] = spt->hops[p] + 1;
+            spt->mark[y] = 1;
+        }
+    }
+}
+
+// Marca a sub-árvore com raiz em 'root'; devolve o número de nós (em stack)
+static uint32_t mark_subtree(spt_state_t *spt, uint32_t root) {
+    uint32_t n = spt->num_nodes;
+    
+    memset(spt->mark, MARK_UNKNOWN, n);
+    spt->mark[root] = MARK_INSIDE;
+    
+    for (uint32_t v = 0; v < n; v++) {
+        if (spt->mark[v] != MARK_UNKNOWN) continue;
+        
+        // Sobe até um nó marcado ou até à raiz/nó inalcançável
+        uint32_t depth = 0;
+        int32_t x = v;
+        while (x != -1 && spt->mark[x] == MARK_UNKNOWN) {
+            spt->stack[depth++] = x;
+            x = spt->parent[x];
+        }
+        
+        uint8_t state = (x == -1) ? MARK_OUTSIDE : spt->mark[x];
+        while (depth > 0) {
+            spt->mark[spt->stack[--depth]] = state;
+        }
+    }
+    
+    uint32_t count = 0;
+    for (uint32_t v = 0; v < n; v++) {
+        if (spt->mark[v] == MARK_INSIDE) spt->stack[count++] = v;
+    }
+    
+    return count;
+}
+
+// ========================================
+// API Pública
+// ========================================
+
+void spt_init(spt_state_t *spt) {
+    memset(spt, 0, sizeof(spt_state_t));
+}
+
+void spt_destroy(spt_state_t *spt) {
+    free(spt->cost);
+    free(spt->parent);
+    free(spt->first_hop);
+    free(spt->hops);
+    free(spt->heap_items);
+    free(spt->heap_pos);
+    free(spt->mark);
+    free(spt->stack);
+    memset(spt, 0, sizeof(spt_state_t));
+}
+
+int spt_compute(spt_state_t *spt, const topology_graph_t *graph,
+                node_id_t src, bool unit_weights) {
+    spt->valid = false;
+    
+    int src_idx = topology_graph_index_of(graph, src);
+    if (src_idx == -1) {
+        printf("[SPT] Source node %d not found in topology\n", src);
+        return -1;
+    }
+    
+    uint32_t n = graph->num_nodes;
+    if (ensure_capacity(spt, n) < 0) return -1;
+    
+    spt->num_nodes = n;
+    spt->src = src_idx;
+    spt->unit_weights = unit_weights;
+    spt->last_relaxed = 0;
+    
+    for (uint32_t i = 0; i < n; i++) {
+        spt->cost[i] = INFINITY_PATH_COST;
+        spt->parent[i] = -1;
+        spt->heap_pos[i] = -1;
+    }
+    
+    cost_heap_t heap = { spt->heap_items, spt->heap_pos, spt->cost, 0 };
+    
+    spt->cost[src_idx] = 0;
+    cost_heap_push_or_decrease(&heap, src_idx);
+    run_heap(spt, &heap, graph, false);
+    
+    rebuild_paths(spt);
+    
+    spt->total_relaxed += spt->last_relaxed;
+    spt->valid = true;
+    return 0;
+}
+
+int spt_update_link(spt_state_t *spt, const topology_graph_t *graph,
+                    const graph_link_change_t *change) {
+    if (!spt->valid || graph->num_nodes != spt->num_nodes) return -1;
+    
+    uint32_t a = change->a, b = change->b;
+    uint32_t old_cost = change->old_weight ? link_cost(spt, change->old_weight) : 0;
+    uint32_t new_cost = change->new_weight ? link_cost(spt, change->new_weight) : 0;
+    
+    spt->last_relaxed = 0;
+    
+    if (old_cost == new_cost) return 0;  // Ex.: peso mudou em modo hop count
+    
+    // heap_pos fica todo a -1 sempre que o heap esvazia
+    cost_heap_t heap = { spt->heap_items, spt->heap_pos, spt->cost, 0 };
+    
+    if (new_cost == 0 || (old_cost != 0 && new_cost > old_cost)) {
+        // ---------- Link piorou ou caiu ----------
+        uint32_t child;
+        if (spt->parent[b] == (int32_t)a) {
+            child = b;
+        } else if (spt->parent[a] == (int32_t)b) {
+            child = a;
+        } else {
+            return 0;  // Fora da árvore: nenhum caminho ótimo o usa
+        }
+        
+        uint32_t count = mark_subtree(spt, child);
+        
+        for (uint32_t k = 0; k < count; k++) {
+            uint32_t y = spt->stack[k];
+            spt->cost[y] = INFINITY_PATH_COST;
+            spt->parent[y] = -1;
+        }
+        
+        // Semeia cada nó da sub-árvore com o melhor vizinho de fora
+        for (uint32_t k = 0; k < count; k++) {
+            uint32_t y = spt->stack[k];
+            const graph_adj_list_t *list = &graph->adj[y];
+            
+            for (uint32_t e = 0; e < list->degree; e++) {
+                uint32_t u = list->edges[e].to;
+                if (spt->mark[u] != MARK_OUTSIDE) continue;
+                relax(spt, u, y, list->edges[e].weight);
+            }
+            
+            if (spt->cost[y] != INFINITY_PATH_COST) {
+                cost_heap_push_or_decrease(&heap, y);
+            }
+        }
+        
+        run_heap(spt, &heap, graph, true);
+    } else {
+        // ---------- Link melhorou ou apareceu ----------
+        if (relax(spt, a, b, change->new_weight)) {
+            cost_heap_push_or_decrease(&heap, b);
+        }
+        if (relax(spt, b, a, change->new_weight)) {
+            cost_heap_push_or_decrease(&heap, a);
+        }
+        
+        run_heap(spt, &heap, graph, false);
+    }
+    
+    rebuild_paths(spt);
+    
+    spt->total_relaxed += spt->last_relaxed;
+    return spt->last_relaxed;
+}
+
+void spt_export(const spt_state_t *spt, const topology_graph_t *graph,
+                dijkstra_result_t *results) {
+    for (uint32_t i = 0; i < spt->num_nodes; i++) {
+        node_id_t dst = graph->node_ids[i];
+        bool reachable = (spt->cost[i] != INFINITY_PATH_COST);
+        
+        results[i].destination = dst;
+        results[i].cost = spt->cost[i];
+        results[i].reachable = reachable;
+        results[i].distance = reachable ? spt->hops[i] : INFINITY_COST;
+        
+        if (i == spt->src) {
+            results[i].next_hop = dst;  // Self
+        } else if (reachable) {
+            results[i].next_hop = graph->node_ids[spt->first_hop[i]];
+        } else {
+            results[i].next_hop = NODE_ID_INVALID;  // Unreachable
+        }
+    }
+}
@@ -0,0 +1,79 @@
+// src/sim/sim_event_queue.c
+#include "sim_event_queue.h"
+#include <stdlib.h>
+#include <string.h>
+
+static inline bool event_before(const sim_event_t *a, const sim_event_t *b) {
+    return a->time_us < b->time_us || (a->time_us == b->time_us && a->seq < b->seq);
+}
+
+int sim_queue_init(sim_event_queue_t *queue, uint32_t capacity) {
+    memset(queue, 0, sizeof(sim_event_queue_t));
+    
+    if (capacity == 0) capacity = SIM_QUEUE_INITIAL_CAPACITY;
+    queue->heap = malloc(capacity * sizeof(sim_event_t));
+    if (!queue->heap) return -1;
+    
+    queue->capacity = capacity;
+    return 0;
+}
+
+void sim_queue_destroy(sim_event_queue_t *queue) {
+    free(queue->heap);
+    queue->heap = NULL;
+    queue->count = 0;
+    queue->capacity = 0;
+}
+
+int sim_queue_push(sim_event_queue_t *queue, uint64_t time_us,
+                   sim_event_type_t type, node_id_t node, uint32_t arg) {
+    if (queue->count == queue->capacity) {
+        sim_event_t *heap = realloc(queue->heap, 2 * queue->capacity * sizeof(sim_event_t));
+        if (!heap) return -1;
+        queue->heap = heap;
+        queue->capacity *= 2;
+    }
+    
+    sim_event_t event = {
+        .time_us = time_us,
+        .seq = queue->next_seq++,
+        .arg = arg,
+        .node = node,
+        .type = (uint8_t)type
+    };
+    
+    // Sift-up com "buraco": uma só escrita por nível
+    uint32_t i = queue->count++;
+    while (i > 0) {
+        uint32_t parent = (i - 1) / 2;
+        if (!event_before(&event, &queue->heap[parent])) break;
+        queue->heap[i] = queue->heap[parent];
+        i = parent;
+    }
+    queue->heap[i] = event;
+    
+    return 0;
+}
+
+bool sim_queue_pop(sim_event_queue_t *queue, sim_event_t *event) {
+    if (queue->count == 0) return false;
+    
+    *event = queue->heap[0];
+    sim_event_t last = queue->heap[--queue->count];
+    
+    uint32_t i = 0;
+    uint32_t n = queue->count;
+    while (true) {
+        uint32_t child = 2 * i + 1;
+        if (child >= n) break;
+        if (child + 1 < n && event_before(&queue->heap[child + 1], &queue->heap[child])) {
+            child++;
+        }
+        if (!event_before(&queue->heap[child], &last)) break;
+        queue->heap[i] = queue->heap[child];
+        i = child;
+    }
+    if (n > 0) queue->heap[i] = last;
+    
+    return true;
+}
@@ -0,0 +1,254 @@
+// src/sim/sim_main.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include "tdma_sim.h"
+#include "async_log.h"
+
+static tdma_sim_t sim;
+static sim_config_t config;
+static double run_seconds = 60.0;
+static const char *csv_file = NULL;
+static bool verbose = false;
+
+// ========================================
+// Options
+// ========================================
+
+static void print_usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [options]\n", prog);
+    fprintf(stderr, "Discrete-event simulation of the TDMA network in virtual time\n");
+    fprintf(stderr, "Network:\n");
+    fprintf(stderr, "  --nodes N        Node count, 2-%d (default %u)\n",
+            MAX_NETWORK_NODES, config.num_nodes);
+    fprintf(stderr, "  --topology T     grid, ring, line, random or mesh (default grid)\n");
+    fprintf(stderr, "  --degree D       Average degree of the random topology (default %u)\n",
+            config.degree);
+    fprintf(stderr, "  --round-us US    TDMA round (default %u)\n", config.round_period_us);
+    fprintf(stderr, "  --drift PPM      Clock drift of each node, U[-PPM, PPM] (default %.0f)\n",
+            config.drift_ppm);
+    fprintf(stderr, "  --offset US      Initial clock offset of each node, U[0, US]\n");
+    fprintf(stderr, "Links:\n");
+    fprintf(stderr, "  --loss P         Loss probability on every link (0-1)\n");
+    fprintf(stderr, "  --delay US       One-way delay on every link\n");
+    fprintf(stderr, "  --jitter US      Extra uniform delay 0-US (delivery stays in order)\n");
+    fprintf(stderr, "  --cut A-B@T[+D]  Take link A<->B down at T s, for D s (repeatable)\n");
+    fprintf(stderr, "  --detect MS      Delay before routing sees a failed link (default %u)\n",
+            config.detect_ms);
+    fprintf(stderr, "Run:\n");
+    fprintf(stderr, "  --duration SEC   Simulated seconds (default %.0f)\n", run_seconds);
+    fprintf(stderr, "  --strategy S     0=Dijkstra, 1=MST, 2=Hybrid\n");
+    fprintf(stderr, "  --seed N         Topology, clocks and link RNG seed\n");
+    fprintf(stderr, "  --flow SPEC      Add a flow (repeatable), e.g.\n");
+    fprintf(stderr, "                   src=1,dst=16,rate=30,size=1000-8000,duration=10\n");
+    fprintf(stderr, "  --traffic FILE   Read flows from FILE (one SPEC per line)\n");
+    fprintf(stderr, "  --warmup SEC     Wait before the flows start (default %u)\n",
+            config.warmup_sec);
+    fprintf(stderr, "  --csv FILE       Append a summary row to FILE\n");
+    fprintf(stderr, "  -v, --verbose    Keep the per-node log output\n");
+}
+
+static int parse_topology(const char *name) {
+    static const char *names[] = { "grid", "ring", "line", "random", "mesh" };
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (strcmp(name, names[i]) == 0) return (int)i;
+    }
+    return -1;
+}
+
+static int parse_cut(const char *spec) {
+    int a, b;
+    double down_sec, duration = 0;
+    
+    if (config.num_link_events >= SIM_MAX_LINK_EVENTS ||
+        sscanf(spec, "%d-%d@%lf+%lf", &a, &b, &down_sec, &duration) < 3 ||
+        a < 1 || b < 1 || a == b || down_sec < 0 || duration < 0) {
+        fprintf(stderr, "Error: bad --cut %s (expected A-B@T[+D])\n", spec);
+        return -1;
+    }
+    
+    sim_link_event_t *ev = &config.link_events[config.num_link_events++];
+    ev->a = a;
+    ev->b = b;
+    ev->down_sec = down_sec;
+    ev->up_sec = duration > 0 ? down_sec + duration : 0;
+    return 0;
+}
+
+static int load_flows(const char *path) {
+    traffic_engine_t *scratch = malloc(sizeof(traffic_engine_t));
+    if (!scratch) return -1;
+    
+    traffic_engine_init(scratch, NULL, 0);
+    int ret = traffic_engine_load_file(scratch, path);
+    
+    for (int i = 0; ret >= 0 && i < scratch->num_flows; i++) {
+        if (config.num_flows >= TRAFFIC_MAX_FLOWS) {
+            fprintf(stderr, "Error: more than %d flows\n", TRAFFIC_MAX_FLOWS);
+            ret = -1;
+            break;
+        }
+        config.flows[config.num_flows++] = scratch->flows[i];
+    }
+    
+    traffic_engine_destroy(scratch);
+    free(scratch);
+    return ret < 0 ? -1 : 0;
+}
+
+static int parse_options(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+            continue;
+        }
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            return -1;
+        }
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Error: unknown option %s\n", argv[i]);
+            return -1;
+        }
+        
+        const char *opt = argv[i];
+        const char *value = argv[++i];
+        
+        if (strcmp(opt, "--nodes") == 0) {
+            config.num_nodes = (uint32_t)atoi(value);
+        } else if (strcmp(opt, "--topology") == 0) {
+            int kind = parse_topology(value);
+            if (kind < 0) {
+                fprintf(stderr, "Error: unknown topology %s\n", value);
+                return -1;
+            }
+            config.topology = (sim_topology_kind_t)kind;
+        } else if (strcmp(opt, "--degree") == 0) {
+            config.degree = (uint32_t)atoi(value);
+        } else if (strcmp(opt, "--round-us") == 0) {
+            config.round_period_us = (uint32_t)atoi(value);
+        } else if (strcmp(opt, "--drift") == 0) {
+            config.drift_ppm = atof(value);
+        } else if (strcmp(opt, "--offset") == 0) {
+            config.max_offset_us = (uint32_t)atoi(value);
+        } else if (strcmp(opt, "--loss") == 0) {
+            config.link.loss = atof(value);
+        } else if (strcmp(opt, "--delay") == 0) {
+            config.link.delay_us = (uint32_t)atoi(value);
+        } else if (strcmp(opt, "--jitter") == 0) {
+            config.link.jitter_us = (uint32_t)atoi(value);
+        } else if (strcmp(opt, "--cut") == 0) {
+            if (parse_cut(value) < 0) return -1;
+        } else if (strcmp(opt, "--detect") == 0) {
+            config.detect_ms = (uint32_t)atoi(value);
+        } else if (strcmp(opt, "--duration") == 0) {
+            run_seconds = atof(value);
+        } else if (strcmp(opt, "--strategy") == 0) {
+            config.strategy = (routing_strategy_t)atoi(value);
+        } else if (strcmp(opt, "--seed") == 0) {
+            config.seed = strtoull(value, NULL, 10);
+        } else if (strcmp(opt, "--flow") == 0) {
+            if (config.num_flows >= TRAFFIC_MAX_FLOWS ||
+                traffic_flow_parse(&config.flows[config.num_flows], value) < 0) {
+                return -1;
+            }
+            config.num_flows++;
+        } else if (strcmp(opt, "--traffic") == 0) {
+            if (load_flows(value) < 0) return -1;
+        } else if (strcmp(opt, "--warmup") == 0) {
+            config.warmup_sec = (uint32_t)atoi(value);
+        } else if (strcmp(opt, "--csv") == 0) {
+            csv_file = value;
+        } else {
+            fprintf(stderr, "Error: unknown option %s\n", opt);
+            return -1;
+        }
+    }
+    
+    if (run_seconds <= 0) {
+        fprintf(stderr, "Error: --duration must be positive\n");
+        return -1;
+    }
+    return 0;
+}
+
+// Um eventfd por nó
+static void raise_fd_limit(void) {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+// Milhares de nós: o printf de cada nó vai para /dev/null (devolve o stdout original)
+static int silence_stdout(void) {
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    
+    if (saved >= 0 && null_fd >= 0) dup2(null_fd, STDOUT_FILENO);
+    if (null_fd >= 0) close(null_fd);
+    return saved;
+}
+
+static void restore_stdout(int saved) {
+    if (saved < 0) return;
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+}
+
+// ========================================
+// Main
+// ========================================
+
+int main(int argc, char *argv[]) {
+    sim_config_default(&config);
+    
+    if (parse_options(argc, argv) < 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    raise_fd_limit();
+    
+    printf("╔════════════════════════════════════════════════╗\n");
+    printf("║  TDMA Network Simulator (virtual time)         ║\n");
+    printf("╚════════════════════════════════════════════════╝\n\n");
+    
+    int saved_stdout = -1;
+    FILE *null_log = NULL;
+    if (!verbose) {
+        saved_stdout = silence_stdout();
+        null_log = fopen("/dev/null", "w");
+        if (null_log) async_log_start(null_log);       // LOG_* também
+    }
+    
+    int ret = tdma_sim_init(&sim, &config);
+    if (ret == 0) {
+        tdma_sim_run(&sim, run_seconds);
+    }
+    
+    if (null_log) {
+        async_log_stop();
+        fclose(null_log);
+    }
+    restore_stdout(saved_stdout);
+    
+    if (ret < 0) {
+        fprintf(stderr, "[SIM] Initialization failed\n");
+        return 1;
+    }
+    
+    tdma_sim_print_summary(&sim);
+    if (csv_file && tdma_sim_append_csv(&sim, csv_file) == 0) {
+        printf("[SIM] Summary appended to %s\n", csv_file);
+    }
+    
+    saved_stdout = verbose ? -1 : silence_stdout();
+    tdma_sim_destroy(&sim);
+    restore_stdout(saved_stdout);
+    return 0;
+}
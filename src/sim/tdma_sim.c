@@ -0,0 +1,911 @@
+// src/sim/tdma_sim.c
+#include "tdma_sim.h"
+#include "spanning_tree.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+// ========================================
+// Helper Functions
+// ========================================
+
+static uint64_t wall_time_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint64_t rng_next(uint64_t *s) {
+    uint64_t x = *s;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *s = x;
+}
+
+// Uniforme em [0, 1)
+static double rng_unit(uint64_t *s) {
+    return (rng_next(s) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static const char *topology_name(sim_topology_kind_t kind) {
+    switch (kind) {
+        case SIM_TOPO_RING:   return "ring";
+        case SIM_TOPO_LINE:   return "line";
+        case SIM_TOPO_RANDOM: return "random";
+        case SIM_TOPO_MESH:   return "mesh";
+        default:              return "grid";
+    }
+}
+
+static void schedule(tdma_sim_t *sim, uint64_t time_us, sim_event_type_t type,
+                     node_id_t node, uint32_t arg) {
+    if (sim_queue_push(&sim->queue, time_us, type, node, arg) < 0) {
+        fprintf(stderr, "[SIM] Out of memory for events\n");
+    }
+}
+
+// ========================================
+// Clocks
+// ========================================
+
+uint64_t tdma_sim_local_time(const sim_node_t *node, uint64_t global_us) {
+    return (uint64_t)((double)global_us * node->clock_rate) + node->clock_offset_us;
+}
+
+uint64_t tdma_sim_global_time(const sim_node_t *node, uint64_t local_us) {
+    if (local_us <= node->clock_offset_us) return 0;
+    
+    uint64_t global_us = (uint64_t)ceil((double)(local_us - node->clock_offset_us) /
+                                        node->clock_rate);
+    
+    // Arredondamento do double: o primeiro instante global em que o relógio local chega lá
+    while (global_us > 0 && tdma_sim_local_time(node, global_us - 1) >= local_us) global_us--;
+    while (tdma_sim_local_time(node, global_us) < local_us) global_us++;
+    return global_us;
+}
+
+// ra_tdmas_get_current_time_us(): relógio local do nó em execução
+static uint64_t sim_clock(void *ctx) {
+    tdma_sim_t *sim = ctx;
+    return sim->current ? tdma_sim_local_time(sim->current, sim->now_us) : sim->now_us;
+}
+
+// Fabric: entregas em tempo global
+static uint64_t sim_fabric_clock(void *ctx) {
+    return ((tdma_sim_t *)ctx)->now_us;
+}
+
+static void sim_on_enqueue(void *ctx, node_id_t dst, uint64_t deliver_at_us) {
+    schedule(ctx, deliver_at_us, SIM_EVENT_RX, dst, 0);
+}
+
+// ========================================
+// Topology
+// ========================================
+
+static int add_link(tdma_sim_t *sim, node_id_t a, node_id_t b) {
+    if (a == b || topology_graph_link_weight(&sim->topology, a, b) != 0) return 0;
+    return topology_graph_set_link(&sim->topology, a, b, 1);
+}
+
+static int build_topology(tdma_sim_t *sim, uint64_t *rng) {
+    const sim_config_t *config = &sim->config;
+    uint32_t n = config->num_nodes;
+    int ret = 0;
+    
+    if (topology_graph_init(&sim->topology, n) < 0) return -1;
+    for (uint32_t i = 1; i <= n; i++) {
+        if (topology_graph_add_node(&sim->topology, i) < 0) return -1;
+    }
+    
+    switch (config->topology) {
+        case SIM_TOPO_GRID: {
+            uint32_t cols = (uint32_t)ceil(sqrt(n));
+            for (uint32_t i = 0; i < n && ret == 0; i++) {
+                if ((i + 1) % cols != 0 && i + 1 < n) ret = add_link(sim, i + 1, i + 2);
+                if (ret == 0 && i + cols < n) ret = add_link(sim, i + 1, i + cols + 1);
+            }
+            break;
+        }
+        
+        case SIM_TOPO_RING:
+        case SIM_TOPO_LINE:
+            for (uint32_t i = 0; i + 1 < n && ret == 0; i++) {
+                ret = add_link(sim, i + 1, i + 2);
+            }
+            if (ret == 0 && config->topology == SIM_TOPO_RING && n > 2) {
+                ret = add_link(sim, n, 1);
+            }
+            break;
+        
+        case SIM_TOPO_RANDOM: {
+            // Anel (conectividade) + cordas aleatórias até ao grau médio
+            for (uint32_t i = 0; i < n && ret == 0; i++) {
+                ret = add_link(sim, i + 1, (i + 1) % n + 1);
+            }
+            uint64_t target = (uint64_t)n * config->degree / 2;
+            for (uint64_t tries = 0; ret == 0 && tries < 8 * target &&
+                 sim->topology.num_edges / 2 < target; tries++) {
+                ret = add_link(sim, rng_next(rng) % n + 1, rng_next(rng) % n + 1);
+            }
+            break;
+        }
+        
+        case SIM_TOPO_MESH:
+            for (uint32_t a = 1; a <= n && ret == 0; a++) {
+                for (uint32_t b = a + 1; b <= n && ret == 0; b++) {
+                    ret = add_link(sim, a, b);
+                }
+            }
+            break;
+    }
+    if (ret < 0) return -1;
+    
+    // Vizinhos físicos (não mudam quando um link cai: a fabric é que descarta)
+    sim->adj_offset = calloc(n + 1, sizeof(uint32_t));
+    sim->adj = malloc((sim->topology.num_edges + 1) * sizeof(node_id_t));
+    if (!sim->adj_offset || !sim->adj) return -1;
+    
+    for (uint32_t i = 0; i < n; i++) {
+        const graph_adj_list_t *list = &sim->topology.adj[i];
+        uint32_t base = sim->adj_offset[i];
+        
+        for (uint32_t k = 0; k < list->degree; k++) {
+            sim->adj[base + k] = sim->topology.node_ids[list->edges[k].to];
+        }
+        sim->adj_offset[i + 1] = base + list->degree;
+        if (list->degree > sim->max_degree) sim->max_degree = list->degree;
+    }
+    
+    sim->hb_batch = calloc(sim->max_degree + 1, sizeof(udp_tx_packet_t));
+    return sim->hb_batch ? 0 : -1;
+}
+
+// Vizinhos de sincronização = pai e filhos na MST da topologia ativa
+static int update_sync_trees(tdma_sim_t *sim) {
+    topology_graph_t *topo = &sim->topology;
+    uint32_t n = topo->num_nodes;
+    
+    int32_t *parent = malloc(n * sizeof(int32_t));
+    uint32_t *offset = calloc(n + 1, sizeof(uint32_t));
+    uint32_t *fill = malloc(n * sizeof(uint32_t));
+    node_id_t *neighbors = malloc(2 * n * sizeof(node_id_t));
+    int ret = -1;
+    
+    if (!parent || !offset || !fill || !neighbors ||
+        spanning_tree_compute_graph(topo, parent) < 0) {
+        goto out;
+    }
+    
+    for (uint32_t i = 0; i < n; i++) {
+        if (parent[i] < 0) continue;
+        offset[i + 1]++;
+        offset[parent[i] + 1]++;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        offset[i + 1] += offset[i];
+        fill[i] = offset[i];
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        if (parent[i] < 0) continue;
+        neighbors[fill[i]++] = topo->node_ids[parent[i]];
+        neighbors[fill[parent[i]]++] = topo->node_ids[i];
+    }
+    
+    for (uint32_t i = 0; i < n; i++) {
+        sim_node_t *node = tdma_sim_node(sim, topo->node_ids[i]);
+        if (!node) continue;
+        ra_tdmas_set_sync_neighbors(&node->sync, neighbors + offset[i],
+                                    offset[i + 1] - offset[i]);
+    }
+    ret = 0;
+
+out:
+    free(parent);
+    free(offset);
+    free(fill);
+    free(neighbors);
+    return ret;
+}
+
+static void update_routing(tdma_sim_t *sim) {
+    for (uint32_t i = 0; i < sim->num_nodes; i++) {
+        sim->current = &sim->nodes[i];
+        routing_manager_update_graph(&sim->nodes[i].routing, &sim->topology);
+    }
+    sim->current = NULL;
+}
+
+// ========================================
+// Nodes
+// ========================================
+
+static int node_init(tdma_sim_t *sim, sim_node_t *node, node_id_t id,
+                     node_id_t *all_nodes, uint64_t *rng) {
+    const sim_config_t *config = &sim->config;
+    
+    node->id = id;
+    node->sim = sim;
+    node->clock_rate = 1.0 + (2.0 * rng_unit(rng) - 1.0) * config->drift_ppm / 1e6;
+    node->clock_offset_us = config->max_offset_us > 0 ?
+                            rng_next(rng) % (config->max_offset_us + 1) : 0;
+    
+    // Tudo o que lê o relógio durante o init (ex.: round_start_us) vê o tempo deste nó
+    sim->current = node;
+    
+    if (buffer_pool_init(&node->buffers, SIM_NODE_POOL_SIZE, BUFFER_POOL_BUF_SIZE) < 0) {
+        return -1;
+    }
+    
+    if (udp_transport_init_shm(&node->transport, id, &sim->fabric) < 0) {
+        buffer_pool_destroy(&node->buffers);
+        return -1;
+    }
+    udp_transport_set_pool(&node->transport, &node->buffers);
+    
+    routing_manager_init(&node->routing, id, config->strategy);
+    routing_manager_set_incremental(&node->routing, true);
+    
+    int sync_ret = ra_tdmas_init(&node->sync, id, all_nodes, config->num_nodes);
+    if (sync_ret == 0) {
+        sync_ret = ra_tdmas_set_round_period(&node->sync, config->round_period_us);
+    }
+    
+    if (sync_ret < 0 || tx_queue_init(&node->tx_queue, SIM_TX_QUEUE_CAPACITY) < 0) {
+        ra_tdmas_destroy(&node->sync);
+        routing_manager_destroy(&node->routing);
+        udp_transport_destroy(&node->transport);
+        buffer_pool_destroy(&node->buffers);
+        return -1;
+    }
+    tx_queue_set_pool(&node->tx_queue, &node->buffers);
+    
+    // Uma só thread: uma fila cheia nunca esvaziaria durante a espera
+    tx_queue_set_max_wait(&node->tx_queue, 0);
+    
+    forwarding_init(&node->forwarding, id, &node->routing,
+                    &node->tx_queue, &node->transport);
+    
+    sim->current = NULL;
+    return 0;
+}
+
+static void node_destroy(sim_node_t *node) {
+    if (node->traffic) {
+        traffic_engine_destroy(node->traffic);
+        free(node->traffic);
+    }
+    if (node->stream) {
+        data_streaming_destroy(node->stream);
+        free(node->stream);
+    }
+    
+    udp_transport_destroy(&node->transport);
+    tx_queue_destroy(&node->tx_queue);
+    routing_manager_destroy(&node->routing);
+    ra_tdmas_destroy(&node->sync);
+    buffer_pool_destroy(&node->buffers);
+}
+
+// Mede a latência real (relógio global) e passa o frame ao traffic engine
+static void sim_on_frame(const reasm_frame_t *frame, void *ctx) {
+    sim_node_t *node = ctx;
+    tdma_sim_t *sim = node->sim;
+    sim_node_t *src = tdma_sim_node(sim, frame->src);
+    
+    traffic_header_t header;
+    if (src && frame->size >= sizeof(header)) {
+        memcpy(&header, frame->data, sizeof(header));
+        
+        if (header.magic == TRAFFIC_MAGIC && header.flow_id < sim->config.num_flows) {
+            uint64_t tx_us = tdma_sim_global_time(src, header.tx_time_us);
+            latency_hist_record(&sim->flow_latency[header.flow_id],
+                                sim->now_us > tx_us ? sim->now_us - tx_us : 0);
+        }
+    }
+    
+    if (node->app_on_frame) {
+        node->app_on_frame(frame, node->app_on_frame_ctx);
+    }
+}
+
+// Origem ou destino de um fluxo: streaming + traffic engine com todos os fluxos
+static int attach_endpoint(tdma_sim_t *sim, sim_node_t *node) {
+    if (node->traffic) return 0;
+    
+    node->stream = malloc(sizeof(data_streaming_t));
+    node->traffic = malloc(sizeof(traffic_engine_t));
+    if (!node->stream || !node->traffic) {
+        free(node->stream);
+        free(node->traffic);
+        node->stream = NULL;
+        node->traffic = NULL;
+        return -1;
+    }
+    
+    sim->current = node;
+    if (data_streaming_init(node->stream, node->id, &node->transport) < 0) {
+        free(node->stream);
+        free(node->traffic);
+        node->stream = NULL;
+        node->traffic = NULL;
+        sim->current = NULL;
+        return -1;
+    }
+    data_streaming_set_forwarding(node->stream, &node->forwarding);
+    
+    traffic_engine_init(node->traffic, node->stream, node->id);
+    node->traffic->warmup_sec = sim->config.warmup_sec;
+    for (int i = 0; i < sim->config.num_flows; i++) {
+        traffic_engine_add_flow(node->traffic, &sim->config.flows[i]);
+    }
+    
+    sim->current = NULL;
+    return 0;
+}
+
+static int setup_flows(tdma_sim_t *sim) {
+    const sim_config_t *config = &sim->config;
+    
+    if (config->num_flows == 0) return 0;
+    
+    sim->flow_latency = calloc(config->num_flows, sizeof(latency_hist_t));
+    if (!sim->flow_latency) return -1;
+    
+    for (int i = 0; i < config->num_flows; i++) {
+        latency_hist_reset(&sim->flow_latency[i]);
+        
+        sim_node_t *src = tdma_sim_node(sim, config->flows[i].src);
+        sim_node_t *dst = tdma_sim_node(sim, config->flows[i].dst);
+        if (!src || !dst) {
+            fprintf(stderr, "[SIM] Flow %d uses a node outside 1-%u\n", i, sim->num_nodes);
+            return -1;
+        }
+        if (attach_endpoint(sim, src) < 0 || attach_endpoint(sim, dst) < 0) {
+            return -1;
+        }
+    }
+    
+    // Arma cada engine no relógio do seu nó e encadeia a medição real
+    for (uint32_t i = 0; i < sim->num_nodes; i++) {
+        sim_node_t *node = &sim->nodes[i];
+        if (!node->traffic) continue;
+        
+        sim->current = node;
+        int ret = traffic_engine_arm(node->traffic);
+        sim->current = NULL;
+        if (ret < 0) return -1;
+        
+        node->app_on_frame = node->stream->on_frame;
+        node->app_on_frame_ctx = node->stream->on_frame_ctx;
+        data_streaming_set_frame_callback(node->stream, sim_on_frame, node);
+        
+        if (node->traffic->num_local_tx > 0) {
+            schedule(sim, sim->now_us, SIM_EVENT_TRAFFIC, node->id, 0);
+        }
+    }
+    
+    return 0;
+}
+
+// Próximo slot do nó no seu relógio (como tx_scheduler_wait_slot) → evento global
+static void schedule_slot(tdma_sim_t *sim, sim_node_t *node) {
+    uint64_t now_local = tdma_sim_local_time(node, sim->now_us);
+    uint64_t start, end;
+    
+    ra_tdmas_next_slot_window(&node->sync, now_local, &start, &end);
+    
+    uint64_t at = tdma_sim_global_time(node, start);
+    schedule(sim, at > sim->now_us ? at : sim->now_us + 1, SIM_EVENT_SLOT, node->id, 0);
+}
+
+// ========================================
+// Event Handlers
+// ========================================
+
+// O ciclo da thread de heartbeat do tdma_node, num só slot
+static void handle_slot(tdma_sim_t *sim, sim_node_t *node) {
+    uint64_t now_local = ra_tdmas_get_current_time_us();
+    uint64_t slot_start, slot_end;
+    
+    ra_tdmas_next_slot_window(&node->sync, now_local, &slot_start, &slot_end);
+    ra_tdmas_mark_window_served(&node->sync, slot_start);
+    node->last_slot_start_us = slot_start;
+    node->slots++;
+    
+    // Colisão: um vizinho físico ainda está a transmitir (tempo global)
+    uint32_t index = node->id - 1;
+    for (uint32_t k = sim->adj_offset[index]; k < sim->adj_offset[index + 1]; k++) {
+        if (sim->nodes[sim->adj[k] - 1].tx_end_us > sim->now_us) {
+            node->collisions++;
+            break;
+        }
+    }
+    // O nó deixa de transmitir na deadline de tx_queue_drain() (margem antes do fim)
+    uint64_t tx_end = tx_queue_slot_deadline(slot_start, slot_end);
+    node->tx_end_us = tdma_sim_global_time(node, tx_end);
+    
+    ra_tdmas_calculate_slot_adjustment(&node->sync);
+    
+    // Heartbeat: rádio, só os vizinhos físicos o ouvem
+    static const uint8_t payload = 0xFF;
+    uint32_t count = 0;
+    for (uint32_t k = sim->adj_offset[index]; k < sim->adj_offset[index + 1]; k++) {
+        udp_tx_packet_t *pkt = &sim->hb_batch[count++];
+        pkt->dst = sim->adj[k];
+        pkt->type = MSG_HEARTBEAT;
+        pkt->tx_timestamp_us = now_local;
+        pkt->segments[0].iov_base = (void *)&payload;
+        pkt->segments[0].iov_len = sizeof(payload);
+        pkt->num_segments = 1;
+    }
+    if (count > 0 && udp_transport_send_batch(&node->transport, sim->hb_batch, count) > 0) {
+        node->heartbeats_sent++;
+        node->packets_sent += count;
+    }
+    
+    if (node->stream) {
+        data_streaming_on_round(node->stream, now_local / 1000);
+    }
+    
+    int sent = tx_queue_drain(&node->tx_queue, &node->transport, tx_end);
+    if (sent > 0) node->packets_sent += sent;
+    
+    ra_tdmas_on_round_end(&node->sync);
+    schedule_slot(sim, node);
+}
+
+static void process_message(sim_node_t *node, udp_header_t *header,
+                            const uint8_t *payload, int payload_len,
+                            uint64_t rx_time_us) {
+    switch (header->type) {
+        case MSG_HEARTBEAT:
+            node->heartbeats_received++;
+            break;
+        
+        case MSG_DATA:
+            if (forwarding_on_receive(&node->forwarding, header, payload, payload_len,
+                                      rx_time_us) != FWD_DELIVER || !node->stream) {
+                break;
+            }
+            data_streaming_receive_from(node->stream,
+                                        ((const mesh_header_t *)payload)->origin,
+                                        ((const mesh_header_t *)payload)->hops + 1,
+                                        payload + sizeof(mesh_header_t),
+                                        payload_len - sizeof(mesh_header_t));
+            break;
+        
+        case MSG_STREAM_NACK:
+            if (forwarding_on_receive(&node->forwarding, header, payload, payload_len,
+                                      rx_time_us) != FWD_DELIVER || !node->stream) {
+                break;
+            }
+            data_streaming_on_nack(node->stream, ((const mesh_header_t *)payload)->origin,
+                                   payload + sizeof(mesh_header_t),
+                                   payload_len - sizeof(mesh_header_t));
+            break;
+        
+        default:
+            break;
+    }
+}
+
+// O corpo da thread de receção do tdma_node
+static void handle_rx(sim_node_t *node) {
+    udp_rx_packet_t batch[UDP_RX_BATCH];
+    int count;
+    
+    do {
+        count = udp_transport_receive_batch(&node->transport, batch, UDP_RX_BATCH);
+        if (count <= 0) break;
+        
+        uint64_t rx_time_us = ra_tdmas_get_current_time_us();
+        
+        for (int i = 0; i < count; i++) {
+            udp_header_t *header = &batch[i].header;
+            
+            process_message(node, header, batch[i].payload, batch[i].payload_len,
+                            rx_time_us);
+            ra_tdmas_on_packet_received(&node->sync, header->src,
+                                        header->tx_timestamp_us, rx_time_us);
+        }
+    } while (count == UDP_RX_BATCH);
+}
+
+static void handle_traffic(tdma_sim_t *sim, sim_node_t *node) {
+    uint64_t now_local = ra_tdmas_get_current_time_us();
+    uint64_t next = traffic_engine_poll(node->traffic, now_local);
+    
+    if (next == UINT64_MAX) return;
+    
+    // Saturação: volta a encher a fila uma vez por ronda
+    if (next <= now_local) next = now_local + node->sync.round_period_us;
+    
+    schedule(sim, tdma_sim_global_time(node, next), SIM_EVENT_TRAFFIC, node->id, 0);
+}
+
+// arg = 2 * índice do evento (+1 quando o link volta)
+static void handle_link(tdma_sim_t *sim, uint32_t arg) {
+    const sim_link_event_t *ev = &sim->config.link_events[arg / 2];
+    bool up = arg & 1;
+    
+    shm_link_params_t params = sim->config.link;
+    params.down = !up;
+    shm_fabric_set_link_pair(&sim->fabric, ev->a, ev->b, &params);
+    
+    uint32_t detect_ms = up ? SIM_RECOVER_DETECT_MS : sim->config.detect_ms;
+    schedule(sim, sim->now_us + (uint64_t)detect_ms * 1000, SIM_EVENT_TOPOLOGY, 0, arg);
+}
+
+static void handle_topology(tdma_sim_t *sim, uint32_t arg) {
+    const sim_link_event_t *ev = &sim->config.link_events[arg / 2];
+    bool up = arg & 1;
+    
+    if ((topology_graph_link_weight(&sim->topology, ev->a, ev->b) != 0) == up) return;
+    
+    topology_graph_set_link(&sim->topology, ev->a, ev->b, up ? 1 : 0);
+    sim->topology_changes++;
+    
+    update_sync_trees(sim);
+    update_routing(sim);
+}
+
+// ========================================
+// Lifecycle
+// ========================================
+
+void sim_config_default(sim_config_t *config) {
+    memset(config, 0, sizeof(sim_config_t));
+    config->num_nodes = 16;
+    config->topology = SIM_TOPO_GRID;
+    config->degree = 4;
+    config->round_period_us = TDMA_ROUND_PERIOD_MS * 1000;
+    config->drift_ppm = 20.0;
+    config->detect_ms = SIM_DEFAULT_DETECT_MS;
+    config->strategy = ROUTING_STRATEGY_DIJKSTRA;
+    config->warmup_sec = SIM_DEFAULT_WARMUP_SEC;
+    config->seed = 1;
+}
+
+static int validate_config(const sim_config_t *config) {
+    if (config->num_nodes < 2 || config->num_nodes > MAX_NETWORK_NODES) {
+        fprintf(stderr, "[SIM] Invalid node count: %u (2-%d)\n",
+                config->num_nodes, MAX_NETWORK_NODES);
+        return -1;
+    }
+    if (config->round_period_us < config->num_nodes) {
+        fprintf(stderr, "[SIM] Round of %u us is shorter than 1 us per slot\n",
+                config->round_period_us);
+        return -1;
+    }
+    if (config->drift_ppm < 0 || config->drift_ppm >= 1e6) {
+        fprintf(stderr, "[SIM] Invalid drift: %.1f ppm\n", config->drift_ppm);
+        return -1;
+    }
+    
+    for (int i = 0; i < config->num_link_events; i++) {
+        const sim_link_event_t *ev = &config->link_events[i];
+        if (ev->a < 1 || ev->b < 1 || ev->a > config->num_nodes ||
+            ev->b > config->num_nodes || ev->a == ev->b || ev->down_sec < 0 ||
+            (ev->up_sec > 0 && ev->up_sec <= ev->down_sec)) {
+            fprintf(stderr, "[SIM] Invalid link event %d-%d\n", ev->a, ev->b);
+            return -1;
+        }
+    }
+    
+    return 0;
+}
+
+int tdma_sim_init(tdma_sim_t *sim, const sim_config_t *config) {
+    memset(sim, 0, sizeof(tdma_sim_t));
+    
+    if (validate_config(config) < 0) return -1;
+    
+    sim->config = *config;
+    sim->now_us = SIM_EPOCH_US;
+    uint32_t n = config->num_nodes;
+    uint64_t rng = config->seed ? config->seed : 1;
+    
+    if (sim_queue_init(&sim->queue, 4 * n) < 0) return -1;
+    
+    if (shm_fabric_init(&sim->fabric, n, config->seed) < 0) {
+        sim_queue_destroy(&sim->queue);
+        return -1;
+    }
+    shm_fabric_set_defaults(&sim->fabric, &config->link);
+    shm_fabric_set_virtual_time(&sim->fabric, sim_fabric_clock, sim_on_enqueue, sim);
+    
+    ra_tdmas_set_clock(sim_clock, sim);
+    
+    sim->nodes = calloc(n, sizeof(sim_node_t));
+    node_id_t *all_nodes = malloc(n * sizeof(node_id_t));
+    
+    if (!sim->nodes || !all_nodes || build_topology(sim, &rng) < 0) {
+        fprintf(stderr, "[SIM] Out of memory building the %s topology\n",
+                topology_name(config->topology));
+        free(all_nodes);
+        tdma_sim_destroy(sim);
+        return -1;
+    }
+    
+    for (uint32_t i = 0; i < n; i++) {
+        all_nodes[i] = i + 1;
+    }
+    
+    for (uint32_t i = 0; i < n; i++) {
+        if (node_init(sim, &sim->nodes[i], i + 1, all_nodes, &rng) < 0) {
+            fprintf(stderr, "[SIM] Failed to init node %u\n", i + 1);
+            sim->current = NULL;
+            free(all_nodes);
+            tdma_sim_destroy(sim);
+            return -1;
+        }
+        sim->num_nodes = i + 1;           // Só os que inicializaram por completo
+    }
+    free(all_nodes);
+    
+    if (update_sync_trees(sim) < 0 || setup_flows(sim) < 0) {
+        tdma_sim_destroy(sim);
+        return -1;
+    }
+    update_routing(sim);
+    
+    for (int i = 0; i < config->num_link_events; i++) {
+        const sim_link_event_t *ev = &config->link_events[i];
+        schedule(sim, SIM_EPOCH_US + (uint64_t)(ev->down_sec * 1e6),
+                 SIM_EVENT_LINK, 0, 2 * i);
+        if (ev->up_sec > 0) {
+            schedule(sim, SIM_EPOCH_US + (uint64_t)(ev->up_sec * 1e6),
+                     SIM_EVENT_LINK, 0, 2 * i + 1);
+        }
+    }
+    
+    for (uint32_t i = 0; i < n; i++) {
+        schedule_slot(sim, &sim->nodes[i]);
+    }
+    
+    printf("[SIM] %u nodes, %s topology (%u links), round %u us, drift ±%.1f ppm\n",
+           n, topology_name(config->topology), sim->topology.num_edges / 2,
+           config->round_period_us, config->drift_ppm);
+    return 0;
+}
+
+int tdma_sim_run(tdma_sim_t *sim, double seconds) {
+    uint64_t end_us = sim->now_us + (uint64_t)(seconds * 1e6);
+    uint64_t wall_start = wall_time_us();
+    sim_event_t event;
+    
+    while (sim_queue_next_time(&sim->queue) <= end_us &&
+           sim_queue_pop(&sim->queue, &event)) {
+        sim->now_us = event.time_us;
+        sim->events[event.type]++;
+        
+        sim_node_t *node = event.node ? &sim->nodes[event.node - 1] : NULL;
+        sim->current = node;
+        
+        switch (event.type) {
+            case SIM_EVENT_SLOT:     handle_slot(sim, node); break;
+            case SIM_EVENT_RX:       handle_rx(node); break;
+            case SIM_EVENT_TRAFFIC:  handle_traffic(sim, node); break;
+            case SIM_EVENT_LINK:     handle_link(sim, event.arg); break;
+            case SIM_EVENT_TOPOLOGY: handle_topology(sim, event.arg); break;
+            default: break;
+        }
+        
+        sim->current = NULL;
+    }
+    
+    sim->now_us = end_us;
+    sim->wall_us += wall_time_us() - wall_start;
+    return 0;
+}
+
+void tdma_sim_destroy(tdma_sim_t *sim) {
+    // Todos desligados da fabric antes de qualquer pool desaparecer
+    for (uint32_t i = 0; i < sim->num_nodes; i++) {
+        node_destroy(&sim->nodes[i]);
+    }
+    
+    ra_tdmas_set_clock(NULL, NULL);
+    
+    free(sim->nodes);
+    free(sim->flow_latency);
+    free(sim->adj_offset);
+    free(sim->adj);
+    free(sim->hb_batch);
+    sim->nodes = NULL;
+    sim->flow_latency = NULL;
+    sim->adj_offset = NULL;
+    sim->adj = NULL;
+    sim->hb_batch = NULL;
+    sim->num_nodes = 0;
+    
+    topology_graph_destroy(&sim->topology);
+    shm_fabric_destroy(&sim->fabric);
+    sim_queue_destroy(&sim->queue);
+}
+
+sim_node_t *tdma_sim_node(tdma_sim_t *sim, node_id_t id) {
+    if (id < 1 || id > sim->num_nodes) return NULL;
+    return &sim->nodes[id - 1];
+}
+
+// ========================================
+// Status
+// ========================================
+
+double tdma_sim_elapsed_sec(const tdma_sim_t *sim) {
+    return (sim->now_us - SIM_EPOCH_US) / 1e6;
+}
+
+uint32_t tdma_sim_synchronized(tdma_sim_t *sim) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < sim->num_nodes; i++) {
+        if (sim->nodes[i].sync.is_synchronized) count++;
+    }
+    return count;
+}
+
+typedef struct {
+    uint64_t slots, collisions;
+    uint64_t heartbeats_sent, heartbeats_received, packets_sent;
+    uint64_t slot_adjustments;
+    int64_t total_shift_us;
+    uint64_t recomputations, incremental_updates;
+    uint64_t delivered, forwarded, no_route, queue_full, ttl_expired;
+    uint64_t frames_sent, frames_failed, frames_received;
+    latency_hist_t latency;       // Todos os fluxos (relógio global)
+} sim_totals_t;
+
+static void collect_totals(tdma_sim_t *sim, sim_totals_t *t) {
+    memset(t, 0, sizeof(sim_totals_t));
+    latency_hist_reset(&t->latency);
+    
+    for (uint32_t i = 0; i < sim->num_nodes; i++) {
+        sim_node_t *node = &sim->nodes[i];
+        
+        t->slots += node->slots;
+        t->collisions += node->collisions;
+        t->heartbeats_sent += node->heartbeats_sent;
+        t->heartbeats_received += node->heartbeats_received;
+        t->packets_sent += node->packets_sent;
+        t->slot_adjustments += node->sync.slot_adjustments;
+        t->total_shift_us += node->sync.total_shift_applied_us;
+        t->recomputations += node->routing.recomputations;
+        t->incremental_updates += node->routing.incremental_updates;
+        t->delivered += node->forwarding.delivered;
+        t->forwarded += node->forwarding.forwarded;
+        t->no_route += node->forwarding.no_route;
+        t->queue_full += node->forwarding.queue_full;
+        t->ttl_expired += node->forwarding.ttl_expired;
+    }
+    
+    for (int f = 0; f < sim->config.num_flows; f++) {
+        sim_node_t *src = tdma_sim_node(sim, sim->config.flows[f].src);
+        sim_node_t *dst = tdma_sim_node(sim, sim->config.flows[f].dst);
+        
+        t->frames_sent += src->traffic->tx[f].frames_sent;
+        t->frames_failed += src->traffic->tx[f].frames_failed;
+        t->frames_received += dst->traffic->rx[f].frames_received;
+        latency_hist_merge(&t->latency, &sim->flow_latency[f]);
+    }
+}
+
+void tdma_sim_print_summary(tdma_sim_t *sim) {
+    sim_totals_t *t = malloc(sizeof(sim_totals_t));
+    if (!t) return;
+    collect_totals(sim, t);
+    
+    double sim_sec = tdma_sim_elapsed_sec(sim);
+    double wall_sec = sim->wall_us / 1e6;
+    uint64_t events = 0;
+    for (int i = 0; i < SIM_EVENT_TYPES; i++) events += sim->events[i];
+    
+    uint32_t min_round = UINT32_MAX, max_round = 0;
+    for (uint32_t i = 0; i < sim->num_nodes; i++) {
+        uint32_t round = sim->nodes[i].sync.round_number;
+        if (round < min_round) min_round = round;
+        if (round > max_round) max_round = round;
+    }
+    
+    shm_link_stats_t links;
+    shm_fabric_get_totals(&sim->fabric, &links);
+    
+    printf("\n=== TDMA Simulation Summary ===\n");
+    printf("Network:        %u nodes, %s, %u links, max degree %u\n",
+           sim->num_nodes, topology_name(sim->config.topology),
+           sim->topology.num_edges / 2, sim->max_degree);
+    printf("TDMA:           round %u us, %u us slots, drift ±%.1f ppm, offset ≤%u us\n",
+           sim->config.round_period_us, sim->config.round_period_us / sim->num_nodes,
+           sim->config.drift_ppm, sim->config.max_offset_us);
+    printf("Links:          delay %u us, jitter %u us, loss %.3f\n",
+           sim->config.link.delay_us, sim->config.link.jitter_us, sim->config.link.loss);
+    printf("Simulated:      %.1f s in %.2f s wall (%.0fx), %lu events (%.2f M/s)\n",
+           sim_sec, wall_sec, wall_sec > 0 ? sim_sec / wall_sec : 0.0, events,
+           wall_sec > 0 ? events / wall_sec / 1e6 : 0.0);
+    printf("Events:         %lu slot, %lu rx, %lu traffic, %lu link, %lu topology\n",
+           sim->events[SIM_EVENT_SLOT], sim->events[SIM_EVENT_RX],
+           sim->events[SIM_EVENT_TRAFFIC], sim->events[SIM_EVENT_LINK],
+           sim->events[SIM_EVENT_TOPOLOGY]);
+    printf("Rounds:         %u-%u\n", min_round, max_round);
+    printf("Slots:          %lu, %lu overlapping a neighbor's (%.2f%%)\n",
+           t->slots, t->collisions, t->slots ? t->collisions * 100.0 / t->slots : 0.0);
+    printf("Sync:           %u/%u synchronized, %lu slot adjustments (%ld us total)\n",
+           tdma_sim_synchronized(sim), sim->num_nodes, t->slot_adjustments,
+           t->total_shift_us);
+    printf("Heartbeats:     %lu broadcast, %lu received\n",
+           t->heartbeats_sent, t->heartbeats_received);
+    printf("Packets:        %lu sent, %lu delivered, %lu lost (link down: %lu)\n",
+           t->packets_sent, links.delivered, links.lost + links.down_drops +
+           links.overflows, links.down_drops);
+    printf("Routing:        %lu topology changes, %lu recomputations, %lu incremental\n",
+           sim->topology_changes, t->recomputations, t->incremental_updates);
+    printf("Mesh:           %lu delivered, %lu relayed, dropped: no route %lu | "
+           "queue full %lu | TTL %lu\n",
+           t->delivered, t->forwarded, t->no_route, t->queue_full, t->ttl_expired);
+    
+    if (sim->config.num_flows > 0) {
+        printf("Flows:          %lu frames sent (failed: %lu), %lu received\n",
+               t->frames_sent, t->frames_failed, t->frames_received);
+        
+        for (int f = 0; f < sim->config.num_flows; f++) {
+            const traffic_flow_t *flow = &sim->config.flows[f];
+            sim_node_t *src = tdma_sim_node(sim, flow->src);
+            sim_node_t *dst = tdma_sim_node(sim, flow->dst);
+            
+            printf("   Flow %d: %d → %d, %lu sent, %lu received\n", f, flow->src,
+                   flow->dst, src->traffic->tx[f].frames_sent,
+                   dst->traffic->rx[f].frames_received);
+            latency_hist_print(&sim->flow_latency[f], "   True");
+            latency_hist_print(&dst->traffic->rx[f].latency, "   Measured");
+        }
+    }
+    printf("\n");
+    
+    free(t);
+}
+
+int tdma_sim_append_csv(tdma_sim_t *sim, const char *filename) {
+    FILE *fp = fopen(filename, "a");
+    if (!fp) {
+        printf("[ERROR] Cannot open %s for writing\n", filename);
+        return -1;
+    }
+    
+    sim_totals_t *t = malloc(sizeof(sim_totals_t));
+    if (!t) {
+        fclose(fp);
+        return -1;
+    }
+    collect_totals(sim, t);
+    
+    if (ftell(fp) == 0) {
+        fprintf(fp, "nodes,topology,round_us,drift_ppm,offset_us,delay_us,jitter_us,loss,"
+                    "sim_sec,wall_sec,events,slots,collision_pct,synchronized,"
+                    "slot_adjustments,recomputations,frames_sent,frames_received,"
+                    "p50_ms,p99_ms,max_ms\n");
+    }
+    
+    uint64_t events = 0;
+    for (int i = 0; i < SIM_EVENT_TYPES; i++) events += sim->events[i];
+    
+    fprintf(fp, "%u,%s,%u,%.2f,%u,%u,%u,%.4f,%.1f,%.3f,%lu,%lu,%.3f,%u,%lu,%lu,%lu,%lu,"
+                "%.3f,%.3f,%.3f\n",
+            sim->num_nodes, topology_name(sim->config.topology),
+            sim->config.round_period_us, sim->config.drift_ppm, sim->config.max_offset_us,
+            sim->config.link.delay_us, sim->config.link.jitter_us, sim->config.link.loss,
+            tdma_sim_elapsed_sec(sim), sim->wall_us / 1e6, events, t->slots,
+            t->slots ? t->collisions * 100.0 / t->slots : 0.0,
+            tdma_sim_synchronized(sim), t->slot_adjustments, t->recomputations,
+            t->frames_sent, t->frames_received,
+            latency_hist_percentile(&t->latency, 50) / 1000.0,
+            latency_hist_percentile(&t->latency, 99) / 1000.0,
+            t->latency.max_us / 1000.0);
+    
+    fclose(fp);
+    free(t);
+    return 0;
+}
@@ -1,26 +1,53 @@
 #include "ra_tdmas_sync.h"
+#include "async_log.h"
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
 #include <unistd.h>
 #include <stdlib.h> // Para abs() se necessário
 
+static ra_tdmas_clock_fn injected_clock = NULL;
+static void *injected_clock_ctx = NULL;
+
+void ra_tdmas_set_clock(ra_tdmas_clock_fn clock, void *ctx) {
+    injected_clock_ctx = ctx;
+    injected_clock = clock;
+}
+
 // Função para obter tempo atual em microsegundos (Monotonic Clock)
 uint64_t ra_tdmas_get_current_time_us(void) {
+    if (injected_clock) return injected_clock(injected_clock_ctx);
+    
     struct timespec ts;
     clock_gettime(CLOCK_MONOTONIC, &ts);
     return (uint64_t)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000ULL);
 }
 
+static int alloc_delay_buffer(delay_buffer_t *buf, uint32_t num_slots) {
+    buf->delays = calloc(num_slots, sizeof(int64_t));
+    buf->count = calloc(num_slots, sizeof(uint32_t));
+    buf->heard = malloc(num_slots * sizeof(uint32_t));
+    buf->num_heard = 0;
+    return (buf->delays && buf->count && buf->heard) ? 0 : -1;
+}
+
+static int find_slot_index(ra_tdmas_sync_t *sync, node_id_t node_id) {
+    if (node_id >= sync->slot_of_node_size) return -1;
+    return sync->slot_of_node[node_id];
+}
+
 int ra_tdmas_init(ra_tdmas_sync_t *sync, node_id_t my_id,
-                  node_id_t *all_nodes, uint8_t num_nodes) {
+                  node_id_t *all_nodes, uint32_t num_nodes) {
     memset(sync, 0, sizeof(ra_tdmas_sync_t));
     
+    if (num_nodes == 0) return -1;
+    
     sync->my_node_id = my_id;
     sync->num_slots = num_nodes;
     sync->round_period_us = TDMA_ROUND_PERIOD_MS * 1000;
     sync->round_start_us = ra_tdmas_get_current_time_us();
     sync->round_number = 0;
+    sync->last_served_round = -1;
     sync->is_synchronized = false;
     
     // Inicializar Mutexes
@@ -28,10 +55,36 @@ int ra_tdmas_init(ra_tdmas_sync_t *sync, node_id_t my_id,
     pthread_mutex_init(&sync->current_delays.lock, NULL);
     pthread_mutex_init(&sync->previous_delays.lock, NULL);
     
+    // Buffers por slot (dimensionados pelo número de nós)
+    node_id_t max_id = 0;
+    for (uint32_t i = 0; i < num_nodes; i++) {
+        if (all_nodes[i] > max_id) max_id = all_nodes[i];
+    }
+    
+    sync->slots = calloc(num_nodes, sizeof(slot_boundary_t));
+    sync->slot_of_node_size = (uint32_t)max_id + 1;
+    sync->slot_of_node = malloc(sync->slot_of_node_size * sizeof(int32_t));
+    sync->sync_neighbors = calloc(num_nodes, sizeof(bool));
+    sync->filtered_delays = calloc(num_nodes, sizeof(int64_t));
+    
+    if (!sync->slots || !sync->slot_of_node || !sync->sync_neighbors ||
+        !sync->filtered_delays ||
+        alloc_delay_buffer(&sync->current_delays, num_nodes) < 0 ||
+        alloc_delay_buffer(&sync->previous_delays, num_nodes) < 0) {
+        fprintf(stderr, "[RA-TDMAs+] Out of memory for %u slots\n", num_nodes);
+        ra_tdmas_destroy(sync);
+        return -1;
+    }
+    
+    for (uint32_t i = 0; i < sync->slot_of_node_size; i++) {
+        sync->slot_of_node[i] = -1;
+    }
+    
     // Dividir o tempo igualmente no início
     uint32_t slot_duration = sync->round_period_us / num_nodes;
     
-    for (int i = 0; i < num_nodes; i++) {
+    for (uint32_t i = 0; i < num_nodes; i++) {
+        sync->slot_of_node[all_nodes[i]] = i;
         sync->slots[i].node_id = all_nodes[i];
         sync->slots[i].start_offset_us = i * slot_duration;
         sync->slots[i].duration_us = slot_duration;
@@ -42,29 +95,92 @@ int ra_tdmas_init(ra_tdmas_sync_t *sync, node_id_t my_id,
         }
     }
     
-    printf("[RA-TDMAs+] Init: Node %d, Slot %d/%d, Duration %u us\n",
+    printf("[RA-TDMAs+] Init: Node %d, Slot %u/%u, Duration %u us\n",
            my_id, sync->my_slot_index, num_nodes, slot_duration);
     
     return 0;
 }
 
+void ra_tdmas_destroy(ra_tdmas_sync_t *sync) {
+    free(sync->slots);
+    free(sync->slot_of_node);
+    free(sync->sync_neighbors);
+    free(sync->filtered_delays);
+    free(sync->current_delays.delays);
+    free(sync->current_delays.count);
+    free(sync->previous_delays.delays);
+    free(sync->previous_delays.count);
+    free(sync->current_delays.heard);
+    free(sync->previous_delays.heard);
+    
+    sync->slots = NULL;
+    sync->slot_of_node = NULL;
+    sync->sync_neighbors = NULL;
+    sync->filtered_delays = NULL;
+    sync->current_delays.delays = sync->previous_delays.delays = NULL;
+    sync->current_delays.count = sync->previous_delays.count = NULL;
+    sync->current_delays.heard = sync->previous_delays.heard = NULL;
+    sync->num_slots = 0;
+}
+
+int ra_tdmas_set_round_period(ra_tdmas_sync_t *sync, uint32_t period_us) {
+    if (sync->num_slots == 0 || period_us < sync->num_slots) return -1;
+    
+    uint32_t slot_duration = period_us / sync->num_slots;
+    
+    pthread_mutex_lock(&sync->lock);
+    sync->round_period_us = period_us;
+    for (uint32_t i = 0; i < sync->num_slots; i++) {
+        sync->slots[i].start_offset_us = i * slot_duration;
+        sync->slots[i].duration_us = slot_duration;
+        sync->slots[i].accumulated_shift_us = 0;
+    }
+    pthread_mutex_unlock(&sync->lock);
+    
+    return 0;
+}
+
 void ra_tdmas_set_spanning_tree(ra_tdmas_sync_t *sync, spanning_tree_t *mst) {
+    // Extrai os vizinhos na árvore densa (índices da árvore → node IDs)
+    node_id_t neighbors[MAX_NODES];
+    uint32_t count = 0;
+    
+    int my_tree_idx = -1;
+    for (int i = 0; i < mst->num_nodes; i++) {
+        if (mst->node_ids[i] == sync->my_node_id) my_tree_idx = i;
+    }
+    
+    if (my_tree_idx != -1) {
+        for (int i = 0; i < mst->num_nodes; i++) {
+            if (mst->tree[my_tree_idx][i] || mst->tree[i][my_tree_idx]) {
+                neighbors[count++] = mst->node_ids[i];
+            }
+        }
+    }
+    
+    ra_tdmas_set_sync_neighbors(sync, neighbors, count);
+}
+
+void ra_tdmas_set_sync_neighbors(ra_tdmas_sync_t *sync,
+                                 const node_id_t *neighbors,
+                                 uint32_t count) {
     pthread_mutex_lock(&sync->lock);
-    sync->mst = mst;
+    
+    memset(sync->sync_neighbors, 0, sync->num_slots * sizeof(bool));
+    for (uint32_t i = 0; i < count; i++) {
+        int idx = find_slot_index(sync, neighbors[i]);
+        if (idx != -1) sync->sync_neighbors[idx] = true;
+    }
+    sync->has_sync_neighbors = true;
+    
     pthread_mutex_unlock(&sync->lock);
 }
 
 // Chamada quando recebemos um pacote: calcula o erro do relógio
 void ra_tdmas_on_packet_received(ra_tdmas_sync_t *sync, node_id_t sender_id,
                                  uint64_t tx_timestamp_us, uint64_t rx_timestamp_us) {
-    int sender_idx = -1;
     // Encontrar qual é o slot deste remetente
-    for (int i = 0; i < sync->num_slots; i++) {
-        if (sync->slots[i].node_id == sender_id) {
-            sender_idx = i;
-            break;
-        }
-    }
+    int sender_idx = find_slot_index(sync, sender_id);
     
     if (sender_idx == -1) return; // Nó desconhecido
     
@@ -95,60 +211,69 @@ void ra_tdmas_on_packet_received(ra_tdmas_sync_t *sync, node_id_t sender_id,
     
     pthread_mutex_lock(&sync->current_delays.lock);
     sync->current_delays.delays[sender_idx] = delay;
-    sync->current_delays.count[sender_idx]++;
+    if (sync->current_delays.count[sender_idx]++ == 0) {
+        sync->current_delays.heard[sync->current_delays.num_heard++] = sender_idx;
+    }
     pthread_mutex_unlock(&sync->current_delays.lock);
 }
 
 // O Cérebro: Analisa os atrasos e ajusta o slot
+static int compare_delay(const void *a, const void *b) {
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
 void ra_tdmas_calculate_slot_adjustment(ra_tdmas_sync_t *sync) {
-    if (!sync->mst) return;
+    if (!sync->has_sync_neighbors) return;
     
     // 1. Trocar buffers (Current -> Previous) para analisar sem bloquear
     pthread_mutex_lock(&sync->current_delays.lock);
     pthread_mutex_lock(&sync->previous_delays.lock);
     
-    delay_buffer_t temp = sync->previous_delays;
-    sync->previous_delays = sync->current_delays;
-    sync->current_delays = temp; // O antigo previous agora é o current (vazio)
-    
-    // Limpar o novo current
-    memset(&sync->current_delays.delays, 0, sizeof(sync->current_delays.delays));
-    memset(&sync->current_delays.count, 0, sizeof(sync->current_delays.count));
+    // Só os arrays trocam de lugar; cada buffer mantém o seu mutex
+    int64_t *tmp_delays = sync->previous_delays.delays;
+    uint32_t *tmp_count = sync->previous_delays.count;
+    uint32_t *tmp_heard = sync->previous_delays.heard;
+    uint32_t tmp_num_heard = sync->previous_delays.num_heard;
+    sync->previous_delays.delays = sync->current_delays.delays;
+    sync->previous_delays.count = sync->current_delays.count;
+    sync->previous_delays.heard = sync->current_delays.heard;
+    sync->previous_delays.num_heard = sync->current_delays.num_heard;
+    sync->current_delays.delays = tmp_delays; // O antigo previous agora é o current (vazio)
+    sync->current_delays.count = tmp_count;
+    sync->current_delays.heard = tmp_heard;
+    
+    // Limpar o novo current: só os slots ouvidos (O(vizinhos), não O(nós))
+    for (uint32_t i = 0; i < tmp_num_heard; i++) {
+        sync->current_delays.delays[tmp_heard[i]] = 0;
+        sync->current_delays.count[tmp_heard[i]] = 0;
+    }
+    sync->current_delays.num_heard = 0;
     
     pthread_mutex_unlock(&sync->previous_delays.lock);
     pthread_mutex_unlock(&sync->current_delays.lock);
     
     // 2. Filtrar dados usando a MST (Só ouvimos pais/vizinhos relevantes)
-    int my_idx = sync->my_slot_index;
-    int64_t filtered_delays[MAX_NODES];
+    uint32_t my_idx = sync->my_slot_index;
+    int64_t *filtered_delays = sync->filtered_delays;
     int valid_count = 0;
     
-    for (int i = 0; i < sync->num_slots; i++) {
-        if (sync->previous_delays.count[i] == 0) continue;
+    pthread_mutex_lock(&sync->lock);
+    for (uint32_t h = 0; h < sync->previous_delays.num_heard; h++) {
+        uint32_t i = sync->previous_delays.heard[h];
         
-        // Verifica na Matriz se devemos sincronizar com este nó
-        // sync->mst->tree[linha][coluna]
-        if (sync->mst->tree[my_idx][i] == 0 && sync->mst->tree[i][my_idx] == 0) {
-             // Se não há link na MST, ignoramos para evitar loops de sync
-             continue;
-        }
+        // Se não há link na MST, ignoramos para evitar loops de sync
+        if (!sync->sync_neighbors[i]) continue;
         
         filtered_delays[valid_count++] = sync->previous_delays.delays[i];
     }
+    pthread_mutex_unlock(&sync->lock);
     
     if (valid_count == 0) return;
     
     // 3. Calcular a Mediana dos atrasos
-    // Sort simples (Bubble sort é ok para N pequeno < 10)
-    for (int i = 0; i < valid_count - 1; i++) {
-        for (int j = 0; j < valid_count - i - 1; j++) {
-            if (filtered_delays[j] > filtered_delays[j+1]) {
-                int64_t tmp = filtered_delays[j];
-                filtered_delays[j] = filtered_delays[j+1];
-                filtered_delays[j+1] = tmp;
-            }
-        }
-    }
+    qsort(filtered_delays, valid_count, sizeof(int64_t), compare_delay);
     
     int64_t median_delay = filtered_delays[valid_count / 2];
     int64_t shift = median_delay;
@@ -177,17 +302,25 @@ void ra_tdmas_calculate_slot_adjustment(ra_tdmas_sync_t *sync) {
         sync->slot_adjustments++;
         sync->total_shift_applied_us += shift;
         
-        printf("[RA-TDMAs+] Node %d: Slot adjusted by %ld us (total: %d us)\n",
-               sync->my_node_id, shift, sync->slots[my_idx].accumulated_shift_us);
+        LOG_INFO("[RA-TDMAs+] Node %d: Slot adjusted by %ld us (total: %d us)\n",
+                 sync->my_node_id, shift, sync->slots[my_idx].accumulated_shift_us);
     }
 }
 
+// Posição dentro da ronda; round_start_us pode estar à frente de 'now'
+// quando on_round_end() é chamado logo após o slot
+static uint64_t time_in_round_us(ra_tdmas_sync_t *sync, uint64_t now) {
+    int64_t diff = (int64_t)(now - sync->round_start_us);
+    int64_t period = sync->round_period_us;
+    return (uint64_t)(((diff % period) + period) % period);
+}
+
 // A função CRÍTICA: Posso transmitir?
 bool ra_tdmas_can_transmit(ra_tdmas_sync_t *sync) {
     uint64_t now = ra_tdmas_get_current_time_us();
     
     // Calcular posição atual dentro da ronda (0 a 100ms)
-    uint64_t time_in_round = (now - sync->round_start_us) % sync->round_period_us;
+    uint64_t time_in_round = time_in_round_us(sync, now);
     
     pthread_mutex_lock(&sync->lock);
     slot_boundary_t *my_slot = &sync->slots[sync->my_slot_index];
@@ -205,7 +338,7 @@ bool ra_tdmas_can_transmit(ra_tdmas_sync_t *sync) {
 // Calcula quanto tempo falta para o meu slot (para dormir)
 uint32_t ra_tdmas_time_until_my_slot_us(ra_tdmas_sync_t *sync) {
     uint64_t now = ra_tdmas_get_current_time_us();
-    uint64_t time_in_round = (now - sync->round_start_us) % sync->round_period_us;
+    uint64_t time_in_round = time_in_round_us(sync, now);
     
     pthread_mutex_lock(&sync->lock);
     uint64_t slot_start = sync->slots[sync->my_slot_index].start_offset_us;
@@ -220,6 +353,55 @@ uint32_t ra_tdmas_time_until_my_slot_us(ra_tdmas_sync_t *sync) {
     }
 }
 
+// Índice absoluto da ronda que começa em 'round_base_us' (arredondado:
+// tolera desvios de menos de meia ronda no início do slot)
+static int64_t round_index(ra_tdmas_sync_t *sync, uint64_t round_base_us) {
+    int64_t period = sync->round_period_us;
+    int64_t phase = (int64_t)(sync->round_start_us % sync->round_period_us);
+    int64_t offset = (int64_t)round_base_us - phase + period / 2;
+    return offset >= 0 ? offset / period : -((period - 1 - offset) / period);
+}
+
+void ra_tdmas_next_slot_window(ra_tdmas_sync_t *sync, uint64_t now_us,
+                               uint64_t *start_us, uint64_t *end_us) {
+    uint64_t time_in_round = time_in_round_us(sync, now_us);
+    
+    pthread_mutex_lock(&sync->lock);
+    uint64_t slot_start = sync->slots[sync->my_slot_index].start_offset_us;
+    uint32_t duration = sync->slots[sync->my_slot_index].duration_us;
+    int64_t last_served = sync->last_served_round;
+    pthread_mutex_unlock(&sync->lock);
+    
+    if (time_in_round >= slot_start && time_in_round < slot_start + duration) {
+        // Dentro do slot: janela atual
+        *start_us = now_us - (time_in_round - slot_start);
+    } else if (time_in_round < slot_start) {
+        // Antes do slot na mesma ronda
+        *start_us = now_us + (slot_start - time_in_round);
+    } else {
+        // Já passou o slot, próxima ronda
+        *start_us = now_us + (sync->round_period_us - time_in_round) + slot_start;
+    }
+    
+    // Já transmitimos nesta ronda (o slot pode ter mudado desde então)
+    int64_t round = round_index(sync, *start_us - slot_start);
+    if (round <= last_served) {
+        *start_us += (uint64_t)(last_served + 1 - round) * sync->round_period_us;
+    }
+    
+    *end_us = *start_us + duration;
+}
+
+void ra_tdmas_mark_window_served(ra_tdmas_sync_t *sync, uint64_t start_us) {
+    pthread_mutex_lock(&sync->lock);
+    uint64_t slot_start = sync->slots[sync->my_slot_index].start_offset_us;
+    int64_t round = round_index(sync, start_us - slot_start);
+    if (round > sync->last_served_round) {
+        sync->last_served_round = round;
+    }
+    pthread_mutex_unlock(&sync->lock);
+}
+
 void ra_tdmas_on_round_end(ra_tdmas_sync_t *sync) {
     // Avançar o tempo base da ronda
     sync->round_start_us += sync->round_period_us;
@@ -241,7 +423,7 @@ void ra_tdmas_print_slot_boundaries(ra_tdmas_sync_t *sync) {
     printf("-----|------------|----------|-------\n");
     
     pthread_mutex_lock(&sync->lock);
-    for (int i = 0; i < sync->num_slots; i++) {
+    for (uint32_t i = 0; i < sync->num_slots; i++) {
         char marker = (i == sync->my_slot_index) ? '*' : ' ';
         printf(" %c%2d | %6lu | %6u | %6d\n", marker,
                sync->slots[i].node_id, sync->slots[i].start_offset_us,
@@ -254,7 +436,7 @@ void ra_tdmas_print_slot_boundaries(ra_tdmas_sync_t *sync) {
 void ra_tdmas_print_delays(ra_tdmas_sync_t *sync) {
     printf("\n=== Delays (Node %d) ===\n", sync->my_node_id);
     pthread_mutex_lock(&sync->previous_delays.lock);
-    for (int i = 0; i < sync->num_slots; i++) {
+    for (uint32_t i = 0; i < sync->num_slots; i++) {
         if (sync->previous_delays.count[i] > 0) {
             printf("  Node %d: %ld us (%u pkts)\n", sync->slots[i].node_id,
                    sync->previous_delays.delays[i], sync->previous_delays.count[i]);
@@ -0,0 +1,120 @@
+// src/sync/tx_scheduler.c
+#include "tx_scheduler.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+
+int tx_scheduler_init(tx_scheduler_t *sched, ra_tdmas_sync_t *sync) {
+    memset(sched, 0, sizeof(tx_scheduler_t));
+    
+    sched->sync = sync;
+    sched->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    sched->cancel_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    
+    if (sched->timer_fd < 0 || sched->cancel_fd < 0) {
+        perror("[TX-SCHED] timerfd/eventfd");
+        tx_scheduler_destroy(sched);
+        return -1;
+    }
+    
+    return 0;
+}
+
+void tx_scheduler_destroy(tx_scheduler_t *sched) {
+    if (sched->timer_fd >= 0) close(sched->timer_fd);
+    if (sched->cancel_fd >= 0) close(sched->cancel_fd);
+    sched->timer_fd = -1;
+    sched->cancel_fd = -1;
+}
+
+int tx_scheduler_wait_slot(tx_scheduler_t *sched,
+                           uint64_t *slot_start_us,
+                           uint64_t *slot_end_us) {
+    uint64_t now = ra_tdmas_get_current_time_us();
+    uint64_t start, end;
+    
+    // Nunca na ronda do último slot servido, mesmo que o slot tenha mudado
+    ra_tdmas_next_slot_window(sched->sync, now, &start, &end);
+    
+    // Deadline absoluto: o tempo de cálculo acima não acumula drift
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    its.it_value.tv_sec = start / 1000000;
+    its.it_value.tv_nsec = (start % 1000000) * 1000;
+    
+    if (timerfd_settime(sched->timer_fd, TFD_TIMER_ABSTIME, &its, NULL) < 0) {
+        perror("[TX-SCHED] timerfd_settime");
+        return -1;
+    }
+    
+    struct pollfd fds[2] = {
+        { .fd = sched->timer_fd, .events = POLLIN },
+        { .fd = sched->cancel_fd, .events = POLLIN }
+    };
+    
+    while (true) {
+        int ret = poll(fds, 2, -1);
+        if (ret < 0) {
+            if (errno == EINTR) continue;
+            perror("[TX-SCHED] poll");
+            return -1;
+        }
+        
+        if (fds[1].revents & POLLIN) {
+            uint64_t value;
+            if (read(sched->cancel_fd, &value, sizeof(value)) < 0) {
+                // EAGAIN: já consumido
+            }
+            return -1;
+        }
+        
+        if (fds[0].revents & POLLIN) {
+            uint64_t expirations;
+            if (read(sched->timer_fd, &expirations, sizeof(expirations)) < 0 &&
+                errno != EAGAIN) {
+                perror("[TX-SCHED] read timerfd");
+                return -1;
+            }
+            break;
+        }
+    }
+    
+    int64_t jitter = (int64_t)(ra_tdmas_get_current_time_us() - start);
+    
+    ra_tdmas_mark_window_served(sched->sync, start);
+    sched->last_slot_start_us = start;
+    sched->slots_served++;
+    sched->last_jitter_us = jitter;
+    sched->total_jitter_us += jitter > 0 ? jitter : -jitter;
+    if (jitter > sched->max_jitter_us) {
+        sched->max_jitter_us = jitter;
+    }
+    
+    *slot_start_us = start;
+    *slot_end_us = end;
+    return 0;
+}
+
+void tx_scheduler_cancel(tx_scheduler_t *sched) {
+    uint64_t one = 1;
+    if (sched->cancel_fd >= 0 &&
+        write(sched->cancel_fd, &one, sizeof(one)) < 0) {
+        perror("[TX-SCHED] eventfd write");
+    }
+}
+
+void tx_scheduler_print_stats(tx_scheduler_t *sched) {
+    printf("\n=== TX Scheduler Stats ===\n");
+    printf("Slots served:  %lu\n", sched->slots_served);
+    if (sched->slots_served > 0) {
+        printf("Slot jitter:   last %ld us | avg %.1f us | max %ld us\n",
+               sched->last_jitter_us,
+               (double)sched->total_jitter_us / sched->slots_served,
+               sched->max_jitter_us);
+    }
+    printf("\n");
+}
@@ -0,0 +1,94 @@
+// src/topology/adjacency_bitset.c
+#include <stdlib.h>
+#include <string.h>
+#include "adjacency_bitset.h"
+
+void adjacency_bitset_init(adjacency_bitset_t *adj) {
+    memset(adj, 0, sizeof(adjacency_bitset_t));
+}
+
+void adjacency_bitset_destroy(adjacency_bitset_t *adj) {
+    free(adj->rows);
+    free(adj->node_ids);
+    memset(adj, 0, sizeof(adjacency_bitset_t));
+}
+
+int adjacency_bitset_resize(adjacency_bitset_t *adj, uint32_t num_nodes) {
+    uint32_t words = BITSET_WORDS_FOR(num_nodes);
+    
+    if (num_nodes > adj->capacity) {
+        bitset_word_t *rows = malloc((size_t)num_nodes * words * sizeof(bitset_word_t));
+        node_id_t *ids = malloc(num_nodes * sizeof(node_id_t));
+        
+        if (!rows || !ids) {
+            free(rows);
+            free(ids);
+            return -1;
+        }
+        
+        free(adj->rows);
+        free(adj->node_ids);
+        adj->rows = rows;
+        adj->node_ids = ids;
+        adj->capacity = num_nodes;
+    }
+    
+    adj->num_nodes = num_nodes;
+    adj->words_per_row = words;
+    
+    if (num_nodes > 0) {
+        memset(adj->rows, 0, (size_t)num_nodes * words * sizeof(bitset_word_t));
+    }
+    return 0;
+}
+
+int adjacency_bitset_from_matrix(adjacency_bitset_t *adj,
+                                 const connectivity_matrix_t *topo) {
+    if (adjacency_bitset_resize(adj, topo->num_nodes) < 0) return -1;
+    
+    memcpy(adj->node_ids, topo->node_ids, topo->num_nodes * sizeof(node_id_t));
+    
+    for (int i = 0; i < topo->num_nodes; i++) {
+        for (int j = 0; j < topo->num_nodes; j++) {
+            if (topo->matrix[i][j]) {
+                adjacency_bitset_set(adj, i, j, true);
+            }
+        }
+    }
+    return 0;
+}
+
+int adjacency_bitset_from_graph(adjacency_bitset_t *adj,
+                                const topology_graph_t *graph) {
+    if (adjacency_bitset_resize(adj, graph->num_nodes) < 0) return -1;
+    
+    memcpy(adj->node_ids, graph->node_ids, graph->num_nodes * sizeof(node_id_t));
+    
+    for (uint32_t i = 0; i < graph->num_nodes; i++) {
+        const graph_adj_list_t *list = &graph->adj[i];
+        for (uint32_t e = 0; e < list->degree; e++) {
+            adjacency_bitset_set(adj, i, list->edges[e].to, true);
+        }
+    }
+    return 0;
+}
+
+void adjacency_bitset_set(adjacency_bitset_t *adj, int i, int j, bool connected) {
+    bitset_word_t *row = &adj->rows[(size_t)i * adj->words_per_row];
+    bitset_word_t mask = 1ULL << (j % BITSET_WORD_BITS);
+    
+    if (connected) {
+        row[j / BITSET_WORD_BITS] |= mask;
+    } else {
+        row[j / BITSET_WORD_BITS] &= ~mask;
+    }
+}
+
+int adjacency_bitset_degree(const adjacency_bitset_t *adj, int i) {
+    const bitset_word_t *row = adjacency_bitset_row(adj, i);
+    int degree = 0;
+    for (uint32_t w = 0; w < adj->words_per_row; w++) {
+        degree += __builtin_popcountll(row[w]);
+    }
+    return degree;
+}
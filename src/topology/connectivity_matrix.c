@@ -3,6 +3,7 @@
 #include <string.h>
 #include <time.h>
 #include "tdma_types.h"
+#include "async_log.h"
 #include <pthread.h>             // <--- Necessário para pthread_mutex_t
 #include "connectivity_matrix.h" // <--- ADICIONE ISTO (para ligar ao seu .
 
@@ -33,7 +34,7 @@ void connectivity_matrix_set_topology(uint8_t matrix[MAX_NODES][MAX_NODES],
     
     pthread_mutex_unlock(&global_topology.lock);
     
-    printf("[TOPOLOGY] Updated: %d nodes\n", num_nodes);
+    LOG_DEBUG("[TOPOLOGY] Updated: %d nodes\n", num_nodes);
 }
 
 void connectivity_matrix_get(connectivity_matrix_t *output) {
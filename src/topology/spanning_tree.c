@@ -1,9 +1,11 @@
 // src/topology/spanning_tree.c
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <limits.h>
 #include "tdma_types.h"
 #include "spanning_tree.h"
+#include "async_log.h"
 
 void spanning_tree_compute(connectivity_matrix_t *topo, spanning_tree_t *tree) {
     // Implementação de Prim (igual à da Ana)
@@ -59,7 +61,109 @@ void spanning_tree_compute(connectivity_matrix_t *topo, spanning_tree_t *tree) {
         }
     }
     
-    printf("[SPANNING TREE] Computed for %d nodes\n", tree->num_nodes);
+    LOG_DEBUG("[SPANNING TREE] Computed for %d nodes\n", tree->num_nodes);
+}
+
+// ========================================
+// Versão esparsa (topologia dinâmica)
+// ========================================
+
+typedef struct {
+    uint32_t key;
+    uint32_t node;
+    int32_t parent;
+} prim_item_t;
+
+// Ordem (key, node) = mesmo desempate do min-scan da versão densa
+static bool prim_less(const prim_item_t *a, const prim_item_t *b) {
+    return a->key < b->key || (a->key == b->key && a->node < b->node);
+}
+
+static void prim_push(prim_item_t *heap, uint32_t *size, prim_item_t item) {
+    uint32_t i = (*size)++;
+    heap[i] = item;
+    
+    while (i > 0) {
+        uint32_t p = (i - 1) / 2;
+        if (!prim_less(&heap[i], &heap[p])) break;
+        prim_item_t tmp = heap[p];
+        heap[p] = heap[i];
+        heap[i] = tmp;
+        i = p;
+    }
+}
+
+static prim_item_t prim_pop(prim_item_t *heap, uint32_t *size) {
+    prim_item_t top = heap[0];
+    heap[0] = heap[--(*size)];
+    
+    uint32_t i = 0;
+    while (true) {
+        uint32_t l = 2 * i + 1, r = l + 1, m = i;
+        if (l < *size && prim_less(&heap[l], &heap[m])) m = l;
+        if (r < *size && prim_less(&heap[r], &heap[m])) m = r;
+        if (m == i) break;
+        prim_item_t tmp = heap[m];
+        heap[m] = heap[i];
+        heap[i] = tmp;
+        i = m;
+    }
+    
+    return top;
+}
+
+int spanning_tree_compute_graph(const topology_graph_t *topo, int32_t *parent) {
+    uint32_t n = topo->num_nodes;
+    if (n == 0) return 0;
+    
+    bool *in_tree = calloc(n, sizeof(bool));
+    uint32_t *key = malloc(n * sizeof(uint32_t));
+    // Lazy deletion: no máximo uma entrada por aresta + raiz
+    prim_item_t *heap = malloc((topo->num_edges + 1) * sizeof(prim_item_t));
+    
+    if (!in_tree || !key || !heap) {
+        free(in_tree);
+        free(key);
+        free(heap);
+        return -1;
+    }
+    
+    for (uint32_t i = 0; i < n; i++) {
+        key[i] = UINT32_MAX;
+        parent[i] = -1;
+    }
+    
+    uint32_t size = 0;
+    key[0] = 0;
+    prim_push(heap, &size, (prim_item_t){0, 0, -1});
+    
+    while (size > 0) {
+        prim_item_t item = prim_pop(heap, &size);
+        uint32_t u = item.node;
+        
+        if (in_tree[u] || item.key != key[u]) continue;  // Entrada obsoleta
+        
+        in_tree[u] = true;
+        parent[u] = item.parent;
+        
+        const graph_adj_list_t *list = &topo->adj[u];
+        for (uint32_t e = 0; e < list->degree; e++) {
+            uint32_t v = list->edges[e].to;
+            uint32_t w = list->edges[e].weight;
+            
+            if (!in_tree[v] && w < key[v]) {
+                key[v] = w;
+                prim_push(heap, &size, (prim_item_t){w, v, (int32_t)u});
+            }
+        }
+    }
+    
+    free(in_tree);
+    free(key);
+    free(heap);
+    
+    LOG_DEBUG("[SPANNING TREE] Computed for %u nodes\n", n);
+    return 0;
 }
 
 void spanning_tree_print(spanning_tree_t *tree) {
@@ -0,0 +1,391 @@
+// src/topology/topology_graph.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "topology_graph.h"
+
+static uint64_t get_current_time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// ========================================
+// Gestão de memória
+// ========================================
+
+static int ensure_node_capacity(topology_graph_t *graph, uint32_t needed) {
+    if (needed <= graph->capacity) return 0;
+    
+    uint32_t new_cap = graph->capacity ? graph->capacity : 16;
+    while (new_cap < needed) new_cap *= 2;
+    
+    node_id_t *ids = realloc(graph->node_ids, new_cap * sizeof(node_id_t));
+    if (!ids) return -1;
+    graph->node_ids = ids;
+    
+    graph_adj_list_t *adj = realloc(graph->adj, new_cap * sizeof(graph_adj_list_t));
+    if (!adj) return -1;
+    memset(adj + graph->capacity, 0,
+           (new_cap - graph->capacity) * sizeof(graph_adj_list_t));
+    graph->adj = adj;
+    
+    graph->capacity = new_cap;
+    return 0;
+}
+
+static int ensure_index_map(topology_graph_t *graph, node_id_t id) {
+    if (id < graph->index_of_size) return 0;
+    
+    uint32_t new_size = graph->index_of_size ? graph->index_of_size : 64;
+    while (new_size <= id) new_size *= 2;
+    
+    int32_t *map = realloc(graph->index_of, new_size * sizeof(int32_t));
+    if (!map) return -1;
+    
+    for (uint32_t i = graph->index_of_size; i < new_size; i++) {
+        map[i] = -1;
+    }
+    
+    graph->index_of = map;
+    graph->index_of_size = new_size;
+    return 0;
+}
+
+static int ensure_degree_capacity(graph_adj_list_t *list, uint32_t needed) {
+    if (needed <= list->capacity) return 0;
+    
+    uint32_t new_cap = list->capacity ? list->capacity * 2 : 4;
+    while (new_cap < needed) new_cap *= 2;
+    
+    graph_edge_t *edges = realloc(list->edges, new_cap * sizeof(graph_edge_t));
+    if (!edges) return -1;
+    
+    list->edges = edges;
+    list->capacity = new_cap;
+    return 0;
+}
+
+// Procura binária: posição do vizinho 'to' (ou ponto de inserção)
+static uint32_t find_edge_pos(const graph_adj_list_t *list, uint32_t to) {
+    uint32_t lo = 0, hi = list->degree;
+    
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (list->edges[mid].to < to) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    
+    return lo;
+}
+
+// ========================================
+// Init/Destroy
+// ========================================
+
+int topology_graph_init(topology_graph_t *graph, uint32_t capacity) {
+    memset(graph, 0, sizeof(topology_graph_t));
+    
+    if (capacity > 0 && ensure_node_capacity(graph, capacity) < 0) {
+        return -1;
+    }
+    
+    graph->timestamp = get_current_time_ms();
+    return 0;
+}
+
+void topology_graph_destroy(topology_graph_t *graph) {
+    for (uint32_t i = 0; i < graph->capacity; i++) {
+        free(graph->adj[i].edges);
+    }
+    
+    free(graph->adj);
+    free(graph->node_ids);
+    free(graph->index_of);
+    
+    memset(graph, 0, sizeof(topology_graph_t));
+}
+
+void topology_graph_clear(topology_graph_t *graph) {
+    for (uint32_t i = 0; i < graph->num_nodes; i++) {
+        graph->adj[i].degree = 0;
+        graph->index_of[graph->node_ids[i]] = -1;
+    }
+    
+    graph->num_nodes = 0;
+    graph->num_edges = 0;
+    graph->timestamp = get_current_time_ms();
+}
+
+// ========================================
+// Nós e arestas
+// ========================================
+
+int topology_graph_add_node(topology_graph_t *graph, node_id_t id) {
+    if (id == NODE_ID_INVALID) return -1;
+    
+    int existing = topology_graph_index_of(graph, id);
+    if (existing != -1) return existing;
+    
+    if (graph->num_nodes >= MAX_NETWORK_NODES) {
+        fprintf(stderr, "[GRAPH] Node limit reached (%d)\n", MAX_NETWORK_NODES);
+        return -1;
+    }
+    
+    if (ensure_node_capacity(graph, graph->num_nodes + 1) < 0 ||
+        ensure_index_map(graph, id) < 0) {
+        fprintf(stderr, "[GRAPH] Out of memory adding node %d\n", id);
+        return -1;
+    }
+    
+    uint32_t idx = graph->num_nodes++;
+    graph->node_ids[idx] = id;
+    graph->adj[idx].degree = 0;
+    graph->index_of[id] = (int32_t)idx;
+    
+    return (int)idx;
+}
+
+int topology_graph_set_edge(topology_graph_t *graph, uint32_t from,
+                            uint32_t to, uint16_t weight) {
+    if (from >= graph->num_nodes || to >= graph->num_nodes) return -1;
+    
+    graph_adj_list_t *list = &graph->adj[from];
+    uint32_t pos = find_edge_pos(list, to);
+    bool exists = (pos < list->degree && list->edges[pos].to == to);
+    
+    if (weight == 0) {
+        if (exists) {
+            memmove(&list->edges[pos], &list->edges[pos + 1],
+                    (list->degree - pos - 1) * sizeof(graph_edge_t));
+            list->degree--;
+            graph->num_edges--;
+        }
+        return 0;
+    }
+    
+    if (exists) {
+        list->edges[pos].weight = weight;
+        return 0;
+    }
+    
+    if (ensure_degree_capacity(list, list->degree + 1) < 0) {
+        return -1;
+    }
+    
+    memmove(&list->edges[pos + 1], &list->edges[pos],
+            (list->degree - pos) * sizeof(graph_edge_t));
+    list->edges[pos].to = to;
+    list->edges[pos].weight = weight;
+    list->degree++;
+    graph->num_edges++;
+    
+    return 0;
+}
+
+uint16_t topology_graph_edge_weight(const topology_graph_t *graph,
+                                    uint32_t from, uint32_t to) {
+    if (from >= graph->num_nodes || to >= graph->num_nodes) return 0;
+    
+    const graph_adj_list_t *list = &graph->adj[from];
+    uint32_t pos = find_edge_pos(list, to);
+    
+    if (pos < list->degree && list->edges[pos].to == to) {
+        return list->edges[pos].weight;
+    }
+    return 0;
+}
+
+int topology_graph_set_link(topology_graph_t *graph, node_id_t a,
+                            node_id_t b, uint16_t weight) {
+    int ia = topology_graph_index_of(graph, a);
+    int ib = topology_graph_index_of(graph, b);
+    
+    if (ia == -1 || ib == -1 || ia == ib) return -1;
+    
+    if (topology_graph_set_edge(graph, ia, ib, weight) < 0 ||
+        topology_graph_set_edge(graph, ib, ia, weight) < 0) {
+        return -1;
+    }
+    
+    graph->timestamp = get_current_time_ms();
+    return 0;
+}
+
+uint16_t topology_graph_link_weight(const topology_graph_t *graph,
+                                    node_id_t a, node_id_t b) {
+    int ia = topology_graph_index_of(graph, a);
+    int ib = topology_graph_index_of(graph, b);
+    
+    if (ia == -1 || ib == -1) return 0;
+    return topology_graph_edge_weight(graph, ia, ib);
+}
+
+// ========================================
+// Cópia / comparação
+// ========================================
+
+int topology_graph_copy(topology_graph_t *dst, const topology_graph_t *src) {
+    topology_graph_clear(dst);
+    
+    if (ensure_node_capacity(dst, src->num_nodes) < 0) return -1;
+    
+    for (uint32_t i = 0; i < src->num_nodes; i++) {
+        if (topology_graph_add_node(dst, src->node_ids[i]) < 0) return -1;
+    }
+    
+    for (uint32_t i = 0; i < src->num_nodes; i++) {
+        const graph_adj_list_t *from = &src->adj[i];
+        graph_adj_list_t *to = &dst->adj[i];
+        
+        if (ensure_degree_capacity(to, from->degree) < 0) return -1;
+        
+        memcpy(to->edges, from->edges, from->degree * sizeof(graph_edge_t));
+        to->degree = from->degree;
+    }
+    
+    dst->num_edges = src->num_edges;
+    dst->timestamp = src->timestamp;
+    return 0;
+}
+
+bool topology_graph_equals(const topology_graph_t *a, const topology_graph_t *b) {
+    if (a->num_nodes != b->num_nodes) return false;
+    if (a->num_edges != b->num_edges) return false;
+    
+    // Compara campo a campo (graph_edge_t tem padding, memcmp não serve)
+    for (uint32_t i = 0; i < a->num_nodes; i++) {
+        if (a->node_ids[i] != b->node_ids[i]) return false;
+        if (a->adj[i].degree != b->adj[i].degree) return false;
+        
+        for (uint32_t e = 0; e < a->adj[i].degree; e++) {
+            if (a->adj[i].edges[e].to != b->adj[i].edges[e].to ||
+                a->adj[i].edges[e].weight != b->adj[i].edges[e].weight) {
+                return false;
+            }
+        }
+    }
+    
+    return true;
+}
+
+int topology_graph_diff(const topology_graph_t *old_graph,
+                        const topology_graph_t *new_graph,
+                        graph_link_change_t *changes,
+                        uint32_t max_changes) {
+    if (old_graph->num_nodes != new_graph->num_nodes) return -1;
+    
+    uint32_t count = 0;
+    
+    for (uint32_t i = 0; i < old_graph->num_nodes; i++) {
+        if (old_graph->node_ids[i] != new_graph->node_ids[i]) return -1;
+        
+        const graph_adj_list_t *lo = &old_graph->adj[i];
+        const graph_adj_list_t *ln = &new_graph->adj[i];
+        uint32_t p = 0, q = 0;
+        
+        // Merge das duas listas ordenadas
+        while (p < lo->degree || q < ln->degree) {
+            uint32_t to_old = p < lo->degree ? lo->edges[p].to : UINT32_MAX;
+            uint32_t to_new = q < ln->degree ? ln->edges[q].to : UINT32_MAX;
+            uint32_t to = to_old < to_new ? to_old : to_new;
+            uint16_t w_old = (to_old == to) ? lo->edges[p++].weight : 0;
+            uint16_t w_new = (to_new == to) ? ln->edges[q++].weight : 0;
+            
+            if (w_old == w_new) continue;
+            
+            // Links simétricos: a aresta inversa tem de ter mudado igual
+            if (topology_graph_edge_weight(old_graph, to, i) != w_old ||
+                topology_graph_edge_weight(new_graph, to, i) != w_new) {
+                return -1;
+            }
+            
+            if (to < i) continue;  // Já contado a partir de 'to'
+            
+            if (count == max_changes) return -1;
+            changes[count++] = (graph_link_change_t){ i, to, w_old, w_new };
+        }
+    }
+    
+    return (int)count;
+}
+
+// ========================================
+// Conversões
+// ========================================
+
+int topology_graph_from_matrix(topology_graph_t *graph,
+                               const connectivity_matrix_t *matrix) {
+    topology_graph_clear(graph);
+    
+    for (int i = 0; i < matrix->num_nodes; i++) {
+        if (topology_graph_add_node(graph, matrix->node_ids[i]) < 0) return -1;
+    }
+    
+    for (int i = 0; i < matrix->num_nodes; i++) {
+        for (int j = 0; j < matrix->num_nodes; j++) {
+            if (i != j && matrix->matrix[i][j]) {
+                if (topology_graph_set_edge(graph, i, j, matrix->matrix[i][j]) < 0) {
+                    return -1;
+                }
+            }
+        }
+    }
+    
+    graph->timestamp = matrix->timestamp;
+    return 0;
+}
+
+int topology_graph_full_mesh(topology_graph_t *graph, uint32_t num_nodes) {
+    return topology_graph_full_mesh_weighted(graph, num_nodes, 1);
+}
+
+int topology_graph_full_mesh_weighted(topology_graph_t *graph, uint32_t num_nodes,
+                                      uint16_t weight) {
+    if (weight == 0) return -1;
+    
+    topology_graph_clear(graph);
+    
+    for (uint32_t i = 0; i < num_nodes; i++) {
+        if (topology_graph_add_node(graph, (node_id_t)(i + 1)) < 0) return -1;
+    }
+    
+    for (uint32_t i = 0; i < num_nodes; i++) {
+        graph_adj_list_t *list = &graph->adj[i];
+        
+        if (ensure_degree_capacity(list, num_nodes - 1) < 0) return -1;
+        
+        // Já ordenado por índice: append direto
+        list->degree = 0;
+        for (uint32_t j = 0; j < num_nodes; j++) {
+            if (j == i) continue;
+            list->edges[list->degree].to = j;
+            list->edges[list->degree].weight = weight;
+            list->degree++;
+        }
+        graph->num_edges += list->degree;
+    }
+    
+    graph->timestamp = get_current_time_ms();
+    return 0;
+}
+
+void topology_graph_print(const topology_graph_t *graph) {
+    printf("\n=== Topology Graph ===\n");
+    printf("Nodes: %u | Links: %u\n\n", graph->num_nodes, graph->num_edges / 2);
+    
+    for (uint32_t i = 0; i < graph->num_nodes; i++) {
+        printf("%4d:", graph->node_ids[i]);
+        for (uint32_t e = 0; e < graph->adj[i].degree; e++) {
+            const graph_edge_t *edge = &graph->adj[i].edges[e];
+            printf(" %d", graph->node_ids[edge->to]);
+            if (edge->weight != 1) printf("(%u)", edge->weight);
+        }
+        printf("\n");
+    }
+    printf("\n");
+}
@@ -0,0 +1,242 @@
+// tests/test_async_log.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include "async_log.h"
+
+#define THREADS 4
+#define PER_THREAD 200          // Cabe num anel mesmo que as threads o partilhem em sequência
+
+static FILE *sink;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// Conteúdo atual do sink (o chamador liberta)
+static char *read_sink(void) {
+    fflush(sink);
+    long size = ftell(sink);
+    char *text = malloc(size + 1);
+    rewind(sink);
+    assert(fread(text, 1, size, sink) == (size_t)size);
+    text[size] = '\0';
+    fseek(sink, 0, SEEK_END);
+    return text;
+}
+
+static void reset_sink(void) {
+    assert(ftruncate(fileno(sink), 0) == 0);
+    rewind(sink);
+}
+
+void test_format(void) {
+    printf("\n=== Test: Deferred Formatting Matches printf ===\n");
+    
+    const uint64_t args[] = {
+        (uint64_t)-42, 4096, 18446744073709551615ULL,
+        async_log_arg_double(3.14159), async_log_arg_ptr("abc"), 255, 'z'
+    };
+    char out[256], expected[256];
+    
+    async_log_format(out, sizeof(out), "%d|%5u|%lu|%.2f|%-5s|%#x|%c|100%%\n", 7, args);
+    snprintf(expected, sizeof(expected), "%d|%5u|%lu|%.2f|%-5s|%#x|%c|100%%\n",
+             -42, 4096u, 18446744073709551615UL, 3.14159, "abc", 255u, 'z');
+    assert(strcmp(out, expected) == 0);
+    
+    // Argumentos em falta e buffers curtos não saem dos limites
+    async_log_format(out, sizeof(out), "%s and %ld", 0, args);
+    assert(strcmp(out, "(null) and 0") == 0);
+    async_log_format(out, 8, "node %d says hello", 1, args);
+    assert(strcmp(out, "node -4") == 0);
+    
+    printf("✓ Test passed\n");
+}
+
+void test_compile_time_filter(void) {
+    printf("\n=== Test: Compile-Time Level Filtering ===\n");
+    
+    async_log_stats_t before, after;
+    async_log_get_stats(&before);
+    
+    // Acima de ASYNC_LOG_LEVEL: nem os argumentos são avaliados
+    int evaluated = 0;
+    LOG_DEBUG("[TEST] debug %d\n", ++evaluated);
+    assert(evaluated == 0);
+    
+    // Sem logger a correr: síncrono, como printf
+    LOG_INFO("[TEST] synchronous %d %s\n", 1, "line");
+    async_log_get_stats(&after);
+    assert(after.synchronous == before.synchronous + 1);
+    assert(after.written == before.written);
+    
+    printf("✓ Test passed\n");
+}
+
+static void *producer(void *arg) {
+    int id = (int)(intptr_t)arg;
+    for (int i = 0; i < PER_THREAD; i++) {
+        LOG_INFO("T%d %d %.1f\n", id, i, i / 2.0);
+    }
+    return NULL;
+}
+
+void test_threads(void) {
+    printf("\n=== Test: %d Producer Threads Through the Rings ===\n", THREADS);
+    
+    reset_sink();
+    assert(async_log_start(sink) == 0);
+    assert(async_log_start(sink) == -1);
+    assert(async_log_running());
+    
+    pthread_t threads[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+        assert(pthread_create(&threads[i], NULL, producer, (void *)(intptr_t)i) == 0);
+    }
+    for (int i = 0; i < THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    async_log_flush();
+    
+    // Todas as linhas, e por ordem dentro de cada thread
+    char *text = read_sink();
+    int next[THREADS] = {0};
+    int lines = 0;
+    
+    for (char *line = strtok(text, "\n"); line; line = strtok(NULL, "\n")) {
+        int id, seq;
+        double half;
+        assert(sscanf(line, "T%d %d %lf", &id, &seq, &half) == 3);
+        assert(id >= 0 && id < THREADS);
+        assert(seq == next[id]++);
+        assert(half == seq / 2.0);
+        lines++;
+    }
+    free(text);
+    assert(lines == THREADS * PER_THREAD);
+    
+    async_log_stats_t stats;
+    async_log_get_stats(&stats);
+    assert(stats.dropped == 0);
+    assert(stats.drained == stats.written);
+    printf("%lu records in %lu write passes\n", stats.drained, stats.flushes);
+    
+    printf("✓ Test passed\n");
+}
+
+void test_overflow_and_stop(void) {
+    printf("\n=== Test: Full Ring Drops Instead of Blocking ===\n");
+    
+    reset_sink();
+    async_log_stats_t before, after;
+    async_log_get_stats(&before);
+    
+    int attempts = 4 * ASYNC_LOG_RING_SIZE;
+    uint64_t start = now_ns();
+    for (int i = 0; i < attempts; i++) {
+        LOG_INFO("burst %d\n", i);
+    }
+    uint64_t elapsed = now_ns() - start;
+    printf("%d LOG_INFO calls: %.1f ns each\n", attempts, (double)elapsed / attempts);
+    
+    async_log_get_stats(&after);
+    uint64_t written = after.written - before.written;
+    uint64_t dropped = after.dropped - before.dropped;
+    assert(written + dropped == (uint64_t)attempts);
+    assert(written >= ASYNC_LOG_RING_SIZE);
+    
+    // O stop escoa o resto; depois disso o LOG_* volta a ser síncrono
+    async_log_stop();
+    assert(!async_log_running());
+    LOG_INFO("after stop\n");
+    
+    async_log_get_stats(&after);
+    assert(after.drained == after.written);
+    
+    char *text = read_sink();
+    int lines = 0;
+    for (char *p = text; (p = strstr(p, "burst ")); p++) lines++;
+    assert((uint64_t)lines == written);
+    assert(strstr(text, "after stop\n") != NULL);
+    free(text);
+    
+    printf("✓ Test passed\n");
+}
+
+static atomic_bool producers_done;
+
+static void *racing_producer(void *arg) {
+    int id = (int)(intptr_t)arg;
+    long count = 0;
+    while (!atomic_load(&producers_done)) {
+        LOG_INFO("race %d %ld\n", id, count);
+        count++;
+    }
+    return (void *)count;
+}
+
+void test_stop_while_logging(void) {
+    printf("\n=== Test: Stop While Producers Keep Logging ===\n");
+    
+    reset_sink();
+    async_log_stats_t before, after;
+    async_log_get_stats(&before);
+    
+    assert(async_log_start(sink) == 0);
+    atomic_store(&producers_done, false);
+    
+    pthread_t threads[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+        assert(pthread_create(&threads[i], NULL, racing_producer, (void *)(intptr_t)i) == 0);
+    }
+    
+    // Os produtores atravessam o stop: antes vão para os anéis, depois são síncronos
+    usleep(20000);
+    async_log_stop();
+    usleep(5000);
+    atomic_store(&producers_done, true);
+    
+    long logged = 0;
+    for (int i = 0; i < THREADS; i++) {
+        void *count;
+        pthread_join(threads[i], &count);
+        logged += (long)count;
+    }
+    
+    async_log_get_stats(&after);
+    uint64_t dropped = after.dropped - before.dropped;
+    assert(after.drained == after.written);
+    assert(after.synchronous > before.synchronous);
+    
+    // Cada chamada aceite chega ao sink: nenhum registo fica preso num anel
+    char *text = read_sink();
+    long lines = 0;
+    for (char *p = text; (p = strstr(p, "race ")); p++) lines++;
+    free(text);
+    printf("%ld records logged, %lu dropped on full rings\n", logged, dropped);
+    assert((uint64_t)lines + dropped == (uint64_t)logged);
+    
+    printf("✓ Test passed\n");
+}
+
+int main(void) {
+    sink = tmpfile();
+    assert(sink != NULL);
+    
+    test_format();
+    test_compile_time_filter();
+    test_threads();
+    test_overflow_and_stop();
+    test_stop_while_logging();
+    
+    fclose(sink);
+    printf("\n=== All async log tests passed ===\n");
+    return 0;
+}
@@ -0,0 +1,188 @@
+// tests/test_bfs_bitset.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <time.h>
+#include "tdma_types.h"
+#include "connectivity_matrix.h"
+#include "dijkstra.h"
+#include "bfs_bitset.h"
+#include "routing_manager.h"
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// Compara BFS em bitset com Dijkstra para todos os sources
+static void assert_same_as_dijkstra(connectivity_matrix_t *topo) {
+    for (int s = 0; s < topo->num_nodes; s++) {
+        node_id_t src = topo->node_ids[s];
+        
+        dijkstra_result_t expected[MAX_NODES] = {0};
+        dijkstra_result_t actual[MAX_NODES] = {0};
+        
+        assert(dijkstra_compute(src, topo, expected) == 0);
+        assert(bfs_bitset_compute_matrix(src, topo, actual) == 0);
+        
+        for (int i = 0; i < topo->num_nodes; i++) {
+            assert(actual[i].destination == expected[i].destination);
+            assert(actual[i].reachable == expected[i].reachable);
+            assert(actual[i].distance == expected[i].distance);
+            assert(actual[i].next_hop == expected[i].next_hop);
+        }
+    }
+}
+
+void test_bitset_line_topology(void) {
+    printf("\n=== Test: Bitset BFS on Line Topology ===\n");
+    
+    // Topology: 1 -- 2 -- 3 -- 4
+    uint8_t matrix[MAX_NODES][MAX_NODES] = {0};
+    matrix[0][1] = matrix[1][0] = 1;
+    matrix[1][2] = matrix[2][1] = 1;
+    matrix[2][3] = matrix[3][2] = 1;
+    
+    node_id_t nodes[] = {1, 2, 3, 4};
+    
+    connectivity_matrix_init();
+    connectivity_matrix_set_topology(matrix, nodes, 4);
+    
+    connectivity_matrix_t topo;
+    connectivity_matrix_get(&topo);
+    
+    dijkstra_result_t results[MAX_NODES] = {0};
+    assert(bfs_bitset_compute_matrix(1, &topo, results) == 0);
+    
+    dijkstra_print_results(1, results, 4);
+    
+    assert(results[3].destination == 4);
+    assert(results[3].next_hop == 2);
+    assert(results[3].distance == 3);
+    assert(results[3].reachable == true);
+    
+    assert_same_as_dijkstra(&topo);
+    
+    printf("✓ Test passed\n");
+}
+
+void test_bitset_disconnected(void) {
+    printf("\n=== Test: Bitset BFS with Disconnected Nodes ===\n");
+    
+    // Topology: 1 -- 2    3 -- 4  (two islands)
+    uint8_t matrix[MAX_NODES][MAX_NODES] = {0};
+    matrix[0][1] = matrix[1][0] = 1;
+    matrix[2][3] = matrix[3][2] = 1;
+    
+    node_id_t nodes[] = {1, 2, 3, 4};
+    
+    connectivity_matrix_set_topology(matrix, nodes, 4);
+    connectivity_matrix_t topo;
+    connectivity_matrix_get(&topo);
+    
+    dijkstra_result_t results[MAX_NODES] = {0};
+    assert(bfs_bitset_compute_matrix(1, &topo, results) == 0);
+    
+    assert(results[1].reachable == true);
+    assert(results[2].reachable == false);
+    assert(results[3].reachable == false);
+    assert(results[3].next_hop == NODE_ID_INVALID);
+    
+    // Source inexistente
+    assert(bfs_bitset_compute_matrix(99, &topo, results) == -1);
+    
+    printf("✓ Test passed\n");
+}
+
+void test_bitset_random_equivalence(void) {
+    printf("\n=== Test: Bitset BFS == Dijkstra on Random Topologies ===\n");
+    
+    srand(12345);
+    uint64_t t_dijkstra = 0, t_bitset = 0;
+    
+    for (int round = 0; round < 200; round++) {
+        uint8_t matrix[MAX_NODES][MAX_NODES] = {0};
+        node_id_t nodes[MAX_NODES];
+        int n = 2 + rand() % (MAX_NODES - 1);
+        int density = 10 + rand() % 60;  // % de links
+        
+        for (int i = 0; i < n; i++) {
+            nodes[i] = i + 1;
+            for (int j = i + 1; j < n; j++) {
+                if (rand() % 100 < density) {
+                    matrix[i][j] = matrix[j][i] = 1;
+                }
+            }
+        }
+        
+        connectivity_matrix_t topo;
+        memset(&topo, 0, sizeof(topo));
+        memcpy(topo.matrix, matrix, sizeof(matrix));
+        memcpy(topo.node_ids, nodes, sizeof(nodes));
+        topo.num_nodes = n;
+        
+        assert_same_as_dijkstra(&topo);
+        
+        dijkstra_result_t results[MAX_NODES];
+        uint64_t t0 = now_ns();
+        dijkstra_compute(1, &topo, results);
+        uint64_t t1 = now_ns();
+        bfs_bitset_compute_matrix(1, &topo, results);
+        uint64_t t2 = now_ns();
+        
+        t_dijkstra += t1 - t0;
+        t_bitset += t2 - t1;
+    }
+    
+    printf("Dijkstra total:   %lu ns\n", t_dijkstra);
+    printf("Bitset BFS total: %lu ns (inclui conversão)\n", t_bitset);
+    printf("✓ Test passed - 200 random topologies match\n");
+}
+
+void test_routing_manager_bitset_engine(void) {
+    printf("\n=== Test: Routing Manager with Bitset Engine ===\n");
+    
+    // Diamond topology
+    uint8_t matrix[MAX_NODES][MAX_NODES] = {0};
+    matrix[0][1] = matrix[1][0] = 1;  // 1-2
+    matrix[0][2] = matrix[2][0] = 1;  // 1-3
+    matrix[1][3] = matrix[3][1] = 1;  // 2-4
+    matrix[2][3] = matrix[3][2] = 1;  // 3-4
+    
+    node_id_t nodes[] = {1, 2, 3, 4};
+    
+    connectivity_matrix_set_topology(matrix, nodes, 4);
+    connectivity_matrix_t topo;
+    connectivity_matrix_get(&topo);
+    
+    routing_manager_t rm;
+    routing_manager_init(&rm, 1, ROUTING_STRATEGY_DIJKSTRA);
+    routing_manager_set_path_engine(&rm, PATH_ENGINE_BITSET_BFS);
+    routing_manager_update_topology(&rm, &topo);
+    
+    assert(routing_manager_get_next_hop(&rm, 4) == 2);
+    
+    // Falha do link 1-2: deve passar por 3
+    matrix[0][1] = matrix[1][0] = 0;
+    connectivity_matrix_set_topology(matrix, nodes, 4);
+    connectivity_matrix_get(&topo);
+    routing_manager_update_topology(&rm, &topo);
+    
+    assert(routing_manager_get_next_hop(&rm, 4) == 3);
+    assert(routing_manager_get_next_hop(&rm, 2) == 3);
+    
+    routing_manager_destroy(&rm);
+    printf("✓ Test passed\n");
+}
+
+int main(void) {
+    test_bitset_line_topology();
+    test_bitset_disconnected();
+    test_bitset_random_equivalence();
+    test_routing_manager_bitset_engine();
+    
+    printf("\n=== All Bitset BFS tests passed ===\n");
+    return 0;
+}
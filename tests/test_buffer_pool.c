@@ -0,0 +1,160 @@
+// tests/test_buffer_pool.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include "buffer_pool.h"
+
+#define POOL_COUNT 32
+#define STRESS_THREADS 4
+#define STRESS_ITERATIONS 100000
+
+void test_exhaust_and_reuse() {
+    printf("Test: Get until exhausted, put and reuse...\n");
+
+    buffer_pool_t pool;
+    assert(buffer_pool_init(&pool, POOL_COUNT, 1500) == 0);
+    assert(pool.buf_size == BUFFER_POOL_BUF_SIZE);
+
+    uint8_t *bufs[POOL_COUNT];
+    for (int i = 0; i < POOL_COUNT; i++) {
+        bufs[i] = buffer_pool_get(&pool);
+        assert(bufs[i] != NULL);
+        assert(buffer_pool_owns(&pool, bufs[i]));
+        memset(bufs[i], i, pool.buf_size);   // Sem sobreposição entre buffers
+    }
+    assert(buffer_pool_get(&pool) == NULL);
+    assert(pool.alloc_failures == 1);
+    assert(pool.in_use == POOL_COUNT);
+
+    for (int i = 0; i < POOL_COUNT; i++) {
+        for (uint32_t j = 0; j < pool.buf_size; j++) {
+            assert(bufs[i][j] == (uint8_t)i);
+        }
+    }
+
+    buffer_pool_put(&pool, bufs[7]);
+    uint8_t *again = buffer_pool_get(&pool);
+    assert(again == bufs[7]);
+
+    for (int i = 0; i < POOL_COUNT; i++) {
+        buffer_pool_put(&pool, bufs[i]);
+    }
+    assert(pool.in_use == 0);
+    assert(pool.high_water == POOL_COUNT);
+
+    buffer_pool_destroy(&pool);
+    printf("✓ Test passed\n\n");
+}
+
+void test_alloc_fallback() {
+    printf("Test: alloc/release fall back to malloc...\n");
+
+    buffer_pool_t pool;
+    assert(buffer_pool_init(&pool, 1, BUFFER_POOL_BUF_SIZE) == 0);
+
+    uint8_t *small = buffer_pool_alloc(&pool, 100);
+    assert(buffer_pool_owns(&pool, small));
+
+    // Pool esgotado: malloc
+    uint8_t *spill = buffer_pool_alloc(&pool, 100);
+    assert(spill && !buffer_pool_owns(&pool, spill));
+
+    // Maior que um buffer: malloc
+    uint8_t *big = buffer_pool_alloc(&pool, 4 * BUFFER_POOL_BUF_SIZE);
+    assert(big && !buffer_pool_owns(&pool, big));
+    memset(big, 0xAB, 4 * BUFFER_POOL_BUF_SIZE);
+
+    // Sem pool: malloc
+    uint8_t *plain = buffer_pool_alloc(NULL, 64);
+    assert(plain && !buffer_pool_owns(NULL, plain));
+
+    buffer_pool_release(&pool, small);
+    buffer_pool_release(&pool, spill);
+    buffer_pool_release(&pool, big);
+    buffer_pool_release(NULL, plain);
+    assert(pool.in_use == 0);
+
+    buffer_pool_destroy(&pool);
+    printf("✓ Test passed\n\n");
+}
+
+typedef struct {
+    buffer_pool_t *pool;
+    int id;
+    int got;
+} stress_arg_t;
+
+static void *stress_worker(void *arg) {
+    stress_arg_t *a = arg;
+    uint8_t *held[4];
+
+    for (int i = 0; i < STRESS_ITERATIONS; i++) {
+        int n = 0;
+        for (int k = 0; k < 4; k++) {
+            held[n] = buffer_pool_get(a->pool);
+            if (held[n]) {
+                // Marca o buffer; outro thread não o pode ter ao mesmo tempo
+                memset(held[n], a->id, 16);
+                n++;
+            }
+        }
+        for (int k = 0; k < n; k++) {
+            for (int j = 0; j < 16; j++) {
+                assert(held[k][j] == (uint8_t)a->id);
+            }
+            buffer_pool_put(a->pool, held[k]);
+        }
+        a->got += n;
+    }
+    return NULL;
+}
+
+void test_concurrent_get_put() {
+    printf("Test: Concurrent get/put from %d threads...\n", STRESS_THREADS);
+
+    buffer_pool_t pool;
+    assert(buffer_pool_init(&pool, 12, BUFFER_POOL_BUF_SIZE) == 0);
+
+    pthread_t threads[STRESS_THREADS];
+    stress_arg_t args[STRESS_THREADS];
+    for (int t = 0; t < STRESS_THREADS; t++) {
+        args[t] = (stress_arg_t){ .pool = &pool, .id = t + 1, .got = 0 };
+        pthread_create(&threads[t], NULL, stress_worker, &args[t]);
+    }
+
+    uint64_t total = 0;
+    for (int t = 0; t < STRESS_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+        total += args[t].got;
+    }
+
+    assert(pool.in_use == 0);
+    assert(pool.high_water <= 12);
+    assert(pool.allocs == total);
+
+    // Todos os buffers voltaram à free list
+    uint8_t *bufs[12];
+    for (int i = 0; i < 12; i++) {
+        bufs[i] = buffer_pool_get(&pool);
+        assert(bufs[i] != NULL);
+        for (int j = 0; j < i; j++) {
+            assert(bufs[i] != bufs[j]);
+        }
+    }
+    assert(buffer_pool_get(&pool) == NULL);
+
+    buffer_pool_print_stats(&pool);
+    buffer_pool_destroy(&pool);
+    printf("✓ Test passed\n\n");
+}
+
+int main() {
+    test_exhaust_and_reuse();
+    test_alloc_fallback();
+    test_concurrent_get_put();
+
+    printf("\n=== All buffer pool tests passed ===\n");
+    return 0;
+}
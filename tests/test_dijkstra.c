@@ -5,6 +5,7 @@
 #include "tdma_types.h"
 #include "connectivity_matrix.h"
 #include "dijkstra.h"
+#include "topology_graph.h"
 
 void test_dijkstra_line_topology(void) {
     printf("\n=== Test: Dijkstra on Line Topology ===\n");
@@ -169,11 +170,67 @@ void test_dijkstra_disconnected(void) {
     printf("✓ Test passed - Correctly identified unreachable nodes\n");
 }
 
+void test_dijkstra_weighted(void) {
+    printf("\n=== Test: Weighted Dijkstra (Link Costs) ===\n");
+    
+    // Topology (custos nos links):
+    //       1
+    //    1 / \ 10
+    //     2   3
+    //    1 \ / 1
+    //       4 --- 5 (1)
+    
+    topology_graph_t graph;
+    topology_graph_init(&graph, 5);
+    for (node_id_t id = 1; id <= 5; id++) {
+        topology_graph_add_node(&graph, id);
+    }
+    topology_graph_set_link(&graph, 1, 2, 1);
+    topology_graph_set_link(&graph, 1, 3, 10);
+    topology_graph_set_link(&graph, 2, 4, 1);
+    topology_graph_set_link(&graph, 3, 4, 1);
+    topology_graph_set_link(&graph, 4, 5, 1);
+    
+    dijkstra_result_t results[MAX_NODES] = {0};
+    assert(dijkstra_compute_weighted(1, &graph, results) == 0);
+    dijkstra_print_results(1, results, 5);
+    
+    // 1 -> 3: link direto custa 10, via 2-4 custa 3 (3 hops)
+    assert(results[2].next_hop == 2);
+    assert(results[2].cost == 3);
+    assert(results[2].distance == 3);
+    
+    assert(results[4].next_hop == 2);
+    assert(results[4].cost == 3);
+    
+    // Link 1-3 fica barato: passa a ser o melhor
+    topology_graph_set_link(&graph, 1, 3, 2);
+    assert(dijkstra_compute_weighted(1, &graph, results) == 0);
+    assert(results[2].next_hop == 3);
+    assert(results[2].cost == 2);
+    assert(results[2].distance == 1);
+    
+    // Pesos unitários → igual ao Dijkstra por hop count
+    topology_graph_set_link(&graph, 1, 3, 1);
+    dijkstra_result_t hop_results[5] = {0};
+    assert(dijkstra_compute_weighted(1, &graph, results) == 0);
+    assert(dijkstra_compute_graph(1, &graph, hop_results) == 0);
+    for (int i = 0; i < 5; i++) {
+        assert(results[i].next_hop == hop_results[i].next_hop);
+        assert(results[i].distance == hop_results[i].distance);
+        assert(results[i].cost == hop_results[i].cost);
+    }
+    
+    topology_graph_destroy(&graph);
+    printf("✓ Test passed\n");
+}
+
 int main(void) {
     test_dijkstra_line_topology();
     test_dijkstra_diamond_topology();
     test_dijkstra_link_failure();
     test_dijkstra_disconnected();
+    test_dijkstra_weighted();
     
     printf("\n=== All Dijkstra tests passed ===\n");
     return 0;
@@ -0,0 +1,186 @@
+// tests/test_frame_generator.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include <time.h>
+#include "frame_generator.h"
+
+#define BUF_SIZE (256 * 1024)
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void test_deterministic_seed(void) {
+    printf("\n=== Test: Same Seed → Same Frames ===\n");
+    
+    frame_model_t model;
+    frame_model_default(&model);
+    
+    static frame_generator_t a, b, c;
+    assert(frame_generator_init(&a, &model) == 0);
+    assert(frame_generator_init(&b, &model) == 0);
+    model.seed++;
+    assert(frame_generator_init(&c, &model) == 0);
+    
+    static uint8_t fa[BUF_SIZE], fb[BUF_SIZE], fc[BUF_SIZE];
+    uint32_t max_size = frame_generator_max_frame_size(&a);
+    assert(max_size <= BUF_SIZE);
+    
+    for (int i = 0; i < 60; i++) {
+        int sa = frame_generator_next_video(&a, fa, max_size, NULL);
+        int sb = frame_generator_next_video(&b, fb, max_size, NULL);
+        int sc = frame_generator_next_video(&c, fc, max_size, NULL);
+        assert(sa == sb && sa > FRAME_GEN_HEADER_SIZE);
+        
+        // O timestamp (bytes 4-11) é o único campo que não vem da seed
+        assert(memcmp(fa, fb, 4) == 0);
+        assert(memcmp(fa + 12, fb + 12, sa - 12) == 0);
+        
+        int common = sa < sc ? sa : sc;
+        assert(memcmp(fa + FRAME_GEN_HEADER_SIZE, fc + FRAME_GEN_HEADER_SIZE,
+                      common - FRAME_GEN_HEADER_SIZE) != 0);
+    }
+    
+    printf("✓ Test passed\n");
+}
+
+void test_gop_structure(void) {
+    printf("\n=== Test: I-Frame Every GOP, Header Layout ===\n");
+    
+    frame_model_t model;
+    frame_model_default(&model);
+    model.gop_size = 10;
+    
+    static frame_generator_t gen;
+    assert(frame_generator_init(&gen, &model) == 0);
+    assert(gen.i_frame_size == gen.p_frame_size * model.i_to_p_ratio);
+    
+    static uint8_t frame[BUF_SIZE];
+    uint32_t max_size = frame_generator_max_frame_size(&gen);
+    
+    for (uint32_t i = 0; i < 50; i++) {
+        bool iframe;
+        int size = frame_generator_next_video(&gen, frame, max_size, &iframe);
+        assert(iframe == (i % model.gop_size == 0));
+        
+        assert(memcmp(frame, "VID", 3) == 0);
+        assert(frame[3] == (iframe ? 'I' : 'P'));
+        
+        uint32_t counter;
+        memcpy(&counter, frame + 12, sizeof(counter));
+        assert(counter == i);
+        
+        // Tamanho dentro de ±FRAME_GEN_SIZE_JITTER % do nominal
+        uint32_t base = iframe ? gen.i_frame_size : gen.p_frame_size;
+        assert((uint32_t)size >= base * (100 - FRAME_GEN_SIZE_JITTER) / 100);
+        assert((uint32_t)size <= base * (100 + FRAME_GEN_SIZE_JITTER) / 100 + 1);
+    }
+    
+    // Buffer pequeno: o frame é truncado, nunca ultrapassa max_size
+    assert(frame_generator_next_video(&gen, frame, 100, NULL) == 100);
+    assert(frame_generator_next_video(&gen, frame, FRAME_GEN_HEADER_SIZE - 1, NULL) == -1);
+    
+    model.gop_size = 0;
+    assert(frame_generator_init(&gen, &model) == -1);
+    
+    printf("✓ Test passed\n");
+}
+
+void test_average_bitrate(void) {
+    printf("\n=== Test: Average Bitrate Matches Model ===\n");
+    
+    frame_model_t model;
+    frame_model_default(&model);
+    
+    static frame_generator_t gen;
+    assert(frame_generator_init(&gen, &model) == 0);
+    
+    static uint8_t frame[BUF_SIZE];
+    uint32_t max_size = frame_generator_max_frame_size(&gen);
+    
+    // 100 GOPs de 1 segundo
+    uint32_t frames = 100 * model.gop_size;
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < frames; i++) {
+        total += frame_generator_next_video(&gen, frame, max_size, NULL);
+    }
+    
+    double bitrate = total * 8.0 * model.fps / frames;
+    printf("Model %.2f Mbps → generated %.2f Mbps\n",
+           model.bitrate_bps / 1e6, bitrate / 1e6);
+    assert(fabs(bitrate - model.bitrate_bps) < model.bitrate_bps * 0.02);
+    
+    printf("✓ Test passed\n");
+}
+
+void test_audio_waveform(void) {
+    printf("\n=== Test: Audio Chunk Waveform ===\n");
+    
+    frame_model_t model;
+    frame_model_default(&model);
+    
+    static frame_generator_t gen;
+    assert(frame_generator_init(&gen, &model) == 0);
+    
+    uint8_t chunk[1024];
+    for (uint32_t n = 0; n < 3; n++) {
+        assert(frame_generator_audio(&gen, chunk, sizeof(chunk)) == (int)sizeof(chunk));
+        assert(memcmp(chunk, "AUD", 3) == 0 && chunk[3] == 0xFF);
+        
+        uint32_t counter;
+        memcpy(&counter, chunk + 12, sizeof(counter));
+        assert(counter == n);
+        
+        for (uint32_t i = FRAME_GEN_HEADER_SIZE; i < sizeof(chunk); i++) {
+            assert(chunk[i] == (uint8_t)(128 + 127 * sin(i * 0.1)));
+        }
+    }
+    
+    printf("✓ Test passed\n");
+}
+
+void test_fill_throughput(void) {
+    printf("\n=== Test: Fill Throughput ===\n");
+    
+    frame_model_t model;
+    frame_model_default(&model);
+    
+    static frame_generator_t gen;
+    assert(frame_generator_init(&gen, &model) == 0);
+    
+    static uint8_t buf[BUF_SIZE];
+    const int rounds = 2000;
+    
+    double start = now_sec();
+    for (int i = 0; i < rounds; i++) {
+        frame_generator_fill(&gen, buf, sizeof(buf) - i % 31);
+    }
+    double elapsed = now_sec() - start;
+    
+    // Bytes não ficam todos iguais (a cauda também é preenchida)
+    int histogram[256] = {0};
+    for (uint32_t i = 0; i < sizeof(buf); i++) histogram[buf[i]]++;
+    for (int v = 0; v < 256; v++) assert(histogram[v] > 0);
+    
+    printf("Filled %.0f MB in %.3f s (%.0f MB/s)\n",
+           rounds * (double)sizeof(buf) / 1e6, elapsed,
+           rounds * (double)sizeof(buf) / 1e6 / elapsed);
+    
+    printf("✓ Test passed\n");
+}
+
+int main(void) {
+    test_deterministic_seed();
+    test_gop_structure();
+    test_average_bitrate();
+    test_audio_waveform();
+    test_fill_throughput();
+    
+    printf("\n=== All frame generator tests passed ===\n");
+    return 0;
+}
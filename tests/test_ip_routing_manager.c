@@ -0,0 +1,115 @@
+// tests/test_ip_routing_manager.c
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include "ip_routing_manager.h"
+
+// Rotas 192.168.2.x programadas em loopback (gateways onlink)
+#define TEST_IFACE "lo"
+#define NUM_NODES 4
+
+static int count_ctx_ifindex;
+
+static void count_route(const nl_route_info_t *route, void *ctx) {
+    if (route->ifindex == count_ctx_ifindex && route->protocol == NL_ROUTE_PROTO) {
+        (*(int *)ctx)++;
+    }
+}
+
+// Rotas NL_ROUTE_PROTO instaladas no kernel em TEST_IFACE
+static int kernel_routes(nl_route_t *nl) {
+    int count = 0;
+    count_ctx_ifindex = nl->ifindex;
+    assert(nl_route_dump(nl, count_route, &count) >= 0);
+    return count;
+}
+
+static in_addr_t node_addr(node_id_t id) {
+    char ip[16];
+    node_id_to_ip_str(id, ip);
+    return inet_addr(ip);
+}
+
+void test_diff_sync(nl_route_t *probe) {
+    printf("\n=== Test: Diff-Based Sync with Kernel Mirror ===\n");
+    
+    // Restos de uma execução anterior: rota válida + rota fora da rede
+    assert(nl_route_apply(probe, NL_ROUTE_REPLACE, node_addr(3), node_addr(2), 2) == 0);
+    assert(nl_route_apply(probe, NL_ROUTE_REPLACE, node_addr(50), node_addr(2), 2) == 0);
+    
+    // Linha 1 - 2 - 3 - 4
+    topology_graph_t graph;
+    assert(topology_graph_init(&graph, NUM_NODES) == 0);
+    for (node_id_t id = 1; id <= NUM_NODES; id++) topology_graph_add_node(&graph, id);
+    topology_graph_set_link(&graph, 1, 2, 1);
+    topology_graph_set_link(&graph, 2, 3, 1);
+    topology_graph_set_link(&graph, 3, 4, 1);
+    
+    routing_manager_t rm;
+    routing_manager_init(&rm, 1, ROUTING_STRATEGY_DIJKSTRA);
+    routing_manager_update_graph(&rm, &graph);
+    
+    ip_routing_manager_t mgr;
+    assert(ip_routing_manager_init(&mgr, 1, TEST_IFACE, NUM_NODES) == 0);
+    
+    // Reconciliação: adota 3 via 2, remove a rota para o nó 50
+    assert(ip_routing_manager_reconcile(&mgr) == 1);
+    assert(mgr.num_routes == 1);
+    assert(kernel_routes(probe) == 1);
+    
+    // Primeiro sync: só faltam os nós 2 e 4
+    assert(ip_routing_manager_update_from_routing(&mgr, &rm) == 2);
+    assert(mgr.last_sync_changes == 2);
+    assert(mgr.num_routes == 3);
+    assert(kernel_routes(probe) == 3);
+    
+    // Sem mudanças: nada vai ao kernel
+    uint64_t sent_before = mgr.nl.messages_sent;
+    assert(ip_routing_manager_update_from_routing(&mgr, &rm) == 0);
+    assert(mgr.nl.messages_sent == sent_before);
+    
+    // Nó 4 inalcançável: um delete
+    topology_graph_set_link(&graph, 3, 4, 0);
+    routing_manager_update_graph(&rm, &graph);
+    assert(ip_routing_manager_update_from_routing(&mgr, &rm) == 1);
+    assert(mgr.num_routes == 2);
+    assert(kernel_routes(probe) == 2);
+    
+    // Atalho 1-3: gateway e métrica mudam (delete + replace)
+    topology_graph_set_link(&graph, 1, 3, 1);
+    routing_manager_update_graph(&rm, &graph);
+    assert(ip_routing_manager_update_from_routing(&mgr, &rm) == 1);
+    assert(mgr.route_table[3].gateway == 3 && mgr.route_table[3].metric == 1);
+    assert(kernel_routes(probe) == 2);
+    assert(mgr.route_errors == 0);
+    
+    ip_routing_manager_print_kernel_routes(&mgr);
+    ip_routing_manager_print_stats(&mgr);
+    
+    // Destroy remove tudo o que instalou
+    ip_routing_manager_destroy(&mgr);
+    assert(kernel_routes(probe) == 0);
+    
+    routing_manager_destroy(&rm);
+    topology_graph_destroy(&graph);
+    printf("✓ Test passed\n");
+}
+
+int main(void) {
+    nl_route_t probe;
+    
+    // Programar rotas exige CAP_NET_ADMIN
+    if (geteuid() != 0 || nl_route_open(&probe, TEST_IFACE) < 0) {
+        printf("Skipping IP routing tests (requires root)\n");
+        printf("\n=== All IP routing manager tests passed ===\n");
+        return 0;
+    }
+    
+    test_diff_sync(&probe);
+    nl_route_close(&probe);
+    
+    printf("\n=== All IP routing manager tests passed ===\n");
+    return 0;
+}
@@ -0,0 +1,203 @@
+// tests/test_large_topology.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <time.h>
+#include "tdma_types.h"
+#include "topology_graph.h"
+#include "dijkstra.h"
+#include "bfs_bitset.h"
+#include "routing_manager.h"
+#include "ra_tdmas_sync.h"
+
+#define GRID_SIDE 32   // 32 x 32 = 1024 nós
+
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// node_id = 1 + linha * GRID_SIDE + coluna
+static node_id_t grid_id(int row, int col) {
+    return (node_id_t)(1 + row * GRID_SIDE + col);
+}
+
+static void build_grid(topology_graph_t *graph) {
+    topology_graph_init(graph, GRID_SIDE * GRID_SIDE);
+    
+    for (int r = 0; r < GRID_SIDE; r++) {
+        for (int c = 0; c < GRID_SIDE; c++) {
+            assert(topology_graph_add_node(graph, grid_id(r, c)) >= 0);
+        }
+    }
+    
+    for (int r = 0; r < GRID_SIDE; r++) {
+        for (int c = 0; c < GRID_SIDE; c++) {
+            if (c + 1 < GRID_SIDE) {
+                assert(topology_graph_set_link(graph, grid_id(r, c), grid_id(r, c + 1), 1) == 0);
+            }
+            if (r + 1 < GRID_SIDE) {
+                assert(topology_graph_set_link(graph, grid_id(r, c), grid_id(r + 1, c), 1) == 0);
+            }
+        }
+    }
+}
+
+void test_graph_basics(void) {
+    printf("\n=== Test: Topology Graph Basics ===\n");
+    
+    topology_graph_t graph;
+    topology_graph_init(&graph, 0);
+    
+    assert(topology_graph_add_node(&graph, 1000) == 0);
+    assert(topology_graph_add_node(&graph, 3) == 1);
+    assert(topology_graph_add_node(&graph, 1000) == 0);  // Já existe
+    assert(topology_graph_index_of(&graph, 3) == 1);
+    assert(topology_graph_index_of(&graph, 4) == -1);
+    
+    assert(topology_graph_set_link(&graph, 1000, 3, 5) == 0);
+    assert(topology_graph_link_weight(&graph, 3, 1000) == 5);
+    assert(graph.num_edges == 2);
+    
+    topology_graph_t copy;
+    topology_graph_init(&copy, 0);
+    assert(topology_graph_copy(&copy, &graph) == 0);
+    assert(topology_graph_equals(&copy, &graph));
+    
+    assert(topology_graph_set_link(&graph, 1000, 3, 0) == 0);
+    assert(topology_graph_link_weight(&graph, 1000, 3) == 0);
+    assert(graph.num_edges == 0);
+    assert(!topology_graph_equals(&copy, &graph));
+    
+    topology_graph_destroy(&copy);
+    topology_graph_destroy(&graph);
+    printf("✓ Test passed\n");
+}
+
+void test_grid_routing(void) {
+    printf("\n=== Test: %d-Node Grid Routing ===\n", GRID_SIDE * GRID_SIDE);
+    
+    topology_graph_t graph;
+    build_grid(&graph);
+    printf("Nodes: %u | Links: %u\n", graph.num_nodes, graph.num_edges / 2);
+    
+    node_id_t src = grid_id(0, 0);
+    dijkstra_result_t *expected = calloc(graph.num_nodes, sizeof(dijkstra_result_t));
+    dijkstra_result_t *actual = calloc(graph.num_nodes, sizeof(dijkstra_result_t));
+    
+    uint64_t t0 = now_us();
+    assert(dijkstra_compute_graph(src, &graph, expected) == 0);
+    uint64_t t1 = now_us();
+    
+    adjacency_bitset_t adj;
+    adjacency_bitset_init(&adj);
+    assert(adjacency_bitset_from_graph(&adj, &graph) == 0);
+    uint64_t t2 = now_us();
+    assert(bfs_bitset_compute(src, &adj, actual) == 0);
+    uint64_t t3 = now_us();
+    
+    printf("Graph BFS:  %lu us\n", t1 - t0);
+    printf("Bitset BFS: %lu us (+%lu us conversão)\n", t3 - t2, t2 - t1);
+    
+    // Distância em grelha = distância de Manhattan
+    for (int r = 0; r < GRID_SIDE; r++) {
+        for (int c = 0; c < GRID_SIDE; c++) {
+            int idx = topology_graph_index_of(&graph, grid_id(r, c));
+            assert(expected[idx].reachable);
+            assert(expected[idx].distance == r + c);
+            
+            assert(actual[idx].distance == expected[idx].distance);
+            assert(actual[idx].next_hop == expected[idx].next_hop);
+        }
+    }
+    
+    // Canto oposto: 62 hops
+    int far = topology_graph_index_of(&graph, grid_id(GRID_SIDE - 1, GRID_SIDE - 1));
+    assert(expected[far].distance == 2 * (GRID_SIDE - 1));
+    
+    adjacency_bitset_destroy(&adj);
+    free(expected);
+    free(actual);
+    topology_graph_destroy(&graph);
+    printf("✓ Test passed\n");
+}
+
+void test_grid_routing_manager(void) {
+    printf("\n=== Test: Routing Manager on Large Grid ===\n");
+    
+    topology_graph_t graph;
+    build_grid(&graph);
+    
+    routing_strategy_t strategies[] = {
+        ROUTING_STRATEGY_DIJKSTRA, ROUTING_STRATEGY_MST, ROUTING_STRATEGY_HYBRID
+    };
+    
+    for (int s = 0; s < 3; s++) {
+        routing_manager_t rm;
+        routing_manager_init(&rm, grid_id(0, 0), strategies[s]);
+        
+        assert(routing_manager_update_graph(&rm, &graph));
+        assert(!routing_manager_update_graph(&rm, &graph));  // Sem mudanças
+        assert(routing_manager_num_nodes(&rm) == GRID_SIDE * GRID_SIDE);
+        
+        // Todos os destinos alcançáveis por um vizinho direto
+        for (int r = 0; r < GRID_SIDE; r++) {
+            for (int c = 0; c < GRID_SIDE; c++) {
+                if (r == 0 && c == 0) continue;
+                node_id_t next = routing_manager_get_next_hop(&rm, grid_id(r, c));
+                assert(next == grid_id(0, 1) || next == grid_id(1, 0));
+            }
+        }
+        
+        // Falha do link (0,0)-(0,1): tudo passa por (1,0)
+        topology_graph_set_link(&graph, grid_id(0, 0), grid_id(0, 1), 0);
+        assert(routing_manager_update_graph(&rm, &graph));
+        
+        assert(routing_manager_get_next_hop(&rm, grid_id(0, 1)) == grid_id(1, 0));
+        assert(routing_manager_get_next_hop(&rm, grid_id(0, GRID_SIDE - 1)) == grid_id(1, 0));
+        
+        printf("Strategy %d: recompute %lu us\n", strategies[s], rm.last_recompute_time_us);
+        
+        topology_graph_set_link(&graph, grid_id(0, 0), grid_id(0, 1), 1);
+        routing_manager_destroy(&rm);
+    }
+    
+    topology_graph_destroy(&graph);
+    printf("✓ Test passed\n");
+}
+
+void test_large_sync_init(void) {
+    printf("\n=== Test: RA-TDMAs+ with %d Slots ===\n", GRID_SIDE * GRID_SIDE);
+    
+    int n = GRID_SIDE * GRID_SIDE;
+    node_id_t *ids = malloc(n * sizeof(node_id_t));
+    for (int i = 0; i < n; i++) ids[i] = i + 1;
+    
+    ra_tdmas_sync_t sync;
+    assert(ra_tdmas_init(&sync, 700, ids, n) == 0);
+    assert(sync.num_slots == (uint32_t)n);
+    assert(sync.slots[sync.my_slot_index].node_id == 700);
+    
+    node_id_t neighbors[] = {699, 701};
+    ra_tdmas_set_sync_neighbors(&sync, neighbors, 2);
+    
+    // Atraso do vizinho 699 entra na mediana; nó 5 (não vizinho) é ignorado
+    ra_tdmas_on_packet_received(&sync, 699, 0, 0);
+    ra_tdmas_on_packet_received(&sync, 5, 0, 0);
+    ra_tdmas_calculate_slot_adjustment(&sync);
+    
+    ra_tdmas_destroy(&sync);
+    free(ids);
+    printf("✓ Test passed\n");
+}
+
+int main(void) {
+    test_graph_basics();
+    test_grid_routing();
+    test_grid_routing_manager();
+    test_large_sync_init();
+    
+    printf("\n=== All large topology tests passed ===\n");
+    return 0;
+}
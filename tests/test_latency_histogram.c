@@ -0,0 +1,204 @@
+// tests/test_latency_histogram.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include <unistd.h>
+#include "latency_histogram.h"
+#include "data_streaming.h"
+#include "ra_tdmas_sync.h"
+
+#define SAMPLES 100000
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+void test_exact_small_values(void) {
+    printf("\n=== Test: Small Values Are Exact ===\n");
+    
+    static latency_hist_t hist;
+    latency_hist_reset(&hist);
+    
+    // 1..200 μs: cada valor tem o seu bucket
+    for (uint64_t v = 1; v <= 200; v++) {
+        latency_hist_record(&hist, v);
+    }
+    
+    assert(hist.total == 200 && hist.min_us == 1 && hist.max_us == 200);
+    assert(latency_hist_percentile(&hist, 50) == 100);
+    assert(latency_hist_percentile(&hist, 99) == 198);
+    assert(latency_hist_percentile(&hist, 100) == 200);
+    assert(latency_hist_percentile(&hist, 0) == 1);
+    assert(fabs(latency_hist_mean_us(&hist) - 100.5) < 1e-9);
+    
+    latency_hist_reset(&hist);
+    assert(latency_hist_percentile(&hist, 50) == 0);
+    
+    printf("✓ Test passed\n");
+}
+
+void test_relative_error(void) {
+    printf("\n=== Test: Percentile Relative Error (log-uniform 10 μs - 10 s) ===\n");
+    
+    static latency_hist_t hist;
+    static uint64_t values[SAMPLES];
+    latency_hist_reset(&hist);
+    srand(19);
+    
+    for (int i = 0; i < SAMPLES; i++) {
+        double exponent = 1 + 6.0 * rand() / RAND_MAX;
+        values[i] = (uint64_t)pow(10, exponent);
+        latency_hist_record(&hist, values[i]);
+    }
+    qsort(values, SAMPLES, sizeof(uint64_t), compare_u64);
+    
+    const double pcts[] = {1, 10, 50, 90, 99, 99.9, 99.99};
+    for (size_t i = 0; i < sizeof(pcts) / sizeof(pcts[0]); i++) {
+        uint64_t rank = (uint64_t)ceil(SAMPLES * pcts[i] / 100.0);
+        uint64_t exact = values[rank - 1];
+        uint64_t approx = latency_hist_percentile(&hist, pcts[i]);
+        
+        // Limite superior do bucket: nunca abaixo, no máximo 1/128 acima
+        assert(approx >= exact);
+        assert(approx - exact <= exact / LATENCY_HIST_SUB_COUNT + 1);
+        printf("p%-6g exact %8lu us, histogram %8lu us\n", pcts[i], exact, approx);
+    }
+    assert(latency_hist_percentile(&hist, 100) == values[SAMPLES - 1]);
+    
+    printf("✓ Test passed\n");
+}
+
+void test_merge_and_clamp(void) {
+    printf("\n=== Test: Merge and Saturation ===\n");
+    
+    static latency_hist_t a, b;
+    latency_hist_reset(&a);
+    latency_hist_reset(&b);
+    
+    for (int i = 0; i < 900; i++) latency_hist_record(&a, 1000);
+    for (int i = 0; i < 100; i++) latency_hist_record(&b, 50000);
+    latency_hist_merge(&a, &b);
+    
+    assert(a.total == 1000 && a.min_us == 1000 && a.max_us == 50000);
+    assert(latency_hist_percentile(&a, 90) <= 1000 + 1000 / LATENCY_HIST_SUB_COUNT);
+    assert(latency_hist_percentile(&a, 91) == 50000);
+    
+    // Acima do máximo satura em vez de sair do array
+    latency_hist_record(&b, UINT64_MAX);
+    assert(b.max_us == LATENCY_HIST_MAX_US);
+    assert(latency_hist_percentile(&b, 100) == LATENCY_HIST_MAX_US);
+    
+    printf("✓ Test passed\n");
+}
+
+void test_csv_row(void) {
+    printf("\n=== Test: CSV Export ===\n");
+    
+    static latency_hist_t hist;
+    latency_hist_reset(&hist);
+    latency_hist_record(&hist, 2000);
+    latency_hist_record(&hist, 4000);
+    
+    char *buf = NULL;
+    size_t len = 0;
+    FILE *fp = open_memstream(&buf, &len);
+    latency_hist_csv_header(fp);
+    latency_hist_csv_row(fp, "flow", 3, &hist);
+    fclose(fp);
+    
+    assert(strstr(buf, "scope,key,samples,mean_ms") == buf);
+    assert(strstr(buf, "\nflow,3,2,3.000,2.000,") != NULL);   // samples, mean, min
+    assert(strstr(buf, ",4.000\n") != NULL);                   // max
+    free(buf);
+    
+    printf("✓ Test passed\n");
+}
+
+// Frame de 3 chunks com timestamp 5 ms no passado, vindo de 'src' a 'hops'
+static void receive_frame(data_streaming_t *stream, node_id_t src, uint8_t hops,
+                          uint32_t stream_id) {
+    static uint8_t frame[3 * STREAM_CHUNK_PAYLOAD];
+    uint64_t origin_us = ra_tdmas_get_current_time_us() - 5000;
+    
+    for (uint32_t seq = 0; seq < 3; seq++) {
+        uint8_t wire[MAX_CHUNK_SIZE];
+        stream_header_t header = {
+            .stream_id = stream_id,
+            .sequence_number = seq,
+            .total_chunks = 3,
+            .chunk_size = STREAM_CHUNK_PAYLOAD,
+            .type = STREAM_TYPE_DATA,
+            .timestamp_us = origin_us
+        };
+        memcpy(wire, &header, sizeof(header));
+        memcpy(wire + sizeof(header), frame + seq * STREAM_CHUNK_PAYLOAD, STREAM_CHUNK_PAYLOAD);
+        
+        // O último chunk veio por um caminho mais longo
+        uint8_t chunk_hops = seq == 2 ? hops : 1;
+        assert(data_streaming_receive_from(stream, src, chunk_hops, wire,
+                                           sizeof(header) + STREAM_CHUNK_PAYLOAD) >= 0);
+    }
+}
+
+void test_streaming_latency(void) {
+    printf("\n=== Test: Streaming Latency per Source and Hop Count ===\n");
+    
+    static data_streaming_t stream;
+    assert(data_streaming_init(&stream, 9, NULL) == 0);
+    
+    receive_frame(&stream, 1, 1, 100);
+    receive_frame(&stream, 1, 3, 101);
+    receive_frame(&stream, 2, 3, 102);
+    receive_frame(&stream, 2, 40, 103);       // Além de STREAM_LAT_MAX_HOPS
+    
+    const stream_latency_t *lat = stream.latency;
+    assert(lat->all.total == 4);
+    assert(lat->num_sources == 2);
+    assert(lat->sources[0] == 1 && lat->by_source[0].total == 2);
+    assert(lat->sources[1] == 2 && lat->by_source[1].total == 2);
+    assert(lat->by_hops[0].total == 1);
+    assert(lat->by_hops[2].total == 2);
+    assert(lat->by_hops[STREAM_LAT_MAX_HOPS - 1].total == 1);
+    
+    // ~5 ms desde a submissão (timestamp de origem, não de chegada)
+    uint64_t p50 = latency_hist_percentile(&lat->all, 50);
+    assert(p50 >= 5000 && p50 < 50000);
+    assert(stream.rx_stats.avg_latency_ms >= 5.0);
+    
+    data_streaming_print_stats(&stream);
+    
+    char path[] = "/tmp/test_latency_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+    assert(data_streaming_export_latency_csv(&stream, path) == 0);
+    
+    FILE *fp = fopen(path, "r");
+    char line[256];
+    int rows = 0;
+    while (fgets(line, sizeof(line), fp)) rows++;
+    fclose(fp);
+    unlink(path);
+    assert(rows == 1 + 1 + 2 + 3);            // Cabeçalho, all, 2 origens, 3 hops
+    
+    data_streaming_reset_stats(&stream);
+    assert(stream.latency->all.total == 0);
+    
+    data_streaming_destroy(&stream);
+    printf("✓ Test passed\n");
+}
+
+int main(void) {
+    test_exact_small_values();
+    test_relative_error();
+    test_merge_and_clamp();
+    test_csv_row();
+    test_streaming_latency();
+    
+    printf("\n=== All latency histogram tests passed ===\n");
+    return 0;
+}
@@ -0,0 +1,247 @@
+// tests/test_link_quality.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "link_quality.h"
+
+// Uma ronda entre dois nós; a_to_b/b_to_a = o heartbeat chega?
+static void exchange(link_quality_t *a, link_quality_t *b, bool a_to_b, bool b_to_a) {
+    uint8_t buf[LQ_HEARTBEAT_MAX_SIZE];
+    int len;
+    
+    len = link_quality_build_heartbeat(a, buf, sizeof(buf));
+    assert(len >= (int)sizeof(lq_heartbeat_t));
+    if (a_to_b) assert(link_quality_on_heartbeat(b, a->my_id, buf, len) == 0);
+    
+    len = link_quality_build_heartbeat(b, buf, sizeof(buf));
+    assert(len >= (int)sizeof(lq_heartbeat_t));
+    if (b_to_a) assert(link_quality_on_heartbeat(a, b->my_id, buf, len) == 0);
+    
+    link_quality_on_round(a);
+    link_quality_on_round(b);
+}
+
+void test_perfect_link(void) {
+    printf("\n=== Test: Perfect Link ===\n");
+    
+    link_quality_t a, b;
+    assert(link_quality_init(&a, 1, 4) == 0);
+    assert(link_quality_init(&b, 2, 4) == 0);
+    
+    // Ainda não ouvido: perfeito por omissão
+    assert(link_quality_weight(&a, 2) == LQ_ETX_SCALE);
+    
+    for (int r = 0; r < 2 * LQ_WINDOW_ROUNDS; r++) {
+        exchange(&a, &b, true, true);
+    }
+    
+    assert(link_quality_weight(&a, 2) == LQ_ETX_SCALE);
+    assert(link_quality_weight(&b, 1) == LQ_ETX_SCALE);
+    assert(link_quality_delivery(&a, 2, true) == 1.0);
+    assert(link_quality_delivery(&a, 2, false) == 1.0);
+    
+    // Nunca ouvidos: em baixo depois de uma janela em silêncio
+    assert(link_quality_weight(&a, 3) == 0);
+    assert(link_quality_weight(&a, 1) == 0);      // Eu próprio
+    
+    link_quality_destroy(&a);
+    link_quality_destroy(&b);
+    printf("✓ Test passed\n");
+}
+
+void test_asymmetric_loss(void) {
+    printf("\n=== Test: Loss in One Direction ===\n");
+    
+    link_quality_t a, b;
+    assert(link_quality_init(&a, 1, 2) == 0);
+    assert(link_quality_init(&b, 2, 2) == 0);
+    
+    // Metade dos heartbeats de A perdem-se; B → A perfeito
+    for (int r = 0; r < 3 * LQ_WINDOW_ROUNDS; r++) {
+        exchange(&a, &b, r % 2 == 0, true);
+    }
+    
+    double b_in = link_quality_delivery(&b, 1, true);
+    double a_out = link_quality_delivery(&a, 2, false);
+    printf("   B hears %.0f%% of A, A learns %.0f%% from B's reports\n",
+           b_in * 100, a_out * 100);
+    assert(b_in == 0.5);
+    assert(a_out == 0.5);
+    assert(link_quality_delivery(&a, 2, true) == 1.0);
+    assert(link_quality_delivery(&b, 1, false) == 1.0);
+    
+    // Os dois lados chegam ao mesmo ETX = 1 / (0.5 * 1.0)
+    assert(link_quality_weight(&a, 2) == 2 * LQ_ETX_SCALE);
+    assert(link_quality_weight(&b, 1) == 2 * LQ_ETX_SCALE);
+    
+    link_quality_destroy(&a);
+    link_quality_destroy(&b);
+    printf("✓ Test passed\n");
+}
+
+void test_failure_and_recovery(void) {
+    printf("\n=== Test: Link Failure and Recovery ===\n");
+    
+    link_quality_t a, b;
+    assert(link_quality_init(&a, 1, 2) == 0);
+    assert(link_quality_init(&b, 2, 2) == 0);
+    
+    for (int r = 0; r < LQ_WINDOW_ROUNDS; r++) {
+        exchange(&a, &b, true, true);
+    }
+    assert(link_quality_weight(&b, 1) == LQ_ETX_SCALE);
+    
+    // A cala-se: o ETX sobe e o link cai antes do fim da janela
+    int down_after = -1;
+    uint16_t last = LQ_ETX_SCALE;
+    for (int r = 0; r < LQ_WINDOW_ROUNDS; r++) {
+        exchange(&a, &b, false, true);
+        uint16_t weight = link_quality_weight(&b, 1);
+        assert(weight == 0 || weight >= last);
+        last = weight;
+        if (weight == 0) {
+            down_after = r + 1;
+            break;
+        }
+    }
+    printf("   Link down after %d silent rounds\n", down_after);
+    assert(down_after > 0 && down_after < LQ_WINDOW_ROUNDS);
+    
+    // Volta caro e converge para ETX 1.0 à medida que a janela se enche
+    int up_after = -1;
+    last = UINT16_MAX;
+    for (int r = 0; r < LQ_WINDOW_ROUNDS; r++) {
+        exchange(&a, &b, true, true);
+        uint16_t weight = link_quality_weight(&b, 1);
+        if (weight == 0) continue;
+        if (up_after < 0) up_after = r + 1;
+        assert(weight <= last);
+        last = weight;
+    }
+    printf("   Link back after %d rounds\n", up_after);
+    assert(up_after > 0 && up_after <= 10);       // Os bits velhos saem da janela
+    assert(link_quality_weight(&b, 1) == LQ_ETX_SCALE);
+    
+    // Uma janela inteira em silêncio: esquecido, e o primeiro heartbeat recomeça do zero
+    for (int r = 0; r < LQ_WINDOW_ROUNDS; r++) {
+        exchange(&a, &b, false, true);
+    }
+    assert(!b.neighbors[0].known);
+    exchange(&a, &b, true, true);
+    assert(link_quality_weight(&b, 1) == LQ_ETX_SCALE);
+    
+    link_quality_destroy(&a);
+    link_quality_destroy(&b);
+    printf("✓ Test passed\n");
+}
+
+void test_late_heartbeat(void) {
+    printf("\n=== Test: Late Heartbeat Fills Its Round ===\n");
+    
+    link_quality_t a, b;
+    uint8_t buf[LQ_HEARTBEAT_MAX_SIZE];
+    assert(link_quality_init(&a, 1, 2) == 0);
+    assert(link_quality_init(&b, 2, 2) == 0);
+    
+    for (int r = 0; r < 10; r++) {
+        exchange(&a, &b, true, true);
+    }
+    
+    // O heartbeat de A escorrega para a ronda seguinte de B
+    int len = link_quality_build_heartbeat(&a, buf, sizeof(buf));
+    link_quality_on_round(&b);
+    assert(link_quality_delivery(&b, 1, true) < 1.0);
+    assert(link_quality_on_heartbeat(&b, 1, buf, len) == 0);
+    assert(link_quality_delivery(&b, 1, true) == 1.0);
+    
+    len = link_quality_build_heartbeat(&a, buf, sizeof(buf));
+    assert(link_quality_on_heartbeat(&b, 1, buf, len) == 0);
+    link_quality_on_round(&b);
+    assert(link_quality_delivery(&b, 1, true) == 1.0);
+    
+    // Payloads inválidos: curto e com relatórios truncados
+    assert(link_quality_on_heartbeat(&b, 1, buf, 3) == -1);
+    lq_heartbeat_t hdr = { .seq = 99, .num_reports = 10 };
+    memcpy(buf, &hdr, sizeof(hdr));
+    assert(link_quality_on_heartbeat(&b, 1, buf, sizeof(hdr) + 4) == -1);
+    assert(b.malformed == 2);
+    assert(link_quality_on_heartbeat(&b, 7, buf, len) == -1);   // Fora de 1..num_nodes
+    
+    link_quality_destroy(&a);
+    link_quality_destroy(&b);
+    printf("✓ Test passed\n");
+}
+
+void test_report_rotation(void) {
+    printf("\n=== Test: Reports Rotate When They Do Not Fit ===\n");
+    
+    const uint32_t n = 3 * LQ_MAX_REPORTS;
+    link_quality_t lq, peer;
+    uint8_t buf[LQ_HEARTBEAT_MAX_SIZE];
+    assert(link_quality_init(&lq, 1, n) == 0);
+    assert(link_quality_init(&peer, 2, 2) == 0);
+    
+    // Ouve todos os outros nós
+    for (uint32_t id = 2; id <= n; id++) {
+        int len = link_quality_build_heartbeat(&peer, buf, sizeof(buf));
+        assert(link_quality_on_heartbeat(&lq, id, buf, len) == 0);
+    }
+    
+    bool *seen = calloc(n + 1, sizeof(bool));
+    uint32_t total = 0;
+    for (int hb = 0; hb < 3; hb++) {
+        int len = link_quality_build_heartbeat(&lq, buf, sizeof(buf));
+        lq_heartbeat_t hdr;
+        memcpy(&hdr, buf, sizeof(hdr));
+        assert(hdr.seq == (uint32_t)hb);
+        assert(len == (int)(sizeof(hdr) + hdr.num_reports * sizeof(lq_report_t)));
+        
+        for (uint16_t r = 0; r < hdr.num_reports; r++) {
+            lq_report_t report;
+            memcpy(&report, buf + sizeof(hdr) + r * sizeof(report), sizeof(report));
+            assert(report.received == 1 && report.window == 1);
+            if (!seen[report.node]) total++;
+            seen[report.node] = true;
+        }
+        assert((hdr.flags & LQ_FLAG_COMPLETE) == 0);
+    }
+    printf("   %u of %u neighbors reported in 3 heartbeats\n", total, n - 1);
+    assert(total == n - 1);
+    
+    // Buffer pequeno: só o cabeçalho
+    assert(link_quality_build_heartbeat(&lq, buf, 2) == -1);
+    assert(link_quality_build_heartbeat(&lq, buf, sizeof(lq_heartbeat_t)) ==
+           (int)sizeof(lq_heartbeat_t));
+    
+    free(seen);
+    link_quality_destroy(&lq);
+    link_quality_destroy(&peer);
+    printf("✓ Test passed\n");
+}
+
+void test_hysteresis(void) {
+    printf("\n=== Test: Weight Hysteresis ===\n");
+    
+    assert(!link_quality_significant(10, 10));
+    assert(!link_quality_significant(10, 11));
+    assert(link_quality_significant(10, 12));
+    assert(link_quality_significant(20, 15));
+    assert(link_quality_significant(10, 0));
+    assert(link_quality_significant(0, 10));
+    assert(!link_quality_significant(0, 0));
+    
+    printf("✓ Test passed\n");
+}
+
+int main(void) {
+    test_perfect_link();
+    test_asymmetric_loss();
+    test_failure_and_recovery();
+    test_late_heartbeat();
+    test_report_rotation();
+    test_hysteresis();
+    
+    printf("\n=== All link quality tests passed ===\n");
+    return 0;
+}
@@ -0,0 +1,328 @@
+// tests/test_link_state.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "link_state.h"
+
+#define LINE_NODES 6
+
+static lsa_link_t link_to(node_id_t neighbor, uint16_t weight) {
+    return (lsa_link_t){ .neighbor = neighbor, .weight = weight };
+}
+
+// Um slot de cada nó da linha 1-2-...-n: os seus pendentes chegam aos vizinhos
+static uint32_t flood_line(link_state_t *nodes, uint32_t n) {
+    uint8_t lsa[LSA_MAX_SIZE];
+    uint32_t sent = 0;
+    
+    for (uint32_t i = 0; i < n; i++) {
+        int len;
+        while ((len = link_state_next_flood(&nodes[i], lsa, sizeof(lsa))) > 0) {
+            sent++;
+            if (i > 0) link_state_on_lsa(&nodes[i - 1], lsa, len);
+            if (i + 1 < n) link_state_on_lsa(&nodes[i + 1], lsa, len);
+        }
+        link_state_on_round(&nodes[i]);
+    }
+    return sent;
+}
+
+static void originate_line(link_state_t *nodes, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        lsa_link_t links[2];
+        uint32_t count = 0;
+        node_id_t id = (node_id_t)(i + 1);
+        
+        if (id > 1) links[count++] = link_to(id - 1, 10);
+        if (id < n) links[count++] = link_to(id + 1, 10);
+        link_state_update_local(&nodes[i], links, count);
+    }
+}
+
+void test_origination(void) {
+    printf("\n=== Test: Origination and Refresh ===\n");
+    
+    link_state_t ls;
+    uint8_t buf[LSA_MAX_SIZE];
+    assert(link_state_init(&ls, 1, 4) == 0);
+    assert(link_state_next_flood(&ls, buf, sizeof(buf)) == 0);
+    
+    // Fora de ordem: o LSA sai ordenado por vizinho
+    lsa_link_t links[] = { link_to(3, 20), link_to(2, 10) };
+    assert(link_state_update_local(&ls, links, 2));
+    assert(!link_state_update_local(&ls, links, 2));      // Nada mudou
+    
+    int len = link_state_next_flood(&ls, buf, sizeof(buf));
+    assert(len == (int)(sizeof(lsa_header_t) + 2 * sizeof(lsa_link_t)));
+    assert(link_state_next_flood(&ls, buf, sizeof(buf)) == 0);
+    
+    lsa_header_t hdr;
+    lsa_link_t first;
+    memcpy(&hdr, buf, sizeof(hdr));
+    memcpy(&first, buf + sizeof(hdr), sizeof(first));
+    assert(hdr.origin == 1 && hdr.seq == 1 && hdr.num_links == 2);
+    assert(first.neighbor == 2 && first.weight == 10);
+    
+    // Peso mudou: LSA novo
+    links[0].weight = 30;
+    assert(link_state_update_local(&ls, links, 2));
+    assert(link_state_next_flood(&ls, buf, sizeof(buf)) > 0);
+    memcpy(&hdr, buf, sizeof(hdr));
+    assert(hdr.seq == 2);
+    
+    // Sem mudanças, só depois de LS_REFRESH_ROUNDS
+    for (int r = 0; r < LS_REFRESH_ROUNDS - 1; r++) link_state_on_round(&ls);
+    assert(!link_state_update_local(&ls, links, 2));
+    link_state_on_round(&ls);
+    assert(link_state_update_local(&ls, links, 2));
+    assert(ls.originated == 3);
+    
+    // Buffer pequeno: fica pendente
+    assert(link_state_next_flood(&ls, buf, sizeof(lsa_header_t)) == -1);
+    assert(link_state_next_flood(&ls, buf, sizeof(buf)) > 0);
+    
+    link_state_destroy(&ls);
+    printf("✓ Test passed\n");
+}
+
+void test_flooding(void) {
+    printf("\n=== Test: Flooding Along a Line ===\n");
+    
+    link_state_t nodes[LINE_NODES];
+    for (uint32_t i = 0; i < LINE_NODES; i++) {
+        assert(link_state_init(&nodes[i], (node_id_t)(i + 1), LINE_NODES) == 0);
+    }
+    originate_line(nodes, LINE_NODES);
+    
+    // Um hop por ronda no pior caso
+    uint32_t sent = 0;
+    int rounds = 0;
+    while (rounds < LINE_NODES) {
+        uint32_t now = flood_line(nodes, LINE_NODES);
+        if (now == 0) break;
+        sent += now;
+        rounds++;
+    }
+    printf("   Converged in %d rounds, %u LSAs sent\n", rounds, sent);
+    
+    // Cada nó envia cada LSA uma vez: duplicados morrem à chegada
+    assert(sent == LINE_NODES * LINE_NODES);
+    for (uint32_t i = 0; i < LINE_NODES; i++) {
+        assert(link_state_known_origins(&nodes[i]) == LINE_NODES);
+        assert(nodes[i].flooded == LINE_NODES);
+        assert(nodes[i].installed == LINE_NODES - 1);
+    }
+    
+    // Todos veem a linha inteira e nada mais
+    link_state_t *far = &nodes[LINE_NODES - 1];
+    assert(link_state_link_weight(far, 1, 2) == 10);
+    assert(link_state_link_weight(far, 2, 3) == 10);
+    assert(link_state_link_weight(far, 1, 3) == 0);
+    
+    // Origens com links novos aparecem uma vez em next_changed()
+    uint32_t changed = 0;
+    while (link_state_next_changed(far) != 0) changed++;
+    assert(changed == LINE_NODES - 1);
+    
+    // O link 2-3 piora: só o LSA de 2 volta a circular
+    lsa_link_t links[] = { link_to(1, 10), link_to(3, 40) };
+    assert(link_state_update_local(&nodes[1], links, 2));
+    sent = 0;
+    for (int r = 0; r < LINE_NODES; r++) sent += flood_line(nodes, LINE_NODES);
+    assert(sent == LINE_NODES);
+    assert(link_state_next_changed(far) == 2);
+    assert(link_state_next_changed(far) == 0);
+    
+    // 3 ainda diz 10: as duas pontas anunciam, vale o pior
+    assert(link_state_link_weight(far, 2, 3) == 40);
+    
+    for (uint32_t i = 0; i < LINE_NODES; i++) link_state_destroy(&nodes[i]);
+    printf("✓ Test passed\n");
+}
+
+void test_own_echo(void) {
+    printf("\n=== Test: Own LSA Echoed Back ===\n");
+    
+    link_state_t nodes[2];
+    uint8_t buf[LSA_MAX_SIZE];
+    for (uint32_t i = 0; i < 2; i++) {
+        assert(link_state_init(&nodes[i], (node_id_t)(i + 1), 2) == 0);
+    }
+    
+    lsa_link_t to_2 = link_to(2, 10);
+    assert(link_state_update_local(&nodes[0], &to_2, 1));
+    int len = link_state_next_flood(&nodes[0], buf, sizeof(buf));
+    
+    // O eco direto do LSA atual não força uma origem nova
+    assert(link_state_on_lsa(&nodes[0], buf, len) == 0);
+    assert(!link_state_update_local(&nodes[0], &to_2, 1));
+    
+    // Uma passagem por segundo durante 10 s: o LSA de 1 circula uma vez
+    assert(link_state_on_lsa(&nodes[1], buf, len) == 1);
+    for (int second = 0; second < 10; second++) {
+        for (int r = 0; r < 10; r++) flood_line(nodes, 2);
+        assert(!link_state_update_local(&nodes[0], &to_2, 1));
+    }
+    assert(nodes[0].entries[0].seq == 1);
+    assert(nodes[0].originated == 1 && nodes[0].flooded == 1);
+    assert(nodes[1].flooded == 1);
+    
+    for (uint32_t i = 0; i < 2; i++) link_state_destroy(&nodes[i]);
+    printf("✓ Test passed\n");
+}
+
+void test_bidirectional_check(void) {
+    printf("\n=== Test: Link Needs Both Ends ===\n");
+    
+    link_state_t ls;
+    uint8_t buf[LSA_MAX_SIZE];
+    assert(link_state_init(&ls, 1, 4) == 0);
+    
+    // LSA de 2: ouve 3 e 4
+    link_state_t peer;
+    assert(link_state_init(&peer, 2, 4) == 0);
+    lsa_link_t links[] = { link_to(3, 10), link_to(4, 20) };
+    assert(link_state_update_local(&peer, links, 2));
+    int len = link_state_next_flood(&peer, buf, sizeof(buf));
+    assert(link_state_on_lsa(&ls, buf, len) == 1);
+    assert(link_state_on_lsa(&ls, buf, len) == 0);        // Duplicado
+    assert(ls.duplicates == 1);
+    
+    // Só uma ponta conhecida: vale o que ela diz
+    assert(link_state_link_weight(&ls, 2, 3) == 10);
+    assert(link_state_link_weight(&ls, 3, 2) == 10);
+    assert(link_state_link_weight(&ls, 3, 4) == 0);       // Nenhuma ponta conhecida
+    
+    // LSA de 3: não ouve 2 (link só num sentido) → o link cai
+    link_state_t other;
+    assert(link_state_init(&other, 3, 4) == 0);
+    lsa_link_t other_links[] = { link_to(4, 10) };
+    assert(link_state_update_local(&other, other_links, 1));
+    len = link_state_next_flood(&other, buf, sizeof(buf));
+    assert(link_state_on_lsa(&ls, buf, len) == 1);
+    assert(link_state_link_weight(&ls, 2, 3) == 0);
+    assert(link_state_link_weight(&ls, 3, 4) == 10);
+    
+    link_state_destroy(&other);
+    link_state_destroy(&peer);
+    link_state_destroy(&ls);
+    printf("✓ Test passed\n");
+}
+
+void test_restart_and_expiry(void) {
+    printf("\n=== Test: Origin Restart and LSA Expiry ===\n");
+    
+    link_state_t nodes[2];
+    for (uint32_t i = 0; i < 2; i++) {
+        assert(link_state_init(&nodes[i], (node_id_t)(i + 1), 2) == 0);
+    }
+    
+    // Várias gerações do LSA de 1
+    lsa_link_t up = link_to(2, 10);
+    lsa_link_t worse = link_to(2, 30);
+    for (int i = 0; i < 5; i++) {
+        link_state_update_local(&nodes[0], i % 2 ? &worse : &up, 1);
+        flood_line(nodes, 2);
+    }
+    assert(nodes[1].entries[0].seq == 5);
+    
+    // 1 reinicia com sequência 0: o LSA novo parece antigo a 2...
+    link_state_destroy(&nodes[0]);
+    assert(link_state_init(&nodes[0], 1, 2) == 0);
+    assert(link_state_update_local(&nodes[0], &up, 1));
+    flood_line(nodes, 2);
+    assert(nodes[1].entries[0].seq == 5);
+    
+    // ... que lhe devolve a cópia dele; 1 reorigina acima dela
+    assert(nodes[0].entries[0].seq == 5);
+    assert(link_state_update_local(&nodes[0], &up, 1));
+    flood_line(nodes, 2);
+    assert(nodes[1].entries[0].seq == 6);
+    
+    // 1 cala-se: o LSA expira e o link sai da topologia
+    while (link_state_next_changed(&nodes[1]) != 0) {}
+    for (int r = 0; r < LS_MAX_AGE_ROUNDS; r++) link_state_on_round(&nodes[1]);
+    assert(nodes[1].expired == 1);
+    assert(link_state_known_origins(&nodes[1]) == 0);     // Nem o meu: nunca originei
+    assert(link_state_next_changed(&nodes[1]) == 1);
+    
+    // Depois de expirado, qualquer sequência volta a entrar
+    link_state_destroy(&nodes[0]);
+    assert(link_state_init(&nodes[0], 1, 2) == 0);
+    assert(link_state_update_local(&nodes[0], &up, 1));
+    flood_line(nodes, 2);
+    assert(nodes[1].entries[0].valid && nodes[1].entries[0].seq == 1);
+    
+    for (uint32_t i = 0; i < 2; i++) link_state_destroy(&nodes[i]);
+    printf("✓ Test passed\n");
+}
+
+void test_malformed_and_truncation(void) {
+    printf("\n=== Test: Malformed LSAs and Large Neighborhoods ===\n");
+    
+    const uint32_t n = LS_MAX_LINKS + 50;
+    link_state_t ls;
+    uint8_t buf[LSA_MAX_SIZE];
+    assert(link_state_init(&ls, 1, n) == 0);
+    
+    // Curto, origem fora de 1..n, links truncados, peso 0, link para si próprio
+    assert(link_state_on_lsa(&ls, buf, 3) == -1);
+    lsa_header_t hdr = { .origin = (node_id_t)(n + 1), .seq = 1 };
+    memcpy(buf, &hdr, sizeof(hdr));
+    assert(link_state_on_lsa(&ls, buf, sizeof(hdr)) == -1);
+    
+    hdr = (lsa_header_t){ .origin = 2, .num_links = 3, .seq = 1 };
+    memcpy(buf, &hdr, sizeof(hdr));
+    assert(link_state_on_lsa(&ls, buf, sizeof(hdr) + sizeof(lsa_link_t)) == -1);
+    
+    hdr.num_links = 1;
+    memcpy(buf, &hdr, sizeof(hdr));
+    lsa_link_t bad = link_to(3, 0);
+    memcpy(buf + sizeof(hdr), &bad, sizeof(bad));
+    assert(link_state_on_lsa(&ls, buf, sizeof(hdr) + sizeof(bad)) == -1);
+    bad = link_to(2, 10);
+    memcpy(buf + sizeof(hdr), &bad, sizeof(bad));
+    assert(link_state_on_lsa(&ls, buf, sizeof(hdr) + sizeof(bad)) == -1);
+    assert(ls.malformed == 5);
+    assert(link_state_known_origins(&ls) == 0);
+    
+    // Mais vizinhos do que cabem: ficam os de menor peso
+    lsa_link_t *links = malloc((n - 1) * sizeof(lsa_link_t));
+    for (uint32_t i = 0; i < n - 1; i++) {
+        node_id_t id = (node_id_t)(i + 2);
+        links[i] = link_to(id, id % 2 ? 10 : 50);
+    }
+    assert(link_state_update_local(&ls, links, n - 1));
+    
+    int len = link_state_next_flood(&ls, buf, sizeof(buf));
+    assert(len == (int)LSA_MAX_SIZE);
+    memcpy(&hdr, buf, sizeof(hdr));
+    assert(hdr.num_links == LS_MAX_LINKS);
+    
+    uint32_t cheap = 0;
+    for (uint16_t i = 0; i < hdr.num_links; i++) {
+        lsa_link_t link;
+        memcpy(&link, buf + sizeof(hdr) + i * sizeof(link), sizeof(link));
+        if (link.weight == 10) cheap++;
+    }
+    printf("   %u links advertised, %u of them at the lowest weight\n",
+           hdr.num_links, cheap);
+    assert(cheap == (n - 1) / 2);
+    
+    free(links);
+    link_state_destroy(&ls);
+    printf("✓ Test passed\n");
+}
+
+int main(void) {
+    test_origination();
+    test_flooding();
+    test_own_echo();
+    test_bidirectional_check();
+    test_restart_and_expiry();
+    test_malformed_and_truncation();
+    
+    printf("\n=== All link state tests passed ===\n");
+    return 0;
+}
@@ -0,0 +1,262 @@
+// tests/test_metrics_registry.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "metrics_registry.h"
+#include "ra_tdmas_sync.h"
+
+#define THREADS 4
+#define INCREMENTS 1000000
+
+static metrics_registry_t reg;
+static metric_id_t counter_id, hist_id;
+
+void test_register(void) {
+    printf("\n=== Test: Registration ===\n");
+    
+    metrics_registry_t local;
+    assert(metrics_registry_init(&local, 1) == 0);
+    
+    assert(metrics_register_counter(&local, "packets_total", "Packets") == 0);
+    assert(metrics_register_histogram(&local, "delay_us", "Delay") == 1);
+    assert(metrics_register_counter(&local, "packets_total", "Again") == -1);
+    assert(metrics_register_counter(&local, "bad.name", "Dots") == -1);
+    assert(metrics_register_counter(&local, "9lives", "Digit first") == -1);
+    assert(metrics_register_counter(&local, "", "Empty") == -1);
+    
+    uint32_t field = 0;
+    assert(metrics_register_source(&local, "bad_size", "", METRIC_GAUGE,
+                                   &field, sizeof(uint16_t)) == -1);
+    
+    // Incrementos numa métrica não registada são ignorados
+    metrics_inc(&local, -1);
+    metrics_inc(NULL, 0);
+    assert(local.num_shards == 0);
+    
+    for (int i = local.num_metrics; i < METRICS_MAX; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "filler_%d", i);
+        assert(metrics_register_counter(&local, name, "") == i);
+    }
+    assert(metrics_register_counter(&local, "one_too_many", "") == -1);
+    
+    metrics_registry_destroy(&local);
+    printf("✓ Test passed\n");
+}
+
+static void *worker(void *arg) {
+    (void)arg;
+    
+    for (int i = 0; i < INCREMENTS; i++) {
+        metrics_inc(&reg, counter_id);
+    }
+    for (uint64_t v = 1; v <= 1000; v++) {
+        metrics_observe(&reg, hist_id, v);
+    }
+    return NULL;
+}
+
+void test_sharded_counters(void) {
+    printf("\n=== Test: %d Threads x %d Increments ===\n", THREADS, INCREMENTS);
+    
+    assert(metrics_registry_init(&reg, 7) == 0);
+    counter_id = metrics_register_counter(&reg, "events_total", "Events");
+    hist_id = metrics_register_histogram(&reg, "value_us", "Values");
+    
+    uint64_t start_us = ra_tdmas_get_current_time_us();
+    
+    pthread_t threads[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+        assert(pthread_create(&threads[i], NULL, worker, NULL) == 0);
+    }
+    for (int i = 0; i < THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    
+    uint64_t elapsed_us = ra_tdmas_get_current_time_us() - start_us;
+    
+    // Sem RMW atómicos e sem perdas: cada thread escreve só o seu shard
+    assert(reg.num_shards == THREADS);
+    assert(metrics_value(&reg, counter_id) == (uint64_t)THREADS * INCREMENTS);
+    printf("%d increments in %lu us (%.2f ns each, all threads)\n",
+           THREADS * INCREMENTS, elapsed_us,
+           elapsed_us * 1000.0 / ((double)THREADS * INCREMENTS));
+    
+    metric_hist_t hist;
+    metrics_histogram(&reg, hist_id, &hist);
+    assert(hist.count == THREADS * 1000);
+    assert(hist.sum == THREADS * 500500);
+    assert(metrics_value(&reg, hist_id) == hist.count);
+    
+    printf("✓ Test passed\n");
+}
+
+void test_histogram_buckets(void) {
+    printf("\n=== Test: Power-of-Two Buckets ===\n");
+    
+    metrics_registry_t local;
+    assert(metrics_registry_init(&local, 2) == 0);
+    metric_id_t id = metrics_register_histogram(&local, "size", "Sizes");
+    
+    const uint64_t values[] = {0, 1, 2, 3, 4, 5, 1024, 1025, 1ULL << 40};
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        metrics_observe(&local, id, values[i]);
+    }
+    
+    metric_hist_t hist;
+    metrics_histogram(&local, id, &hist);
+    assert(hist.buckets[0] == 2);      // 0, 1
+    assert(hist.buckets[1] == 1);      // 2
+    assert(hist.buckets[2] == 2);      // 3, 4
+    assert(hist.buckets[3] == 1);      // 5
+    assert(hist.buckets[10] == 1);     // 1024
+    assert(hist.buckets[11] == 1);     // 1025
+    assert(hist.buckets[METRICS_HIST_BUCKETS] == 1);
+    assert(hist.count == 9);
+    
+    char *text = NULL;
+    size_t len = 0;
+    FILE *fp = open_memstream(&text, &len);
+    metrics_write_prometheus(&local, fp);
+    fclose(fp);
+    
+    assert(strstr(text, "# TYPE tdma_size histogram\n") != NULL);
+    assert(strstr(text, "tdma_size_bucket{node=\"2\",le=\"4\"} 5\n") != NULL);
+    assert(strstr(text, "tdma_size_bucket{node=\"2\",le=\"1024\"} 7\n") != NULL);
+    assert(strstr(text, "tdma_size_bucket{node=\"2\",le=\"+Inf\"} 9\n") != NULL);
+    assert(strstr(text, "tdma_size_count{node=\"2\"} 9\n") != NULL);
+    free(text);
+    
+    metrics_registry_destroy(&local);
+    printf("✓ Test passed\n");
+}
+
+void test_sources_and_reuse(void) {
+    printf("\n=== Test: Exposed Fields and Registry Reuse ===\n");
+    
+    static uint64_t packets = 0;
+    static uint32_t round_number = 0;
+    
+    metrics_registry_t a, b;
+    assert(metrics_registry_init(&a, 1) == 0);
+    assert(metrics_registry_init(&b, 2) == 0);
+    
+    metric_id_t pkts = metrics_register_source(&a, "packets_total", "Packets",
+                                               METRIC_COUNTER, &packets, sizeof(packets));
+    metric_id_t round = metrics_register_source(&a, "round", "Round",
+                                                METRIC_GAUGE, &round_number,
+                                                sizeof(round_number));
+    packets = 42;
+    round_number = 7;
+    assert(metrics_value(&a, pkts) == 42);
+    assert(metrics_value(&a, round) == 7);
+    
+    // A mesma thread a alternar entre registos não mistura contagens
+    metric_id_t ca = metrics_register_counter(&a, "a_total", "");
+    metric_id_t cb = metrics_register_counter(&b, "b_total", "");
+    for (int i = 0; i < 10; i++) {
+        metrics_inc(&a, ca);
+        metrics_add(&b, cb, 2);
+    }
+    assert(metrics_value(&a, ca) == 10 && metrics_value(&b, cb) == 20);
+    assert(a.num_shards == 1 && b.num_shards == 1);
+    
+    // Re-inicializado no mesmo endereço: a cache thread-local não serve o shard antigo
+    metrics_registry_destroy(&b);
+    assert(metrics_registry_init(&b, 2) == 0);
+    cb = metrics_register_counter(&b, "b_total", "");
+    metrics_inc(&b, cb);
+    assert(metrics_value(&b, cb) == 1);
+    
+    char *text = NULL;
+    size_t len = 0;
+    FILE *fp = open_memstream(&text, &len);
+    metrics_write_json(&a, fp);
+    fclose(fp);
+    assert(strstr(text, "\"node\": 1") != NULL);
+    assert(strstr(text, "\"packets_total\": 42") != NULL);
+    assert(strstr(text, "\"a_total\": 10") != NULL);
+    free(text);
+    
+    metrics_registry_destroy(&a);
+    metrics_registry_destroy(&b);
+    printf("✓ Test passed\n");
+}
+
+static size_t read_all(int fd, char *buf, size_t size) {
+    size_t total = 0;
+    ssize_t n;
+    while (total + 1 < size && (n = read(fd, buf + total, size - 1 - total)) > 0) {
+        total += n;
+    }
+    buf[total] = '\0';
+    return total;
+}
+
+void test_exporter(void) {
+    printf("\n=== Test: File and Unix Socket Export ===\n");
+    
+    char dir[] = "/tmp/test_metrics_XXXXXX";
+    assert(mkdtemp(dir) != NULL);
+    char file_path[128], socket_path[128];
+    snprintf(file_path, sizeof(file_path), "%s/node.json", dir);
+    snprintf(socket_path, sizeof(socket_path), "%s/node.sock", dir);
+    
+    metrics_inc(&reg, counter_id);
+    assert(metrics_export_start(&reg, file_path, socket_path, 20) == 0);
+    assert(metrics_export_start(&reg, file_path, NULL, 20) == -1);   // Já a exportar
+    
+    usleep(100000);
+    assert(reg.snapshots_written >= 2);
+    
+    static char buf[16384];
+    FILE *fp = fopen(file_path, "r");
+    assert(fp != NULL);
+    size_t len = fread(buf, 1, sizeof(buf) - 1, fp);
+    buf[len] = '\0';
+    fclose(fp);
+    assert(strstr(buf, "\"node\": 7") != NULL);
+    assert(strstr(buf, "\"events_total\": 4000001") != NULL);
+    assert(strstr(buf, "\"value_us\": {\"count\": 4000") != NULL);
+    
+    // Scrape: uma ligação = um snapshot Prometheus
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    strcpy(addr.sun_path, socket_path);
+    assert(connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+    assert(read_all(fd, buf, sizeof(buf)) > 0);
+    close(fd);
+    assert(strstr(buf, "# TYPE tdma_events_total counter\n") != NULL);
+    assert(strstr(buf, "tdma_events_total{node=\"7\"} 4000001\n") != NULL);
+    
+    // O stop escreve um último snapshot e remove o socket
+    metrics_inc(&reg, counter_id);
+    metrics_export_stop(&reg);
+    assert(access(socket_path, F_OK) != 0);
+    fp = fopen(file_path, "r");
+    len = fread(buf, 1, sizeof(buf) - 1, fp);
+    buf[len] = '\0';
+    fclose(fp);
+    assert(strstr(buf, "\"events_total\": 4000002") != NULL);
+    
+    unlink(file_path);
+    rmdir(dir);
+    metrics_registry_destroy(&reg);
+    printf("✓ Test passed\n");
+}
+
+int main(void) {
+    test_register();
+    test_sharded_counters();
+    test_histogram_buckets();
+    test_sources_and_reuse();
+    test_exporter();
+    
+    printf("\n=== All metrics registry tests passed ===\n");
+    return 0;
+}
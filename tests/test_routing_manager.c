@@ -1,6 +1,8 @@
 // tests/test_routing_manager.c
 #include <stdio.h>
 #include <unistd.h>
+#include <assert.h>
+#include <pthread.h>
 #include "routing_manager.h"
 
 void test_basic_routing() {
@@ -218,6 +220,79 @@ void test_performance_metrics() {
     printf("\n✓ Test passed - Metrics collected and exported!\n");
 }
 
+// Leitor concorrente: lookups sem lock durante link flaps
+typedef struct {
+    routing_manager_t *rm;
+    volatile bool stop;
+    uint64_t lookups;
+} reader_args_t;
+
+static void *lookup_reader(void *arg) {
+    reader_args_t *args = (reader_args_t *)arg;
+    
+    while (!args->stop) {
+        node_id_t next = routing_manager_get_next_hop(args->rm, 4);
+        
+        // Diamante com 1-3 sempre ativo: há sempre rota para 4
+        assert(next == 2 || next == 3);
+        args->lookups++;
+    }
+    
+    return NULL;
+}
+
+void test_lockfree_lookups() {
+    printf("\n╔══════════════════════════════════════╗\n");
+    printf("║  TEST 5: Lock-free Lookups (RCU)    ║\n");
+    printf("╚══════════════════════════════════════╝\n");
+    
+    topology_graph_t graph;
+    topology_graph_init(&graph, 4);
+    topology_graph_full_mesh(&graph, 4);
+    topology_graph_set_link(&graph, 1, 4, 0);
+    topology_graph_set_link(&graph, 2, 3, 0);
+    
+    routing_manager_t rm;
+    routing_manager_init(&rm, 1, ROUTING_STRATEGY_DIJKSTRA);
+    routing_manager_update_graph(&rm, &graph);
+    
+    unsigned epoch;
+    const routing_snapshot_t *snap = routing_manager_snapshot_acquire(&rm, &epoch);
+    assert(snap != NULL);
+    assert(snap->by_dest[4].valid && snap->by_dest[4].distance == 2);
+    uint64_t first_version = snap->version;
+    routing_manager_snapshot_release(&rm, epoch);
+    
+    reader_args_t readers[2] = {{&rm, false, 0}, {&rm, false, 0}};
+    pthread_t threads[2];
+    for (int i = 0; i < 2; i++) {
+        pthread_create(&threads[i], NULL, lookup_reader, &readers[i]);
+    }
+    
+    // Link 1-2 a oscilar enquanto os leitores fazem lookups
+    int flaps = 200;
+    for (int i = 0; i < flaps; i++) {
+        topology_graph_set_link(&graph, 1, 2, (i % 2) ? 1 : 0);
+        routing_manager_update_graph(&rm, &graph);
+    }
+    
+    for (int i = 0; i < 2; i++) {
+        readers[i].stop = true;
+        pthread_join(threads[i], NULL);
+    }
+    
+    snap = routing_manager_snapshot_acquire(&rm, &epoch);
+    assert(snap->version == first_version + flaps);
+    routing_manager_snapshot_release(&rm, epoch);
+    
+    printf("Lookups during %d flaps: %lu + %lu\n", flaps,
+           readers[0].lookups, readers[1].lookups);
+    
+    routing_manager_destroy(&rm);
+    topology_graph_destroy(&graph);
+    printf("✓ Test passed\n");
+}
+
 int main() {
     printf("\n");
     printf("╔════════════════════════════════════════════════╗\n");
@@ -228,6 +303,7 @@ int main() {
     test_link_failure_recovery();
     test_strategy_comparison();
     test_performance_metrics();  // <--- NOVO TESTE
+    test_lockfree_lookups();
     
     printf("\n");
     printf("╔════════════════════════════════════════════════╗\n");
@@ -0,0 +1,187 @@
+// tests/test_spt_incremental.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "tdma_types.h"
+#include "topology_graph.h"
+#include "dijkstra.h"
+#include "spt_incremental.h"
+#include "routing_manager.h"
+
+#define GRID_SIDE 16
+
+static node_id_t grid_id(int row, int col) {
+    return (node_id_t)(1 + row * GRID_SIDE + col);
+}
+
+static void build_grid(topology_graph_t *graph) {
+    topology_graph_init(graph, GRID_SIDE * GRID_SIDE);
+    
+    for (int r = 0; r < GRID_SIDE; r++) {
+        for (int c = 0; c < GRID_SIDE; c++) {
+            topology_graph_add_node(graph, grid_id(r, c));
+        }
+    }
+    
+    for (int r = 0; r < GRID_SIDE; r++) {
+        for (int c = 0; c < GRID_SIDE; c++) {
+            if (c + 1 < GRID_SIDE) {
+                topology_graph_set_link(graph, grid_id(r, c), grid_id(r, c + 1),
+                                        1 + (r * 7 + c * 3) % 5);
+            }
+            if (r + 1 < GRID_SIDE) {
+                topology_graph_set_link(graph, grid_id(r, c), grid_id(r + 1, c),
+                                        1 + (r * 5 + c * 11) % 5);
+            }
+        }
+    }
+}
+
+// Compara a SPT reparada com um Dijkstra completo sobre o mesmo grafo
+static void assert_matches_full(spt_state_t *spt, const topology_graph_t *graph,
+                                node_id_t src, bool unit_weights) {
+    uint32_t n = graph->num_nodes;
+    dijkstra_result_t *expected = calloc(n, sizeof(dijkstra_result_t));
+    dijkstra_result_t *actual = calloc(n, sizeof(dijkstra_result_t));
+    
+    if (unit_weights) {
+        assert(dijkstra_compute_graph(src, graph, expected) == 0);
+    } else {
+        assert(dijkstra_compute_weighted(src, graph, expected) == 0);
+    }
+    spt_export(spt, graph, actual);
+    
+    for (uint32_t i = 0; i < n; i++) {
+        assert(actual[i].reachable == expected[i].reachable);
+        assert(actual[i].cost == expected[i].cost);
+        assert(actual[i].distance == expected[i].distance);
+        assert(actual[i].next_hop == expected[i].next_hop);
+    }
+    
+    free(expected);
+    free(actual);
+}
+
+void test_spt_link_flaps(bool unit_weights) {
+    printf("\n=== Test: Incremental SPT Link Flaps (%s) ===\n",
+           unit_weights ? "hop count" : "weighted");
+    
+    topology_graph_t graph;
+    build_grid(&graph);
+    
+    node_id_t src = grid_id(3, 4);
+    spt_state_t spt;
+    spt_init(&spt);
+    assert(spt_compute(&spt, &graph, src, unit_weights) == 0);
+    uint32_t full_relaxed = spt.last_relaxed;
+    assert(full_relaxed == graph.num_nodes);
+    
+    srand(42);
+    uint64_t relaxed_sum = 0;
+    int flaps = 500;
+    
+    for (int k = 0; k < flaps; k++) {
+        // Escolhe uma aresta da grelha (horizontal ou vertical)
+        int r = rand() % GRID_SIDE;
+        int c = rand() % (GRID_SIDE - 1);
+        node_id_t a = grid_id(r, c), b = grid_id(r, c + 1);
+        if (rand() % 2) {
+            a = grid_id(c, r);
+            b = grid_id(c + 1, r);
+        }
+        
+        uint16_t old_w = topology_graph_link_weight(&graph, a, b);
+        uint16_t new_w = (old_w == 0) ? 1 + rand() % 5 :
+                         (rand() % 2) ? 0 : 1 + rand() % 5;
+        
+        topology_graph_set_link(&graph, a, b, new_w);
+        
+        graph_link_change_t change = {
+            topology_graph_index_of(&graph, a) < topology_graph_index_of(&graph, b) ?
+                (uint32_t)topology_graph_index_of(&graph, a) :
+                (uint32_t)topology_graph_index_of(&graph, b),
+            topology_graph_index_of(&graph, a) < topology_graph_index_of(&graph, b) ?
+                (uint32_t)topology_graph_index_of(&graph, b) :
+                (uint32_t)topology_graph_index_of(&graph, a),
+            old_w, new_w
+        };
+        
+        int relaxed = spt_update_link(&spt, &graph, &change);
+        assert(relaxed >= 0);
+        relaxed_sum += relaxed;
+        
+        assert_matches_full(&spt, &graph, src, unit_weights);
+    }
+    
+    printf("Full compute: %u nodes | Avg per flap: %.1f nodes\n",
+           full_relaxed, (double)relaxed_sum / flaps);
+    assert(relaxed_sum / flaps < full_relaxed);
+    
+    spt_destroy(&spt);
+    topology_graph_destroy(&graph);
+    printf("✓ Test passed\n");
+}
+
+void test_routing_manager_incremental(void) {
+    printf("\n=== Test: Routing Manager Incremental Mode ===\n");
+    
+    topology_graph_t graph;
+    build_grid(&graph);
+    
+    routing_manager_t rm;
+    routing_manager_init(&rm, grid_id(0, 0), ROUTING_STRATEGY_HYBRID);
+    routing_manager_set_path_engine(&rm, PATH_ENGINE_WEIGHTED);
+    routing_manager_set_incremental(&rm, true);
+    
+    assert(routing_manager_update_graph(&rm, &graph));
+    assert(rm.incremental_updates == 0);  // Primeira topologia: recompute total
+    
+    // Falha de um link: tratado de forma incremental
+    topology_graph_set_link(&graph, grid_id(0, 0), grid_id(0, 1), 0);
+    assert(routing_manager_update_graph(&rm, &graph));
+    assert(rm.incremental_updates == 1);
+    assert(routing_manager_get_next_hop(&rm, grid_id(0, 1)) == grid_id(1, 0));
+    
+    // Isola o nó (0,0) → HYBRID cai para MST nas rotas inalcançáveis
+    topology_graph_set_link(&graph, grid_id(0, 0), grid_id(1, 0), 0);
+    assert(routing_manager_update_graph(&rm, &graph));
+    assert(rm.incremental_updates == 2);
+    assert(routing_manager_get_next_hop(&rm, grid_id(5, 5)) == NODE_ID_INVALID);
+    
+    // Recuperação
+    topology_graph_set_link(&graph, grid_id(0, 0), grid_id(1, 0), 1);
+    topology_graph_set_link(&graph, grid_id(0, 0), grid_id(0, 1), 1);
+    assert(routing_manager_update_graph(&rm, &graph));
+    assert(rm.incremental_updates == 3);
+    
+    // Mesmo resultado que um manager sem modo incremental
+    routing_manager_t full;
+    routing_manager_init(&full, grid_id(0, 0), ROUTING_STRATEGY_HYBRID);
+    routing_manager_set_path_engine(&full, PATH_ENGINE_WEIGHTED);
+    assert(routing_manager_update_graph(&full, &graph));
+    
+    for (int r = 0; r < GRID_SIDE; r++) {
+        for (int c = 0; c < GRID_SIDE; c++) {
+            node_id_t dst = grid_id(r, c);
+            assert(routing_manager_get_next_hop(&rm, dst) ==
+                   routing_manager_get_next_hop(&full, dst));
+        }
+    }
+    
+    printf("Incremental updates: %u | Last relaxed: %u | Total relaxed: %lu\n",
+           rm.incremental_updates, rm.last_nodes_relaxed, rm.total_nodes_relaxed);
+    
+    routing_manager_destroy(&full);
+    routing_manager_destroy(&rm);
+    topology_graph_destroy(&graph);
+    printf("✓ Test passed\n");
+}
+
+int main(void) {
+    test_spt_link_flaps(true);
+    test_spt_link_flaps(false);
+    test_routing_manager_incremental();
+    
+    printf("\n=== All incremental SPT tests passed ===\n");
+    return 0;
+}
@@ -0,0 +1,280 @@
+// tests/test_stream_arq.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include "data_streaming.h"
+
+// Ligação direta 46 — 47 via loopback
+#define NODE_TX 46
+#define NODE_RX 47
+#define FRAME_SIZE (12 * 1024)
+
+typedef struct {
+    udp_transport_t transport;
+    routing_manager_t rm;
+    tx_queue_t queue;
+    forwarding_engine_t fwd;
+    data_streaming_t stream;
+} test_node_t;
+
+typedef struct {
+    int frames;
+    uint32_t last_size;
+    uint8_t last_data[FRAME_SIZE];
+} sink_t;
+
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void sink_deliver(const reasm_frame_t *frame, void *ctx) {
+    sink_t *sink = ctx;
+    sink->frames++;
+    sink->last_size = frame->size;
+    memcpy(sink->last_data, frame->data, frame->size);
+}
+
+static void setup_node(test_node_t *node, node_id_t id, const topology_graph_t *graph) {
+    assert(udp_transport_init(&node->transport, id) == 0);
+    assert(udp_transport_set_peers(&node->transport, 64) == 0);
+    node->transport.peer_addrs[NODE_TX].sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    node->transport.peer_addrs[NODE_RX].sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    routing_manager_init(&node->rm, id, ROUTING_STRATEGY_DIJKSTRA);
+    routing_manager_update_graph(&node->rm, graph);
+    assert(tx_queue_init(&node->queue, 64) == 0);
+    forwarding_init(&node->fwd, id, &node->rm, &node->queue, &node->transport);
+    assert(data_streaming_init(&node->stream, id, &node->transport) == 0);
+    data_streaming_set_forwarding(&node->stream, &node->fwd);
+}
+
+static void teardown_node(test_node_t *node) {
+    data_streaming_destroy(&node->stream);
+    tx_queue_destroy(&node->queue);
+    routing_manager_destroy(&node->rm);
+    udp_transport_destroy(&node->transport);
+}
+
+// Entrega tudo o que chegou; descarta a 1ª cópia dos chunks em 'drop'
+static int pump(test_node_t *node, const uint32_t *drop, int num_drop,
+                bool *dropped) {
+    udp_rx_packet_t batch[UDP_RX_BATCH];
+    int handled = 0;
+
+    while (udp_transport_wait(&node->transport, 50) > 0) {
+        int count = udp_transport_receive_batch(&node->transport, batch, UDP_RX_BATCH);
+
+        for (int i = 0; i < count; i++) {
+            udp_rx_packet_t *pkt = &batch[i];
+            assert(forwarding_on_receive(&node->fwd, &pkt->header, pkt->payload,
+                                         pkt->payload_len, now_us()) == FWD_DELIVER);
+
+            const uint8_t *body = pkt->payload + sizeof(mesh_header_t);
+            uint32_t body_len = pkt->payload_len - sizeof(mesh_header_t);
+
+            if (pkt->header.type == MSG_STREAM_NACK) {
+                data_streaming_on_nack(&node->stream, pkt->header.src, body, body_len);
+                handled++;
+                continue;
+            }
+
+            stream_header_t header;
+            memcpy(&header, body, sizeof(header));
+
+            bool lost = false;
+            for (int d = 0; d < num_drop; d++) {
+                if (drop[d] == header.sequence_number && !dropped[d]) {
+                    dropped[d] = true;
+                    lost = true;
+                }
+            }
+            if (!lost) {
+                data_streaming_receive(&node->stream, pkt->header.src, body, body_len);
+            }
+            handled++;
+        }
+    }
+
+    return handled;
+}
+
+static uint64_t now_ms(void) {
+    return now_us() / 1000;
+}
+
+void test_gap_collection(void) {
+    printf("\n=== Test: Gap Collection (holes, tail, deadline) ===\n");
+
+    reasm_engine_t engine;
+    reasm_init(&engine, 64 * 100, NULL, NULL);
+    engine.nack_interval_ms = 100;
+
+    uint8_t data[100] = {0};
+    reasm_chunk_t chunk = {
+        .src = 5, .stream_id = 1, .total_chunks = 10,
+        .chunk_stride = 100, .data = data, .len = 100
+    };
+
+    // Recebidos 0, 1, 4, 6: faltam 2, 3, 5 e a cauda 7..9
+    uint32_t got[] = {0, 1, 4, 6};
+    for (int i = 0; i < 4; i++) {
+        chunk.sequence = got[i];
+        assert(reasm_on_chunk(&engine, &chunk, 1000) == 0);
+    }
+
+    reasm_gap_t gaps[REASM_MAX_STREAMS];
+    assert(reasm_collect_gaps(&engine, 1000, gaps, REASM_MAX_STREAMS) == 1);
+    assert(gaps[0].src == 5 && gaps[0].stream_id == 1);
+    assert(gaps[0].base_seq == 2 && gaps[0].missing_count == 3);
+    assert(gaps[0].num_chunks == 4);
+    assert(gaps[0].missing[0] == 0xB);   // 2, 3, 5
+
+    // Uma vez por intervalo
+    assert(reasm_collect_gaps(&engine, 1050, gaps, REASM_MAX_STREAMS) == 0);
+
+    // Parado há um intervalo: a cauda também é pedida
+    assert(reasm_collect_gaps(&engine, 1100, gaps, REASM_MAX_STREAMS) == 1);
+    assert(gaps[0].missing_count == 6 && gaps[0].num_chunks == 8);
+
+    // Stream com prazo: sem NACK depois dele, expira como atrasado
+    chunk.stream_id = 2;
+    chunk.sequence = 0;
+    chunk.deadline_ms = 50;
+    assert(reasm_on_chunk(&engine, &chunk, 2000) == 0);
+    int count = reasm_collect_gaps(&engine, 2051, gaps, REASM_MAX_STREAMS);
+    for (int i = 0; i < count; i++) {
+        assert(gaps[i].stream_id != 2);
+    }
+    assert(reasm_expire(&engine, 2051) == 1);
+    assert(engine.frames_late == 1 && engine.frames_expired == 0);
+
+    reasm_destroy(&engine);
+    printf("✓ Test passed\n");
+}
+
+void test_nack_recovery(void) {
+    printf("\n=== Test: NACK Recovery of Lost and Tail Chunks ===\n");
+
+    topology_graph_t graph;
+    assert(topology_graph_init(&graph, 2) == 0);
+    topology_graph_add_node(&graph, NODE_TX);
+    topology_graph_add_node(&graph, NODE_RX);
+    topology_graph_set_link(&graph, NODE_TX, NODE_RX, 1);
+
+    static test_node_t tx, rx;
+    static sink_t sink;
+    setup_node(&tx, NODE_TX, &graph);
+    setup_node(&rx, NODE_RX, &graph);
+    data_streaming_set_frame_callback(&rx.stream, sink_deliver, &sink);
+
+    static uint8_t frame[FRAME_SIZE];
+    for (uint32_t i = 0; i < sizeof(frame); i++) frame[i] = (uint8_t)(i * 13);
+    uint32_t total = (sizeof(frame) + STREAM_CHUNK_PAYLOAD - 1) / STREAM_CHUNK_PAYLOAD;
+
+    assert(data_streaming_send(&tx.stream, NODE_RX, frame, sizeof(frame),
+                               STREAM_TYPE_DATA) == (int)total);
+    assert(tx.stream.arq.streams_retained == 1);
+    assert(tx_queue_drain(&tx.queue, &tx.transport, now_us() + 100000) == (int)total);
+
+    // Perdidos: dois chunks a meio e o último
+    uint32_t drop[] = {3, 7, total - 1};
+    bool dropped[3] = {false};
+    assert(pump(&rx, drop, 3, dropped) == (int)total);
+    assert(sink.frames == 0);
+
+    // Ronda 1: NACK das lacunas (a cauda ainda não conta)
+    uint64_t round_ms = now_ms();
+    assert(data_streaming_on_round(&rx.stream, round_ms) == 1);
+    assert(tx_queue_drain(&rx.queue, &rx.transport, now_us() + 100000) == 1);
+    assert(pump(&tx, NULL, 0, NULL) == 1);
+    assert(tx.stream.arq.chunks_retransmitted == 2);
+    assert(tx_queue_drain(&tx.queue, &tx.transport, now_us() + 100000) == 2);
+    assert(pump(&rx, drop, 3, dropped) == 2);
+    assert(sink.frames == 0);
+
+    // Ronda seguinte, sem chunks novos: NACK da cauda completa o frame
+    round_ms = now_ms() + STREAM_NACK_INTERVAL_MS;
+    assert(data_streaming_on_round(&rx.stream, round_ms) == 1);
+    assert(tx_queue_drain(&rx.queue, &rx.transport, now_us() + 100000) == 1);
+    assert(pump(&tx, NULL, 0, NULL) == 1);
+    assert(tx.stream.arq.chunks_retransmitted == 3);
+    assert(tx_queue_drain(&tx.queue, &tx.transport, now_us() + 100000) == 1);
+    assert(pump(&rx, drop, 3, dropped) == 1);
+
+    assert(sink.frames == 1 && sink.last_size == sizeof(frame));
+    assert(memcmp(sink.last_data, frame, sizeof(frame)) == 0);
+    assert(rx.stream.frames_delivered == 1);
+    assert(rx.stream.bytes_delivered == sizeof(frame));
+    assert(rx.stream.nacks_sent == 2);
+
+    // Nada em falta: sem mais NACKs
+    assert(data_streaming_on_round(&rx.stream, round_ms + 10 * STREAM_NACK_INTERVAL_MS) == 0);
+
+    data_streaming_print_stats(&rx.stream);
+
+    teardown_node(&tx);
+    teardown_node(&rx);
+    topology_graph_destroy(&graph);
+    printf("✓ Test passed\n");
+}
+
+void test_nack_deadline(void) {
+    printf("\n=== Test: NACKs for Unknown or Late Streams ===\n");
+
+    topology_graph_t graph;
+    assert(topology_graph_init(&graph, 2) == 0);
+    topology_graph_add_node(&graph, NODE_TX);
+    topology_graph_add_node(&graph, NODE_RX);
+    topology_graph_set_link(&graph, NODE_TX, NODE_RX, 1);
+
+    static test_node_t tx;
+    setup_node(&tx, NODE_TX, &graph);
+    data_streaming_set_deadline(&tx.stream, STREAM_TYPE_VIDEO, 1);
+
+    static uint8_t frame[FRAME_SIZE];
+    assert(data_streaming_send(&tx.stream, NODE_RX, frame, sizeof(frame),
+                               STREAM_TYPE_VIDEO) > 0);
+    uint32_t stream_id = tx.stream.tx_stats.stream_id;
+
+    uint8_t wire[sizeof(stream_nack_t) + sizeof(uint64_t)];
+    stream_nack_t nack = { .stream_id = stream_id, .base_seq = 0, .num_chunks = 1 };
+    uint64_t missing = 1;
+    memcpy(wire, &nack, sizeof(nack));
+    memcpy(wire + sizeof(nack), &missing, sizeof(missing));
+
+    // Stream que nunca foi enviado
+    nack.stream_id = stream_id + 100;
+    memcpy(wire, &nack, sizeof(nack));
+    assert(data_streaming_on_nack(&tx.stream, NODE_RX, wire, sizeof(wire)) == -1);
+    assert(tx.stream.arq.nacks_unknown == 1);
+
+    // Prazo de vídeo (1 ms) já passou: não reenvia
+    usleep(5000);
+    nack.stream_id = stream_id;
+    memcpy(wire, &nack, sizeof(nack));
+    assert(data_streaming_on_nack(&tx.stream, NODE_RX, wire, sizeof(wire)) == -1);
+    assert(tx.stream.arq.nacks_late == 1);
+    assert(tx.stream.arq.chunks_retransmitted == 0);
+
+    // Bitmap truncado
+    assert(data_streaming_on_nack(&tx.stream, NODE_RX, wire, sizeof(nack)) == -1);
+
+    teardown_node(&tx);
+    topology_graph_destroy(&graph);
+    printf("✓ Test passed\n");
+}
+
+int main(void) {
+    test_gap_collection();
+    test_nack_recovery();
+    test_nack_deadline();
+
+    printf("\n=== All stream ARQ tests passed ===\n");
+    return 0;
+}
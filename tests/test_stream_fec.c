@@ -0,0 +1,273 @@
+// tests/test_stream_fec.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include "data_streaming.h"
+#include "stream_fec.h"
+
+// Ligação direta 48 — 49 via loopback
+#define NODE_TX 48
+#define NODE_RX 49
+#define CHUNK_LEN 1357                // Ímpar: exercita a cauda não vetorizada
+#define FRAME_SIZE 8192
+
+typedef struct {
+    udp_transport_t transport;
+    routing_manager_t rm;
+    tx_queue_t queue;
+    forwarding_engine_t fwd;
+    data_streaming_t stream;
+} test_node_t;
+
+typedef struct {
+    int frames;
+    uint32_t last_size;
+    uint32_t last_recovered;
+    uint8_t last_data[FRAME_SIZE];
+} sink_t;
+
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Multiplicação de referência (shift-and-add, polinómio 0x11D)
+static uint8_t ref_mul(uint8_t a, uint8_t b) {
+    uint8_t r = 0;
+    while (b) {
+        if (b & 1) r ^= a;
+        a = (a << 1) ^ ((a & 0x80) ? 0x1D : 0);
+        b >>= 1;
+    }
+    return r;
+}
+
+void test_mul_add(void) {
+    printf("\n=== Test: GF(256) Multiply-Accumulate ===\n");
+    
+    static uint8_t src[CHUNK_LEN], dst[CHUNK_LEN], expected[CHUNK_LEN];
+    srand(11);
+    
+    for (int c = 0; c < 256; c++) {
+        for (int i = 0; i < CHUNK_LEN; i++) {
+            src[i] = rand() & 0xFF;
+            dst[i] = rand() & 0xFF;
+            expected[i] = dst[i] ^ ref_mul((uint8_t)c, src[i]);
+        }
+        gf256_mul_add(dst, src, (uint8_t)c, CHUNK_LEN);
+        assert(memcmp(dst, expected, CHUNK_LEN) == 0);
+    }
+    
+    printf("✓ Test passed\n");
+}
+
+void test_encode_decode(void) {
+    printf("\n=== Test: Encode / Decode Every Erasure Pattern (n=8, k=3) ===\n");
+    
+    enum { N = 8, K = 3 };
+    static uint8_t original[N][CHUNK_LEN], work[N][CHUNK_LEN], parity[K][CHUNK_LEN];
+    const uint8_t *data_ptrs[N];
+    uint8_t *work_ptrs[N];
+    uint8_t *parity_ptrs[K];
+    
+    for (int i = 0; i < N; i++) {
+        for (int b = 0; b < CHUNK_LEN; b++) original[i][b] = rand() & 0xFF;
+        data_ptrs[i] = original[i];
+        work_ptrs[i] = work[i];
+    }
+    for (int j = 0; j < K; j++) parity_ptrs[j] = parity[j];
+    
+    assert(fec_encode(data_ptrs, N, parity_ptrs, K, CHUNK_LEN) == 0);
+    
+    int patterns = 0;
+    for (uint32_t lost = 1; lost < (1u << (N + K)); lost++) {
+        if (__builtin_popcount(lost) > K) continue;
+        
+        bool present[N];
+        const uint8_t *par[K];
+        int missing = 0;
+        for (int i = 0; i < N; i++) {
+            present[i] = !(lost & (1u << i));
+            if (present[i]) {
+                memcpy(work[i], original[i], CHUNK_LEN);
+            } else {
+                memset(work[i], 0xEE, CHUNK_LEN);
+                missing++;
+            }
+        }
+        for (int j = 0; j < K; j++) {
+            par[j] = (lost & (1u << (N + j))) ? NULL : parity[j];
+        }
+        
+        assert(fec_decode(work_ptrs, present, N, par, K, CHUNK_LEN) == missing);
+        for (int i = 0; i < N; i++) {
+            assert(memcmp(work[i], original[i], CHUNK_LEN) == 0);
+        }
+        patterns++;
+    }
+    printf("Recovered %d erasure patterns\n", patterns);
+    
+    // Mais perdas do que paridades: não há solução
+    bool present[N] = {false, false, true, true, true, true, false, false};
+    const uint8_t *par[K] = {parity[0], parity[1], parity[2]};
+    assert(fec_decode(work_ptrs, present, N, par, K, CHUNK_LEN) == -1);
+    
+    printf("✓ Test passed\n");
+}
+
+static void sink_deliver(const reasm_frame_t *frame, void *ctx) {
+    sink_t *sink = ctx;
+    sink->frames++;
+    sink->last_size = frame->size;
+    sink->last_recovered = frame->recovered;
+    memcpy(sink->last_data, frame->data, frame->size);
+}
+
+static void setup_node(test_node_t *node, node_id_t id, const topology_graph_t *graph) {
+    assert(udp_transport_init(&node->transport, id) == 0);
+    assert(udp_transport_set_peers(&node->transport, 64) == 0);
+    node->transport.peer_addrs[NODE_TX].sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    node->transport.peer_addrs[NODE_RX].sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    
+    routing_manager_init(&node->rm, id, ROUTING_STRATEGY_DIJKSTRA);
+    routing_manager_update_graph(&node->rm, graph);
+    assert(tx_queue_init(&node->queue, 64) == 0);
+    forwarding_init(&node->fwd, id, &node->rm, &node->queue, &node->transport);
+    assert(data_streaming_init(&node->stream, id, &node->transport) == 0);
+    data_streaming_set_forwarding(&node->stream, &node->fwd);
+}
+
+static void teardown_node(test_node_t *node) {
+    data_streaming_destroy(&node->stream);
+    tx_queue_destroy(&node->queue);
+    routing_manager_destroy(&node->rm);
+    udp_transport_destroy(&node->transport);
+}
+
+// Entrega ao streaming tudo o que chegou, exceto os chunks de dados em 'drop'
+static int pump(test_node_t *node, const uint32_t *drop, int num_drop) {
+    udp_rx_packet_t batch[UDP_RX_BATCH];
+    int handled = 0;
+    
+    while (udp_transport_wait(&node->transport, 50) > 0) {
+        int count = udp_transport_receive_batch(&node->transport, batch, UDP_RX_BATCH);
+        
+        for (int i = 0; i < count; i++) {
+            const uint8_t *body = batch[i].payload + sizeof(mesh_header_t);
+            uint32_t body_len = batch[i].payload_len - sizeof(mesh_header_t);
+            
+            stream_header_t header;
+            memcpy(&header, body, sizeof(header));
+            
+            bool lost = false;
+            for (int d = 0; d < num_drop; d++) {
+                if (drop[d] == header.sequence_number) lost = true;
+            }
+            if (!lost) {
+                data_streaming_receive(&node->stream, batch[i].header.src, body, body_len);
+            }
+            handled++;
+        }
+    }
+    
+    return handled;
+}
+
+static void run_lossy_frame(const uint32_t *drop, int num_drop,
+                            bool expect_complete) {
+    topology_graph_t graph;
+    assert(topology_graph_init(&graph, 2) == 0);
+    topology_graph_add_node(&graph, NODE_TX);
+    topology_graph_add_node(&graph, NODE_RX);
+    topology_graph_set_link(&graph, NODE_TX, NODE_RX, 1);
+    
+    static test_node_t tx, rx;
+    static sink_t sink;
+    memset(&sink, 0, sizeof(sink));
+    setup_node(&tx, NODE_TX, &graph);
+    setup_node(&rx, NODE_RX, &graph);
+    data_streaming_set_frame_callback(&rx.stream, sink_deliver, &sink);
+    assert(data_streaming_set_fec(&tx.stream, STREAM_TYPE_VIDEO, 4, 2) == 0);
+    
+    static uint8_t frame[FRAME_SIZE];
+    generate_video_frame(frame, sizeof(frame));
+    uint32_t total = (sizeof(frame) + STREAM_CHUNK_PAYLOAD - 1) / STREAM_CHUNK_PAYLOAD;
+    uint32_t blocks = (total + 3) / 4;
+    
+    assert(data_streaming_send(&tx.stream, NODE_RX, frame, sizeof(frame),
+                               STREAM_TYPE_VIDEO) == (int)total);
+    assert(tx.stream.parity_sent == blocks * 2);
+    assert(tx_queue_drain(&tx.queue, &tx.transport, now_us() + 100000) ==
+           (int)(total + blocks * 2));
+    assert(pump(&rx, drop, num_drop) == (int)(total + blocks * 2));
+    
+    if (expect_complete) {
+        // Sem NACK nem retransmissão
+        assert(sink.frames == 1 && sink.last_size == sizeof(frame));
+        assert(memcmp(sink.last_data, frame, sizeof(frame)) == 0);
+        assert(sink.last_recovered == (uint32_t)num_drop);
+        assert(rx.stream.reasm.frames_recovered == (num_drop > 0 ? 1 : 0));
+        
+        // Paridade que chega depois de o frame estar completo não reabre o
+        // stream: nem NACK do frame inteiro nem expiração mais tarde
+        uint64_t idle_ms = now_us() / 1000 + REASM_TIMEOUT_MS;
+        reasm_gap_t gaps[REASM_MAX_STREAMS];
+        assert(reasm_active_streams(&rx.stream.reasm) == 0);
+        assert(reasm_collect_gaps(&rx.stream.reasm, idle_ms, gaps, REASM_MAX_STREAMS) == 0);
+        assert(reasm_expire(&rx.stream.reasm, idle_ms) == 0);
+        assert(rx.stream.reasm.chunks_duplicate > 0);
+    } else {
+        assert(sink.frames == 0);
+        assert(reasm_active_streams(&rx.stream.reasm) == 1);
+    }
+    
+    reasm_print_stats(&rx.stream.reasm);
+    
+    teardown_node(&tx);
+    teardown_node(&rx);
+    topology_graph_destroy(&graph);
+}
+
+void test_stream_recovery(void) {
+    printf("\n=== Test: Lost Chunks Recovered by Parity (n=4, k=2) ===\n");
+    
+    // 8 KB = 7 chunks: blocos {0-3} e {4-6}; perdidos 1, 2 e o último
+    uint32_t total = (FRAME_SIZE + STREAM_CHUNK_PAYLOAD - 1) / STREAM_CHUNK_PAYLOAD;
+    uint32_t drop[] = {1, 2, total - 1};
+    run_lossy_frame(drop, 3, true);
+    
+    printf("✓ Test passed\n");
+}
+
+void test_parity_after_completion(void) {
+    printf("\n=== Test: Parity After Completion Is a Duplicate ===\n");
+    
+    // Sem perdas o frame completa antes da paridade do último bloco
+    run_lossy_frame(NULL, 0, true);
+    
+    printf("✓ Test passed\n");
+}
+
+void test_stream_too_many_losses(void) {
+    printf("\n=== Test: More Losses Than Parity Waits for ARQ ===\n");
+    
+    uint32_t drop[] = {0, 1, 2};
+    run_lossy_frame(drop, 3, false);
+    
+    printf("✓ Test passed\n");
+}
+
+int main(void) {
+    test_mul_add();
+    test_encode_decode();
+    test_stream_recovery();
+    test_parity_after_completion();
+    test_stream_too_many_losses();
+    
+    printf("\n=== All stream FEC tests passed ===\n");
+    return 0;
+}
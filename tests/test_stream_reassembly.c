@@ -0,0 +1,250 @@
+// tests/test_stream_reassembly.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "stream_reassembly.h"
+#include "data_streaming.h"
+
+#define STRIDE 100
+#define MAX_FRAME (64 * STRIDE)
+
+typedef struct {
+    int frames;
+    node_id_t last_src;
+    uint32_t last_size;
+    uint8_t last_data[MAX_STREAM_BUFFER];
+} sink_t;
+
+static void sink_deliver(const reasm_frame_t *frame, void *ctx) {
+    sink_t *sink = ctx;
+    sink->frames++;
+    sink->last_src = frame->src;
+    sink->last_size = frame->size;
+    memcpy(sink->last_data, frame->data, frame->size);
+}
+
+// Conteúdo determinístico por (origem, byte)
+static uint8_t pattern(node_id_t src, uint32_t i) {
+    return (uint8_t)(src * 31 + i * 7);
+}
+
+static reasm_chunk_t make_chunk(node_id_t src, uint32_t stream_id, uint32_t seq,
+                                uint32_t size, const uint8_t *frame) {
+    uint32_t total = (size + STRIDE - 1) / STRIDE;
+    uint32_t offset = seq * STRIDE;
+    reasm_chunk_t chunk = {
+        .src = src,
+        .stream_id = stream_id,
+        .sequence = seq,
+        .total_chunks = total,
+        .type = STREAM_TYPE_VIDEO,
+        .chunk_stride = STRIDE,
+        .data = frame + offset,
+        .len = size - offset < STRIDE ? size - offset : STRIDE
+    };
+    return chunk;
+}
+
+static void shuffle(uint32_t *order, uint32_t n) {
+    for (uint32_t i = n - 1; i > 0; i--) {
+        uint32_t j = rand() % (i + 1);
+        uint32_t tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+}
+
+void test_interleaved_out_of_order(void) {
+    printf("\n=== Test: Interleaved Sources, Out-of-Order Chunks ===\n");
+    
+    static sink_t sink;
+    memset(&sink, 0, sizeof(sink));
+    reasm_engine_t engine;
+    reasm_init(&engine, MAX_FRAME, sink_deliver, &sink);
+    
+    // Mesmo stream_id em duas origens diferentes
+    uint32_t size = 37 * STRIDE + 42;
+    uint32_t total = (size + STRIDE - 1) / STRIDE;
+    uint8_t frame_a[MAX_FRAME], frame_b[MAX_FRAME];
+    for (uint32_t i = 0; i < size; i++) {
+        frame_a[i] = pattern(3, i);
+        frame_b[i] = pattern(9, i);
+    }
+    
+    uint32_t order_a[64], order_b[64];
+    for (uint32_t i = 0; i < total; i++) order_a[i] = order_b[i] = i;
+    srand(7);
+    shuffle(order_a, total);
+    shuffle(order_b, total);
+    
+    for (uint32_t i = 0; i < total; i++) {
+        reasm_chunk_t a = make_chunk(3, 1, order_a[i], size, frame_a);
+        reasm_chunk_t b = make_chunk(9, 1, order_b[i], size, frame_b);
+        
+        int ra = reasm_on_chunk(&engine, &a, 100);
+        assert(ra == (i == total - 1 ? 1 : 0));
+        if (i == total - 1) {
+            assert(sink.last_src == 3 && sink.last_size == size);
+            assert(memcmp(sink.last_data, frame_a, size) == 0);
+        }
+        
+        // Duplicado é ignorado
+        if (i % 5 == 0 && i != total - 1) {
+            assert(reasm_on_chunk(&engine, &a, 100) == -1);
+        }
+        
+        assert(reasm_on_chunk(&engine, &b, 100) == (i == total - 1 ? 1 : 0));
+    }
+    
+    assert(sink.frames == 2);
+    assert(sink.last_src == 9 && memcmp(sink.last_data, frame_b, size) == 0);
+    assert(engine.chunks_duplicate > 0);
+    assert(engine.chunks_out_of_order > 0);
+    assert(reasm_active_streams(&engine) == 0);
+    
+    // Chunks inválidos: sequence fora do frame, chunk intermédio curto
+    reasm_chunk_t bad = make_chunk(3, 2, 0, size, frame_a);
+    bad.sequence = total;
+    assert(reasm_on_chunk(&engine, &bad, 100) == -1);
+    bad = make_chunk(3, 2, 0, size, frame_a);
+    bad.len = STRIDE - 1;
+    assert(reasm_on_chunk(&engine, &bad, 100) == -1);
+    
+    reasm_print_stats(&engine);
+    reasm_destroy(&engine);
+    printf("✓ Test passed\n");
+}
+
+void test_expiry_and_eviction(void) {
+    printf("\n=== Test: Expiry and Eviction ===\n");
+    
+    static sink_t sink;
+    memset(&sink, 0, sizeof(sink));
+    reasm_engine_t engine;
+    reasm_init(&engine, MAX_FRAME, sink_deliver, &sink);
+    
+    uint8_t frame[MAX_FRAME] = {0};
+    uint32_t size = 10 * STRIDE;
+    
+    // Stream incompleto expira (9 chunks perdidos)
+    reasm_chunk_t chunk = make_chunk(5, 1, 0, size, frame);
+    assert(reasm_on_chunk(&engine, &chunk, 1000) == 0);
+    assert(reasm_expire(&engine, 1000 + REASM_TIMEOUT_MS) == 0);
+    assert(reasm_expire(&engine, 1001 + REASM_TIMEOUT_MS) == 1);
+    assert(engine.frames_expired == 1 && engine.chunks_lost == 9);
+    
+    // REASM_MAX_STREAMS + 1 streams: o mais antigo é despejado
+    for (uint32_t s = 0; s <= REASM_MAX_STREAMS; s++) {
+        chunk = make_chunk(5, 100 + s, 0, size, frame);
+        assert(reasm_on_chunk(&engine, &chunk, 2000 + s) == 0);
+    }
+    assert(engine.frames_evicted == 1);
+    assert(reasm_active_streams(&engine) == REASM_MAX_STREAMS);
+    
+    reasm_destroy(&engine);
+    printf("✓ Test passed\n");
+}
+
+void test_late_duplicates(void) {
+    printf("\n=== Test: Late Retransmissions After Completion ===\n");
+    
+    static sink_t sink;
+    memset(&sink, 0, sizeof(sink));
+    reasm_engine_t engine;
+    reasm_init(&engine, MAX_FRAME, sink_deliver, &sink);
+    
+    uint8_t frame[MAX_FRAME];
+    uint32_t size = 10 * STRIDE + 17;
+    uint32_t total = (size + STRIDE - 1) / STRIDE;
+    for (uint32_t i = 0; i < size; i++) frame[i] = pattern(4, i);
+    
+    for (uint32_t seq = 0; seq < total; seq++) {
+        reasm_chunk_t chunk = make_chunk(4, 1, seq, size, frame);
+        assert(reasm_on_chunk(&engine, &chunk, 1000) == (seq == total - 1 ? 1 : 0));
+    }
+    assert(sink.frames == 1);
+    
+    // Resposta a um NACK já sem razão de ser: o frame inteiro outra vez
+    uint64_t duplicates = engine.chunks_duplicate;
+    for (uint32_t seq = 0; seq < total; seq++) {
+        reasm_chunk_t chunk = make_chunk(4, 1, seq, size, frame);
+        assert(reasm_on_chunk(&engine, &chunk, 1500) == -1);
+    }
+    assert(sink.frames == 1);
+    assert(engine.chunks_duplicate == duplicates + total);
+    assert(reasm_active_streams(&engine) == 0);
+    
+    // Stream que expirou também não volta a abrir
+    reasm_chunk_t chunk = make_chunk(4, 2, 0, size, frame);
+    assert(reasm_on_chunk(&engine, &chunk, 2000) == 0);
+    assert(reasm_expire(&engine, 2001 + REASM_TIMEOUT_MS) == 1);
+    chunk = make_chunk(4, 2, 1, size, frame);
+    assert(reasm_on_chunk(&engine, &chunk, 2002 + REASM_TIMEOUT_MS) == -1);
+    assert(reasm_active_streams(&engine) == 0);
+    
+    // Passado timeout_ms o stream_id volta a valer (emissor reiniciado)
+    chunk = make_chunk(4, 1, 0, size, frame);
+    assert(reasm_on_chunk(&engine, &chunk, 1001 + REASM_TIMEOUT_MS) == 0);
+    assert(reasm_active_streams(&engine) == 1);
+    
+    reasm_destroy(&engine);
+    printf("✓ Test passed\n");
+}
+
+void test_streaming_receive(void) {
+    printf("\n=== Test: data_streaming_receive() Reassembly ===\n");
+    
+    static data_streaming_t stream;
+    static sink_t sink;
+    memset(&sink, 0, sizeof(sink));
+    assert(data_streaming_init(&stream, 4, NULL) == 0);
+    data_streaming_set_frame_callback(&stream, sink_deliver, &sink);
+    
+    static uint8_t frame[8192];
+    generate_video_frame(frame, sizeof(frame));
+    uint32_t total = (sizeof(frame) + STREAM_CHUNK_PAYLOAD - 1) / STREAM_CHUNK_PAYLOAD;
+    
+    // Chunks em ordem inversa, tal como chegariam de um relay
+    int ret = 0;
+    for (int seq = total - 1; seq >= 0; seq--) {
+        uint8_t wire[MAX_CHUNK_SIZE];
+        uint32_t offset = seq * STREAM_CHUNK_PAYLOAD;
+        uint32_t len = sizeof(frame) - offset < STREAM_CHUNK_PAYLOAD ?
+                       sizeof(frame) - offset : STREAM_CHUNK_PAYLOAD;
+        
+        stream_header_t header = {
+            .stream_id = 77,
+            .sequence_number = seq,
+            .total_chunks = total,
+            .chunk_size = len,
+            .type = STREAM_TYPE_VIDEO
+        };
+        memcpy(wire, &header, sizeof(header));
+        memcpy(wire + sizeof(header), frame + offset, len);
+        
+        ret = data_streaming_receive(&stream, 1, wire, sizeof(header) + len);
+        assert(ret >= 0);
+    }
+    
+    assert(ret == (int)sizeof(frame));
+    assert(sink.frames == 1 && sink.last_src == 1);
+    assert(memcmp(sink.last_data, frame, sizeof(frame)) == 0);
+    
+    // Chunk truncado é rejeitado
+    stream_header_t header = { .stream_id = 78, .total_chunks = 1, .chunk_size = 100 };
+    assert(data_streaming_receive(&stream, 1, (uint8_t *)&header, sizeof(header)) == -1);
+    
+    data_streaming_destroy(&stream);
+    printf("✓ Test passed\n");
+}
+
+int main(void) {
+    test_interleaved_out_of_order();
+    test_expiry_and_eviction();
+    test_late_duplicates();
+    test_streaming_receive();
+    
+    printf("\n=== All stream reassembly tests passed ===\n");
+    return 0;
+}
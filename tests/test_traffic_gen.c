@@ -0,0 +1,247 @@
+// tests/test_traffic_gen.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include "traffic_gen.h"
+
+// Ligação direta 50 — 51 via loopback (envio direto, sem forwarding)
+#define NODE_TX 50
+#define NODE_RX 51
+
+typedef struct {
+    udp_transport_t transport;
+    data_streaming_t stream;
+    traffic_engine_t engine;
+} test_node_t;
+
+static test_node_t tx_node, rx_node;
+
+void test_parse(void) {
+    printf("\n=== Test: Flow Spec Parsing ===\n");
+    
+    traffic_flow_t flow;
+    assert(traffic_flow_parse(&flow,
+           "src=1,dst=4,rate=12.5,pattern=poisson,size=1000-8000,duration=10,type=audio") == 0);
+    assert(flow.src == 1 && flow.dst == 4);
+    assert(flow.rate_fps == 12.5);
+    assert(flow.pattern == TRAFFIC_PATTERN_POISSON);
+    assert(flow.size_dist == TRAFFIC_SIZE_UNIFORM);
+    assert(flow.size_min == 1000 && flow.size_max == 8000);
+    assert(flow.duration_sec == 10);
+    assert(flow.type == STREAM_TYPE_AUDIO);
+    
+    // Espaços também separam; valores por defeito no resto
+    assert(traffic_flow_parse(&flow, "src=2 dst=3 size=gop bitrate=4000000") == 0);
+    assert(flow.size_dist == TRAFFIC_SIZE_GOP && flow.bitrate_bps == 4000000);
+    assert(flow.pattern == TRAFFIC_PATTERN_CBR && flow.rate_fps == 30);
+    
+    assert(traffic_flow_parse(&flow, "src=2,dst=3,size=4096") == 0);
+    assert(flow.size_dist == TRAFFIC_SIZE_FIXED && flow.size_min == 4096);
+    
+    assert(traffic_flow_parse(&flow, "src=1") == -1);                 // Sem dst
+    assert(traffic_flow_parse(&flow, "src=1,dst=1") == -1);
+    assert(traffic_flow_parse(&flow, "src=1,dst=2,size=8") == -1);    // < cabeçalho
+    assert(traffic_flow_parse(&flow, "src=1,dst=2,size=9000-100") == -1);
+    assert(traffic_flow_parse(&flow, "src=1,dst=2,pattern=square") == -1);
+    assert(traffic_flow_parse(&flow, "src=1,dst=2,rate=-3") == -1);
+    assert(traffic_flow_parse(&flow, "src=1,dst=2,color=red") == -1);
+    assert(traffic_flow_parse(&flow, "src=1,dst=2,rate") == -1);
+    
+    printf("✓ Test passed\n");
+}
+
+void test_load_file(void) {
+    printf("\n=== Test: Flow File ===\n");
+    
+    char path[] = "/tmp/test_traffic_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    FILE *file = fdopen(fd, "w");
+    fprintf(file, "# Dois fluxos para o nó 4\n");
+    fprintf(file, "src=1,dst=4,rate=30\n");
+    fprintf(file, "\n");
+    fprintf(file, "src=2 dst=4 pattern=bursty burst=3   # rajadas\n");
+    fclose(file);
+    
+    static traffic_engine_t engine;
+    traffic_engine_init(&engine, NULL, 4);
+    assert(traffic_engine_load_file(&engine, path) == 2);
+    assert(engine.num_flows == 2);
+    assert(engine.flows[1].id == 1 && engine.flows[1].burst == 3);
+    assert(engine.flows[0].seed != engine.flows[1].seed);
+    
+    // Linha inválida rejeita o ficheiro
+    file = fopen(path, "a");
+    fprintf(file, "src=3,dst=4,pattern=square\n");
+    fclose(file);
+    assert(traffic_engine_load_file(&engine, path) == -1);
+    
+    assert(traffic_engine_load_file(&engine, "/nonexistent/flows") == -1);
+    unlink(path);
+    
+    printf("✓ Test passed\n");
+}
+
+static void setup_node(test_node_t *node, node_id_t id) {
+    assert(udp_transport_init(&node->transport, id) == 0);
+    assert(udp_transport_set_peers(&node->transport, 64) == 0);
+    node->transport.peer_addrs[NODE_TX].sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    node->transport.peer_addrs[NODE_RX].sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    
+    assert(data_streaming_init(&node->stream, id, &node->transport) == 0);
+    traffic_engine_init(&node->engine, &node->stream, id);
+    node->engine.warmup_sec = 0;
+}
+
+static void teardown_node(test_node_t *node) {
+    traffic_engine_destroy(&node->engine);
+    data_streaming_destroy(&node->stream);
+    udp_transport_destroy(&node->transport);
+}
+
+// Entrega ao streaming tudo o que chega até 'idle_ms' sem tráfego
+static void pump(test_node_t *node, int idle_ms) {
+    udp_rx_packet_t batch[UDP_RX_BATCH];
+    
+    while (udp_transport_wait(&node->transport, idle_ms) > 0) {
+        int count = udp_transport_receive_batch(&node->transport, batch, UDP_RX_BATCH);
+        
+        for (int i = 0; i < count; i++) {
+            data_streaming_receive(&node->stream, batch[i].header.src,
+                                   batch[i].payload + sizeof(mesh_header_t),
+                                   batch[i].payload_len - sizeof(mesh_header_t));
+        }
+    }
+}
+
+static void add_flow(const char *spec) {
+    traffic_flow_t flow;
+    assert(traffic_flow_parse(&flow, spec) == 0);
+    assert(traffic_engine_add_flow(&tx_node.engine, &flow) >= 0);
+    assert(traffic_engine_add_flow(&rx_node.engine, &flow) >= 0);
+}
+
+void test_end_to_end(void) {
+    printf("\n=== Test: Three Flows 50 → 51 (CBR, Poisson, Bursty) ===\n");
+    
+    setup_node(&tx_node, NODE_TX);
+    setup_node(&rx_node, NODE_RX);
+    
+    add_flow("src=50,dst=51,rate=100,size=2000,duration=0.3");
+    add_flow("src=50,dst=51,rate=100,pattern=poisson,size=500-3000,duration=0.3");
+    add_flow("src=50,dst=51,rate=50,pattern=bursty,burst=5,size=1000,duration=0.3,type=data");
+    
+    assert(traffic_engine_start(&rx_node.engine) == 0);
+    assert(!rx_node.engine.running);              // Só recebe
+    assert(traffic_engine_start(&tx_node.engine) == 0);
+    assert(tx_node.engine.running && tx_node.engine.num_local_tx == 3);
+    
+    while (!traffic_engine_tx_done(&tx_node.engine)) {
+        pump(&rx_node, 10);
+    }
+    pump(&rx_node, 100);
+    traffic_engine_stop(&tx_node.engine);
+    
+    // CBR: 30 frames em 0.3 s; rajadas: múltiplos de 5
+    assert(tx_node.engine.tx[0].frames_sent >= 29 && tx_node.engine.tx[0].frames_sent <= 31);
+    assert(tx_node.engine.tx[1].frames_sent >= 10 && tx_node.engine.tx[1].frames_sent <= 60);
+    assert(tx_node.engine.tx[2].frames_sent % 5 == 0);
+    assert(tx_node.engine.tx[2].frames_sent >= 10 && tx_node.engine.tx[2].frames_sent <= 20);
+    
+    for (int i = 0; i < 3; i++) {
+        const traffic_tx_state_t *tx = &tx_node.engine.tx[i];
+        const traffic_rx_state_t *rx = &rx_node.engine.rx[i];
+        assert(tx->frames_failed == 0);
+        assert(rx->frames_received == tx->frames_sent);
+        assert(rx->bytes_received == tx->bytes_sent);
+        assert(rx->next_seq == tx->frames_sent);           // Sem perdas
+        assert(rx->report_received && rx->sender_frames_sent == tx->frames_sent);
+        assert(rx->frames_duplicate == 0);
+        assert(traffic_engine_rx_lost(&rx_node.engine, i) == 0);
+        
+        assert(rx->latency.total == rx->frames_received);
+        assert(latency_hist_percentile(&rx->latency, 50) <=
+               latency_hist_percentile(&rx->latency, 99));
+        assert(latency_hist_percentile(&rx->latency, 99) <= rx->latency.max_us);
+    }
+    
+    double fairness = traffic_engine_rx_fairness(&rx_node.engine);
+    assert(fairness > 0 && fairness <= 1.0);
+    assert(rx_node.engine.frames_unknown == 0);
+    
+    // Payload sem traffic_header_t: contado, não atribuído a um fluxo
+    uint8_t junk[600];
+    memset(junk, 0xAB, sizeof(junk));
+    assert(data_streaming_send(&tx_node.stream, NODE_RX, junk, sizeof(junk),
+                               STREAM_TYPE_DATA) > 0);
+    pump(&rx_node, 100);
+    assert(rx_node.engine.frames_unknown == 1);
+    
+    assert(traffic_engine_print_report(&tx_node.engine) == 3);
+    assert(traffic_engine_print_report(&rx_node.engine) == 3);
+    
+    teardown_node(&tx_node);
+    teardown_node(&rx_node);
+    
+    printf("✓ Test passed\n");
+}
+
+// Frame do fluxo 0 com a seq dada, tal como o emissor o montaria
+static void send_seq(uint32_t seq) {
+    uint8_t frame[600];
+    memset(frame, 0, sizeof(frame));
+    traffic_header_t header = { .magic = TRAFFIC_MAGIC, .flow_id = 0, .seq = seq };
+    memcpy(frame, &header, sizeof(header));
+    assert(data_streaming_send(&tx_node.stream, NODE_RX, frame, sizeof(frame),
+                               STREAM_TYPE_DATA) > 0);
+}
+
+void test_loss_accounting(void) {
+    printf("\n=== Test: Loss Counts Duplicates and Tail Losses ===\n");
+    
+    setup_node(&tx_node, NODE_TX);
+    setup_node(&rx_node, NODE_RX);
+    add_flow("src=50,dst=51,rate=10,size=600,duration=1");
+    assert(traffic_engine_start(&rx_node.engine) == 0);
+    
+    // Seq 1 perdida, 2 duplicada: a duplicada não tapa a perda
+    send_seq(0);
+    send_seq(2);
+    send_seq(2);
+    send_seq(3);
+    pump(&rx_node, 100);
+    
+    const traffic_rx_state_t *rx = &rx_node.engine.rx[0];
+    assert(rx->frames_received == 3 && rx->frames_duplicate == 1);
+    assert(rx->next_seq == 4);
+    assert(traffic_engine_rx_lost(&rx_node.engine, 0) == 1);
+    
+    // O emissor enviou 6: as seqs 4 e 5 perderam-se no fim do fluxo
+    traffic_report_t report = { .magic = TRAFFIC_REPORT_MAGIC, .flow_id = 0, .frames_sent = 6 };
+    assert(data_streaming_send(&tx_node.stream, NODE_RX, (const uint8_t *)&report,
+                               sizeof(report), STREAM_TYPE_DATA) > 0);
+    pump(&rx_node, 100);
+    assert(rx->report_received && rx->sender_frames_sent == 6);
+    assert(traffic_engine_rx_lost(&rx_node.engine, 0) == 3);
+    assert(rx_node.engine.frames_unknown == 0);
+    
+    assert(traffic_engine_print_report(&rx_node.engine) == 1);
+    
+    teardown_node(&tx_node);
+    teardown_node(&rx_node);
+    
+    printf("✓ Test passed\n");
+}
+
+int main(void) {
+    test_parse();
+    test_load_file();
+    test_end_to_end();
+    test_loss_accounting();
+    
+    printf("\n=== All traffic generator tests passed ===\n");
+    return 0;
+}
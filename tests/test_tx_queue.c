@@ -0,0 +1,229 @@
+// tests/test_tx_queue.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include "tx_queue.h"
+
+#define TEST_NODE_ID 42   // Porta 5042 (evita colidir com uma rede a correr)
+#define LOOP_PEER 7
+
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static tx_frame_t make_frame(uint32_t value) {
+    tx_frame_t frame = {0};
+    frame.dst = LOOP_PEER;
+    frame.type = MSG_DATA;
+    frame.data = malloc(sizeof(value));
+    memcpy(frame.data, &value, sizeof(value));
+    frame.len = sizeof(value);
+    return frame;
+}
+
+// Transporte cujo peer LOOP_PEER aponta para o próprio socket
+static void init_loopback_transport(udp_transport_t *transport) {
+    assert(udp_transport_init(transport, TEST_NODE_ID) == 0);
+    assert(udp_transport_set_peers(transport, 16) == 0);
+    transport->peer_addrs[LOOP_PEER].sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    transport->peer_addrs[LOOP_PEER].sin_port = htons(transport->port);
+}
+
+void test_drain_in_slot(void) {
+    printf("\n=== Test: Drain Inside Slot ===\n");
+    
+    udp_transport_t transport;
+    init_loopback_transport(&transport);
+    
+    tx_queue_t queue;
+    assert(tx_queue_init(&queue, 64) == 0);
+    
+    // Contadores exportados vão para os shards do registo
+    metrics_registry_t reg;
+    assert(metrics_registry_init(&reg, TEST_NODE_ID) == 0);
+    udp_transport_set_metrics(&transport, &reg);
+    tx_queue_set_metrics(&queue, &reg);
+    
+    // Fora do slot nada sai da fila
+    for (int i = 0; i < 50; i++) {
+        tx_frame_t frame = make_frame(100 + i);
+        assert(tx_queue_push(&queue, &frame, 0) == 0);
+    }
+    assert(tx_queue_pending(&queue) == 50);
+    assert(udp_transport_wait(&transport, 10) == 0);
+    
+    // Deadline já passada: não envia nada
+    assert(tx_queue_drain(&queue, &transport, now_us()) == 0);
+    assert(tx_queue_pending(&queue) == 50);
+    
+    // Slot de 100 ms: drena tudo em batches
+    assert(tx_queue_drain(&queue, &transport, now_us() + 100000) == 50);
+    assert(tx_queue_pending(&queue) == 0);
+    assert(queue.sent == 50 && queue.send_errors == 0);
+    assert(queue.bytes_sent == 50 * sizeof(uint32_t));
+    assert(queue.slots_with_data == 1);
+    assert(queue.last_slot_bytes == 50 * sizeof(uint32_t));
+    assert(metrics_value(&reg, queue.metric_ids.sent) == 50);
+    assert(metrics_value(&reg, transport.metric_ids.packets_sent) == 50);
+    assert(metrics_value(&reg, transport.metric_ids.bytes_sent) == transport.bytes_sent);
+    
+    // Ordem FIFO preservada
+    udp_rx_packet_t batch[UDP_RX_BATCH];
+    int total = 0, count;
+    assert(udp_transport_wait(&transport, 1000) == 1);
+    while ((count = udp_transport_receive_batch(&transport, batch, UDP_RX_BATCH)) > 0) {
+        for (int i = 0; i < count; i++) {
+            uint32_t value;
+            memcpy(&value, batch[i].payload, sizeof(value));
+            assert(value == (uint32_t)(100 + total));
+            total++;
+        }
+    }
+    assert(total == 50);
+    assert(metrics_value(&reg, transport.metric_ids.packets_received) == 50);
+    
+    tx_queue_print_stats(&queue);
+    tx_queue_destroy(&queue);
+    udp_transport_destroy(&transport);
+    metrics_registry_destroy(&reg);
+    printf("✓ Test passed\n");
+}
+
+void test_slot_deadline(void) {
+    printf("\n=== Test: Guard Scales With Slot Length ===\n");
+    
+    // Slot de 100 ms: margem máxima
+    assert(tx_queue_slot_deadline(1000000, 1100000) == 1100000 - TX_SLOT_GUARD_US);
+    
+    // Slots de 1 ms e 400 us: 1/10 do slot, sobra tempo para dados
+    assert(tx_queue_slot_deadline(1000000, 1001000) == 1000900);
+    assert(tx_queue_slot_deadline(1000000, 1000400) == 1000360);
+    
+    // Slot vazio: deadline no início, nada sai
+    assert(tx_queue_slot_deadline(1000000, 1000000) == 1000000);
+    
+    printf("✓ Test passed\n");
+}
+
+void test_failed_packet_accounting(void) {
+    printf("\n=== Test: Failed Packet Mid-Batch ===\n");
+    
+    udp_transport_t transport;
+    init_loopback_transport(&transport);
+    
+    tx_queue_t queue;
+    assert(tx_queue_init(&queue, 64) == 0);
+    
+    // Frame 0 não cabe num pacote: falha, os outros 9 saem
+    tx_frame_t big = make_frame(0);
+    free(big.data);
+    big.len = MAX_PACKET_SIZE;
+    big.data = calloc(1, big.len);
+    assert(tx_queue_push(&queue, &big, 0) == 0);
+    usleep(200000);   // Só o frame que falha fica muito tempo na fila
+    for (int i = 1; i < 10; i++) {
+        tx_frame_t frame = make_frame(i);
+        assert(tx_queue_push(&queue, &frame, 0) == 0);
+    }
+    
+    assert(tx_queue_drain(&queue, &transport, now_us() + 100000) == 9);
+    assert(queue.sent == 9 && queue.send_errors == 1);
+    assert(queue.bytes_sent == 9 * sizeof(uint32_t));   // Não os bytes do frame grande
+    assert(queue.total_queue_delay_us < 100000);        // Nem a espera dele
+    
+    // Os que saíram são os frames 1-9
+    udp_rx_packet_t batch[UDP_RX_BATCH];
+    assert(udp_transport_wait(&transport, 1000) == 1);
+    int count = udp_transport_receive_batch(&transport, batch, UDP_RX_BATCH);
+    assert(count == 9);
+    for (int i = 0; i < count; i++) {
+        uint32_t value;
+        memcpy(&value, batch[i].payload, sizeof(value));
+        assert(value == (uint32_t)(i + 1));
+    }
+    
+    tx_queue_destroy(&queue);
+    udp_transport_destroy(&transport);
+    printf("✓ Test passed\n");
+}
+
+static void *blocked_producer(void *arg) {
+    tx_queue_t *queue = arg;
+    tx_frame_t frame = make_frame(999);
+    int ret = tx_queue_push(queue, &frame, -1);
+    if (ret < 0) free(frame.data);
+    return (void *)(intptr_t)ret;
+}
+
+void test_backpressure(void) {
+    printf("\n=== Test: Producer Backpressure ===\n");
+    
+    udp_transport_t transport;
+    init_loopback_transport(&transport);
+    
+    tx_queue_t queue;
+    assert(tx_queue_init(&queue, 4) == 0);
+    
+    for (int i = 0; i < 4; i++) {
+        tx_frame_t frame = make_frame(i);
+        assert(tx_queue_push(&queue, &frame, 0) == 0);
+    }
+    
+    // Fila cheia: sem espera falha logo, com timeout espera e falha
+    tx_frame_t extra = make_frame(4);
+    assert(tx_queue_push(&queue, &extra, 0) < 0);
+    uint64_t t0 = now_us();
+    assert(tx_queue_push(&queue, &extra, 30) < 0);
+    assert(now_us() - t0 >= 25000);
+    free(extra.data);
+    assert(queue.rejected == 2);
+    
+    // Produtor bloqueado só avança quando o slot drena
+    pthread_t producer;
+    pthread_create(&producer, NULL, blocked_producer, &queue);
+    usleep(20000);
+    assert(tx_queue_pending(&queue) == 4);
+    
+    assert(tx_queue_drain(&queue, &transport, now_us() + 100000) >= 4);
+    void *ret;
+    pthread_join(producer, &ret);
+    assert((intptr_t)ret == 0);
+    assert(queue.enqueued == 5);
+    
+    // Fila fechada acorda e rejeita produtores
+    tx_queue_drain(&queue, &transport, now_us() + 100000);
+    for (int i = 0; i < 4; i++) {
+        tx_frame_t frame = make_frame(i);
+        assert(tx_queue_push(&queue, &frame, 0) == 0);
+    }
+    pthread_create(&producer, NULL, blocked_producer, &queue);
+    usleep(20000);
+    tx_queue_close(&queue);
+    pthread_join(producer, &ret);
+    assert((intptr_t)ret < 0);
+    
+    printf("Producer waits: %lu, rejected: %lu\n",
+           queue.producer_waits, queue.rejected);
+    
+    tx_queue_destroy(&queue);
+    udp_transport_destroy(&transport);
+    printf("✓ Test passed\n");
+}
+
+int main(void) {
+    test_drain_in_slot();
+    test_slot_deadline();
+    test_failed_packet_accounting();
+    test_backpressure();
+    
+    printf("\n=== All TX queue tests passed ===\n");
+    return 0;
+}
@@ -0,0 +1,126 @@
+// tests/test_tx_scheduler.c
+#include <stdio.h>
+#include <assert.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "ra_tdmas_sync.h"
+#include "tx_scheduler.h"
+
+void test_slot_wakeups(void) {
+    printf("\n=== Test: Slot-aligned Wakeups (timerfd) ===\n");
+    
+    node_id_t nodes[] = {1, 2, 3, 4};
+    ra_tdmas_sync_t sync;
+    assert(ra_tdmas_init(&sync, 3, nodes, 4) == 0);
+    
+    tx_scheduler_t sched;
+    assert(tx_scheduler_init(&sched, &sync) == 0);
+    
+    uint64_t prev_start = 0;
+    for (int i = 0; i < 4; i++) {
+        uint64_t start, end;
+        assert(tx_scheduler_wait_slot(&sched, &start, &end) == 0);
+        
+        // Acordou dentro do meu slot
+        assert(ra_tdmas_can_transmit(&sync));
+        assert(end - start == sync.slots[sync.my_slot_index].duration_us);
+        
+        // Um slot por ronda, sem repetir o mesmo slot
+        if (prev_start > 0) {
+            assert(start - prev_start == sync.round_period_us);
+        }
+        prev_start = start;
+        
+        ra_tdmas_on_round_end(&sync);
+    }
+    
+    tx_scheduler_print_stats(&sched);
+    assert(sched.slots_served == 4);
+    assert(sched.max_jitter_us < (int64_t)sync.slots[sync.my_slot_index].duration_us);
+    
+    tx_scheduler_destroy(&sched);
+    ra_tdmas_destroy(&sync);
+    printf("✓ Test passed\n");
+}
+
+void test_one_window_per_round(void) {
+    printf("\n=== Test: Slot Shifted Later After TX ===\n");
+    
+    node_id_t nodes[] = {1, 2, 3, 4};
+    ra_tdmas_sync_t sync;
+    assert(ra_tdmas_init(&sync, 3, nodes, 4) == 0);
+    
+    uint64_t round0 = 10 * (uint64_t)sync.round_period_us;
+    sync.round_start_us = round0;
+    slot_boundary_t *slot = &sync.slots[sync.my_slot_index];
+    uint64_t offset = slot->start_offset_us;
+    
+    // Transmitimos no slot da ronda 0
+    uint64_t start, end;
+    ra_tdmas_next_slot_window(&sync, round0 + offset + 1000, &start, &end);
+    assert(start == round0 + offset);
+    ra_tdmas_mark_window_served(&sync, start);
+    
+    // Um ajuste empurra o slot para depois do ponto onde estamos
+    slot->start_offset_us += 5000;
+    ra_tdmas_next_slot_window(&sync, round0 + offset + 2000, &start, &end);
+    assert(start == round0 + sync.round_period_us + slot->start_offset_us);
+    
+    // Dentro do slot deslocado continua a ser a próxima ronda
+    ra_tdmas_next_slot_window(&sync, round0 + slot->start_offset_us + 100, &start, &end);
+    assert(start == round0 + sync.round_period_us + slot->start_offset_us);
+    assert(end - start == slot->duration_us);
+    
+    // Na ronda seguinte a janela volta a ser a atual
+    uint64_t round1 = round0 + sync.round_period_us;
+    ra_tdmas_next_slot_window(&sync, round1 + slot->start_offset_us + 100, &start, &end);
+    assert(start == round1 + slot->start_offset_us);
+    
+    ra_tdmas_destroy(&sync);
+    printf("✓ Test passed\n");
+}
+
+static void *cancel_later(void *arg) {
+    usleep(20000);
+    tx_scheduler_cancel((tx_scheduler_t *)arg);
+    return NULL;
+}
+
+void test_cancel(void) {
+    printf("\n=== Test: Scheduler Cancel ===\n");
+    
+    // Um só nó com slot de 100ms: cancelar antes de chegar à próxima ronda
+    node_id_t nodes[] = {1};
+    ra_tdmas_sync_t sync;
+    assert(ra_tdmas_init(&sync, 1, nodes, 1) == 0);
+    
+    tx_scheduler_t sched;
+    assert(tx_scheduler_init(&sched, &sync) == 0);
+    
+    uint64_t start, end;
+    assert(tx_scheduler_wait_slot(&sched, &start, &end) == 0);  // Slot atual
+    
+    pthread_t thread;
+    pthread_create(&thread, NULL, cancel_later, &sched);
+    
+    uint64_t t0 = ra_tdmas_get_current_time_us();
+    assert(tx_scheduler_wait_slot(&sched, &start, &end) == -1);
+    uint64_t waited = ra_tdmas_get_current_time_us() - t0;
+    pthread_join(thread, NULL);
+    
+    printf("Cancelled after %lu us\n", waited);
+    assert(waited < sync.round_period_us);
+    
+    tx_scheduler_destroy(&sched);
+    ra_tdmas_destroy(&sync);
+    printf("✓ Test passed\n");
+}
+
+int main(void) {
+    test_slot_wakeups();
+    test_one_window_per_round();
+    test_cancel();
+    
+    printf("\n=== All TX scheduler tests passed ===\n");
+    return 0;
+}
@@ -0,0 +1,204 @@
+// tests/test_udp_transport.c
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include "udp_transport.h"
+
+#define TEST_NODE_ID 41   // Porta 5041 (evita colidir com uma rede a correr)
+
+// Envia um pacote com header válido para o transporte via loopback
+static void send_loopback(int sock, uint16_t port, uint16_t seq,
+                          const void *payload, uint16_t len) {
+    uint8_t buffer[MAX_PACKET_SIZE];
+    udp_header_t header = {0};
+    header.version = 1;
+    header.type = MSG_DATA;
+    header.src = 7;
+    header.dst = TEST_NODE_ID;
+    header.sequence = seq;
+    header.payload_len = len;
+    
+    memcpy(buffer, &header, sizeof(header));
+    memcpy(buffer + sizeof(header), payload, len);
+    
+    struct sockaddr_in addr = {0};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    
+    ssize_t sent = sendto(sock, buffer, sizeof(header) + len, 0,
+                          (struct sockaddr *)&addr, sizeof(addr));
+    assert(sent == (ssize_t)(sizeof(header) + len));
+}
+
+void test_batch_receive(void) {
+    printf("\n=== Test: Batch Receive (epoll + recvmmsg) ===\n");
+    
+    udp_transport_t transport;
+    assert(udp_transport_init(&transport, TEST_NODE_ID) == 0);
+    
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    assert(sock >= 0);
+    
+    // Sem dados: wait expira e receive_batch não bloqueia
+    udp_rx_packet_t batch[UDP_RX_BATCH];
+    assert(udp_transport_wait(&transport, 10) == 0);
+    assert(udp_transport_receive_batch(&transport, batch, UDP_RX_BATCH) == 0);
+    
+    // Burst de 40 pacotes + 1 pacote inválido
+    int burst = 40;
+    for (int i = 0; i < burst; i++) {
+        uint32_t value = 1000 + i;
+        send_loopback(sock, transport.port, i, &value, sizeof(value));
+    }
+    uint8_t garbage[4] = {0};
+    struct sockaddr_in addr = {0};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(transport.port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    sendto(sock, garbage, sizeof(garbage), 0, (struct sockaddr *)&addr, sizeof(addr));
+    
+    assert(udp_transport_wait(&transport, 1000) == 1);
+    
+    int total = 0;
+    int count;
+    while ((count = udp_transport_receive_batch(&transport, batch, UDP_RX_BATCH)) > 0) {
+        for (int i = 0; i < count; i++) {
+            uint32_t value;
+            assert(batch[i].payload_len == sizeof(value));
+            memcpy(&value, batch[i].payload, sizeof(value));
+            assert(batch[i].header.sequence == total);
+            assert(value == (uint32_t)(1000 + total));
+            total++;
+        }
+    }
+    
+    printf("Received %d packets in %lu recvmmsg() calls (errors: %lu)\n",
+           total, transport.rx_batches, transport.errors);
+    assert(total == burst);
+    assert(transport.rx_batches == 2);
+    assert(transport.errors == 1);
+    
+    close(sock);
+    udp_transport_destroy(&transport);
+    printf("✓ Test passed\n");
+}
+
+void test_address_mapping(void) {
+    printf("\n=== Test: Node ID to Address Mapping ===\n");
+    
+    char ip[32];
+    node_id_to_ip(1, ip, sizeof(ip));
+    assert(strcmp(ip, "192.168.2.11") == 0);
+    node_id_to_ip(244, ip, sizeof(ip));
+    assert(strcmp(ip, "192.168.2.254") == 0);
+    node_id_to_ip(245, ip, sizeof(ip));
+    assert(strcmp(ip, "192.168.3.1") == 0);
+    
+    // Nenhum nó cai num endereço de rede ou de broadcast
+    for (uint32_t id = 1; id < 2000; id++) {
+        uint32_t addr = node_id_to_ipv4((node_id_t)id);
+        assert((addr & 0xFF) != 0 && (addr & 0xFF) != 255);
+        assert(ipv4_to_node_id(addr) == id);
+    }
+    
+    assert(ipv4_to_node_id(node_id_to_ipv4(244) + 1) == NODE_ID_INVALID);
+    assert(ipv4_to_node_id((192u << 24) | (168u << 16) | (3u << 8)) == NODE_ID_INVALID);
+    assert(node_id_to_ipv4(NODE_ID_INVALID - 1) == 0);
+    
+    printf("✓ Test passed\n");
+}
+
+void test_wakeup(void) {
+    printf("\n=== Test: Receiver Wakeup ===\n");
+    
+    udp_transport_t transport;
+    assert(udp_transport_init(&transport, TEST_NODE_ID) == 0);
+    
+    // Wakeup pendente: wait volta logo, sem dados
+    udp_transport_wakeup(&transport);
+    assert(udp_transport_wait(&transport, 5000) == 0);
+    
+    // Wakeup consumido: próximo wait expira
+    assert(udp_transport_wait(&transport, 10) == 0);
+    
+    udp_transport_destroy(&transport);
+    printf("✓ Test passed\n");
+}
+
+void test_batch_send(void) {
+    printf("\n=== Test: Batch Send (sendmmsg + scatter-gather) ===\n");
+    
+    udp_transport_t transport;
+    assert(udp_transport_init(&transport, TEST_NODE_ID) == 0);
+    assert(udp_transport_set_peers(&transport, 64) == 0);
+    
+    // Endereço pré-calculado segue o mapeamento de node_id_to_ip()
+    char ip[32], cached[INET_ADDRSTRLEN];
+    node_id_to_ip(300, ip, sizeof(ip));
+    struct sockaddr_in addr;
+    node_id_to_sockaddr(300, &addr);
+    inet_ntop(AF_INET, &addr.sin_addr, cached, sizeof(cached));
+    assert(strcmp(ip, cached) == 0);
+    assert(ntohs(transport.peer_addrs[7].sin_port) == node_id_to_port(7));
+    
+    // Redireciona o nó 7 para o próprio socket via loopback
+    transport.peer_addrs[7].sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    transport.peer_addrs[7].sin_port = htons(transport.port);
+    
+    // 40 pacotes: prefixo (2 bytes) + corpo (4 bytes) em segmentos separados
+    int count = 40;
+    uint16_t prefix = 0xBEEF;
+    uint32_t bodies[40];
+    udp_tx_packet_t packets[40];
+    for (int i = 0; i < count; i++) {
+        bodies[i] = 5000 + i;
+        packets[i].dst = 7;
+        packets[i].type = MSG_DATA;
+        packets[i].tx_timestamp_us = i;
+        packets[i].segments[0].iov_base = &prefix;
+        packets[i].segments[0].iov_len = sizeof(prefix);
+        packets[i].segments[1].iov_base = &bodies[i];
+        packets[i].segments[1].iov_len = sizeof(bodies[i]);
+        packets[i].num_segments = 2;
+    }
+    
+    assert(udp_transport_send_batch(&transport, packets, count) == count);
+    assert(transport.tx_batches == 2);
+    
+    udp_rx_packet_t batch[UDP_RX_BATCH];
+    int total = 0, n;
+    while ((n = udp_transport_receive_batch(&transport, batch, UDP_RX_BATCH)) > 0) {
+        for (int i = 0; i < n; i++) {
+            uint16_t p;
+            uint32_t body;
+            assert(batch[i].payload_len == sizeof(p) + sizeof(body));
+            memcpy(&p, batch[i].payload, sizeof(p));
+            memcpy(&body, batch[i].payload + sizeof(p), sizeof(body));
+            assert(p == 0xBEEF);
+            assert(body == (uint32_t)(5000 + total));
+            assert(batch[i].header.tx_timestamp_us == (uint64_t)total);
+            assert(batch[i].header.src == TEST_NODE_ID);
+            total++;
+        }
+    }
+    assert(total == count);
+    
+    printf("Sent %d packets in %lu sendmmsg() calls\n", count, transport.tx_batches);
+    
+    udp_transport_destroy(&transport);
+    printf("✓ Test passed\n");
+}
+
+int main(void) {
+    test_batch_receive();
+    test_batch_send();
+    test_address_mapping();
+    test_wakeup();
+    
+    printf("\n=== All UDP transport tests passed ===\n");
+    return 0;
+}